@@ -31,6 +31,12 @@
     #define XSIMD_HAS_MM_MALLOC 0
 #endif
 
+#if defined(__linux__)
+    #define XSIMD_HAS_MMAP 1
+#else
+    #define XSIMD_HAS_MMAP 0
+#endif
+
 /********************
  * Stack allocation *
  ********************/
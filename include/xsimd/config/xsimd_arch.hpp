@@ -15,6 +15,7 @@
 #include "xsimd_instruction_set.hpp"
 
 #include <algorithm>
+#include <cassert>
 #include <cstring>
 
 // header for runtime architecture detection {
@@ -485,7 +486,9 @@ namespace xsimd
                 auto walk_archs(arch_list<Arch, ArchNext, Archs...>, Tys&&... args) -> decltype(functor(Arch{}, std::forward<Tys>(args)...))
                 {
                     static_assert(Arch::supported, "dispatching on supported architecture");
-                    if(Arch::version == best_arch)
+                    // the best available architecture may be newer than the
+                    // ones the code is compiled for
+                    if(Arch::version <= best_arch && Arch::available())
                       return functor(Arch{}, std::forward<Tys>(args)...);
                     else
                       return walk_archs(arch_list<ArchNext, Archs...>{}, std::forward<Tys>(args)...);
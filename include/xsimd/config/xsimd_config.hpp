@@ -30,6 +30,18 @@
     #define XSIMD_STACK_ALLOCATION_LIMIT 20000
 #endif
 
+// Size in bytes of the outputs above which the streaming transform uses
+// non-temporal stores
+#ifndef XSIMD_STREAM_STORE_THRESHOLD
+    #define XSIMD_STREAM_STORE_THRESHOLD (1 << 22)
+#endif
+
+// Distance in bytes ahead of the loads at which the array algorithms
+// prefetch their inputs by default
+#ifndef XSIMD_PREFETCH_DISTANCE
+    #define XSIMD_PREFETCH_DISTANCE 512
+#endif
+
 #if defined(__LP64__) || defined(_WIN64)
     #define XSIMD_64_BIT_ABI
 #else
@@ -129,6 +129,14 @@
         #define XSIMD_AVX512BW_AVAILABLE 1
     #endif
 
+    #if defined(__AVX512CD__)
+        #define XSIMD_AVX512CD_AVAILABLE 1
+    #endif
+
+    #if defined(__AVX512VBMI__)
+        #define XSIMD_AVX512VBMI_AVAILABLE 1
+    #endif
+
     #if __GNUC__ == 6
         #define XSIMD_AVX512_SHIFT_INTRINSICS_IMM_ONLY 1
     #endif
@@ -19,6 +19,12 @@
 
 #include "../config/xsimd_align.hpp"
 
+#if XSIMD_HAS_MMAP
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #if defined(XSIMD_ALLOCA)
 #if defined(__GNUC__)
 #include <alloca.h>
@@ -94,6 +100,87 @@ namespace xsimd
                     const aligned_allocator<T2, Align2>& rhs) noexcept;
 
 
+    namespace detail
+    {
+        constexpr size_t huge_page_size = size_t(2) * 1024 * 1024;
+    }
+
+    /**
+     * @class huge_page_allocator
+     * @brief Allocator for large arrays backed by huge pages
+     *
+     * The huge_page_allocator class template is an allocator that
+     * performs memory allocation aligned by the specified value, like
+     * aligned_allocator, and maps the allocations of at least
+     * huge_page_size bytes to 2 MB pages: it reserves huge pages with
+     * MAP_HUGETLB when the system has some available, and otherwise asks
+     * for transparent huge pages with madvise on a mapping aligned on
+     * 2 MB. These allocations may be bound to a NUMA node with mbind;
+     * without a node, the pages are placed on the node of the thread
+     * which first touches them. Platforms without mmap use aligned_malloc
+     * for all sizes.
+     *
+     * @tparam T type of objects to allocate.
+     * @tparam Align alignment in bytes, at most huge_page_size.
+     */
+    template <class T, size_t Align = arch::default_::alignment>
+    class huge_page_allocator
+    {
+    public:
+
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+        static constexpr size_t alignment = Align;
+        static constexpr size_t huge_page_size = detail::huge_page_size;
+        static_assert(Align <= huge_page_size, "huge_page_allocator alignment must not exceed huge_page_size");
+        // first-touch placement
+        static constexpr int any_node = -1;
+
+        template <class U>
+        struct rebind
+        {
+            using other = huge_page_allocator<U, Align>;
+        };
+
+        huge_page_allocator() noexcept;
+        explicit huge_page_allocator(int numa_node) noexcept;
+
+        template <class U>
+        huge_page_allocator(const huge_page_allocator<U, Align>& rhs) noexcept;
+
+        int numa_node() const noexcept;
+
+        pointer allocate(size_type n, const void* hint = 0);
+        void deallocate(pointer p, size_type n);
+
+        size_type max_size() const noexcept;
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args);
+
+        template <class U>
+        void destroy(U* p);
+
+    private:
+
+        int m_numa_node;
+    };
+
+    template <class T1, size_t Align1, class T2, size_t Align2>
+    bool operator==(const huge_page_allocator<T1, Align1>& lhs,
+                    const huge_page_allocator<T2, Align2>& rhs) noexcept;
+
+    template <class T1, size_t Align1, class T2, size_t Align2>
+    bool operator!=(const huge_page_allocator<T1, Align1>& lhs,
+                    const huge_page_allocator<T2, Align2>& rhs) noexcept;
+
+
     void* aligned_malloc(size_t size, size_t alignment);
     void aligned_free(void* ptr);
 
@@ -316,6 +403,225 @@ namespace xsimd
         detail::xaligned_free(ptr);
     }
 
+    /**************************************
+     * huge_page_allocator implementation *
+     **************************************/
+
+    namespace detail
+    {
+        inline size_t huge_page_mapping_size(size_t size)
+        {
+            return (size + huge_page_size - 1) & ~(huge_page_size - 1);
+        }
+
+#if XSIMD_HAS_MMAP
+        // Binds the pages to the node, as a hint: the pages stay on the
+        // default placement when the system does not support it.
+        inline void huge_page_bind(void* ptr, size_t size, int numa_node)
+        {
+            constexpr size_t word_bits = 8 * sizeof(unsigned long);
+            constexpr size_t mask_words = 16;
+            if (numa_node < 0 || static_cast<size_t>(numa_node) >= word_bits * mask_words)
+            {
+                return;
+            }
+            unsigned long mask[mask_words] = {};
+            mask[static_cast<size_t>(numa_node) / word_bits] = 1ul << (static_cast<size_t>(numa_node) % word_bits);
+            // MPOL_BIND, without depending on libnuma for <numaif.h>
+            const int bind_policy = 2;
+            syscall(SYS_mbind, ptr, size, bind_policy, mask, word_bits * mask_words + 1, 0u);
+        }
+
+        inline void* huge_page_malloc(size_t size, int numa_node)
+        {
+            size_t mapping_size = huge_page_mapping_size(size);
+            void* res = MAP_FAILED;
+#ifdef MAP_HUGETLB
+            res = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+            if (res == MAP_FAILED)
+            {
+                // over-allocate to unmap the unaligned ends
+                void* raw = mmap(nullptr, mapping_size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (raw == MAP_FAILED)
+                {
+                    return nullptr;
+                }
+                char* begin = static_cast<char*>(raw);
+                char* aligned = reinterpret_cast<char*>((reinterpret_cast<size_t>(begin) + huge_page_size - 1) & ~(huge_page_size - 1));
+                if (aligned != begin)
+                {
+                    munmap(begin, static_cast<size_t>(aligned - begin));
+                }
+                size_t tail = huge_page_size - static_cast<size_t>(aligned - begin);
+                if (tail != 0)
+                {
+                    munmap(aligned + mapping_size, tail);
+                }
+                res = aligned;
+#ifdef MADV_HUGEPAGE
+                madvise(res, mapping_size, MADV_HUGEPAGE);
+#endif
+            }
+            huge_page_bind(res, mapping_size, numa_node);
+            return res;
+        }
+
+        inline void huge_page_free(void* ptr, size_t size)
+        {
+            munmap(ptr, huge_page_mapping_size(size));
+        }
+#endif
+    }
+
+    /**
+     * Builds an allocator whose huge page allocations are placed by first
+     * touch.
+     */
+    template <class T, size_t A>
+    inline huge_page_allocator<T, A>::huge_page_allocator() noexcept
+        : m_numa_node(any_node)
+    {
+    }
+
+    /**
+     * Builds an allocator whose huge page allocations are bound to the
+     * NUMA node numa_node, or placed by first touch with any_node.
+     */
+    template <class T, size_t A>
+    inline huge_page_allocator<T, A>::huge_page_allocator(int numa_node) noexcept
+        : m_numa_node(numa_node)
+    {
+    }
+
+    /**
+     * Extended copy constructor.
+     */
+    template <class T, size_t A>
+    template <class U>
+    inline huge_page_allocator<T, A>::huge_page_allocator(const huge_page_allocator<U, A>& rhs) noexcept
+        : m_numa_node(rhs.numa_node())
+    {
+    }
+
+    /**
+     * Returns the NUMA node of the huge page allocations, or any_node.
+     */
+    template <class T, size_t A>
+    inline int huge_page_allocator<T, A>::numa_node() const noexcept
+    {
+        return m_numa_node;
+    }
+
+    /**
+     * Allocates <tt>n * sizeof(T)</tt> bytes of uninitialized memory, aligned by \c A,
+     * and on huge pages if it holds at least huge_page_size bytes.
+     * @param n the number of objects to allocate storage for.
+     * @param hint unused parameter provided for standard compliance.
+     * @return a pointer to the first byte of a memory block suitably aligned and sufficient to
+     * hold an array of \c n objects of type \c T.
+     */
+    template <class T, size_t A>
+    inline auto
+    huge_page_allocator<T, A>::allocate(size_type n, const void*) -> pointer
+    {
+        pointer res;
+#if XSIMD_HAS_MMAP
+        if (sizeof(T) * n >= huge_page_size)
+        {
+            res = reinterpret_cast<pointer>(detail::huge_page_malloc(sizeof(T) * n, m_numa_node));
+        }
+        else
+        {
+            res = reinterpret_cast<pointer>(aligned_malloc(sizeof(T) * n, A));
+        }
+#else
+        res = reinterpret_cast<pointer>(aligned_malloc(sizeof(T) * n, A));
+#endif
+        if (res == nullptr)
+            throw std::bad_alloc();
+        return res;
+    }
+
+    /**
+     * Deallocates the storage referenced by the pointer p, which must be a pointer obtained by
+     * an earlier call to allocate(). The argument \c n must be equal to the first argument of the call
+     * to allocate() that originally produced \c p; otherwise, the behavior is undefined.
+     * @param p pointer obtained from allocate().
+     * @param n number of objects earlier passed to allocate().
+     */
+    template <class T, size_t A>
+    inline void huge_page_allocator<T, A>::deallocate(pointer p, size_type n)
+    {
+#if XSIMD_HAS_MMAP
+        if (sizeof(T) * n >= huge_page_size)
+        {
+            detail::huge_page_free(p, sizeof(T) * n);
+            return;
+        }
+#endif
+        aligned_free(p);
+    }
+
+    /**
+     * Returns the maximum theoretically possible value of \c n, for which the
+     * call allocate(n, 0) could succeed.
+     * @return the maximum supported allocated size.
+     */
+    template <class T, size_t A>
+    inline auto
+    huge_page_allocator<T, A>::max_size() const noexcept -> size_type
+    {
+        return size_type(-1) / sizeof(T);
+    }
+
+    /**
+     * Constructs an object of type \c T in allocated uninitialized memory
+     * pointed to by \c p, using placement-new.
+     * @param p pointer to allocated uninitialized memory.
+     * @param args the constructor arguments to use.
+     */
+    template <class T, size_t A>
+    template <class U, class... Args>
+    inline void huge_page_allocator<T, A>::construct(U* p, Args&&... args)
+    {
+        new ((void*)p) U(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Calls the destructor of the object pointed to by \c p.
+     * @param p pointer to the object that is going to be destroyed.
+     */
+    template <class T, size_t A>
+    template <class U>
+    inline void huge_page_allocator<T, A>::destroy(U* p)
+    {
+        p->~U();
+    }
+
+    /**
+     * Compares two huge page allocators for equality. Since deallocation
+     * depends only on the size of the allocation, which selects a huge
+     * page mapping or aligned_free, memory allocated by one can always
+     * be deallocated by the other.
+     */
+    template <class T1, size_t A1, class T2, size_t A2>
+    inline bool operator==(const huge_page_allocator<T1, A1>&,
+                           const huge_page_allocator<T2, A2>&) noexcept
+    {
+        return true;
+    }
+
+    /**
+     * Compares two huge page allocators for inequality.
+     */
+    template <class T1, size_t A1, class T2, size_t A2>
+    inline bool operator!=(const huge_page_allocator<T1, A1>& lhs,
+                           const huge_page_allocator<T2, A2>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
     template <class T>
     inline size_t get_alignment_offset(const T* p, size_t size, size_t block_size)
     {
@@ -0,0 +1,201 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_ALIGNED_ARENA_HPP
+#define XSIMD_ALIGNED_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "xsimd_aligned_allocator.hpp"
+
+namespace xsimd
+{
+    /**
+     * @class aligned_arena
+     * @brief Bump allocator of aligned memory
+     *
+     * The aligned_arena class allocates memory from a list of aligned
+     * blocks by moving a position forward, and never frees single
+     * allocations: reset releases all of them at once, and rewind the
+     * ones made after a call to mark. The blocks are kept for the next
+     * allocations until release or the destruction of the arena. An
+     * arena is not thread-safe; each thread should use its own.
+     */
+    class aligned_arena
+    {
+    public:
+
+        using size_type = std::size_t;
+
+        struct marker
+        {
+            size_type block;
+            size_type offset;
+        };
+
+        static constexpr size_type default_block_size = 64 * 1024;
+
+        explicit aligned_arena(size_type block_size = default_block_size);
+        ~aligned_arena();
+
+        aligned_arena(const aligned_arena&) = delete;
+        aligned_arena& operator=(const aligned_arena&) = delete;
+
+        void* allocate(size_type size, size_type alignment = arch::default_::alignment);
+
+        template <class T>
+        T* allocate(size_type n);
+
+        marker mark() const noexcept;
+        void rewind(marker m) noexcept;
+        void reset() noexcept;
+        void release() noexcept;
+
+        size_type capacity() const noexcept;
+
+    private:
+
+        struct block
+        {
+            char* data;
+            size_type size;
+        };
+
+        std::vector<block> m_blocks;
+        size_type m_block_size;
+        size_type m_block;
+        size_type m_offset;
+    };
+
+    /********************************
+     * aligned_arena implementation *
+     ********************************/
+
+    /**
+     * Builds an arena whose blocks hold at least block_size bytes. No
+     * memory is allocated before the first call to allocate.
+     */
+    inline aligned_arena::aligned_arena(size_type block_size)
+        : m_block_size(block_size), m_block(0), m_offset(0)
+    {
+    }
+
+    inline aligned_arena::~aligned_arena()
+    {
+        release();
+    }
+
+    /**
+     * Returns size bytes aligned on alignment, a power of two, taken
+     * from the current block, from the next block large enough, or
+     * from a new block inserted at the current position.
+     */
+    inline void* aligned_arena::allocate(size_type size, size_type alignment)
+    {
+        while (m_block < m_blocks.size())
+        {
+            const block& b = m_blocks[m_block];
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(b.data);
+            size_type offset = static_cast<size_type>(((base + m_offset + alignment - 1) & ~std::uintptr_t(alignment - 1)) - base);
+            if (offset + size <= b.size)
+            {
+                m_offset = offset + size;
+                return b.data + offset;
+            }
+            if (m_offset == 0)
+            {
+                // the unused block is too small: replace it
+                aligned_free(b.data);
+                m_blocks.erase(m_blocks.begin() + static_cast<std::ptrdiff_t>(m_block));
+                break;
+            }
+            ++m_block;
+            m_offset = 0;
+        }
+        size_type block_size = size + alignment > m_block_size ? size + alignment : m_block_size;
+        char* data = static_cast<char*>(aligned_malloc(block_size, alignment < 64 ? 64 : alignment));
+        if (data == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(m_block), block{ data, block_size });
+        m_offset = size;
+        return data;
+    }
+
+    /**
+     * Returns uninitialized memory for n objects of type T, aligned on
+     * the alignment of T and of the default architecture.
+     */
+    template <class T>
+    inline T* aligned_arena::allocate(size_type n)
+    {
+        constexpr size_type alignment = alignof(T) < arch::default_::alignment ? arch::default_::alignment : alignof(T);
+        return static_cast<T*>(allocate(n * sizeof(T), alignment));
+    }
+
+    /**
+     * Returns the current position, which rewind restores.
+     */
+    inline auto aligned_arena::mark() const noexcept -> marker
+    {
+        return { m_block, m_offset };
+    }
+
+    /**
+     * Releases the allocations made after the call to mark which
+     * returned m.
+     */
+    inline void aligned_arena::rewind(marker m) noexcept
+    {
+        m_block = m.block;
+        m_offset = m.offset;
+    }
+
+    /**
+     * Releases all the allocations, keeping the blocks of memory.
+     */
+    inline void aligned_arena::reset() noexcept
+    {
+        m_block = 0;
+        m_offset = 0;
+    }
+
+    /**
+     * Releases all the allocations and frees the blocks of memory.
+     */
+    inline void aligned_arena::release() noexcept
+    {
+        for (auto& b : m_blocks)
+        {
+            aligned_free(b.data);
+        }
+        m_blocks.clear();
+        reset();
+    }
+
+    /**
+     * Returns the number of bytes of the blocks of memory.
+     */
+    inline auto aligned_arena::capacity() const noexcept -> size_type
+    {
+        size_type res = 0;
+        for (const auto& b : m_blocks)
+        {
+            res += b.size;
+        }
+        return res;
+    }
+}
+
+#endif
@@ -0,0 +1,341 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_ALIGNED_POOL_ALLOCATOR_HPP
+#define XSIMD_ALIGNED_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "xsimd_aligned_allocator.hpp"
+
+namespace xsimd
+{
+    namespace detail
+    {
+        /**
+         * Thread-local cache of the blocks freed by the pool allocators of
+         * alignment Align, sorted by power of two size classes. Each block
+         * is a separate aligned allocation, so that a block may be freed
+         * by another thread than the one which allocated it; blocks larger
+         * than the largest class are not cached.
+         */
+        template <std::size_t Align>
+        class aligned_pool
+        {
+        public:
+
+            static aligned_pool* local();
+
+            explicit aligned_pool(bool* destroyed);
+            ~aligned_pool();
+
+            aligned_pool(const aligned_pool&) = delete;
+            aligned_pool& operator=(const aligned_pool&) = delete;
+
+            static void* allocate(std::size_t size);
+            static void deallocate(void* p, std::size_t size) noexcept;
+
+        private:
+
+            struct free_block
+            {
+                free_block* next;
+            };
+
+            static constexpr std::size_t min_shift = 6;
+            static constexpr std::size_t max_shift = 24;
+            static constexpr std::size_t class_count = max_shift - min_shift + 1;
+            // bytes kept in the cache of each class
+            static constexpr std::size_t cache_size = std::size_t(1) << 26;
+            static constexpr std::size_t block_alignment = Align < 64 ? 64 : Align;
+
+            static std::size_t size_class(std::size_t size) noexcept;
+
+            free_block* m_heads[class_count];
+            std::size_t m_counts[class_count];
+            bool* m_destroyed;
+        };
+    }
+
+    /**
+     * @class aligned_pool_allocator
+     * @brief Allocator for aligned memory recycled by each thread
+     *
+     * The aligned_pool_allocator class template is an allocator that
+     * performs memory allocation aligned by the specified value, like
+     * aligned_allocator, and keeps the freed memory in a cache local to
+     * the thread for the next allocations of the same size class, so that
+     * threads allocating and freeing temporary arrays do not contend for
+     * the system allocator.
+     *
+     * @tparam T type of objects to allocate.
+     * @tparam Align alignment in bytes.
+     */
+    template <class T, size_t Align = arch::default_::alignment>
+    class aligned_pool_allocator
+    {
+    public:
+
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+
+        static constexpr size_t alignment = Align;
+
+        template <class U>
+        struct rebind
+        {
+            using other = aligned_pool_allocator<U, Align>;
+        };
+
+        aligned_pool_allocator() noexcept = default;
+
+        template <class U>
+        aligned_pool_allocator(const aligned_pool_allocator<U, Align>& rhs) noexcept;
+
+        pointer allocate(size_type n, const void* hint = 0);
+        void deallocate(pointer p, size_type n);
+
+        size_type max_size() const noexcept;
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args);
+
+        template <class U>
+        void destroy(U* p);
+    };
+
+    template <class T1, size_t Align1, class T2, size_t Align2>
+    bool operator==(const aligned_pool_allocator<T1, Align1>& lhs,
+                    const aligned_pool_allocator<T2, Align2>& rhs) noexcept;
+
+    template <class T1, size_t Align1, class T2, size_t Align2>
+    bool operator!=(const aligned_pool_allocator<T1, Align1>& lhs,
+                    const aligned_pool_allocator<T2, Align2>& rhs) noexcept;
+
+    /*******************************
+     * aligned_pool implementation *
+     *******************************/
+
+    namespace detail
+    {
+        /**
+         * Returns the pool of the thread, or a null pointer once it has
+         * been destroyed at the exit of the thread.
+         */
+        template <std::size_t A>
+        inline aligned_pool<A>* aligned_pool<A>::local()
+        {
+            static thread_local bool destroyed = false;
+            if (destroyed)
+            {
+                return nullptr;
+            }
+            static thread_local aligned_pool pool(&destroyed);
+            return &pool;
+        }
+
+        template <std::size_t A>
+        inline aligned_pool<A>::aligned_pool(bool* destroyed)
+            : m_destroyed(destroyed)
+        {
+            for (std::size_t c = 0; c < class_count; ++c)
+            {
+                m_heads[c] = nullptr;
+                m_counts[c] = 0;
+            }
+        }
+
+        template <std::size_t A>
+        inline aligned_pool<A>::~aligned_pool()
+        {
+            *m_destroyed = true;
+            for (std::size_t c = 0; c < class_count; ++c)
+            {
+                while (m_heads[c] != nullptr)
+                {
+                    free_block* next = m_heads[c]->next;
+                    aligned_free(m_heads[c]);
+                    m_heads[c] = next;
+                }
+            }
+        }
+
+        template <std::size_t A>
+        inline std::size_t aligned_pool<A>::size_class(std::size_t size) noexcept
+        {
+            std::size_t c = 0;
+            while ((std::size_t(1) << (c + min_shift)) < size)
+            {
+                ++c;
+            }
+            return c;
+        }
+
+        template <std::size_t A>
+        inline void* aligned_pool<A>::allocate(std::size_t size)
+        {
+            void* res;
+            if (size > (std::size_t(1) << max_shift))
+            {
+                res = aligned_malloc(size, block_alignment);
+            }
+            else
+            {
+                std::size_t c = size_class(size);
+                aligned_pool* pool = local();
+                if (pool != nullptr && pool->m_heads[c] != nullptr)
+                {
+                    free_block* b = pool->m_heads[c];
+                    pool->m_heads[c] = b->next;
+                    --pool->m_counts[c];
+                    return b;
+                }
+                res = aligned_malloc(std::size_t(1) << (c + min_shift), block_alignment);
+            }
+            if (res == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            return res;
+        }
+
+        template <std::size_t A>
+        inline void aligned_pool<A>::deallocate(void* p, std::size_t size) noexcept
+        {
+            if (p == nullptr)
+            {
+                return;
+            }
+            if (size <= (std::size_t(1) << max_shift))
+            {
+                std::size_t c = size_class(size);
+                aligned_pool* pool = local();
+                if (pool != nullptr && (pool->m_counts[c] + 1) << (c + min_shift) <= cache_size)
+                {
+                    free_block* b = static_cast<free_block*>(p);
+                    b->next = pool->m_heads[c];
+                    pool->m_heads[c] = b;
+                    ++pool->m_counts[c];
+                    return;
+                }
+            }
+            aligned_free(p);
+        }
+    }
+
+    /*****************************************
+     * aligned_pool_allocator implementation *
+     *****************************************/
+
+    /**
+     * Extended copy constructor.
+     */
+    template <class T, size_t A>
+    template <class U>
+    inline aligned_pool_allocator<T, A>::aligned_pool_allocator(const aligned_pool_allocator<U, A>&) noexcept
+    {
+    }
+
+    /**
+     * Allocates <tt>n * sizeof(T)</tt> bytes of uninitialized memory, aligned by \c A,
+     * from the cache of the thread if it holds a block of the same size class.
+     * @param n the number of objects to allocate storage for.
+     * @param hint unused parameter provided for standard compliance.
+     * @return a pointer to the first byte of a memory block suitably aligned and sufficient to
+     * hold an array of \c n objects of type \c T.
+     */
+    template <class T, size_t A>
+    inline auto
+    aligned_pool_allocator<T, A>::allocate(size_type n, const void*) -> pointer
+    {
+        return static_cast<pointer>(detail::aligned_pool<A>::allocate(sizeof(T) * n));
+    }
+
+    /**
+     * Returns the storage referenced by the pointer p to the cache of the
+     * calling thread, or frees it if the cache is full. The argument \c n
+     * must be equal to the first argument of the call to allocate() that
+     * originally produced \c p.
+     * @param p pointer obtained from allocate().
+     * @param n number of objects earlier passed to allocate().
+     */
+    template <class T, size_t A>
+    inline void aligned_pool_allocator<T, A>::deallocate(pointer p, size_type n)
+    {
+        detail::aligned_pool<A>::deallocate(p, sizeof(T) * n);
+    }
+
+    /**
+     * Returns the maximum theoretically possible value of \c n, for which the
+     * call allocate(n, 0) could succeed.
+     * @return the maximum supported allocated size.
+     */
+    template <class T, size_t A>
+    inline auto
+    aligned_pool_allocator<T, A>::max_size() const noexcept -> size_type
+    {
+        return size_type(-1) / sizeof(T);
+    }
+
+    /**
+     * Constructs an object of type \c T in allocated uninitialized memory
+     * pointed to by \c p, using placement-new.
+     * @param p pointer to allocated uninitialized memory.
+     * @param args the constructor arguments to use.
+     */
+    template <class T, size_t A>
+    template <class U, class... Args>
+    inline void aligned_pool_allocator<T, A>::construct(U* p, Args&&... args)
+    {
+        new ((void*)p) U(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Calls the destructor of the object pointed to by \c p.
+     * @param p pointer to the object that is going to be destroyed.
+     */
+    template <class T, size_t A>
+    template <class U>
+    inline void aligned_pool_allocator<T, A>::destroy(U* p)
+    {
+        p->~U();
+    }
+
+    /**
+     * Compares two pool allocators for equality. Since allocators are
+     * stateless, return \c true iff <tt>A1 == A2</tt>.
+     */
+    template <class T1, size_t A1, class T2, size_t A2>
+    inline bool operator==(const aligned_pool_allocator<T1, A1>& lhs,
+                           const aligned_pool_allocator<T2, A2>& rhs) noexcept
+    {
+        return lhs.alignment == rhs.alignment;
+    }
+
+    /**
+     * Compares two pool allocators for inequality. Since allocators are
+     * stateless, return \c true iff <tt>A1 != A2</tt>.
+     */
+    template <class T1, size_t A1, class T2, size_t A2>
+    inline bool operator!=(const aligned_pool_allocator<T1, A1>& lhs,
+                           const aligned_pool_allocator<T2, A2>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
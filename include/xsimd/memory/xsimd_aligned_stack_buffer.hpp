@@ -11,28 +11,48 @@
 #ifndef XSIMD_ALIGNED_STACK_BUFFER_HPP
 #define XSIMD_ALIGNED_STACK_BUFFER_HPP
 
+#include <cstddef>
+#include <new>
 #include <type_traits>
 
-#include "xsimd_aligned_allocator.hpp"
+#include "xsimd_aligned_arena.hpp"
 
 namespace xsimd
 {
-
-    template <class T, size_t Align>
+    /**
+     * @class aligned_stack_buffer
+     * @brief Aligned temporary array without heap allocation
+     *
+     * The aligned_stack_buffer class template holds n elements of type T
+     * aligned on Align bytes. They are stored inside the object when n
+     * does not exceed the capacity N, and in a thread-local arena
+     * otherwise. Elements are default-initialized, so that arithmetic
+     * elements are left uninitialized. Buffers which do not fit in their
+     * inline storage must be destroyed in the reverse order of their
+     * construction, as automatic variables are.
+     *
+     * @tparam T type of the elements.
+     * @tparam N number of elements of the inline storage.
+     * @tparam Align alignment in bytes.
+     */
+    template <class T, std::size_t N, std::size_t Align = arch::default_::alignment>
     class aligned_stack_buffer
     {
     public:
 
-        using allocator = aligned_allocator<T, Align>;
-        using value_type = typename allocator::value_type;
-        using pointer = typename allocator::pointer;
-        using const_pointer = typename allocator::const_pointer;
-        using reference = typename allocator::reference;
-        using const_reference = typename allocator::const_reference;
-        using size_type = typename allocator::size_type;
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = pointer;
+        using const_iterator = const_pointer;
+        using size_type = std::size_t;
 
-        static constexpr alignment = allocator::alignment;
+        static constexpr size_type alignment = Align < alignof(T) ? alignof(T) : Align;
+        static constexpr size_type inline_capacity = N;
 
+        aligned_stack_buffer();
         explicit aligned_stack_buffer(size_type n);
         ~aligned_stack_buffer();
 
@@ -43,97 +63,161 @@ namespace xsimd
         aligned_stack_buffer& operator=(aligned_stack_buffer&&) = delete;
 
         size_type size() const noexcept;
+        bool is_inline() const noexcept;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        reference operator[](size_type i);
+        const_reference operator[](size_type i) const;
 
-        reference operator[](size_type);
-        const_reference operator[](size_type) const;
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
 
         operator pointer() noexcept;
+        operator const_pointer() const noexcept;
 
     private:
 
+        alignas(alignment) unsigned char m_storage[(N == 0 ? 1 : N) * sizeof(T)];
         pointer m_ptr;
         size_type m_size;
-        bool m_heap_allocation;
+        aligned_arena::marker m_marker;
     };
 
+    namespace detail
+    {
+        // Arena of the buffers which do not fit in their inline storage
+        inline aligned_arena& stack_buffer_arena()
+        {
+            static thread_local aligned_arena arena;
+            return arena;
+        }
+    }
 
     /***************************************
      * aligned_stack_buffer implementation *
      ***************************************/
 
-    namespace detail
+    template <class T, std::size_t N, std::size_t A>
+    inline aligned_stack_buffer<T, N, A>::aligned_stack_buffer()
+        : aligned_stack_buffer(N)
     {
-        inline void* aligned_alloc_stack(size_t size, size_t alignment)
-        {
-            return reinterpret_cast<void*>(
-                       reinterpret_cast<size_t>(XSIMD_ALLOCA(size + alignment)) &
-                       ~(size_t(alignment - 1))) +
-                alignment;
-        }
     }
 
-    template <class T, size_t A>
-    inline aligned_stack_buffer<T, A>::aligned_stack_buffer(size_type n)
+    /**
+     * Builds a buffer of n elements, in the inline storage if n does not
+     * exceed N.
+     */
+    template <class T, std::size_t N, std::size_t A>
+    inline aligned_stack_buffer<T, N, A>::aligned_stack_buffer(size_type n)
         : m_size(n)
     {
-#ifdef XSIMD_ALLOCA
-        if (sizeof(T) * n <= XSIMD_STACK_ALLOCATION_LIMIT)
+        if (n <= N)
         {
-            m_ptr = reinterpret_cast<pointer>(
-                (reinterpret_cast<size_t>(XSIMD_ALLOCA(n + A)) &
-                 ~(size_t(A - 1))) +
-                A);
-            m_heap_allocation = false;
+            m_ptr = reinterpret_cast<pointer>(m_storage);
         }
         else
         {
-            m_ptr = reinterpret_cast<pointer>(aligned_malloc(n, A));
-            m_heap_allocation = true;
+            aligned_arena& arena = detail::stack_buffer_arena();
+            m_marker = arena.mark();
+            m_ptr = static_cast<pointer>(arena.allocate(n * sizeof(T), alignment));
+        }
+        for (size_type i = 0; i < n; ++i)
+        {
+            ::new (static_cast<void*>(m_ptr + i)) T;
         }
-#else
-        m_ptr = reinterpret_cast<pointer>(aligned_malloc(n, A));
-        m_heap_allocation = true;
-#endif
     }
 
-    template <class T, size_t A>
-    inline aligned_stack_buffer<T, A>::~aligned_stack_buffer()
+    template <class T, std::size_t N, std::size_t A>
+    inline aligned_stack_buffer<T, N, A>::~aligned_stack_buffer()
     {
-        if (!std::is_trivially_destructible<T>::value && m_ptr != 0)
+        if (!std::is_trivially_destructible<T>::value)
         {
             for (auto p = m_ptr; p < m_ptr + m_size; ++p)
             {
                 p->~T();
             }
         }
-        if (m_heap_allocation)
+        if (!is_inline())
         {
-            aligned_free(m_ptr);
+            detail::stack_buffer_arena().rewind(m_marker);
         }
     }
 
-    template <class T, size_t A>
-    inline auto aligned_stack_buffer<T, A>::size() const noexcept -> size_type
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::size() const noexcept -> size_type
     {
         return m_size;
     }
 
-    template <class T, size_t A>
-    inline auto
-        aligned_stack_buffer<T, A>::operator[](size_type i) -> reference
+    /**
+     * Returns true if the elements are stored inside the buffer.
+     */
+    template <class T, std::size_t N, std::size_t A>
+    inline bool aligned_stack_buffer<T, N, A>::is_inline() const noexcept
+    {
+        return m_size <= N;
+    }
+
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::data() noexcept -> pointer
+    {
+        return m_ptr;
+    }
+
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::data() const noexcept -> const_pointer
+    {
+        return m_ptr;
+    }
+
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::operator[](size_type i) -> reference
     {
         return m_ptr[i];
     }
 
-    template <class T, size_t A>
-    inline auto
-        aligned_stack_buffer<T, A>::operator[](size_type i) const -> const_reference
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::operator[](size_type i) const -> const_reference
     {
         return m_ptr[i];
     }
 
-    template <class T, size_t A>
-    inline aligned_stack_buffer<T, A>::operator pointer() noexcept
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::begin() noexcept -> iterator
+    {
+        return m_ptr;
+    }
+
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::end() noexcept -> iterator
+    {
+        return m_ptr + m_size;
+    }
+
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::begin() const noexcept -> const_iterator
+    {
+        return m_ptr;
+    }
+
+    template <class T, std::size_t N, std::size_t A>
+    inline auto aligned_stack_buffer<T, N, A>::end() const noexcept -> const_iterator
+    {
+        return m_ptr + m_size;
+    }
+
+    template <class T, std::size_t N, std::size_t A>
+    inline aligned_stack_buffer<T, N, A>::operator pointer() noexcept
+    {
+        return m_ptr;
+    }
+
+    template <class T, std::size_t N, std::size_t A>
+    inline aligned_stack_buffer<T, N, A>::operator const_pointer() const noexcept
     {
         return m_ptr;
     }
@@ -11,8 +11,12 @@
 #ifndef XSIMD_ALIGNMENT_HPP
 #define XSIMD_ALIGNMENT_HPP
 
+#include <cstddef>
+#include <type_traits>
+
 #include "../config/xsimd_align.hpp"
 #include "xsimd_aligned_allocator.hpp"
+#include "xsimd_aligned_pool_allocator.hpp"
 
 namespace xsimd
 {
@@ -42,10 +46,33 @@ namespace xsimd
         using type = unaligned_mode;
     };
 
-    template <class T>
-    struct allocator_alignment<aligned_allocator<T>>
+    namespace detail
+    {
+        // Memory aligned on at least the alignment of the default
+        // architecture can be loaded and stored with the aligned functions
+        template <std::size_t Align>
+        struct allocator_alignment_mode
+        {
+            using type = typename std::conditional<Align >= arch::default_::alignment, aligned_mode, unaligned_mode>::type;
+        };
+    }
+
+    template <class T, std::size_t Align>
+    struct allocator_alignment<aligned_allocator<T, Align>>
+    {
+        using type = typename detail::allocator_alignment_mode<Align>::type;
+    };
+
+    template <class T, std::size_t Align>
+    struct allocator_alignment<aligned_pool_allocator<T, Align>>
+    {
+        using type = typename detail::allocator_alignment_mode<Align>::type;
+    };
+
+    template <class T, std::size_t Align>
+    struct allocator_alignment<huge_page_allocator<T, Align>>
     {
-        using type = aligned_mode;
+        using type = typename detail::allocator_alignment_mode<Align>::type;
     };
 
     template <class A>
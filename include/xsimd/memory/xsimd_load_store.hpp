@@ -183,6 +183,29 @@ namespace xsimd
     template <class T1, class T2>
     void store_unaligned(T1* real_dst, T1* imag_dst, const simd_type<T2>& src);
 
+    /**
+     * @ingroup data_transfer
+     * Stores the batch \c src into the memory array pointed to by \c dst
+     * with a non-temporal store, which writes around the caches and does
+     * not read the destination line first. \c dst is required to be aligned.
+     * Non-temporal stores are weakly ordered: call stream_fence before the
+     * array is read by another thread.
+     * @param dst the pointer to the memory array.
+     * @param src the batch to store.
+     */
+    template <class T, std::size_t N>
+    void store_stream(T* dst, const batch<T, N>& src);
+
+    template <class T>
+    void store_stream(T* dst, const T& src);
+
+    /**
+     * @ingroup data_transfer
+     * Orders the non-temporal stores issued by store_stream before the
+     * stores which follow it.
+     */
+    void stream_fence();
+
     // Load / store generic functions
 
     /**
@@ -341,9 +364,43 @@ namespace xsimd
 
     // Prefetch
 
+    /**
+     * @ingroup data_transfer
+     * Cache levels and intent of a software prefetch: \c t0 fetches the line
+     * into all the levels of cache, \c t1 into the second level and above,
+     * \c t2 into the last level, and \c nta close to the processor while
+     * minimizing the pollution of the caches. The write hints fetch the line
+     * in anticipation of a store.
+     */
+    enum class prefetch_hint
+    {
+        t0,
+        t1,
+        t2,
+        nta,
+        write_t0,
+        write_t1
+    };
+
+    /**
+     * @ingroup data_transfer
+     * Fetches the cache line holding \c address into all the levels of cache.
+     * A prefetch never faults, and is a no-op on the architectures without
+     * prefetch instruction.
+     * @param address the address to prefetch.
+     */
     template <class T>
     void prefetch(const T* address);
 
+    /**
+     * @ingroup data_transfer
+     * Fetches the cache line holding \c address according to \c Hint.
+     * @tparam Hint the cache levels and intent of the prefetch.
+     * @param address the address to prefetch.
+     */
+    template <prefetch_hint Hint, class T>
+    void prefetch(const T* address);
+
 
     /***************************
      * detail implementation
@@ -351,6 +408,86 @@ namespace xsimd
 
     namespace detail
     {
+        // Non-temporal stores of the batches which fill a register; the
+        // other batches use regular aligned stores.
+        template <class T, class V>
+        inline void stream_store(T* dst, const V& src)
+        {
+            src.store_aligned(dst);
+        }
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE2_VERSION
+        inline void stream_store(float* dst, const batch<float, 4>& src)
+        {
+            _mm_stream_ps(dst, src);
+        }
+
+        inline void stream_store(double* dst, const batch<double, 2>& src)
+        {
+            _mm_stream_pd(dst, src);
+        }
+
+        template <class T>
+        inline typename std::enable_if<std::is_integral<T>::value, void>::type
+        stream_store(T* dst, const batch<T, 16 / sizeof(T)>& src)
+        {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst), src);
+        }
+#endif
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX_VERSION
+        inline void stream_store(float* dst, const batch<float, 8>& src)
+        {
+            _mm256_stream_ps(dst, src);
+        }
+
+        inline void stream_store(double* dst, const batch<double, 4>& src)
+        {
+            _mm256_stream_pd(dst, src);
+        }
+
+        template <class T>
+        inline typename std::enable_if<std::is_integral<T>::value, void>::type
+        stream_store(T* dst, const batch<T, 32 / sizeof(T)>& src)
+        {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), src);
+        }
+#endif
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX512_VERSION
+        inline void stream_store(float* dst, const batch<float, 16>& src)
+        {
+            _mm512_stream_ps(dst, src);
+        }
+
+        inline void stream_store(double* dst, const batch<double, 8>& src)
+        {
+            _mm512_stream_pd(dst, src);
+        }
+
+        template <class T>
+        inline typename std::enable_if<std::is_integral<T>::value, void>::type
+        stream_store(T* dst, const batch<T, 64 / sizeof(T)>& src)
+        {
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(dst), src);
+        }
+#endif
+
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+        // stnp of the two halves of the register
+        inline void stream_store(float* dst, const batch<float, 4>& src)
+        {
+            float64x2_t v = vreinterpretq_f64_f32(src);
+            __asm__ volatile("stnp %d1, %d2, [%0]" : : "r"(dst), "w"(vget_low_f64(v)), "w"(vget_high_f64(v)) : "memory");
+        }
+
+        inline void stream_store(double* dst, const batch<double, 2>& src)
+        {
+            float64x2_t v = src;
+            __asm__ volatile("stnp %d1, %d2, [%0]" : : "r"(dst), "w"(vget_low_f64(v)), "w"(vget_high_f64(v)) : "memory");
+        }
+#endif
+
         // Common implementation of SIMD functions for types supported
         // by vectorization.
         template <class T, class V>
@@ -558,6 +695,27 @@ namespace xsimd
         detail::simd_function_invoker<T1, simd_bool_type<T2>>::store_unaligned(dst, src);
     }
 
+    template <class T, std::size_t N>
+    inline void store_stream(T* dst, const batch<T, N>& src)
+    {
+        detail::stream_store(dst, src);
+    }
+
+    template <class T>
+    inline void store_stream(T* dst, const T& src)
+    {
+        *dst = src;
+    }
+
+    inline void stream_fence()
+    {
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE_VERSION
+        _mm_sfence();
+#elif XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+        __asm__ volatile("dmb ishst" : : : "memory");
+#endif
+    }
+
     template <class T1, class T2>
     inline void store_aligned(T1* real_dst, T1* imag_dst, const simd_type<T2>& src)
     {
@@ -662,39 +820,42 @@ namespace xsimd
      * Prefetch implementation
      *****************************/
 
-    template <class T>
-    inline void prefetch(const T* /*address*/)
-    {
-    }
-
-#if XSIMD_X86_INSTR_SET > XSIMD_VERSION_NUMBER_NOT_AVAILABLE
-
-    template <>
-    inline void prefetch<int32_t>(const int32_t* address)
-    {
-        _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
-    }
-
-    template <>
-    inline void prefetch<int64_t>(const int64_t* address)
+    namespace detail
     {
-        _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
+        template <prefetch_hint Hint>
+        inline void prefetch_line(const char* address)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            constexpr int rw = Hint == prefetch_hint::write_t0 || Hint == prefetch_hint::write_t1 ? 1 : 0;
+            constexpr int locality = Hint == prefetch_hint::t0 || Hint == prefetch_hint::write_t0 ? 3
+                                   : Hint == prefetch_hint::t1 || Hint == prefetch_hint::write_t1 ? 2
+                                   : Hint == prefetch_hint::t2 ? 1
+                                                               : 0;
+            __builtin_prefetch(address, rw, locality);
+#elif XSIMD_X86_INSTR_SET > XSIMD_VERSION_NUMBER_NOT_AVAILABLE
+            // without write prefetch, the write hints fall back to a read
+            // into the same levels
+            _mm_prefetch(address, Hint == prefetch_hint::t1 || Hint == prefetch_hint::write_t1 ? _MM_HINT_T1
+                                : Hint == prefetch_hint::t2 ? _MM_HINT_T2
+                                : Hint == prefetch_hint::nta ? _MM_HINT_NTA
+                                                             : _MM_HINT_T0);
+#else
+            (void)address;
+#endif
+        }
     }
 
-    template <>
-    inline void prefetch<float>(const float* address)
+    template <class T>
+    inline void prefetch(const T* address)
     {
-        _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
+        detail::prefetch_line<prefetch_hint::t0>(reinterpret_cast<const char*>(address));
     }
 
-    template <>
-    inline void prefetch<double>(const double* address)
+    template <prefetch_hint Hint, class T>
+    inline void prefetch(const T* address)
     {
-        _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0);
+        detail::prefetch_line<Hint>(reinterpret_cast<const char*>(address));
     }
-
-#endif
-
 }
 
 #endif
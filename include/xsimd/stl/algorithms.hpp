@@ -11,192 +11,1476 @@
 #ifndef XSIMD_ALGORITHMS_HPP
 #define XSIMD_ALGORITHMS_HPP
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../memory/xsimd_aligned_allocator.hpp"
+#include "../memory/xsimd_aligned_stack_buffer.hpp"
 #include "../memory/xsimd_load_store.hpp"
 
 namespace xsimd
 {
+    namespace detail
+    {
+        // Streams of a multi-stream transform are loaded or stored with
+        // aligned accesses when their batches are aligned on the batches
+        // of the loop, which start at index offset.
+        template <class T>
+        inline bool is_stream_aligned(const T* ptr, std::size_t offset, std::size_t simd_size)
+        {
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(ptr);
+            return address % sizeof(T) == 0 && (address / sizeof(T) + offset) % simd_size == 0;
+        }
+
+        template <class T>
+        inline typename simd_traits<T>::type load_transform_stream(const T* ptr, bool aligned)
+        {
+            typename simd_traits<T>::type res;
+            if (aligned)
+            {
+                xsimd::load_aligned(ptr, res);
+            }
+            else
+            {
+                xsimd::load_unaligned(ptr, res);
+            }
+            return res;
+        }
+
+        template <class T, class V>
+        inline void store_transform_stream(T* ptr, const V& value, bool aligned)
+        {
+            if (aligned)
+            {
+                xsimd::store_aligned(ptr, value);
+            }
+            else
+            {
+                xsimd::store_unaligned(ptr, value);
+            }
+        }
+
+        // End of the iterations in [begin, end) whose prefetched element,
+        // ahead elements further, is still in the range
+        inline std::size_t prefetch_end(std::size_t begin, std::size_t end, std::size_t ahead)
+        {
+            return ahead != 0 && end > begin + ahead ? end - ahead : begin;
+        }
+
+        // Element J of the result of the function of a transform, which
+        // returns a tuple when it has several outputs
+        template <std::size_t J, class R>
+        inline const R& transform_result(const R& res, std::true_type)
+        {
+            return res;
+        }
+
+        template <std::size_t J, class R>
+        inline auto transform_result(const R& res, std::false_type) -> decltype(std::get<J>(res))
+        {
+            return std::get<J>(res);
+        }
+
+        template <class... In, class... Out, class F, std::size_t... I, std::size_t... J>
+        inline void transform_streams(const std::tuple<In*...>& in, const std::tuple<Out*...>& out, std::size_t size, F& f,
+                                      std::size_t ahead, detail::index_sequence<I...>, detail::index_sequence<J...>)
+        {
+            using first_type = typename std::tuple_element<0, std::tuple<typename std::remove_const<In>::type...>>::type;
+            using single_output = std::integral_constant<bool, sizeof...(Out) == 1>;
+            using expander = int[];
+            constexpr std::size_t simd_size = simd_traits<first_type>::size;
+            static_assert(all_true<(simd_traits<typename std::remove_const<In>::type>::size == simd_size)...>::value,
+                          "the batches of the inputs must have the same size");
+
+            // the loop is aligned on the first output
+            std::size_t align_begin = xsimd::get_alignment_offset(std::get<0>(out), size, simd_size);
+            std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+            const bool in_aligned[] = { is_stream_aligned(std::get<I>(in), align_begin, simd_size)... };
+            const bool out_aligned[] = { is_stream_aligned(std::get<J>(out), align_begin, simd_size)... };
+            (void)in_aligned;
+
+            for (std::size_t i = 0; i < align_begin; ++i)
+            {
+                const auto res = f(std::get<I>(in)[i]...);
+                (void)expander{ (std::get<J>(out)[i] = transform_result<J>(res, single_output()), 0)... };
+            }
+            // the inputs are prefetched ahead elements further, if ahead is
+            // not zero
+            std::size_t i = align_begin;
+            for (std::size_t last = prefetch_end(align_begin, align_end, ahead); i < last; i += simd_size)
+            {
+                (void)expander{ (xsimd::prefetch(std::get<I>(in) + i + ahead), 0)... };
+                const auto res = f(load_transform_stream(std::get<I>(in) + i, in_aligned[I])...);
+                (void)expander{ (store_transform_stream(std::get<J>(out) + i, transform_result<J>(res, single_output()), out_aligned[J]), 0)... };
+            }
+            for (; i < align_end; i += simd_size)
+            {
+                const auto res = f(load_transform_stream(std::get<I>(in) + i, in_aligned[I])...);
+                (void)expander{ (store_transform_stream(std::get<J>(out) + i, transform_result<J>(res, single_output()), out_aligned[J]), 0)... };
+            }
+            for (std::size_t i = align_end; i < size; ++i)
+            {
+                const auto res = f(std::get<I>(in)[i]...);
+                (void)expander{ (std::get<J>(out)[i] = transform_result<J>(res, single_output()), 0)... };
+            }
+        }
+
+        template <class... It, std::size_t... I>
+        inline auto stream_pointers(const std::tuple<It...>& it, detail::index_sequence<I...>)
+            -> std::tuple<decltype(&(*std::declval<It>()))...>
+        {
+            return std::tuple<decltype(&(*std::declval<It>()))...>(&(*std::get<I>(it))...);
+        }
+
+        template <class... It>
+        inline auto stream_pointers(const std::tuple<It...>& it) -> std::tuple<decltype(&(*std::declval<It>()))...>
+        {
+            return stream_pointers(it, detail::index_sequence_for<It...>());
+        }
+    }
+
+    /**
+     * Applies f to the elements of the range [first, last) and of the
+     * ranges starting at the iterators of inputs, and stores the results
+     * into the ranges starting at the iterators of outputs. f takes one
+     * argument per input; with several outputs, it returns a tuple of one
+     * result per output. The loop is aligned on the first output, and
+     * each stream uses aligned accesses when its batches are aligned on
+     * the batches of the loop.
+     */
+    template <class I1, class I2, class... In, class... Out, class F>
+    void transform(I1 first, I2 last, std::tuple<In...> inputs, std::tuple<Out...> outputs, F&& f)
+    {
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        auto in = std::tuple_cat(std::make_tuple(&(*first)), detail::stream_pointers(inputs));
+        auto out = detail::stream_pointers(outputs);
+        detail::transform_streams(in, out, size, f, 0,
+                                  detail::make_index_sequence<sizeof...(In) + 1>(),
+                                  detail::index_sequence_for<Out...>());
+    }
+
     template <class I1, class I2, class O1, class UF>
     void transform(I1 first, I2 last, O1 out_first, UF&& f)
+    {
+        xsimd::transform(first, last, std::make_tuple(), std::make_tuple(out_first), std::forward<UF>(f));
+    }
+
+    template <class I1, class I2, class I3, class O1, class UF>
+    void transform(I1 first_1, I2 last_1, I3 first_2, O1 out_first, UF&& f)
+    {
+        xsimd::transform(first_1, last_1, std::make_tuple(first_2), std::make_tuple(out_first), std::forward<UF>(f));
+    }
+
+    /**
+     * Option of transform which writes the output with non-temporal
+     * stores when it holds at least threshold bytes, so that a large
+     * output which is not read again soon neither evicts the working set
+     * from the caches nor reads the destination lines before writing them.
+     */
+    struct stream_mode
+    {
+        explicit stream_mode(std::size_t threshold = XSIMD_STREAM_STORE_THRESHOLD)
+            : threshold(threshold)
+        {
+        }
+
+        std::size_t threshold;
+    };
+
+    template <class I1, class I2, class O1, class UF>
+    void transform(I1 first, I2 last, O1 out_first, UF&& f, stream_mode mode)
     {
         using value_type = typename std::decay<decltype(*first)>::type;
+        using out_type = typename std::decay<decltype(*out_first)>::type;
         using traits = simd_traits<value_type>;
         using batch_type = typename traits::type;
 
         std::size_t size = static_cast<std::size_t>(std::distance(first, last));
         std::size_t simd_size = traits::size;
 
-        const auto* ptr_begin = &(*first);
+        if (size * sizeof(out_type) < mode.threshold)
+        {
+            transform(first, last, out_first, std::forward<UF>(f));
+            return;
+        }
+
+        // the loop is aligned on the output, which is required by the
+        // non-temporal stores
         auto* ptr_out = &(*out_first);
+        std::size_t align_begin = xsimd::get_alignment_offset(ptr_out, size, simd_size);
+        std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+
+        for (std::size_t i = 0; i < align_begin; ++i)
+        {
+            out_first[i] = f(first[i]);
+        }
+
+        batch_type batch;
+        for (std::size_t i = align_begin; i < align_end; i += simd_size)
+        {
+            xsimd::load_unaligned(&first[i], batch);
+            xsimd::store_stream(&out_first[i], f(batch));
+        }
+        xsimd::stream_fence();
+
+        for (std::size_t i = align_end; i < size; ++i)
+        {
+            out_first[i] = f(first[i]);
+        }
+    }
+
+    template <class I1, class I2, class I3, class O1, class UF>
+    void transform(I1 first_1, I2 last_1, I3 first_2, O1 out_first, UF&& f, stream_mode mode)
+    {
+        using value_type = typename std::decay<decltype(*first_1)>::type;
+        using out_type = typename std::decay<decltype(*out_first)>::type;
+        using traits = simd_traits<value_type>;
+        using batch_type = typename traits::type;
 
-        std::size_t align_begin = xsimd::get_alignment_offset(ptr_begin, size, simd_size);
-        std::size_t out_align = xsimd::get_alignment_offset(ptr_out, size, simd_size);
+        std::size_t size = static_cast<std::size_t>(std::distance(first_1, last_1));
+        std::size_t simd_size = traits::size;
+
+        if (size * sizeof(out_type) < mode.threshold)
+        {
+            transform(first_1, last_1, first_2, out_first, std::forward<UF>(f));
+            return;
+        }
+
+        auto* ptr_out = &(*out_first);
+        std::size_t align_begin = xsimd::get_alignment_offset(ptr_out, size, simd_size);
         std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
 
-        if (align_begin == out_align)
+        for (std::size_t i = 0; i < align_begin; ++i)
+        {
+            out_first[i] = f(first_1[i], first_2[i]);
+        }
+
+        batch_type batch_1, batch_2;
+        for (std::size_t i = align_begin; i < align_end; i += simd_size)
+        {
+            xsimd::load_unaligned(&first_1[i], batch_1);
+            xsimd::load_unaligned(&first_2[i], batch_2);
+            xsimd::store_stream(&out_first[i], f(batch_1, batch_2));
+        }
+        xsimd::stream_fence();
+
+        for (std::size_t i = align_end; i < size; ++i)
+        {
+            out_first[i] = f(first_1[i], first_2[i]);
+        }
+    }
+
+    /**
+     * Option of transform and reduce which prefetches the inputs distance
+     * bytes ahead of the loads, rounded up to a batch, so that the memory
+     * latency of strided or irregular access patterns is hidden behind the
+     * computation. calibrated returns the distance which performs best on
+     * the running machine.
+     */
+    struct prefetch_mode
+    {
+        explicit prefetch_mode(std::size_t distance = XSIMD_PREFETCH_DISTANCE)
+            : distance(distance)
+        {
+        }
+
+        static prefetch_mode calibrated();
+
+        std::size_t distance;
+    };
+
+    namespace detail
+    {
+        // Distance of a prefetch_mode in elements of type T, rounded up
+        // to a multiple of simd_size
+        template <class T>
+        inline std::size_t prefetch_elements(const prefetch_mode& mode, std::size_t simd_size)
+        {
+            std::size_t n = (mode.distance + sizeof(T) - 1) / sizeof(T);
+            return (n + simd_size - 1) & ~(simd_size - 1);
+        }
+    }
+
+    template <class I1, class I2, class O1, class UF>
+    void transform(I1 first, I2 last, O1 out_first, UF&& f, prefetch_mode mode)
+    {
+        using value_type = typename std::decay<decltype(*first)>::type;
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        std::size_t ahead = detail::prefetch_elements<value_type>(mode, simd_traits<value_type>::size);
+        auto in = std::make_tuple(&(*first));
+        auto out = std::make_tuple(&(*out_first));
+        detail::transform_streams(in, out, size, f, ahead, detail::make_index_sequence<1>(), detail::make_index_sequence<1>());
+    }
+
+    template <class I1, class I2, class I3, class O1, class UF>
+    void transform(I1 first_1, I2 last_1, I3 first_2, O1 out_first, UF&& f, prefetch_mode mode)
+    {
+        using value_type = typename std::decay<decltype(*first_1)>::type;
+        std::size_t size = static_cast<std::size_t>(std::distance(first_1, last_1));
+        std::size_t ahead = detail::prefetch_elements<value_type>(mode, simd_traits<value_type>::size);
+        auto in = std::make_tuple(&(*first_1), &(*first_2));
+        auto out = std::make_tuple(&(*out_first));
+        detail::transform_streams(in, out, size, f, ahead, detail::make_index_sequence<2>(), detail::make_index_sequence<1>());
+    }
+
+    // TODO: Remove this once we drop C++11 support
+    namespace detail
+    {
+        struct plus
+        {
+            template <class X, class Y>
+            auto operator()(X&& x, Y&& y) -> decltype(x + y) { return x + y; }
+        };
+
+        struct multiplies
+        {
+            template <class X, class Y>
+            auto operator()(X&& x, Y&& y) -> decltype(x * y) { return x * y; }
+        };
+    }
+
+    namespace detail
+    {
+        template <class Iterator1, class Iterator2, class Init, class BinaryFunction>
+        Init reduce_prefetched(Iterator1 first, Iterator2 last, Init init, BinaryFunction& binfun, const prefetch_mode& mode)
         {
+            using value_type = typename std::decay<decltype(*first)>::type;
+            using traits = simd_traits<value_type>;
+            using batch_type = typename traits::type;
+
+            std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+            constexpr std::size_t simd_size = traits::size;
+
+            if(size < simd_size)
+            {
+                while(first != last)
+                {
+                    init = binfun(init, *first++);
+                }
+                return init;
+            }
+
+            const auto* const ptr_begin = &(*first);
+            const std::size_t ahead = prefetch_elements<value_type>(mode, simd_size);
+
+            std::size_t align_begin = xsimd::get_alignment_offset(ptr_begin, size, simd_size);
+            std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+
+            // reduce initial unaligned part
             for (std::size_t i = 0; i < align_begin; ++i)
             {
-                out_first[i] = f(first[i]);
+                init = binfun(init, first[i]);
             }
 
-            batch_type batch;
-            for (std::size_t i = align_begin; i < align_end; i += simd_size)
+            // reduce aligned part
+            batch_type batch_init, batch;
+            auto ptr = ptr_begin + align_begin;
+            xsimd::load_aligned(ptr, batch_init);
+            ptr += simd_size;
+            for (auto const end = ptr_begin + prefetch_end(align_begin + simd_size, align_end, ahead); ptr < end; ptr += simd_size)
             {
-                xsimd::load_aligned(&first[i], batch);
-                xsimd::store_aligned(&out_first[i], f(batch));
+                xsimd::prefetch(ptr + ahead);
+                xsimd::load_aligned(ptr, batch);
+                batch_init = binfun(batch_init, batch);
             }
+            for (auto const end = ptr_begin + align_end; ptr < end; ptr += simd_size)
+            {
+                xsimd::load_aligned(ptr, batch);
+                batch_init = binfun(batch_init, batch);
+            }
+
+            // reduce across batch
+            aligned_stack_buffer<value_type, simd_size, alignof(batch_type)> arr;
+            xsimd::store_aligned(arr.data(), batch_init);
+            for (auto x : arr) init = binfun(init, x);
 
+            // reduce final unaligned part
             for (std::size_t i = align_end; i < size; ++i)
             {
-                out_first[i] = f(first[i]);
+                init = binfun(init, first[i]);
             }
+
+            return init;
         }
-        else
+    }
+
+    template <class Iterator1, class Iterator2, class Init, class BinaryFunction = detail::plus>
+    Init reduce(Iterator1 first, Iterator2 last, Init init, BinaryFunction&& binfun = detail::plus{})
+    {
+        return detail::reduce_prefetched(first, last, init, binfun, prefetch_mode(0));
+    }
+
+    /**
+     * Reduces the range like reduce, prefetching the input as specified
+     * by mode.
+     */
+    template <class Iterator1, class Iterator2, class Init, class BinaryFunction>
+    Init reduce(Iterator1 first, Iterator2 last, Init init, BinaryFunction&& binfun, prefetch_mode mode)
+    {
+        return detail::reduce_prefetched(first, last, init, binfun, mode);
+    }
+
+    namespace detail
+    {
+        // Times the reduction of an array larger than the last level of
+        // cache with increasing prefetch distances, and returns the
+        // fastest distance.
+        inline std::size_t calibrate_prefetch_distance()
         {
-            for (std::size_t i = 0; i < align_begin; ++i)
+            using clock_type = std::chrono::steady_clock;
+            const std::size_t size = std::size_t(1) << 23;
+            const std::size_t distances[] = { 0, 128, 256, 512, 1024, 2048, 4096 };
+            std::vector<float, aligned_allocator<float>> buffer(size, 1.f);
+            volatile float sink = 0.f;
+
+            std::size_t best_distance = 0;
+            clock_type::duration best_time = clock_type::duration::max();
+            for (std::size_t distance : distances)
+            {
+                clock_type::duration time = clock_type::duration::max();
+                for (int repeat = 0; repeat < 3; ++repeat)
+                {
+                    clock_type::time_point start = clock_type::now();
+                    sink = sink + xsimd::reduce(buffer.cbegin(), buffer.cend(), 0.f, plus{}, prefetch_mode(distance));
+                    time = std::min(time, clock_type::now() - start);
+                }
+                if (time < best_time)
+                {
+                    best_time = time;
+                    best_distance = distance;
+                }
+            }
+            return best_distance;
+        }
+    }
+
+    /**
+     * Returns the mode whose distance performs best on the running machine,
+     * measured once by the first call, which takes a fraction of a second.
+     */
+    inline prefetch_mode prefetch_mode::calibrated()
+    {
+        static const std::size_t distance = detail::calibrate_prefetch_distance();
+        return prefetch_mode(distance);
+    }
+
+    /********************
+     * transform_reduce *
+     ********************/
+
+    namespace detail
+    {
+        // Batch of the count < simd_size elements starting at ptr, whose
+        // lanes past count repeat the first element, so that they stay in
+        // the domain of the transformation
+        template <class T>
+        inline typename simd_traits<T>::type load_partial(const T* ptr, std::size_t count)
+        {
+            using batch_type = typename simd_traits<T>::type;
+            aligned_stack_buffer<T, simd_traits<T>::size, alignof(batch_type)> buffer;
+            std::fill(buffer.begin(), buffer.end(), ptr[0]);
+            std::copy(ptr, ptr + count, buffer.begin());
+            batch_type res;
+            xsimd::load_aligned(buffer.data(), res);
+            return res;
+        }
+
+        // Reduces the first count lanes of x into init
+        template <class Init, class B, class R>
+        inline Init reduce_lanes(Init init, const B& x, std::size_t count, R& reduce_op)
+        {
+            using value_type = typename simd_batch_traits<B>::value_type;
+            aligned_stack_buffer<value_type, simd_batch_traits<B>::size, alignof(B)> buffer;
+            xsimd::store_aligned(buffer.data(), x);
+            for (std::size_t i = 0; i < count; ++i)
             {
-                out_first[i] = f(first[i]);
+                init = reduce_op(init, buffer[i]);
             }
+            return init;
+        }
+
+        // Reduces the batches of [first, last) into four accumulators, so
+        // that the latency of reduce_op is hidden
+        template <class Init, class R, class F, class... T, std::size_t... I>
+        inline Init transform_reduce_batches(const std::tuple<const T*...>& in, std::size_t first, std::size_t last,
+                                             std::size_t simd_size, Init init, R& reduce_op, F& transform_op,
+                                             const bool* aligned, detail::index_sequence<I...>)
+        {
+            using batch_type = typename std::decay<decltype(transform_op(load_transform_stream(std::get<I>(in), aligned[I])...))>::type;
 
-            batch_type batch;
-            for (std::size_t i = align_begin; i < align_end; i += simd_size)
+            std::size_t i = first;
+            batch_type acc_0 = transform_op(load_transform_stream(std::get<I>(in) + i, aligned[I])...);
+            i += simd_size;
+            if (i + 3 * simd_size <= last)
+            {
+                batch_type acc_1 = transform_op(load_transform_stream(std::get<I>(in) + i, aligned[I])...);
+                batch_type acc_2 = transform_op(load_transform_stream(std::get<I>(in) + i + simd_size, aligned[I])...);
+                batch_type acc_3 = transform_op(load_transform_stream(std::get<I>(in) + i + 2 * simd_size, aligned[I])...);
+                i += 3 * simd_size;
+                for (; i + 4 * simd_size <= last; i += 4 * simd_size)
+                {
+                    acc_0 = reduce_op(acc_0, transform_op(load_transform_stream(std::get<I>(in) + i, aligned[I])...));
+                    acc_1 = reduce_op(acc_1, transform_op(load_transform_stream(std::get<I>(in) + i + simd_size, aligned[I])...));
+                    acc_2 = reduce_op(acc_2, transform_op(load_transform_stream(std::get<I>(in) + i + 2 * simd_size, aligned[I])...));
+                    acc_3 = reduce_op(acc_3, transform_op(load_transform_stream(std::get<I>(in) + i + 3 * simd_size, aligned[I])...));
+                }
+                acc_0 = reduce_op(reduce_op(acc_0, acc_1), reduce_op(acc_2, acc_3));
+            }
+            for (; i < last; i += simd_size)
             {
-                xsimd::load_aligned(&first[i], batch);
-                xsimd::store_unaligned(&out_first[i], f(batch));
+                acc_0 = reduce_op(acc_0, transform_op(load_transform_stream(std::get<I>(in) + i, aligned[I])...));
             }
+            return reduce_lanes(init, acc_0, simd_size, reduce_op);
+        }
 
-            for (std::size_t i = align_end; i < size; ++i)
+        // The loop is aligned on the first input; the partial batches
+        // before and after it are transformed as batches too, and only
+        // their valid lanes are reduced.
+        template <class Init, class R, class F, class... T, std::size_t... I>
+        inline Init transform_reduce_streams(const std::tuple<const T*...>& in, std::size_t size, Init init,
+                                             R& reduce_op, F& transform_op, detail::index_sequence<I...> is)
+        {
+            using first_type = typename std::tuple_element<0, std::tuple<T...>>::type;
+            constexpr std::size_t simd_size = simd_traits<first_type>::size;
+            static_assert(all_true<(simd_traits<T>::size == simd_size)...>::value,
+                          "the batches of the inputs must have the same size");
+
+            std::size_t align_begin = xsimd::get_alignment_offset(std::get<0>(in), size, simd_size);
+            std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+
+            for (std::size_t i = 0; i < align_begin; i += simd_size)
+            {
+                std::size_t count = std::min(simd_size, align_begin - i);
+                init = reduce_lanes(init, transform_op(load_partial(std::get<I>(in) + i, count)...), count, reduce_op);
+            }
+            if (align_begin < align_end)
             {
-                out_first[i] = f(first[i]);
+                const bool aligned[] = { is_stream_aligned(std::get<I>(in), align_begin, simd_size)... };
+                init = transform_reduce_batches(in, align_begin, align_end, simd_size, init,
+                                                reduce_op, transform_op, aligned, is);
             }
+            for (std::size_t i = align_end; i < size; i += simd_size)
+            {
+                std::size_t count = std::min(simd_size, size - i);
+                init = reduce_lanes(init, transform_op(load_partial(std::get<I>(in) + i, count)...), count, reduce_op);
+            }
+            return init;
         }
     }
 
-    template <class I1, class I2, class I3, class O1, class UF>
-    void transform(I1 first_1, I2 last_1, I3 first_2, O1 out_first, UF&& f)
+    /**
+     * Reduces the results of transform_op applied to the elements of
+     * [first, last) with reduce_op, starting from init, without storing
+     * the transformed elements. reduce_op must be associative and
+     * commutative, the order of the reductions being unspecified.
+     */
+    template <class I1, class I2, class Init, class BinaryFunction, class UnaryFunction>
+    Init transform_reduce(I1 first, I2 last, Init init, BinaryFunction&& reduce_op, UnaryFunction&& transform_op)
     {
-        using value_type = typename std::decay<decltype(*first_1)>::type;
-        using traits = simd_traits<value_type>;
-        using batch_type = typename traits::type;
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        if (size == 0)
+        {
+            return init;
+        }
+        using value_type = typename std::decay<decltype(*first)>::type;
+        std::tuple<const value_type*> in(&(*first));
+        return detail::transform_reduce_streams(in, size, init, reduce_op, transform_op, detail::make_index_sequence<1>());
+    }
 
+    /**
+     * Reduces the results of transform_op applied to the pairs of elements
+     * of [first_1, last_1) and of the range starting at first_2 with
+     * reduce_op, starting from init.
+     */
+    template <class I1, class I2, class I3, class Init, class BinaryFunction1, class BinaryFunction2>
+    Init transform_reduce(I1 first_1, I2 last_1, I3 first_2, Init init, BinaryFunction1&& reduce_op, BinaryFunction2&& transform_op)
+    {
         std::size_t size = static_cast<std::size_t>(std::distance(first_1, last_1));
-        std::size_t simd_size = traits::size;
+        if (size == 0)
+        {
+            return init;
+        }
+        using value_type_1 = typename std::decay<decltype(*first_1)>::type;
+        using value_type_2 = typename std::decay<decltype(*first_2)>::type;
+        std::tuple<const value_type_1*, const value_type_2*> in(&(*first_1), &(*first_2));
+        return detail::transform_reduce_streams(in, size, init, reduce_op, transform_op, detail::make_index_sequence<2>());
+    }
 
-        const auto* ptr_begin_1 = &(*first_1);
-        const auto* ptr_begin_2 = &(*first_2);
-        auto* ptr_out = &(*out_first);
+    /**
+     * Returns the inner product of [first_1, last_1) and of the range
+     * starting at first_2, added to init.
+     */
+    template <class I1, class I2, class I3, class Init>
+    Init transform_reduce(I1 first_1, I2 last_1, I3 first_2, Init init)
+    {
+        return xsimd::transform_reduce(first_1, last_1, first_2, init, detail::plus{}, detail::multiplies{});
+    }
+
+    /*******************************
+     * min / max element searching *
+     *******************************/
 
-        std::size_t align_begin_1 = xsimd::get_alignment_offset(ptr_begin_1, size, simd_size);
-        std::size_t align_begin_2 = xsimd::get_alignment_offset(ptr_begin_2, size, simd_size);
-        std::size_t out_align = xsimd::get_alignment_offset(ptr_out, size, simd_size);
-        std::size_t align_end = align_begin_1 + ((size - align_begin_1) & ~(simd_size - 1));
+    namespace detail
+    {
+        // Integer lanes matching the layout of T, used to keep per-lane
+        // indices or counters alongside a batch of T; mask converts the
+        // result of a comparison on T batches to these lanes.
+        template <class T, class = void>
+        struct lane_integer_traits
+        {
+            using integer_type = T;
 
-        #define XSIMD_LOOP_MACRO(A1, A2, A3)                                    \
-            for (std::size_t i = 0; i < align_begin_1; ++i)                     \
-            {                                                                   \
-                out_first[i] = f(first_1[i], first_2[i]);                       \
-            }                                                                   \
-                                                                                \
-            batch_type batch_1, batch_2;                                        \
-            for (std::size_t i = align_begin_1; i < align_end; i += simd_size)  \
-            {                                                                   \
-                xsimd::A1(&first_1[i], batch_1);                                \
-                xsimd::A2(&first_2[i], batch_2);                                \
-                xsimd::A3(&out_first[i], f(batch_1, batch_2));                  \
-            }                                                                   \
-                                                                                \
-            for (std::size_t i = align_end; i < size; ++i)                      \
-            {                                                                   \
-                out_first[i] = f(first_1[i], first_2[i]);                       \
-            }                                                                   \
+            template <class BB>
+            static const BB& mask(const BB& cond)
+            {
+                return cond;
+            }
+        };
 
-        if (align_begin_1 == out_align && align_begin_1 == align_begin_2)
+        template <class T>
+        struct lane_integer_traits<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
         {
-            XSIMD_LOOP_MACRO(load_aligned, load_aligned, store_aligned);
+            using integer_type = as_integer_t<T>;
+
+            template <class BB>
+            static auto mask(const BB& cond) -> decltype(bool_cast(cond))
+            {
+                return bool_cast(cond);
+            }
+        };
+
+        // replace(v, cur) is true when v, found after cur, takes its place;
+        // better(a, b) is true when a is a strictly better candidate than b.
+        struct min_element_policy
+        {
+            static constexpr bool keep_last = false;
+
+            template <class T>
+            static auto replace(const T& v, const T& cur) -> decltype(v < cur)
+            {
+                return v < cur;
+            }
+
+            template <class T>
+            static bool better(const T& a, const T& b)
+            {
+                return a < b;
+            }
+
+            template <class B>
+            static B fold(const B& lhs, const B& rhs)
+            {
+                return min(lhs, rhs);
+            }
+
+            template <class B>
+            static typename B::value_type hfold(const B& rhs)
+            {
+                return hmin(rhs);
+            }
+        };
+
+        template <bool KeepLast>
+        struct max_element_policy
+        {
+            static constexpr bool keep_last = KeepLast;
+
+            template <class T>
+            static auto replace(const T& v, const T& cur) -> decltype(cur < v)
+            {
+                return KeepLast ? cur <= v : cur < v;
+            }
+
+            template <class T>
+            static bool better(const T& a, const T& b)
+            {
+                return b < a;
+            }
+
+            template <class B>
+            static B fold(const B& lhs, const B& rhs)
+            {
+                return max(lhs, rhs);
+            }
+
+            template <class B>
+            static typename B::value_type hfold(const B& rhs)
+            {
+                return hmax(rhs);
+            }
+        };
+
+        template <class P, class T>
+        inline void extremum_scalar_sweep(const T* ptr, std::size_t first, std::size_t last, std::size_t& best)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                if (P::replace(ptr[i], ptr[best]))
+                {
+                    best = i;
+                }
+            }
         }
-        else if (align_begin_1 == out_align && align_begin_1 != align_begin_2)
+
+        template <class P, class T>
+        inline std::size_t extremum_index_scalar(const T* ptr, std::size_t size)
         {
-            XSIMD_LOOP_MACRO(load_aligned, load_unaligned, store_aligned);
+            std::size_t best = 0;
+            extremum_scalar_sweep<P>(ptr, 1, size, best);
+            return best;
         }
-        else if (align_begin_1 != out_align && align_begin_1 == align_begin_2)
+
+        // Per-lane extremum and block index, merged across lanes at the end.
+        template <class P, class T>
+        inline std::size_t extremum_index_body(const T* ptr, std::size_t align_begin, std::size_t align_end,
+                                               std::size_t best, std::true_type)
         {
-            XSIMD_LOOP_MACRO(load_aligned, load_aligned, store_unaligned);
+            using traits = simd_traits<T>;
+            using batch_type = typename traits::type;
+            using index_traits = lane_integer_traits<T>;
+            using index_type = typename index_traits::integer_type;
+            using index_batch = batch<index_type, traits::size>;
+            constexpr std::size_t simd_size = traits::size;
+
+            batch_type best_batch, current;
+            xsimd::load_aligned(ptr + align_begin, best_batch);
+            index_batch best_block(index_type(0));
+            index_type block = 1;
+            for (std::size_t i = align_begin + simd_size; i < align_end; i += simd_size, ++block)
+            {
+                xsimd::load_aligned(ptr + i, current);
+                auto cond = P::replace(current, best_batch);
+                best_batch = select(cond, current, best_batch);
+                best_block = select(index_traits::mask(cond), index_batch(block), best_block);
+            }
+
+            aligned_stack_buffer<T, simd_size, alignof(batch_type)> values;
+            aligned_stack_buffer<index_type, simd_size, alignof(index_batch)> blocks;
+            best_batch.store_aligned(values.data());
+            best_block.store_aligned(blocks.data());
+            for (std::size_t j = 0; j < simd_size; ++j)
+            {
+                std::size_t index = align_begin + static_cast<std::size_t>(blocks[j]) * simd_size + j;
+                bool tie = !P::better(ptr[best], values[j]);
+                if (P::better(values[j], ptr[best]) || (tie && (P::keep_last ? index > best : index < best)))
+                {
+                    best = index;
+                }
+            }
+            return best;
         }
-        else if (align_begin_1 != out_align && align_begin_1 != align_begin_2)
+
+        // Computes the extremum value first, then searches its position.
+        template <class P, class T>
+        inline std::size_t extremum_index_body(const T* ptr, std::size_t align_begin, std::size_t align_end,
+                                               std::size_t best, std::false_type)
         {
-            XSIMD_LOOP_MACRO(load_aligned, load_unaligned, store_unaligned);
+            using traits = simd_traits<T>;
+            using batch_type = typename traits::type;
+            constexpr std::size_t simd_size = traits::size;
+
+            batch_type acc, current;
+            xsimd::load_aligned(ptr + align_begin, acc);
+            for (std::size_t i = align_begin + simd_size; i < align_end; i += simd_size)
+            {
+                xsimd::load_aligned(ptr + i, current);
+                acc = P::fold(acc, current);
+            }
+            T value = P::hfold(acc);
+            if (P::better(ptr[best], value) || (!P::keep_last && !P::better(value, ptr[best])))
+            {
+                return best;
+            }
+
+            batch_type target(value);
+            if (P::keep_last)
+            {
+                for (std::size_t i = align_end; i > align_begin; i -= simd_size)
+                {
+                    xsimd::load_aligned(ptr + i - simd_size, current);
+                    if (any(current == target))
+                    {
+                        std::size_t j = i;
+                        while (ptr[--j] != value)
+                        {
+                        }
+                        return j;
+                    }
+                }
+            }
+            else
+            {
+                for (std::size_t i = align_begin; i < align_end; i += simd_size)
+                {
+                    xsimd::load_aligned(ptr + i, current);
+                    if (any(current == target))
+                    {
+                        std::size_t j = i;
+                        while (ptr[j] != value)
+                        {
+                            ++j;
+                        }
+                        return j;
+                    }
+                }
+            }
+            return best;
         }
 
-        #undef XSIMD_LOOP_MACRO
+        template <class P, class T>
+        inline std::size_t extremum_index(const T* ptr, std::size_t size, std::true_type)
+        {
+            constexpr std::size_t simd_size = simd_traits<T>::size;
+
+            std::size_t align_begin = xsimd::get_alignment_offset(ptr, size, simd_size);
+            std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+            if (align_end - align_begin < simd_size)
+            {
+                return extremum_index_scalar<P>(ptr, size);
+            }
+
+            std::size_t best = 0;
+            extremum_scalar_sweep<P>(ptr, 1, align_begin, best);
+            // lanes narrower than 32 bits would overflow the block index,
+            // the position is then recovered with a second pass
+            using tracked = std::integral_constant<bool, (sizeof(T) >= 4)>;
+            best = extremum_index_body<P>(ptr, align_begin, align_end, best, tracked());
+            extremum_scalar_sweep<P>(ptr, align_end, size, best);
+            return best;
+        }
+
+        template <class P, class T>
+        inline std::size_t extremum_index(const T* ptr, std::size_t size, std::false_type)
+        {
+            return extremum_index_scalar<P>(ptr, size);
+        }
+
+        template <class P, class Iterator1, class Iterator2>
+        inline std::size_t extremum_index(Iterator1 first, Iterator2 last)
+        {
+            using value_type = typename std::decay<decltype(*first)>::type;
+            using vectorized = std::integral_constant<bool, (simd_traits<value_type>::size > 1)>;
+
+            std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+            if (size == 0)
+            {
+                return 0;
+            }
+            return extremum_index<P>(&(*first), size, vectorized());
+        }
     }
 
+    // Index of the first smallest element of [first, last), 0 if the range is empty.
+    template <class Iterator1, class Iterator2>
+    std::size_t argmin(Iterator1 first, Iterator2 last)
+    {
+        return detail::extremum_index<detail::min_element_policy>(first, last);
+    }
+
+    // Index of the first largest element of [first, last), 0 if the range is empty.
+    template <class Iterator1, class Iterator2>
+    std::size_t argmax(Iterator1 first, Iterator2 last)
+    {
+        return detail::extremum_index<detail::max_element_policy<false>>(first, last);
+    }
+
+    template <class Iterator1, class Iterator2>
+    Iterator1 min_element(Iterator1 first, Iterator2 last)
+    {
+        return std::next(first, static_cast<std::ptrdiff_t>(argmin(first, last)));
+    }
+
+    template <class Iterator1, class Iterator2>
+    Iterator1 max_element(Iterator1 first, Iterator2 last)
+    {
+        return std::next(first, static_cast<std::ptrdiff_t>(argmax(first, last)));
+    }
+
+    // Same semantic as std::minmax_element: the first smallest and the last largest elements.
+    template <class Iterator1, class Iterator2>
+    std::pair<Iterator1, Iterator1> minmax_element(Iterator1 first, Iterator2 last)
+    {
+        std::size_t max_index = detail::extremum_index<detail::max_element_policy<true>>(first, last);
+        return std::make_pair(min_element(first, last),
+                              std::next(first, static_cast<std::ptrdiff_t>(max_index)));
+    }
+
+    /********************************
+     * find / count / mismatch      *
+     ********************************/
 
-    // TODO: Remove this once we drop C++11 support
     namespace detail
     {
-        struct plus
+        // Predicates are applied to both scalars and batches, as the functors
+        // passed to transform.
+        template <class T>
+        struct equal_to_value
         {
-            template <class X, class Y>
-            auto operator()(X&& x, Y&& y) -> decltype(x + y) { return x + y; }
+            T value;
+
+            template <class U>
+            auto operator()(const U& x) const -> decltype(x == U(value))
+            {
+                return x == U(value);
+            }
+        };
+
+        // Whether some value of type T compares equal to value, the
+        // comparison being done in the common type as in std::find.
+        template <class T, class U>
+        inline bool is_representable_value(const U& value)
+        {
+            using common_type = typename std::common_type<T, U>::type;
+            return static_cast<common_type>(static_cast<T>(value)) == static_cast<common_type>(value);
+        }
+
+        template <class F>
+        struct negated_predicate
+        {
+            F pred;
+
+            template <class U>
+            auto operator()(const U& x) const -> decltype(!pred(x))
+            {
+                return !pred(x);
+            }
         };
+
+        // Index of the first i in [0, size) for which scalar_test(i) holds, size if none.
+        // The aligned part is checked by blocks of Unroll batches, whose results are
+        // or-ed together so that any() is called once per block.
+        template <std::size_t Unroll, class T, class BF, class SF>
+        inline std::size_t find_index(const T* ptr, std::size_t size, BF&& batch_test, SF&& scalar_test, std::true_type)
+        {
+            static_assert(Unroll > 0, "early exit granularity must be at least one batch");
+            constexpr std::size_t simd_size = simd_traits<T>::size;
+            constexpr std::size_t block_size = Unroll * simd_size;
+
+            std::size_t align_begin = xsimd::get_alignment_offset(ptr, size, simd_size);
+            std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+            std::size_t block_end = align_begin + ((align_end - align_begin) / block_size) * block_size;
+
+            for (std::size_t i = 0; i < align_begin; ++i)
+            {
+                if (scalar_test(i))
+                {
+                    return i;
+                }
+            }
+
+            std::size_t hit_begin = align_end;
+            std::size_t hit_end = align_end;
+            for (std::size_t i = align_begin; i < block_end; i += block_size)
+            {
+                auto hit = batch_test(i);
+                for (std::size_t j = 1; j < Unroll; ++j)
+                {
+                    hit = hit | batch_test(i + j * simd_size);
+                }
+                if (any(hit))
+                {
+                    hit_begin = i;
+                    hit_end = i + block_size;
+                    break;
+                }
+            }
+            if (hit_begin == align_end)
+            {
+                for (std::size_t i = block_end; i < align_end; i += simd_size)
+                {
+                    if (any(batch_test(i)))
+                    {
+                        hit_begin = i;
+                        hit_end = i + simd_size;
+                        break;
+                    }
+                }
+            }
+            if (hit_begin == align_end)
+            {
+                hit_end = size;
+            }
+
+            for (std::size_t i = hit_begin; i < hit_end; ++i)
+            {
+                if (scalar_test(i))
+                {
+                    return i;
+                }
+            }
+            return size;
+        }
+
+        template <std::size_t Unroll, class T, class BF, class SF>
+        inline std::size_t find_index(const T*, std::size_t size, BF&&, SF&& scalar_test, std::false_type)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (scalar_test(i))
+                {
+                    return i;
+                }
+            }
+            return size;
+        }
+
+        template <std::size_t Unroll, class T, class F>
+        inline std::size_t find_index_if(const T* ptr, std::size_t size, const F& pred)
+        {
+            using traits = simd_traits<T>;
+            using batch_type = typename traits::type;
+            using vectorized = std::integral_constant<bool, (traits::size > 1)>;
+
+            auto batch_test = [ptr, &pred](std::size_t i)
+            {
+                batch_type current;
+                xsimd::load_aligned(ptr + i, current);
+                return pred(current);
+            };
+            auto scalar_test = [ptr, &pred](std::size_t i) -> bool
+            {
+                return pred(ptr[i]);
+            };
+            return find_index<Unroll>(ptr, size, batch_test, scalar_test, vectorized());
+        }
+
+        // Per-lane counters are flushed before they can overflow, which
+        // only matters for 8 and 16-bit lanes.
+        template <class T, class F>
+        inline std::size_t count_index_if(const T* ptr, std::size_t size, const F& pred, std::true_type)
+        {
+            using traits = simd_traits<T>;
+            using batch_type = typename traits::type;
+            using counter_traits = lane_integer_traits<T>;
+            using counter_type = typename counter_traits::integer_type;
+            using counter_batch = batch<counter_type, traits::size>;
+            constexpr std::size_t simd_size = traits::size;
+            constexpr std::size_t flush_interval = static_cast<std::size_t>(std::numeric_limits<counter_type>::max());
+
+            std::size_t align_begin = xsimd::get_alignment_offset(ptr, size, simd_size);
+            std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+
+            std::size_t res = 0;
+            for (std::size_t i = 0; i < align_begin; ++i)
+            {
+                res += pred(ptr[i]) ? 1 : 0;
+            }
+
+            const counter_batch zero(counter_type(0));
+            const counter_batch one(counter_type(1));
+            aligned_stack_buffer<counter_type, simd_size, alignof(counter_batch)> lanes;
+            std::size_t i = align_begin;
+            while (i < align_end)
+            {
+                std::size_t chunk_end = i + std::min((align_end - i) / simd_size, flush_interval) * simd_size;
+                counter_batch counter = zero;
+                batch_type current;
+                for (; i < chunk_end; i += simd_size)
+                {
+                    xsimd::load_aligned(ptr + i, current);
+                    counter += select(counter_traits::mask(pred(current)), one, zero);
+                }
+                counter.store_aligned(lanes.data());
+                for (std::size_t j = 0; j < simd_size; ++j)
+                {
+                    res += static_cast<std::size_t>(lanes[j]);
+                }
+            }
+
+            for (i = align_end; i < size; ++i)
+            {
+                res += pred(ptr[i]) ? 1 : 0;
+            }
+            return res;
+        }
+
+        template <class T, class F>
+        inline std::size_t count_index_if(const T* ptr, std::size_t size, const F& pred, std::false_type)
+        {
+            std::size_t res = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                res += pred(ptr[i]) ? 1 : 0;
+            }
+            return res;
+        }
     }
 
+    // Unroll is the early exit granularity: the number of batches tested
+    // before checking for a hit.
+    template <std::size_t Unroll = 4, class Iterator1, class Iterator2, class UnaryPredicate>
+    Iterator1 find_if(Iterator1 first, Iterator2 last, UnaryPredicate&& pred)
+    {
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        if (size == 0)
+        {
+            return first;
+        }
+        std::size_t index = detail::find_index_if<Unroll>(&(*first), size, pred);
+        return std::next(first, static_cast<std::ptrdiff_t>(index));
+    }
 
-    template <class Iterator1, class Iterator2, class Init, class BinaryFunction = detail::plus>
-    Init reduce(Iterator1 first, Iterator2 last, Init init, BinaryFunction&& binfun = detail::plus{})
+    template <std::size_t Unroll = 4, class Iterator1, class Iterator2, class T>
+    Iterator1 find(Iterator1 first, Iterator2 last, const T& value)
+    {
+        using value_type = typename std::decay<decltype(*first)>::type;
+        if (!detail::is_representable_value<value_type>(value))
+        {
+            return std::next(first, std::distance(first, last));
+        }
+        return find_if<Unroll>(first, last, detail::equal_to_value<value_type>{static_cast<value_type>(value)});
+    }
+
+    template <class Iterator1, class Iterator2, class UnaryPredicate>
+    typename std::iterator_traits<Iterator1>::difference_type
+    count_if(Iterator1 first, Iterator2 last, UnaryPredicate&& pred)
+    {
+        using value_type = typename std::decay<decltype(*first)>::type;
+        using difference_type = typename std::iterator_traits<Iterator1>::difference_type;
+        using vectorized = std::integral_constant<bool, (simd_traits<value_type>::size > 1)>;
+
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        if (size == 0)
+        {
+            return 0;
+        }
+        return static_cast<difference_type>(detail::count_index_if(&(*first), size, pred, vectorized()));
+    }
+
+    template <class Iterator1, class Iterator2, class T>
+    typename std::iterator_traits<Iterator1>::difference_type
+    count(Iterator1 first, Iterator2 last, const T& value)
     {
         using value_type = typename std::decay<decltype(*first)>::type;
+        if (!detail::is_representable_value<value_type>(value))
+        {
+            return 0;
+        }
+        return count_if(first, last, detail::equal_to_value<value_type>{static_cast<value_type>(value)});
+    }
+
+    template <std::size_t Unroll = 4, class Iterator1, class Iterator2, class UnaryPredicate>
+    bool any_of(Iterator1 first, Iterator2 last, UnaryPredicate&& pred)
+    {
+        auto it = find_if<Unroll>(first, last, std::forward<UnaryPredicate>(pred));
+        return it != last;
+    }
+
+    template <std::size_t Unroll = 4, class Iterator1, class Iterator2, class UnaryPredicate>
+    bool none_of(Iterator1 first, Iterator2 last, UnaryPredicate&& pred)
+    {
+        return !any_of<Unroll>(first, last, std::forward<UnaryPredicate>(pred));
+    }
+
+    template <std::size_t Unroll = 4, class Iterator1, class Iterator2, class UnaryPredicate>
+    bool all_of(Iterator1 first, Iterator2 last, UnaryPredicate&& pred)
+    {
+        using predicate_type = typename std::decay<UnaryPredicate>::type;
+        auto it = find_if<Unroll>(first, last, detail::negated_predicate<predicate_type>{std::forward<UnaryPredicate>(pred)});
+        return it == last;
+    }
+
+    template <std::size_t Unroll = 4, class Iterator1, class Iterator2, class Iterator3>
+    std::pair<Iterator1, Iterator3> mismatch(Iterator1 first1, Iterator2 last1, Iterator3 first2)
+    {
+        using value_type = typename std::decay<decltype(*first1)>::type;
         using traits = simd_traits<value_type>;
         using batch_type = typename traits::type;
+        using vectorized = std::integral_constant<bool, (traits::size > 1)>;
 
-        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
-        constexpr std::size_t simd_size = traits::size;
+        std::size_t size = static_cast<std::size_t>(std::distance(first1, last1));
+        if (size == 0)
+        {
+            return std::make_pair(first1, first2);
+        }
 
-        if(size < simd_size)
+        const auto* ptr1 = &(*first1);
+        const auto* ptr2 = &(*first2);
+        auto scalar_test = [ptr1, ptr2](std::size_t i) -> bool
         {
-            while(first != last)
+            return ptr1[i] != ptr2[i];
+        };
+
+        std::size_t index;
+        if (xsimd::get_alignment_offset(ptr1, size, traits::size) == xsimd::get_alignment_offset(ptr2, size, traits::size))
+        {
+            auto batch_test = [ptr1, ptr2](std::size_t i)
+            {
+                batch_type batch1, batch2;
+                xsimd::load_aligned(ptr1 + i, batch1);
+                xsimd::load_aligned(ptr2 + i, batch2);
+                return batch1 != batch2;
+            };
+            index = detail::find_index<Unroll>(ptr1, size, batch_test, scalar_test, vectorized());
+        }
+        else
+        {
+            auto batch_test = [ptr1, ptr2](std::size_t i)
             {
-                init = binfun(init, *first++);
+                batch_type batch1, batch2;
+                xsimd::load_aligned(ptr1 + i, batch1);
+                xsimd::load_unaligned(ptr2 + i, batch2);
+                return batch1 != batch2;
+            };
+            index = detail::find_index<Unroll>(ptr1, size, batch_test, scalar_test, vectorized());
+        }
+        return std::make_pair(std::next(first1, static_cast<std::ptrdiff_t>(index)),
+                              std::next(first2, static_cast<std::ptrdiff_t>(index)));
+    }
+
+    template <std::size_t Unroll = 4, class Iterator1, class Iterator2, class Iterator3>
+    bool equal(Iterator1 first1, Iterator2 last1, Iterator3 first2)
+    {
+        return mismatch<Unroll>(first1, last1, first2).first == last1;
+    }
+
+    /*************
+     * histogram *
+     *************/
+
+    namespace detail
+    {
+        // Sub-histograms of 32-bit counters, merged with batch additions
+        // and flushed into the bins before they can overflow. The last
+        // counter of each sub-histogram collects the indices falling out of
+        // range.
+        template <class C>
+        class histogram_accumulator
+        {
+        public:
+
+            histogram_accumulator(C bins, std::size_t nbins, std::size_t sub_histograms);
+
+            uint32_t* data();
+            std::size_t stride() const;
+
+            // must be called before n increments
+            void reserve(std::size_t n);
+            void flush();
+
+        private:
+
+            using counter_traits = simd_traits<uint32_t>;
+
+            C m_bins;
+            std::size_t m_nbins;
+            std::size_t m_stride;
+            std::size_t m_sub_histograms;
+            std::size_t m_pending;
+            std::vector<uint32_t, aligned_allocator<uint32_t>> m_counts;
+        };
+
+        template <class C>
+        inline histogram_accumulator<C>::histogram_accumulator(C bins, std::size_t nbins, std::size_t sub_histograms)
+            : m_bins(bins),
+              m_nbins(nbins),
+              m_stride((nbins + counter_traits::size) & ~(counter_traits::size - 1)),
+              m_sub_histograms(sub_histograms),
+              m_pending(0),
+              m_counts(sub_histograms * m_stride, 0)
+        {
+        }
+
+        template <class C>
+        inline uint32_t* histogram_accumulator<C>::data()
+        {
+            return m_counts.data();
+        }
+
+        template <class C>
+        inline std::size_t histogram_accumulator<C>::stride() const
+        {
+            return m_stride;
+        }
+
+        template <class C>
+        inline void histogram_accumulator<C>::reserve(std::size_t n)
+        {
+            if (m_pending + n > std::numeric_limits<uint32_t>::max())
+            {
+                flush();
             }
-            return init;
+            m_pending += n;
         }
 
-        const auto* const ptr_begin = &(*first);
+        template <class C>
+        inline void histogram_accumulator<C>::flush()
+        {
+            using counter_batch = typename counter_traits::type;
+            constexpr std::size_t counter_size = counter_traits::size;
+            uint32_t* counts = m_counts.data();
+            for (std::size_t j = 1; j < m_sub_histograms; ++j)
+            {
+                uint32_t* sub = counts + j * m_stride;
+                for (std::size_t b = 0; b < m_stride; b += counter_size)
+                {
+                    counter_batch acc, other;
+                    xsimd::load_aligned(counts + b, acc);
+                    xsimd::load_aligned(sub + b, other);
+                    xsimd::store_aligned(counts + b, acc + other);
+                }
+            }
+            for (std::size_t b = 0; b < m_nbins; ++b)
+            {
+                m_bins[b] += counts[b];
+            }
+            std::fill(m_counts.begin(), m_counts.end(), uint32_t(0));
+            m_pending = 0;
+        }
 
-        std::size_t align_begin = xsimd::get_alignment_offset(ptr_begin, size, simd_size);
-        std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+        // 8-bit and 16-bit values are used as indices as they are: scalar
+        // increments of interleaved sub-histograms are faster than widening
+        // the values to batches of 32-bit indices, even with conflict
+        // detection. Small inputs do not amortize the sub-histograms.
+        template <class T, class C>
+        inline void integer_histogram(const T* ptr, std::size_t size, C bins)
+        {
+            constexpr std::size_t nbins = std::size_t(1) << (8 * sizeof(T));
+            constexpr std::size_t sub_histograms = 4;
+            if (size < nbins)
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    ++bins[ptr[i]];
+                }
+                return;
+            }
 
-        // reduce initial unaligned part
-        for (std::size_t i = 0; i < align_begin; ++i)
+            histogram_accumulator<C> accumulator(bins, nbins, sub_histograms);
+            uint32_t* counts = accumulator.data();
+            const std::size_t stride = accumulator.stride();
+            std::size_t vec_size = size - size % sub_histograms;
+            for (std::size_t i = 0; i < vec_size; i += sub_histograms)
+            {
+                accumulator.reserve(sub_histograms);
+                ++counts[ptr[i]];
+                ++counts[stride + ptr[i + 1]];
+                ++counts[2 * stride + ptr[i + 2]];
+                ++counts[3 * stride + ptr[i + 3]];
+            }
+            accumulator.reserve(size - vec_size);
+            for (std::size_t i = vec_size; i < size; ++i)
+            {
+                ++counts[ptr[i]];
+            }
+            accumulator.flush();
+        }
+
+        template <class T>
+        inline std::size_t scalar_bucket(T x, T lo, T scale, std::size_t nbins)
         {
-            init = binfun(init, first[i]);
+            T bucket = std::floor((x - lo) * scale);
+            return bucket >= T(0) && bucket < static_cast<T>(nbins) ? static_cast<std::size_t>(bucket) : nbins;
         }
 
-        // reduce aligned part
-        batch_type batch_init, batch;
-        auto ptr = ptr_begin + align_begin;
-        xsimd::load_aligned(ptr, batch_init);
-        ptr += simd_size;
-        for (auto const end = ptr_begin + align_end; ptr < end; ptr += simd_size)
+        // Out of range and NaN values are sent to the bin nbins.
+        template <class T, std::size_t N>
+        inline batch<as_integer_t<T>, N> batch_bucket(const batch<T, N>& x, const batch<T, N>& lo, const batch<T, N>& scale,
+                                                      const batch<T, N>& nbins)
         {
-            xsimd::load_aligned(ptr, batch);
-            batch_init = binfun(batch_init, batch);
+            batch<T, N> bucket = floor((x - lo) * scale);
+            batch<T, N> res = select(bucket >= batch<T, N>(T(0)) && bucket < nbins, bucket, nbins);
+            return batch_cast<as_integer_t<T>>(res);
         }
 
-        // reduce across batch
-        alignas(batch_type) std::array<value_type, simd_size> arr;
-        xsimd::store_aligned(arr.data(), batch_init);
-        for (auto x : arr) init = binfun(init, x);
+        template <class T, class C>
+        inline void float_histogram(const T* ptr, std::size_t size, C bins, std::size_t nbins, T lo, T hi, std::true_type)
+        {
+            using traits = simd_traits<T>;
+            using batch_type = typename traits::type;
+            constexpr std::size_t simd_size = traits::size;
+            const T scale = static_cast<T>(nbins) / (hi - lo);
 
-        // reduce final unaligned part
-        for (std::size_t i = align_end; i < size; ++i)
+            using impl = histogram_impl<as_integer_t<T>, simd_size>;
+
+            histogram_accumulator<C> accumulator(bins, nbins, impl::sub_histograms);
+            uint32_t* counts = accumulator.data();
+            const std::size_t stride = accumulator.stride();
+            const batch_type vlo(lo), vscale(scale), vnbins(static_cast<T>(nbins));
+            std::size_t vec_size = size - size % simd_size;
+            batch_type current;
+            for (std::size_t i = 0; i < vec_size; i += simd_size)
+            {
+                xsimd::load_unaligned(ptr + i, current);
+                accumulator.reserve(simd_size);
+                impl::run(counts, stride, batch_bucket(current, vlo, vscale, vnbins));
+            }
+            accumulator.flush();
+            for (std::size_t i = vec_size; i < size; ++i)
+            {
+                std::size_t bucket = scalar_bucket(ptr[i], lo, scale, nbins);
+                if (bucket < nbins)
+                {
+                    ++bins[bucket];
+                }
+            }
+        }
+
+        template <class T, class C>
+        inline void float_histogram(const T* ptr, std::size_t size, C bins, std::size_t nbins, T lo, T hi, std::false_type)
         {
-            init = binfun(init, first[i]);
+            const T scale = static_cast<T>(nbins) / (hi - lo);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                std::size_t bucket = scalar_bucket(ptr[i], lo, scale, nbins);
+                if (bucket < nbins)
+                {
+                    ++bins[bucket];
+                }
+            }
         }
+    }
+
+    /**
+     * Counts the occurrences of every value of [first, last), an 8-bit or
+     * 16-bit unsigned range: bins[v] is incremented by the number of
+     * elements equal to v. bins must hold 256 or 65536 counters.
+     */
+    template <class Iterator1, class Iterator2, class Iterator3>
+    void histogram(Iterator1 first, Iterator2 last, Iterator3 bins)
+    {
+        using value_type = typename std::decay<decltype(*first)>::type;
+        static_assert(std::is_integral<value_type>::value && std::is_unsigned<value_type>::value && sizeof(value_type) <= 2,
+                      "histogram without range requires 8-bit or 16-bit unsigned values");
 
-        return init;
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        if (size == 0)
+        {
+            return;
+        }
+        detail::integer_histogram(&(*first), size, bins);
     }
 
+    /**
+     * Counts the floating point values of [first, last) falling in each of
+     * the nbins buckets of equal width dividing [lo, hi): bins[b] is
+     * incremented by the number of elements x such that
+     * floor((x - lo) * nbins / (hi - lo)) == b. Values out of range and NaN
+     * are ignored.
+     */
+    template <class Iterator1, class Iterator2, class Iterator3, class T>
+    void histogram(Iterator1 first, Iterator2 last, Iterator3 bins, std::size_t nbins, T lo, T hi)
+    {
+        using value_type = typename std::decay<decltype(*first)>::type;
+        static_assert(std::is_floating_point<value_type>::value, "histogram with range requires floating point values");
+        using vectorized = std::integral_constant<bool, (simd_traits<value_type>::size > 1)>;
+
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        if (size == 0 || nbins == 0)
+        {
+            return;
+        }
+        detail::float_histogram(&(*first), size, bins, nbins, static_cast<value_type>(lo), static_cast<value_type>(hi), vectorized());
+    }
 }
 
 #endif
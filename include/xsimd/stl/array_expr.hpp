@@ -0,0 +1,652 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_ARRAY_EXPR_HPP
+#define XSIMD_ARRAY_EXPR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../memory/xsimd_aligned_allocator.hpp"
+#include "../memory/xsimd_load_store.hpp"
+#include "../types/xsimd_utils.hpp"
+
+namespace xsimd
+{
+    /**
+     * @class array_expr
+     * @brief Base class of the lazy array expressions
+     *
+     * An array expression is a tree whose leaves are arrays or scalars and
+     * whose nodes are arithmetic operators or math functions. Building an
+     * expression does not compute anything: evaluate, assign and eval
+     * compute all the nodes in a single loop over batches, so that the
+     * intermediate results stay in registers. The operands of an
+     * expression have the same value type and, for arrays, the same size.
+     *
+     * @tparam D type of the derived expression.
+     */
+    template <class D>
+    class array_expr
+    {
+    public:
+
+        using derived_type = D;
+
+        derived_type& derived_cast() noexcept;
+        const derived_type& derived_cast() const noexcept;
+
+    protected:
+
+        array_expr() = default;
+        ~array_expr() = default;
+
+        array_expr(const array_expr&) = default;
+        array_expr& operator=(const array_expr&) = default;
+
+        array_expr(array_expr&&) = default;
+        array_expr& operator=(array_expr&&) = default;
+    };
+
+    /**
+     * @class array_terminal
+     * @brief Array leaf of an expression
+     *
+     * Refers to the elements of an array, which must outlive the
+     * expression; each terminal loads its elements with aligned loads
+     * when they are aligned like the output of the evaluation.
+     */
+    template <class T>
+    class array_terminal : public array_expr<array_terminal<T>>
+    {
+    public:
+
+        using value_type = T;
+        using batch_type = typename simd_traits<T>::type;
+        using size_type = std::size_t;
+
+        array_terminal(const value_type* data, size_type size) noexcept;
+
+        size_type size() const noexcept;
+        void prepare(size_type offset) noexcept;
+
+        value_type operator[](size_type i) const;
+        batch_type load(size_type i) const;
+
+    private:
+
+        const value_type* m_data;
+        size_type m_size;
+        bool m_aligned;
+    };
+
+    /**
+     * @class array_scalar
+     * @brief Scalar leaf of an expression, broadcast to every element
+     */
+    template <class T>
+    class array_scalar : public array_expr<array_scalar<T>>
+    {
+    public:
+
+        using value_type = T;
+        using batch_type = typename simd_traits<T>::type;
+        using size_type = std::size_t;
+
+        explicit array_scalar(const value_type& value);
+
+        size_type size() const noexcept;
+        void prepare(size_type offset) noexcept;
+
+        value_type operator[](size_type i) const;
+        batch_type load(size_type i) const;
+
+    private:
+
+        value_type m_value;
+        batch_type m_batch;
+    };
+
+    /**
+     * @class array_function
+     * @brief Node of an expression applying F to its operands
+     *
+     * F is a function object applicable both to the values and to the
+     * batches of the operands.
+     */
+    template <class F, class... E>
+    class array_function : public array_expr<array_function<F, E...>>
+    {
+    public:
+
+        using value_type = typename std::decay<decltype(std::declval<F>()(std::declval<typename E::value_type>()...))>::type;
+        using batch_type = typename simd_traits<value_type>::type;
+        using size_type = std::size_t;
+
+        explicit array_function(const E&... e);
+
+        size_type size() const noexcept;
+        void prepare(size_type offset) noexcept;
+
+        value_type operator[](size_type i) const;
+        batch_type load(size_type i) const;
+
+    private:
+
+        template <std::size_t... I>
+        size_type size_impl(detail::index_sequence<I...>) const noexcept;
+
+        template <std::size_t... I>
+        void prepare_impl(size_type offset, detail::index_sequence<I...>) noexcept;
+
+        template <std::size_t... I>
+        value_type access_impl(size_type i, detail::index_sequence<I...>) const;
+
+        template <std::size_t... I>
+        batch_type load_impl(size_type i, detail::index_sequence<I...>) const;
+
+        std::tuple<E...> m_e;
+    };
+
+    template <class C>
+    array_terminal<typename C::value_type> expr(const C& c) noexcept;
+
+    template <class T>
+    array_terminal<T> expr(const T* data, std::size_t size) noexcept;
+
+    template <class E, class T>
+    void evaluate(const array_expr<E>& e, T* out);
+
+    template <class C, class E>
+    void assign(C& c, const array_expr<E>& e);
+
+    template <class E>
+    std::vector<typename E::value_type, aligned_allocator<typename E::value_type>>
+    eval(const array_expr<E>& e);
+
+    /*****************************
+     * array_expr implementation *
+     *****************************/
+
+    template <class D>
+    inline auto array_expr<D>::derived_cast() noexcept -> derived_type&
+    {
+        return *static_cast<derived_type*>(this);
+    }
+
+    template <class D>
+    inline auto array_expr<D>::derived_cast() const noexcept -> const derived_type&
+    {
+        return *static_cast<const derived_type*>(this);
+    }
+
+    /*********************************
+     * array_terminal implementation *
+     *********************************/
+
+    template <class T>
+    inline array_terminal<T>::array_terminal(const value_type* data, size_type size) noexcept
+        : m_data(data), m_size(size), m_aligned(false)
+    {
+    }
+
+    template <class T>
+    inline auto array_terminal<T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Selects the loads of the batches starting at offset plus a
+     * multiple of the batch size.
+     */
+    template <class T>
+    inline void array_terminal<T>::prepare(size_type offset) noexcept
+    {
+        constexpr size_type simd_size = simd_traits<T>::size;
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_data);
+        m_aligned = address % sizeof(T) == 0 && (address / sizeof(T) + offset) % simd_size == 0;
+    }
+
+    template <class T>
+    inline auto array_terminal<T>::operator[](size_type i) const -> value_type
+    {
+        return m_data[i];
+    }
+
+    template <class T>
+    inline auto array_terminal<T>::load(size_type i) const -> batch_type
+    {
+        batch_type res;
+        if (m_aligned)
+        {
+            xsimd::load_aligned(m_data + i, res);
+        }
+        else
+        {
+            xsimd::load_unaligned(m_data + i, res);
+        }
+        return res;
+    }
+
+    /*******************************
+     * array_scalar implementation *
+     *******************************/
+
+    template <class T>
+    inline array_scalar<T>::array_scalar(const value_type& value)
+        : m_value(value), m_batch(value)
+    {
+    }
+
+    /**
+     * Returns the maximum size, since a scalar adapts to the size of the
+     * other operands.
+     */
+    template <class T>
+    inline auto array_scalar<T>::size() const noexcept -> size_type
+    {
+        return std::numeric_limits<size_type>::max();
+    }
+
+    template <class T>
+    inline void array_scalar<T>::prepare(size_type) noexcept
+    {
+    }
+
+    template <class T>
+    inline auto array_scalar<T>::operator[](size_type) const -> value_type
+    {
+        return m_value;
+    }
+
+    template <class T>
+    inline auto array_scalar<T>::load(size_type) const -> batch_type
+    {
+        return m_batch;
+    }
+
+    /*********************************
+     * array_function implementation *
+     *********************************/
+
+    template <class F, class... E>
+    inline array_function<F, E...>::array_function(const E&... e)
+        : m_e(e...)
+    {
+    }
+
+    /**
+     * Returns the smallest size of the operands.
+     */
+    template <class F, class... E>
+    inline auto array_function<F, E...>::size() const noexcept -> size_type
+    {
+        return size_impl(detail::index_sequence_for<E...>());
+    }
+
+    template <class F, class... E>
+    inline void array_function<F, E...>::prepare(size_type offset) noexcept
+    {
+        prepare_impl(offset, detail::index_sequence_for<E...>());
+    }
+
+    template <class F, class... E>
+    inline auto array_function<F, E...>::operator[](size_type i) const -> value_type
+    {
+        return access_impl(i, detail::index_sequence_for<E...>());
+    }
+
+    template <class F, class... E>
+    inline auto array_function<F, E...>::load(size_type i) const -> batch_type
+    {
+        return load_impl(i, detail::index_sequence_for<E...>());
+    }
+
+    template <class F, class... E>
+    template <std::size_t... I>
+    inline auto array_function<F, E...>::size_impl(detail::index_sequence<I...>) const noexcept -> size_type
+    {
+        const size_type sizes[] = { std::get<I>(m_e).size()... };
+        size_type res = sizes[0];
+        for (size_type s : sizes)
+        {
+            res = s < res ? s : res;
+        }
+        return res;
+    }
+
+    template <class F, class... E>
+    template <std::size_t... I>
+    inline void array_function<F, E...>::prepare_impl(size_type offset, detail::index_sequence<I...>) noexcept
+    {
+        using expander = int[];
+        (void)expander{ (std::get<I>(m_e).prepare(offset), 0)... };
+    }
+
+    template <class F, class... E>
+    template <std::size_t... I>
+    inline auto array_function<F, E...>::access_impl(size_type i, detail::index_sequence<I...>) const -> value_type
+    {
+        return F()(std::get<I>(m_e)[i]...);
+    }
+
+    template <class F, class... E>
+    template <std::size_t... I>
+    inline auto array_function<F, E...>::load_impl(size_type i, detail::index_sequence<I...>) const -> batch_type
+    {
+        return F()(std::get<I>(m_e).load(i)...);
+    }
+
+    /**************************
+     * expression construction *
+     **************************/
+
+    namespace detail
+    {
+        template <class T>
+        struct is_array_expr : std::is_base_of<array_expr<T>, T>
+        {
+        };
+
+        template <class... Args>
+        struct any_array_expr : std::false_type
+        {
+        };
+
+        template <class Arg, class... Args>
+        struct any_array_expr<Arg, Args...>
+            : std::integral_constant<bool, is_array_expr<Arg>::value || any_array_expr<Args...>::value>
+        {
+        };
+
+        template <class Arg, bool = is_array_expr<Arg>::value>
+        struct array_value_type_of
+        {
+        };
+
+        template <class Arg>
+        struct array_value_type_of<Arg, true>
+        {
+            using type = typename Arg::value_type;
+        };
+
+        // Value type of the first expression among Args
+        template <class... Args>
+        struct array_value_type;
+
+        template <class Arg, class... Args>
+        struct array_value_type<Arg, Args...>
+            : std::conditional<is_array_expr<Arg>::value, array_value_type_of<Arg>, array_value_type<Args...>>::type
+        {
+        };
+
+        // Expression wrapping an operand, scalars being converted to the
+        // value type T of the other operands
+        template <class Arg, class T, bool = is_array_expr<Arg>::value>
+        struct array_operand
+        {
+            using type = Arg;
+
+            static const Arg& get(const Arg& arg) noexcept
+            {
+                return arg;
+            }
+        };
+
+        template <class Arg, class T>
+        struct array_operand<Arg, T, false>
+        {
+            using type = array_scalar<T>;
+
+            static type get(const Arg& arg)
+            {
+                return type(static_cast<T>(arg));
+            }
+        };
+
+        // Operands are expressions or arithmetic scalars, and at least one
+        // of them is an expression
+        template <class... Args>
+        struct enable_array_function
+            : std::enable_if<any_array_expr<Args...>::value &&
+                             all_true<(is_array_expr<Args>::value || std::is_arithmetic<Args>::value)...>::value>
+        {
+        };
+
+        template <class F, class... Args>
+        using array_function_t = array_function<F, typename array_operand<Args, typename array_value_type<Args...>::type>::type...>;
+
+        template <class F, class... Args>
+        inline array_function_t<F, Args...> make_array_function(const Args&... args)
+        {
+            using value_type = typename array_value_type<Args...>::type;
+            return array_function_t<F, Args...>(array_operand<Args, value_type>::get(args)...);
+        }
+    }
+
+    /**
+     * Returns an expression referring to the elements of the contiguous
+     * container c.
+     */
+    template <class C>
+    inline array_terminal<typename C::value_type> expr(const C& c) noexcept
+    {
+        return array_terminal<typename C::value_type>(c.data(), c.size());
+    }
+
+    /**
+     * Returns an expression referring to the size elements starting at data.
+     */
+    template <class T>
+    inline array_terminal<T> expr(const T* data, std::size_t size) noexcept
+    {
+        return array_terminal<T>(data, size);
+    }
+
+#define XSIMD_ARRAY_EXPR_OPERATOR(NAME, OP)                                                       \
+    namespace detail                                                                              \
+    {                                                                                             \
+        struct array_##NAME                                                                       \
+        {                                                                                         \
+            template <class X, class Y>                                                           \
+            auto operator()(const X& x, const Y& y) const -> decltype(x OP y)                     \
+            {                                                                                     \
+                return x OP y;                                                                    \
+            }                                                                                     \
+        };                                                                                        \
+    }                                                                                             \
+                                                                                                  \
+    template <class L, class R, class = typename detail::enable_array_function<L, R>::type>       \
+    inline detail::array_function_t<detail::array_##NAME, L, R> operator OP(const L& l, const R& r) \
+    {                                                                                             \
+        return detail::make_array_function<detail::array_##NAME>(l, r);                          \
+    }
+
+#define XSIMD_ARRAY_EXPR_UNARY_FUNCTION(NAME)                                                     \
+    namespace detail                                                                              \
+    {                                                                                             \
+        struct array_##NAME                                                                       \
+        {                                                                                         \
+            template <class X>                                                                    \
+            auto operator()(const X& x) const -> decltype(xsimd::NAME(x))                         \
+            {                                                                                     \
+                return xsimd::NAME(x);                                                            \
+            }                                                                                     \
+        };                                                                                        \
+    }                                                                                             \
+                                                                                                  \
+    template <class E>                                                                            \
+    inline array_function<detail::array_##NAME, E> NAME(const array_expr<E>& e)                  \
+    {                                                                                             \
+        return array_function<detail::array_##NAME, E>(e.derived_cast());                        \
+    }
+
+#define XSIMD_ARRAY_EXPR_BINARY_FUNCTION(NAME)                                                    \
+    namespace detail                                                                              \
+    {                                                                                             \
+        struct array_##NAME                                                                       \
+        {                                                                                         \
+            template <class X, class Y>                                                           \
+            auto operator()(const X& x, const Y& y) const -> decltype(xsimd::NAME(x, y))          \
+            {                                                                                     \
+                return xsimd::NAME(x, y);                                                         \
+            }                                                                                     \
+        };                                                                                        \
+    }                                                                                             \
+                                                                                                  \
+    template <class L, class R, class = typename detail::enable_array_function<L, R>::type>       \
+    inline detail::array_function_t<detail::array_##NAME, L, R> NAME(const L& l, const R& r)      \
+    {                                                                                             \
+        return detail::make_array_function<detail::array_##NAME>(l, r);                          \
+    }
+
+    XSIMD_ARRAY_EXPR_OPERATOR(plus, +)
+    XSIMD_ARRAY_EXPR_OPERATOR(minus, -)
+    XSIMD_ARRAY_EXPR_OPERATOR(multiplies, *)
+    XSIMD_ARRAY_EXPR_OPERATOR(divides, /)
+
+    namespace detail
+    {
+        struct array_negate
+        {
+            template <class X>
+            auto operator()(const X& x) const -> decltype(-x)
+            {
+                return -x;
+            }
+        };
+    }
+
+    template <class E>
+    inline array_function<detail::array_negate, E> operator-(const array_expr<E>& e)
+    {
+        return array_function<detail::array_negate, E>(e.derived_cast());
+    }
+
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(abs)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(sqrt)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(cbrt)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(exp)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(exp2)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(expm1)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(log)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(log2)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(log10)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(log1p)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(sin)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(cos)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(tan)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(asin)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(acos)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(atan)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(sinh)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(cosh)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(tanh)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(erf)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(floor)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(ceil)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(trunc)
+    XSIMD_ARRAY_EXPR_UNARY_FUNCTION(round)
+
+    XSIMD_ARRAY_EXPR_BINARY_FUNCTION(min)
+    XSIMD_ARRAY_EXPR_BINARY_FUNCTION(max)
+    XSIMD_ARRAY_EXPR_BINARY_FUNCTION(pow)
+    XSIMD_ARRAY_EXPR_BINARY_FUNCTION(atan2)
+    XSIMD_ARRAY_EXPR_BINARY_FUNCTION(hypot)
+
+    namespace detail
+    {
+        struct array_fma
+        {
+            template <class X, class Y, class Z>
+            auto operator()(const X& x, const Y& y, const Z& z) const -> decltype(xsimd::fma(x, y, z))
+            {
+                return xsimd::fma(x, y, z);
+            }
+        };
+    }
+
+    template <class X, class Y, class Z, class = typename detail::enable_array_function<X, Y, Z>::type>
+    inline detail::array_function_t<detail::array_fma, X, Y, Z> fma(const X& x, const Y& y, const Z& z)
+    {
+        return detail::make_array_function<detail::array_fma>(x, y, z);
+    }
+
+#undef XSIMD_ARRAY_EXPR_BINARY_FUNCTION
+#undef XSIMD_ARRAY_EXPR_UNARY_FUNCTION
+#undef XSIMD_ARRAY_EXPR_OPERATOR
+
+    /**************
+     * evaluation *
+     **************/
+
+    /**
+     * Computes the elements of the expression e into the array out, in a
+     * single loop aligned on out. out may be one of the arrays of e, the
+     * element i of out being written after the elements i of the operands
+     * have been read.
+     */
+    template <class E, class T>
+    inline void evaluate(const array_expr<E>& e, T* out)
+    {
+        using value_type = typename E::value_type;
+        constexpr std::size_t simd_size = simd_traits<value_type>::size;
+
+        E expr = e.derived_cast();
+        std::size_t size = expr.size();
+        std::size_t align_begin = xsimd::get_alignment_offset(out, size, simd_size);
+        std::size_t align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
+        expr.prepare(align_begin);
+
+        for (std::size_t i = 0; i < align_begin; ++i)
+        {
+            out[i] = expr[i];
+        }
+        for (std::size_t i = align_begin; i < align_end; i += simd_size)
+        {
+            xsimd::store_aligned(out + i, expr.load(i));
+        }
+        for (std::size_t i = align_end; i < size; ++i)
+        {
+            out[i] = expr[i];
+        }
+    }
+
+    /**
+     * Resizes the contiguous container c to the size of the expression e
+     * and computes the elements of e into it.
+     */
+    template <class C, class E>
+    inline void assign(C& c, const array_expr<E>& e)
+    {
+        c.resize(e.derived_cast().size());
+        evaluate(e, c.data());
+    }
+
+    /**
+     * Returns an aligned vector of the elements of the expression e.
+     */
+    template <class E>
+    inline std::vector<typename E::value_type, aligned_allocator<typename E::value_type>>
+    eval(const array_expr<E>& e)
+    {
+        std::vector<typename E::value_type, aligned_allocator<typename E::value_type>> res(e.derived_cast().size());
+        evaluate(e, res.data());
+        return res;
+    }
+}
+
+#endif
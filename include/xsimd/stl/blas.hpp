@@ -0,0 +1,1206 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_BLAS_HPP
+#define XSIMD_BLAS_HPP
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithms.hpp"
+
+namespace xsimd
+{
+    /****************
+     * BLAS level 1 *
+     ****************/
+
+    // The functions below work on contiguous arrays of n real or
+    // std::complex values. They are dispatched at runtime to the best
+    // architecture available among the ones the code is compiled for, and
+    // reductions are spread over several accumulators so that consecutive
+    // fused multiply-adds do not wait for each other.
+
+    template <class T>
+    T dot(const T* x, const T* y, std::size_t n);
+
+    template <class T>
+    T dotc(const T* x, const T* y, std::size_t n);
+
+    template <class T>
+    void axpy(const T& alpha, const T* x, T* y, std::size_t n);
+
+    template <class T>
+    void scal(const T& alpha, T* x, std::size_t n);
+
+    namespace detail
+    {
+        template <class T>
+        struct blas_real
+        {
+            using type = T;
+        };
+
+        template <class T>
+        struct blas_real<std::complex<T>>
+        {
+            using type = T;
+        };
+
+        template <class T>
+        using blas_real_t = typename blas_real<T>::type;
+    }
+
+    template <class T>
+    detail::blas_real_t<T> nrm2(const T* x, std::size_t n);
+
+    template <class T>
+    detail::blas_real_t<T> asum(const T* x, std::size_t n);
+
+    template <class T>
+    std::size_t iamax(const T* x, std::size_t n);
+
+    /****************
+     * BLAS level 3 *
+     ****************/
+
+    // Row-major matrix products built on a micro-kernel which keeps a
+    // block of C in registers, updated with a row of B times broadcast
+    // elements of A at each step.
+
+    template <std::size_t M, std::size_t N, std::size_t K, class T>
+    void gemm_small(const T* a, const T* b, T* c);
+
+    template <class T>
+    void gemm(std::size_t m, std::size_t n, std::size_t k, const T& alpha, const T* a, std::size_t lda,
+              const T* b, std::size_t ldb, const T& beta, T* c, std::size_t ldc);
+
+    /*******************************
+     * BLAS level 1 implementation *
+     *******************************/
+
+    namespace detail
+    {
+        // Complex batches hold as many elements as the batches of their
+        // real parts.
+        template <class T, class Arch>
+        struct blas_batch
+        {
+            using type = typename Arch::template batch<T>;
+        };
+
+        template <class T, class Arch>
+        struct blas_batch<std::complex<T>, Arch>
+        {
+            using type = batch<std::complex<T>, Arch::template batch<T>::size>;
+        };
+
+        template <class T, class Arch>
+        using blas_batch_t = typename blas_batch<T, Arch>::type;
+
+        template <class T, class Arch>
+        using blas_vectorized = std::integral_constant<bool, Arch::supported && !std::is_same<Arch, arch::scalar>::value &&
+                                                                 (simd_traits<T>::size > 1)>;
+
+        // Independent accumulators of the reductions
+        constexpr std::size_t blas_unroll = 4;
+
+        template <class B, class T>
+        inline B blas_load(const T* src)
+        {
+            B res;
+            res.load_unaligned(src);
+            return res;
+        }
+
+        template <class F, class... Args>
+        inline auto blas_dispatch_impl(F f, std::true_type, Args... args) -> decltype(f(arch::default_{}, args...))
+        {
+            return arch::dispatch(f)(args...);
+        }
+
+        template <class F, class... Args>
+        inline auto blas_dispatch_impl(F f, std::false_type, Args... args) -> decltype(f(arch::unavailable{}, args...))
+        {
+            return f(arch::unavailable{}, args...);
+        }
+
+        template <class F, class... Args>
+        inline auto blas_dispatch(F f, Args... args) -> decltype(f(arch::unavailable{}, args...))
+        {
+            return blas_dispatch_impl(f, std::integral_constant<bool, arch::default_::supported>(), args...);
+        }
+
+        template <bool Conj, class T>
+        inline T conj_if(const T& x)
+        {
+            return x;
+        }
+
+        template <bool Conj, class T>
+        inline std::complex<T> conj_if(const std::complex<T>& x)
+        {
+            return Conj ? std::conj(x) : x;
+        }
+
+        // |re| + |im| for complex values, as the BLAS i?amax
+        template <class T>
+        inline T blas_magnitude(const T& x)
+        {
+            return std::abs(x);
+        }
+
+        template <class T>
+        inline T blas_magnitude(const std::complex<T>& x)
+        {
+            return std::abs(x.real()) + std::abs(x.imag());
+        }
+
+        template <class T, std::size_t N>
+        inline batch<T, N> blas_magnitude(const batch<T, N>& x)
+        {
+            return abs(x);
+        }
+
+        template <class T, std::size_t N>
+        inline batch<T, N> blas_magnitude(const batch<std::complex<T>, N>& x)
+        {
+            return abs(x.real()) + abs(x.imag());
+        }
+
+        /*******
+         * dot *
+         *******/
+
+        template <class Arch, bool Conj, class T>
+        inline T dot_impl(const T* x, const T* y, std::size_t n, std::false_type)
+        {
+            T res(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                res += conj_if<Conj>(x[i]) * y[i];
+            }
+            return res;
+        }
+
+        template <class Arch, bool Conj, class T>
+        inline T dot_impl(const T* x, const T* y, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            constexpr std::size_t simd_size = batch_type::size;
+            constexpr std::size_t block = blas_unroll * simd_size;
+
+            batch_type acc[blas_unroll];
+            for (std::size_t u = 0; u < blas_unroll; ++u)
+            {
+                acc[u] = batch_type(T(0));
+            }
+            std::size_t i = 0;
+            for (; i + block <= n; i += block)
+            {
+                for (std::size_t u = 0; u < blas_unroll; ++u)
+                {
+                    std::size_t j = i + u * simd_size;
+                    acc[u] = fma(blas_load<batch_type>(x + j), blas_load<batch_type>(y + j), acc[u]);
+                }
+            }
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                acc[0] = fma(blas_load<batch_type>(x + i), blas_load<batch_type>(y + i), acc[0]);
+            }
+            T res = hadd((acc[0] + acc[1]) + (acc[2] + acc[3]));
+            for (; i < n; ++i)
+            {
+                res += x[i] * y[i];
+            }
+            return res;
+        }
+
+        // Accumulates the real and imaginary parts of conj_if<Conj>(x) * y
+        // separately, so that every step is a fused multiply-add.
+        template <bool Conj, class B, class R>
+        inline void complex_fma(const B& x, const B& y, R& re, R& im)
+        {
+            re = fma(x.real(), y.real(), re);
+            re = Conj ? fma(x.imag(), y.imag(), re) : fnma(x.imag(), y.imag(), re);
+            im = fma(x.real(), y.imag(), im);
+            im = Conj ? fnma(x.imag(), y.real(), im) : fma(x.imag(), y.real(), im);
+        }
+
+        template <class Arch, bool Conj, class T>
+        inline std::complex<T> dot_impl(const std::complex<T>* x, const std::complex<T>* y, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<std::complex<T>, Arch>;
+            using real_batch = typename batch_type::real_batch;
+            constexpr std::size_t simd_size = batch_type::size;
+            constexpr std::size_t block = blas_unroll * simd_size;
+
+            real_batch re[blas_unroll], im[blas_unroll];
+            for (std::size_t u = 0; u < blas_unroll; ++u)
+            {
+                re[u] = real_batch(T(0));
+                im[u] = real_batch(T(0));
+            }
+            std::size_t i = 0;
+            for (; i + block <= n; i += block)
+            {
+                for (std::size_t u = 0; u < blas_unroll; ++u)
+                {
+                    std::size_t j = i + u * simd_size;
+                    complex_fma<Conj>(blas_load<batch_type>(x + j), blas_load<batch_type>(y + j), re[u], im[u]);
+                }
+            }
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                complex_fma<Conj>(blas_load<batch_type>(x + i), blas_load<batch_type>(y + i), re[0], im[0]);
+            }
+            std::complex<T> res(hadd((re[0] + re[1]) + (re[2] + re[3])), hadd((im[0] + im[1]) + (im[2] + im[3])));
+            for (; i < n; ++i)
+            {
+                res += conj_if<Conj>(x[i]) * y[i];
+            }
+            return res;
+        }
+
+        template <bool Conj>
+        struct dot_kernel
+        {
+            template <class Arch, class T>
+            T operator()(Arch, const T* x, const T* y, std::size_t n) const
+            {
+                return dot_impl<Arch, Conj>(x, y, n, blas_vectorized<T, Arch>());
+            }
+        };
+
+        /********
+         * axpy *
+         ********/
+
+        template <class Arch, class T>
+        inline void axpy_impl(const T& alpha, const T* x, T* y, std::size_t n, std::false_type)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                y[i] += alpha * x[i];
+            }
+        }
+
+        template <class Arch, class T>
+        inline void axpy_impl(const T& alpha, const T* x, T* y, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            constexpr std::size_t simd_size = batch_type::size;
+
+            const batch_type a(alpha);
+            std::size_t i = 0;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                fma(a, blas_load<batch_type>(x + i), blas_load<batch_type>(y + i)).store_unaligned(y + i);
+            }
+            for (; i < n; ++i)
+            {
+                y[i] += alpha * x[i];
+            }
+        }
+
+        template <class Arch, class T>
+        inline void axpy_impl(const std::complex<T>& alpha, const std::complex<T>* x, std::complex<T>* y, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<std::complex<T>, Arch>;
+            using real_batch = typename batch_type::real_batch;
+            constexpr std::size_t simd_size = batch_type::size;
+
+            const real_batch a_re(alpha.real()), a_im(alpha.imag());
+            std::size_t i = 0;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                batch_type xb = blas_load<batch_type>(x + i);
+                batch_type yb = blas_load<batch_type>(y + i);
+                real_batch re = fnma(a_im, xb.imag(), fma(a_re, xb.real(), yb.real()));
+                real_batch im = fma(a_im, xb.real(), fma(a_re, xb.imag(), yb.imag()));
+                batch_type(re, im).store_unaligned(y + i);
+            }
+            for (; i < n; ++i)
+            {
+                y[i] += alpha * x[i];
+            }
+        }
+
+        struct axpy_kernel
+        {
+            template <class Arch, class T>
+            void operator()(Arch, const T& alpha, const T* x, T* y, std::size_t n) const
+            {
+                axpy_impl<Arch>(alpha, x, y, n, blas_vectorized<T, Arch>());
+            }
+        };
+
+        /********
+         * scal *
+         ********/
+
+        template <class Arch, class T>
+        inline void scal_impl(const T& alpha, T* x, std::size_t n, std::false_type)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                x[i] *= alpha;
+            }
+        }
+
+        template <class Arch, class T>
+        inline void scal_impl(const T& alpha, T* x, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            constexpr std::size_t simd_size = batch_type::size;
+
+            const batch_type a(alpha);
+            std::size_t i = 0;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                (a * blas_load<batch_type>(x + i)).store_unaligned(x + i);
+            }
+            for (; i < n; ++i)
+            {
+                x[i] *= alpha;
+            }
+        }
+
+        template <class Arch, class T>
+        inline void scal_impl(const std::complex<T>& alpha, std::complex<T>* x, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<std::complex<T>, Arch>;
+            using real_batch = typename batch_type::real_batch;
+            constexpr std::size_t simd_size = batch_type::size;
+
+            const real_batch a_re(alpha.real()), a_im(alpha.imag());
+            std::size_t i = 0;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                batch_type xb = blas_load<batch_type>(x + i);
+                real_batch re = fnma(a_im, xb.imag(), a_re * xb.real());
+                real_batch im = fma(a_im, xb.real(), a_re * xb.imag());
+                batch_type(re, im).store_unaligned(x + i);
+            }
+            for (; i < n; ++i)
+            {
+                x[i] *= alpha;
+            }
+        }
+
+        struct scal_kernel
+        {
+            template <class Arch, class T>
+            void operator()(Arch, const T& alpha, T* x, std::size_t n) const
+            {
+                scal_impl<Arch>(alpha, x, n, blas_vectorized<T, Arch>());
+            }
+        };
+
+        /**************
+         * nrm2, asum *
+         **************/
+
+        // The functions below work on the real and imaginary parts of
+        // complex arrays as on real arrays of 2n elements.
+
+        template <class Arch, class T>
+        inline T asum_impl(const T* x, std::size_t n, std::false_type)
+        {
+            T res(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                res += std::abs(x[i]);
+            }
+            return res;
+        }
+
+        template <class Arch, class T>
+        inline T asum_impl(const T* x, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            constexpr std::size_t simd_size = batch_type::size;
+            constexpr std::size_t block = blas_unroll * simd_size;
+
+            batch_type acc[blas_unroll];
+            for (std::size_t u = 0; u < blas_unroll; ++u)
+            {
+                acc[u] = batch_type(T(0));
+            }
+            std::size_t i = 0;
+            for (; i + block <= n; i += block)
+            {
+                for (std::size_t u = 0; u < blas_unroll; ++u)
+                {
+                    acc[u] += abs(blas_load<batch_type>(x + i + u * simd_size));
+                }
+            }
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                acc[0] += abs(blas_load<batch_type>(x + i));
+            }
+            T res = hadd((acc[0] + acc[1]) + (acc[2] + acc[3]));
+            for (; i < n; ++i)
+            {
+                res += std::abs(x[i]);
+            }
+            return res;
+        }
+
+        struct asum_kernel
+        {
+            template <class Arch, class T>
+            T operator()(Arch, const T* x, std::size_t n) const
+            {
+                return asum_impl<Arch>(x, n, blas_vectorized<T, Arch>());
+            }
+        };
+
+        // Sum of the squares of the elements, multiplied by s1 and s2 first
+        // when Scaled is true.
+        template <class Arch, bool Scaled, class T>
+        inline T sum_squares(const T* x, std::size_t n, T s1, T s2, std::false_type)
+        {
+            T res(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                T v = Scaled ? (x[i] * s1) * s2 : x[i];
+                res += v * v;
+            }
+            return res;
+        }
+
+        template <class Arch, bool Scaled, class T>
+        inline T sum_squares(const T* x, std::size_t n, T s1, T s2, std::true_type)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            constexpr std::size_t simd_size = batch_type::size;
+            constexpr std::size_t block = blas_unroll * simd_size;
+
+            const batch_type b1(s1), b2(s2);
+            batch_type acc[blas_unroll];
+            for (std::size_t u = 0; u < blas_unroll; ++u)
+            {
+                acc[u] = batch_type(T(0));
+            }
+            std::size_t i = 0;
+            for (; i + block <= n; i += block)
+            {
+                for (std::size_t u = 0; u < blas_unroll; ++u)
+                {
+                    batch_type v = blas_load<batch_type>(x + i + u * simd_size);
+                    if (Scaled)
+                    {
+                        v = (v * b1) * b2;
+                    }
+                    acc[u] = fma(v, v, acc[u]);
+                }
+            }
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                batch_type v = blas_load<batch_type>(x + i);
+                if (Scaled)
+                {
+                    v = (v * b1) * b2;
+                }
+                acc[0] = fma(v, v, acc[0]);
+            }
+            T res = hadd((acc[0] + acc[1]) + (acc[2] + acc[3]));
+            for (; i < n; ++i)
+            {
+                T v = Scaled ? (x[i] * s1) * s2 : x[i];
+                res += v * v;
+            }
+            return res;
+        }
+
+        template <class Arch, class T>
+        inline T max_abs(const T* x, std::size_t n, std::false_type)
+        {
+            T res(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                res = (std::max)(res, std::abs(x[i]));
+            }
+            return res;
+        }
+
+        template <class Arch, class T>
+        inline T max_abs(const T* x, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            constexpr std::size_t simd_size = batch_type::size;
+
+            batch_type acc(T(0));
+            std::size_t i = 0;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                acc = max(acc, abs(blas_load<batch_type>(x + i)));
+            }
+            T res = hmax(acc);
+            for (; i < n; ++i)
+            {
+                res = (std::max)(res, std::abs(x[i]));
+            }
+            return res;
+        }
+
+        // The plain sum of squares is used unless it overflows or is small
+        // enough for the squares to underflow. The elements are then scaled
+        // by a power of two bringing the largest one to [0.5, 1), split in
+        // two factors that are representable for any exponent.
+        struct nrm2_kernel
+        {
+            template <class Arch, class T>
+            T operator()(Arch, const T* x, std::size_t n) const
+            {
+                using vectorized = blas_vectorized<T, Arch>;
+                T ssq = sum_squares<Arch, false>(x, n, T(1), T(1), vectorized());
+                const T tiny = static_cast<T>(n) * ((std::numeric_limits<T>::min)() / std::numeric_limits<T>::epsilon());
+                if (std::isfinite(ssq) && ssq >= tiny)
+                {
+                    return std::sqrt(ssq);
+                }
+                if (std::isnan(ssq))
+                {
+                    return ssq;
+                }
+                T amax = max_abs<Arch>(x, n, vectorized());
+                if (amax == T(0) || std::isinf(amax))
+                {
+                    return amax;
+                }
+                int e;
+                std::frexp(amax, &e);
+                T s1 = std::ldexp(T(1), -e / 2);
+                T s2 = std::ldexp(T(1), -e - (-e / 2));
+                ssq = sum_squares<Arch, true>(x, n, s1, s2, vectorized());
+                return std::ldexp(std::sqrt(ssq), e);
+            }
+        };
+
+        /*********
+         * iamax *
+         *********/
+
+        template <class Arch, class T>
+        inline std::size_t iamax_impl(const T* x, std::size_t n, std::false_type)
+        {
+            std::size_t best = 0;
+            auto best_value = blas_magnitude(x[0]);
+            for (std::size_t i = 1; i < n; ++i)
+            {
+                auto value = blas_magnitude(x[i]);
+                if (best_value < value)
+                {
+                    best = i;
+                    best_value = value;
+                }
+            }
+            return best;
+        }
+
+        // Per-lane largest magnitude and block index, merged across lanes
+        // at the end, as in extremum_index_body.
+        template <class Arch, class T>
+        inline std::size_t iamax_impl(const T* x, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            using real_type = blas_real_t<T>;
+            using real_batch = decltype(blas_magnitude(std::declval<batch_type>()));
+            using index_traits = lane_integer_traits<real_type>;
+            using index_type = typename index_traits::integer_type;
+            constexpr std::size_t simd_size = batch_type::size;
+            using index_batch = batch<index_type, simd_size>;
+
+            if (n < simd_size)
+            {
+                return iamax_impl<Arch>(x, n, std::false_type());
+            }
+
+            real_batch best_batch = blas_magnitude(blas_load<batch_type>(x));
+            index_batch best_block(index_type(0));
+            index_type block = 1;
+            std::size_t i = simd_size;
+            for (; i + simd_size <= n; i += simd_size, ++block)
+            {
+                real_batch current = blas_magnitude(blas_load<batch_type>(x + i));
+                auto cond = best_batch < current;
+                best_batch = select(cond, current, best_batch);
+                best_block = select(index_traits::mask(cond), index_batch(block), best_block);
+            }
+
+            alignas(real_batch) real_type values[simd_size];
+            alignas(index_batch) index_type blocks[simd_size];
+            best_batch.store_aligned(values);
+            best_block.store_aligned(blocks);
+            std::size_t best = static_cast<std::size_t>(blocks[0]) * simd_size;
+            real_type best_value = values[0];
+            for (std::size_t j = 1; j < simd_size; ++j)
+            {
+                std::size_t index = static_cast<std::size_t>(blocks[j]) * simd_size + j;
+                if (best_value < values[j] || (!(values[j] < best_value) && index < best))
+                {
+                    best = index;
+                    best_value = values[j];
+                }
+            }
+            for (; i < n; ++i)
+            {
+                real_type value = blas_magnitude(x[i]);
+                if (best_value < value)
+                {
+                    best = i;
+                    best_value = value;
+                }
+            }
+            return best;
+        }
+
+        struct iamax_kernel
+        {
+            template <class Arch, class T>
+            std::size_t operator()(Arch, const T* x, std::size_t n) const
+            {
+                return iamax_impl<Arch>(x, n, blas_vectorized<T, Arch>());
+            }
+        };
+
+        template <class T>
+        struct is_blas_floating_point : std::is_floating_point<T>
+        {
+        };
+
+        template <class T>
+        struct is_blas_floating_point<std::complex<T>> : std::is_floating_point<T>
+        {
+        };
+
+        // Number of real values in an array of n values of type T
+        template <class T>
+        inline std::size_t blas_real_size(std::size_t n)
+        {
+            return n * (sizeof(T) / sizeof(blas_real_t<T>));
+        }
+    }
+
+    /**
+     * Returns the sum of the products x[i] * y[i] for i in [0, n). Complex
+     * values are not conjugated, see dotc.
+     */
+    template <class T>
+    T dot(const T* x, const T* y, std::size_t n)
+    {
+        return detail::blas_dispatch(detail::dot_kernel<false>{}, x, y, n);
+    }
+
+    /**
+     * Returns the sum of the products conj(x[i]) * y[i] for i in [0, n),
+     * which is the same as dot for real values.
+     */
+    template <class T>
+    T dotc(const T* x, const T* y, std::size_t n)
+    {
+        return detail::blas_dispatch(detail::dot_kernel<true>{}, x, y, n);
+    }
+
+    /**
+     * Computes y[i] += alpha * x[i] for i in [0, n).
+     */
+    template <class T>
+    void axpy(const T& alpha, const T* x, T* y, std::size_t n)
+    {
+        detail::blas_dispatch(detail::axpy_kernel{}, alpha, x, y, n);
+    }
+
+    /**
+     * Computes x[i] *= alpha for i in [0, n).
+     */
+    template <class T>
+    void scal(const T& alpha, T* x, std::size_t n)
+    {
+        detail::blas_dispatch(detail::scal_kernel{}, alpha, x, n);
+    }
+
+    /**
+     * Returns the euclidean norm of [x, x + n), without overflow or
+     * underflow in the intermediate sum of squares.
+     */
+    template <class T>
+    detail::blas_real_t<T> nrm2(const T* x, std::size_t n)
+    {
+        static_assert(detail::is_blas_floating_point<T>::value, "nrm2 requires floating point or complex values");
+        using real_type = detail::blas_real_t<T>;
+        return detail::blas_dispatch(detail::nrm2_kernel{}, reinterpret_cast<const real_type*>(x), detail::blas_real_size<T>(n));
+    }
+
+    /**
+     * Returns the sum of the absolute values of [x, x + n), or of the
+     * absolute values of the real and imaginary parts for complex values.
+     */
+    template <class T>
+    detail::blas_real_t<T> asum(const T* x, std::size_t n)
+    {
+        static_assert(detail::is_blas_floating_point<T>::value, "asum requires floating point or complex values");
+        using real_type = detail::blas_real_t<T>;
+        return detail::blas_dispatch(detail::asum_kernel{}, reinterpret_cast<const real_type*>(x), detail::blas_real_size<T>(n));
+    }
+
+    /**
+     * Returns the index of the first element of [x, x + n) with the largest
+     * absolute value, or the largest |re| + |im| for complex values; 0 if
+     * n is 0.
+     */
+    template <class T>
+    std::size_t iamax(const T* x, std::size_t n)
+    {
+        static_assert(detail::is_blas_floating_point<T>::value, "iamax requires floating point or complex values");
+        if (n == 0)
+        {
+            return 0;
+        }
+        return detail::blas_dispatch(detail::iamax_kernel{}, x, n);
+    }
+
+    /*******************************
+     * BLAS level 3 implementation *
+     *******************************/
+
+    namespace detail
+    {
+        // Accumulation of a * b into a batch of C; complex accumulators
+        // keep their real and imaginary parts apart, as in dot.
+        template <class B>
+        struct gemm_ops
+        {
+            using value_type = typename B::value_type;
+            using acc_type = B;
+
+            static acc_type zero()
+            {
+                return B(value_type(0));
+            }
+
+            static void update(acc_type& acc, const value_type& a, const B& b)
+            {
+                acc = fma(B(a), b, acc);
+            }
+
+            static B result(const acc_type& acc)
+            {
+                return acc;
+            }
+        };
+
+        template <class T, std::size_t N>
+        struct gemm_ops<batch<std::complex<T>, N>>
+        {
+            using batch_type = batch<std::complex<T>, N>;
+            using real_batch = typename batch_type::real_batch;
+            using value_type = std::complex<T>;
+
+            struct acc_type
+            {
+                real_batch re;
+                real_batch im;
+            };
+
+            static acc_type zero()
+            {
+                return { real_batch(T(0)), real_batch(T(0)) };
+            }
+
+            static void update(acc_type& acc, const value_type& a, const batch_type& b)
+            {
+                complex_fma<false>(batch_type(a), b, acc.re, acc.im);
+            }
+
+            static batch_type result(const acc_type& acc)
+            {
+                return batch_type(acc.re, acc.im);
+            }
+        };
+
+        // Rows of the register block, 4 for matrices read in place and 6
+        // for packed ones, and batches of columns: complex accumulators
+        // take twice as many registers.
+        constexpr std::size_t gemm_mr = 4;
+        constexpr std::size_t gemm_packed_mr = 6;
+
+        template <class T>
+        struct gemm_nb : std::integral_constant<std::size_t, 2>
+        {
+        };
+
+        template <class T>
+        struct gemm_nb<std::complex<T>> : std::integral_constant<std::size_t, 1>
+        {
+        };
+
+        // Cache blocking of the packed product: a KC x NC panel of B stays
+        // in the L3 cache, an MC x KC block of A in the L2 cache.
+        constexpr std::size_t gemm_kc = 256;
+        constexpr std::size_t gemm_mc = 128;
+        constexpr std::size_t gemm_nc = 4096;
+
+        template <class T>
+        inline void gemm_store(T* dst, const T& alpha, const T& res, const T& beta)
+        {
+            *dst = beta == T(0) ? alpha * res : alpha * res + beta * *dst;
+        }
+
+        // C = alpha * A * B + beta * C on MR rows and NB batches of
+        // columns, where A(r, p) is a[r * rs_a + p * cs_a] and the row p of
+        // B starts at b + p * ldb. C is not read when beta is zero.
+        template <std::size_t MR, std::size_t NB, class B>
+        inline void gemm_micro_kernel(std::size_t k, const typename B::value_type* a, std::size_t rs_a, std::size_t cs_a,
+                                      const typename B::value_type* b, std::size_t ldb,
+                                      const typename B::value_type& alpha, const typename B::value_type& beta,
+                                      typename B::value_type* c, std::size_t ldc)
+        {
+            using ops = gemm_ops<B>;
+            using value_type = typename B::value_type;
+            constexpr std::size_t simd_size = B::size;
+
+            typename ops::acc_type acc[MR][NB];
+            for (std::size_t r = 0; r < MR; ++r)
+            {
+                for (std::size_t j = 0; j < NB; ++j)
+                {
+                    acc[r][j] = ops::zero();
+                }
+            }
+            // explicitly unrolled, so that the accumulators stay in registers
+            for (std::size_t p = 0; p < k; ++p)
+            {
+                B row[NB];
+                unroller<NB>([&](std::size_t j) {
+                    row[j] = blas_load<B>(b + p * ldb + j * simd_size);
+                });
+                unroller<MR>([&](std::size_t r) {
+                    const value_type av = a[r * rs_a + p * cs_a];
+                    unroller<NB>([&](std::size_t j) {
+                        ops::update(acc[r][j], av, row[j]);
+                    });
+                });
+            }
+
+            const B alpha_batch(alpha), beta_batch(beta);
+            for (std::size_t r = 0; r < MR; ++r)
+            {
+                for (std::size_t j = 0; j < NB; ++j)
+                {
+                    value_type* dst = c + r * ldc + j * simd_size;
+                    B res = alpha_batch * ops::result(acc[r][j]);
+                    if (beta != value_type(0))
+                    {
+                        res += beta_batch * blas_load<B>(dst);
+                    }
+                    res.store_unaligned(dst);
+                }
+            }
+        }
+
+        template <class T>
+        inline void gemm_naive(std::size_t m, std::size_t n, std::size_t k, const T& alpha, const T* a, std::size_t lda,
+                               const T* b, std::size_t ldb, const T& beta, T* c, std::size_t ldc)
+        {
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    T res(0);
+                    for (std::size_t p = 0; p < k; ++p)
+                    {
+                        res += a[i * lda + p] * b[p * ldb + j];
+                    }
+                    gemm_store(c + i * ldc + j, alpha, res, beta);
+                }
+            }
+        }
+
+        // MR rows of C, column blocks of NB batches, then single batches,
+        // then scalars.
+        template <std::size_t MR, std::size_t NB, class B>
+        inline void gemm_rows(std::size_t n, std::size_t k, const typename B::value_type* a, std::size_t lda,
+                              const typename B::value_type* b, std::size_t ldb,
+                              const typename B::value_type& alpha, const typename B::value_type& beta,
+                              typename B::value_type* c, std::size_t ldc)
+        {
+            constexpr std::size_t simd_size = B::size;
+            std::size_t j = 0;
+            for (; j + NB * simd_size <= n; j += NB * simd_size)
+            {
+                gemm_micro_kernel<MR, NB, B>(k, a, lda, 1, b + j, ldb, alpha, beta, c + j, ldc);
+            }
+            for (; j + simd_size <= n; j += simd_size)
+            {
+                gemm_micro_kernel<MR, 1, B>(k, a, lda, 1, b + j, ldb, alpha, beta, c + j, ldc);
+            }
+            gemm_naive(MR, n - j, k, alpha, a, lda, b + j, ldb, beta, c + j, ldc);
+        }
+
+        template <std::size_t MR, std::size_t NB, class B>
+        struct gemm_tail_rows
+        {
+            template <class... Args>
+            static void run(Args... args)
+            {
+                gemm_rows<MR, NB, B>(args...);
+            }
+        };
+
+        template <std::size_t NB, class B>
+        struct gemm_tail_rows<0, NB, B>
+        {
+            template <class... Args>
+            static void run(Args...)
+            {
+            }
+        };
+
+        // Widest batch of the real parts of T not wider than N columns,
+        // down to 128 bits.
+        template <class R, std::size_t N, std::size_t W, bool = (W <= N || W * sizeof(R) <= 16)>
+        struct gemm_small_width : std::integral_constant<std::size_t, W>
+        {
+        };
+
+        template <class R, std::size_t N, std::size_t W>
+        struct gemm_small_width<R, N, W, false> : gemm_small_width<R, N, W / 2>
+        {
+        };
+
+        template <class T, std::size_t N>
+        struct gemm_small_batch
+        {
+            using real_type = blas_real_t<T>;
+            static constexpr std::size_t width = gemm_small_width<real_type, N, simd_traits<real_type>::size>::value;
+            using type = typename std::conditional<std::is_same<T, real_type>::value,
+                                                   batch<real_type, width>,
+                                                   batch<std::complex<real_type>, width>>::type;
+            static constexpr bool vectorized = width > 1 && width <= N;
+        };
+
+        template <std::size_t M, std::size_t N, std::size_t K, class T>
+        inline void gemm_small_impl(const T* a, const T* b, T* c, std::true_type)
+        {
+            using batch_type = typename gemm_small_batch<T, N>::type;
+            constexpr std::size_t nb = gemm_nb<T>::value;
+            const T one(1), zero(0);
+            std::size_t i = 0;
+            for (; i + gemm_mr <= M; i += gemm_mr)
+            {
+                gemm_rows<gemm_mr, nb, batch_type>(N, K, a + i * K, K, b, N, one, zero, c + i * N, N);
+            }
+            gemm_tail_rows<M % gemm_mr, nb, batch_type>::run(N, K, a + i * K, K, b, N, one, zero, c + i * N, N);
+        }
+
+        template <std::size_t M, std::size_t N, std::size_t K, class T>
+        inline void gemm_small_impl(const T* a, const T* b, T* c, std::false_type)
+        {
+            gemm_naive(M, N, K, T(1), a, K, b, N, T(0), c, N);
+        }
+
+        // Rows of A by strips of MR, stored column by column, and zero
+        // padded to MR rows.
+        template <std::size_t MR, class T>
+        inline void gemm_pack_a(std::size_t mc, std::size_t kc, const T* a, std::size_t lda, T* dst)
+        {
+            for (std::size_t i = 0; i < mc; i += MR)
+            {
+                std::size_t rows = (std::min)(MR, mc - i);
+                for (std::size_t p = 0; p < kc; ++p)
+                {
+                    for (std::size_t r = 0; r < MR; ++r)
+                    {
+                        *dst++ = r < rows ? a[(i + r) * lda + p] : T(0);
+                    }
+                }
+            }
+        }
+
+        // Columns of B by strips of NR, stored row by row, and zero padded
+        // to NR columns.
+        template <std::size_t NR, class T>
+        inline void gemm_pack_b(std::size_t kc, std::size_t nc, const T* b, std::size_t ldb, T* dst)
+        {
+            for (std::size_t j = 0; j < nc; j += NR)
+            {
+                std::size_t cols = (std::min)(NR, nc - j);
+                for (std::size_t p = 0; p < kc; ++p)
+                {
+                    const T* src = b + p * ldb + j;
+                    for (std::size_t q = 0; q < NR; ++q)
+                    {
+                        *dst++ = q < cols ? src[q] : T(0);
+                    }
+                }
+            }
+        }
+
+        template <class Arch, class T>
+        inline void gemm_impl(std::size_t m, std::size_t n, std::size_t k, const T& alpha, const T* a, std::size_t lda,
+                              const T* b, std::size_t ldb, const T& beta, T* c, std::size_t ldc, std::false_type)
+        {
+            gemm_naive(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        }
+
+        // Small products do not amortize the packing: the micro-kernel
+        // then reads A and B in place.
+        constexpr std::size_t gemm_unpacked_max = 128 * 128 * 128;
+
+        template <class Arch, class T>
+        inline void gemm_unpacked(std::size_t m, std::size_t n, std::size_t k, const T& alpha, const T* a, std::size_t lda,
+                                  const T* b, std::size_t ldb, const T& beta, T* c, std::size_t ldc)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            constexpr std::size_t nb = gemm_nb<T>::value;
+            std::size_t i = 0;
+            for (; i + gemm_mr <= m; i += gemm_mr)
+            {
+                gemm_rows<gemm_mr, nb, batch_type>(n, k, a + i * lda, lda, b, ldb, alpha, beta, c + i * ldc, ldc);
+            }
+            switch (m - i)
+            {
+            case 3:
+                gemm_rows<3, nb, batch_type>(n, k, a + i * lda, lda, b, ldb, alpha, beta, c + i * ldc, ldc);
+                break;
+            case 2:
+                gemm_rows<2, nb, batch_type>(n, k, a + i * lda, lda, b, ldb, alpha, beta, c + i * ldc, ldc);
+                break;
+            case 1:
+                gemm_rows<1, nb, batch_type>(n, k, a + i * lda, lda, b, ldb, alpha, beta, c + i * ldc, ldc);
+                break;
+            default:
+                break;
+            }
+        }
+
+        // The micro-kernel runs on packed strips of A and B, which are
+        // contiguous and padded: partial blocks of C go through a
+        // temporary tile.
+        template <class Arch, class T>
+        inline void gemm_impl(std::size_t m, std::size_t n, std::size_t k, const T& alpha, const T* a, std::size_t lda,
+                              const T* b, std::size_t ldb, const T& beta, T* c, std::size_t ldc, std::true_type)
+        {
+            using batch_type = blas_batch_t<T, Arch>;
+            using buffer_type = std::vector<T, aligned_allocator<T, Arch::alignment>>;
+            constexpr std::size_t mr = gemm_packed_mr;
+            constexpr std::size_t nb = gemm_nb<T>::value;
+            constexpr std::size_t nr = nb * batch_type::size;
+            constexpr std::size_t mc_block = gemm_mc / mr * mr;
+
+            if (k == 0)
+            {
+                gemm_naive(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+                return;
+            }
+            if (m * n * k <= gemm_unpacked_max)
+            {
+                gemm_unpacked<Arch>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+                return;
+            }
+
+            const std::size_t kc_max = (std::min)(k, gemm_kc);
+            const std::size_t mc_max = (std::min)((m + mr - 1) / mr * mr, mc_block);
+            const std::size_t nc_max = (std::min)((n + nr - 1) / nr * nr, gemm_nc);
+            buffer_type a_pack(mc_max * kc_max), b_pack(kc_max * nc_max), tile(mr * nr);
+
+            for (std::size_t jc = 0; jc < n; jc += gemm_nc)
+            {
+                const std::size_t nc = (std::min)(gemm_nc, n - jc);
+                for (std::size_t pc = 0; pc < k; pc += gemm_kc)
+                {
+                    const std::size_t kc = (std::min)(gemm_kc, k - pc);
+                    const T beta_block = pc == 0 ? beta : T(1);
+                    gemm_pack_b<nr>(kc, nc, b + pc * ldb + jc, ldb, b_pack.data());
+                    for (std::size_t ic = 0; ic < m; ic += mc_block)
+                    {
+                        const std::size_t mc = (std::min)(mc_block, m - ic);
+                        gemm_pack_a<mr>(mc, kc, a + ic * lda + pc, lda, a_pack.data());
+                        for (std::size_t jr = 0; jr < nc; jr += nr)
+                        {
+                            const std::size_t cols = (std::min)(nr, nc - jr);
+                            const T* b_strip = b_pack.data() + jr * kc;
+                            for (std::size_t ir = 0; ir < mc; ir += mr)
+                            {
+                                const std::size_t rows = (std::min)(mr, mc - ir);
+                                const T* a_strip = a_pack.data() + ir * kc;
+                                T* c_block = c + (ic + ir) * ldc + jc + jr;
+                                if (rows == mr && cols == nr)
+                                {
+                                    gemm_micro_kernel<mr, nb, batch_type>(kc, a_strip, 1, mr, b_strip, nr, alpha, beta_block, c_block, ldc);
+                                }
+                                else
+                                {
+                                    gemm_micro_kernel<mr, nb, batch_type>(kc, a_strip, 1, mr, b_strip, nr, alpha, T(0), tile.data(), nr);
+                                    for (std::size_t r = 0; r < rows; ++r)
+                                    {
+                                        for (std::size_t q = 0; q < cols; ++q)
+                                        {
+                                            gemm_store(c_block + r * ldc + q, T(1), tile[r * nr + q], beta_block);
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        struct gemm_kernel
+        {
+            template <class Arch, class T>
+            void operator()(Arch, std::size_t m, std::size_t n, std::size_t k, const T& alpha, const T* a, std::size_t lda,
+                            const T* b, std::size_t ldb, const T& beta, T* c, std::size_t ldc) const
+            {
+                gemm_impl<Arch>(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, blas_vectorized<T, Arch>());
+            }
+        };
+    }
+
+    /**
+     * Computes C = A * B for the row-major M x K matrix A, K x N matrix B
+     * and M x N matrix C, with sizes known at compile time. The product is
+     * computed with the widest batches not wider than a row of C, without
+     * packing nor runtime dispatch, for small matrices.
+     */
+    template <std::size_t M, std::size_t N, std::size_t K, class T>
+    void gemm_small(const T* a, const T* b, T* c)
+    {
+        using vectorized = std::integral_constant<bool, detail::gemm_small_batch<T, N>::vectorized>;
+        detail::gemm_small_impl<M, N, K>(a, b, c, vectorized());
+    }
+
+    /**
+     * Computes C = alpha * A * B + beta * C for the row-major m x k matrix
+     * A, k x n matrix B and m x n matrix C, whose rows start every lda,
+     * ldb and ldc elements. C is not read when beta is zero.
+     */
+    template <class T>
+    void gemm(std::size_t m, std::size_t n, std::size_t k, const T& alpha, const T* a, std::size_t lda,
+              const T* b, std::size_t ldb, const T& beta, T* c, std::size_t ldc)
+    {
+        if (m == 0 || n == 0)
+        {
+            return;
+        }
+        detail::blas_dispatch(detail::gemm_kernel{}, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
+}
+
+#endif
@@ -0,0 +1,1001 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_FFT_HPP
+#define XSIMD_FFT_HPP
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "blas.hpp"
+#include "split_complex.hpp"
+
+namespace xsimd
+{
+    /************
+     * fft_plan *
+     ************/
+
+    namespace detail
+    {
+        struct fft_kernel;
+
+        struct fft_stage
+        {
+            std::size_t radix;
+            // distance between the elements of a butterfly in the output
+            std::size_t stride;
+            // number of butterflies sharing a stride
+            std::size_t count;
+            std::size_t twiddle_offset;
+            std::size_t root_offset;
+        };
+    }
+
+    /**
+     * Discrete Fourier transform of a given size n, of any factorization:
+     * the radix 4, 2 and 3 butterflies are specialized, the other prime
+     * factors are computed in O(p) operations per element. The transform
+     * runs a Stockham stage per factor over separate real and imaginary
+     * arrays, where the butterflies are vectorized over the elements
+     * which share their twiddle factors, and interleaved values are
+     * split before and merged after the transform.
+     *
+     * The forward transform computes X[k] = sum of x[j] * exp(-2i * pi * j * k / n)
+     * and the inverse transform is scaled by 1 / n, so that it inverts the
+     * forward one. A plan is not modified by the transforms and may be
+     * shared by several threads.
+     */
+    template <class T>
+    class fft_plan
+    {
+    public:
+
+        using real_type = T;
+        using value_type = std::complex<T>;
+        using size_type = std::size_t;
+
+        explicit fft_plan(size_type n);
+
+        static const fft_plan& cached(size_type n);
+
+        size_type size() const noexcept;
+
+        void forward(const value_type* in, value_type* out) const;
+        void inverse(const value_type* in, value_type* out) const;
+
+        void forward(const real_type* in_real, const real_type* in_imag, real_type* out_real, real_type* out_imag) const;
+        void inverse(const real_type* in_real, const real_type* in_imag, real_type* out_real, real_type* out_imag) const;
+
+    private:
+
+        using buffer_type = std::vector<real_type, aligned_allocator<real_type>>;
+
+        template <class Arch>
+        void run(const real_type* in_real, const real_type* in_imag, real_type* out_real, real_type* out_imag,
+                 real_type* work) const;
+
+        template <class Arch>
+        void transform(const value_type* in, value_type* out, bool inverse) const;
+
+        template <class Arch>
+        void transform(const real_type* in_real, const real_type* in_imag, real_type* out_real, real_type* out_imag,
+                       bool inverse) const;
+
+        static buffer_type& workspace(size_type size);
+
+        size_type m_size;
+        std::vector<detail::fft_stage> m_stages;
+        // twiddle factors w^(i * k) of each stage, for k in [1, radix)
+        buffer_type m_twiddle_real;
+        buffer_type m_twiddle_imag;
+        // roots of unity of the generic radices
+        buffer_type m_root_real;
+        buffer_type m_root_imag;
+
+        friend struct detail::fft_kernel;
+    };
+
+    /**
+     * Fourier transform of n real values, whose n / 2 + 1 first outputs
+     * are computed. An even size is transformed by a complex transform of
+     * size n / 2 whose input holds the even values in its real part and
+     * the odd values in its imaginary part, an odd size by a complex
+     * transform of size n.
+     */
+    template <class T>
+    class rfft_plan
+    {
+    public:
+
+        using real_type = T;
+        using value_type = std::complex<T>;
+        using size_type = std::size_t;
+
+        explicit rfft_plan(size_type n);
+
+        static const rfft_plan& cached(size_type n);
+
+        size_type size() const noexcept;
+
+        void forward(const real_type* in, value_type* out) const;
+        void inverse(const value_type* in, real_type* out) const;
+
+    private:
+
+        using buffer_type = std::vector<real_type, aligned_allocator<real_type>>;
+
+        size_type m_size;
+        const fft_plan<T>& m_plan;
+        // exp(-2i * pi * k / n) for k in [0, n / 2)
+        buffer_type m_twiddle_real;
+        buffer_type m_twiddle_imag;
+    };
+
+    template <class T>
+    void fft(const std::complex<T>* in, std::complex<T>* out, std::size_t n);
+
+    template <class T>
+    void ifft(const std::complex<T>* in, std::complex<T>* out, std::size_t n);
+
+    template <class T>
+    void fft(const T* in_real, const T* in_imag, T* out_real, T* out_imag, std::size_t n);
+
+    template <class T>
+    void ifft(const T* in_real, const T* in_imag, T* out_real, T* out_imag, std::size_t n);
+
+    template <class T, class A>
+    void fft(const split_complex_vector<T, A>& in, split_complex_vector<T, A>& out);
+
+    template <class T, class A>
+    void ifft(const split_complex_vector<T, A>& in, split_complex_vector<T, A>& out);
+
+    template <class T>
+    void rfft(const T* in, std::complex<T>* out, std::size_t n);
+
+    template <class T>
+    void irfft(const std::complex<T>* in, T* out, std::size_t n);
+
+    /*****************************
+     * fft kernel implementation *
+     *****************************/
+
+    namespace detail
+    {
+        // Arithmetic shared by the scalar and the vectorized butterflies,
+        // V being T or a batch of T.
+        template <class V>
+        struct fft_complex
+        {
+            V re;
+            V im;
+        };
+
+        template <class V>
+        inline fft_complex<V> operator+(const fft_complex<V>& lhs, const fft_complex<V>& rhs)
+        {
+            return { lhs.re + rhs.re, lhs.im + rhs.im };
+        }
+
+        template <class V>
+        inline fft_complex<V> operator-(const fft_complex<V>& lhs, const fft_complex<V>& rhs)
+        {
+            return { lhs.re - rhs.re, lhs.im - rhs.im };
+        }
+
+        template <class T>
+        inline T fft_fma(const T& x, const T& y, const T& z)
+        {
+            return x * y + z;
+        }
+
+        template <class T, std::size_t N>
+        inline batch<T, N> fft_fma(const batch<T, N>& x, const batch<T, N>& y, const batch<T, N>& z)
+        {
+            return fma(x, y, z);
+        }
+
+        template <class T>
+        inline T fft_fms(const T& x, const T& y, const T& z)
+        {
+            return x * y - z;
+        }
+
+        template <class T, std::size_t N>
+        inline batch<T, N> fft_fms(const batch<T, N>& x, const batch<T, N>& y, const batch<T, N>& z)
+        {
+            return fms(x, y, z);
+        }
+
+        // a * (wr + i * wi)
+        template <class V, class T>
+        inline fft_complex<V> fft_mul(const fft_complex<V>& a, const T& wr, const T& wi)
+        {
+            V vr(wr), vi(wi);
+            return { fft_fms(a.re, vr, a.im * vi), fft_fma(a.re, vi, a.im * vr) };
+        }
+
+        // acc + a * (wr + i * wi)
+        template <class V, class T>
+        inline fft_complex<V> fft_mul_add(const fft_complex<V>& a, const T& wr, const T& wi, const fft_complex<V>& acc)
+        {
+            V vr(wr), vi(wi);
+            return { fft_fma(a.re, vr, fft_fma(-a.im, vi, acc.re)), fft_fma(a.re, vi, fft_fma(a.im, vr, acc.im)) };
+        }
+
+        template <class V, class T>
+        inline typename std::enable_if<std::is_same<V, T>::value, fft_complex<V>>::type
+        fft_load(const T* re, const T* im)
+        {
+            return { *re, *im };
+        }
+
+        template <class V, class T>
+        inline typename std::enable_if<!std::is_same<V, T>::value, fft_complex<V>>::type
+        fft_load(const T* re, const T* im)
+        {
+            return { blas_load<V>(re), blas_load<V>(im) };
+        }
+
+        template <class T>
+        inline void fft_store(T* re, T* im, const fft_complex<T>& x)
+        {
+            *re = x.re;
+            *im = x.im;
+        }
+
+        template <class T, std::size_t N>
+        inline void fft_store(T* re, T* im, const fft_complex<batch<T, N>>& x)
+        {
+            x.re.store_unaligned(re);
+            x.im.store_unaligned(im);
+        }
+
+        // The butterflies read the radix inputs every in_stride elements,
+        // and write the radix outputs multiplied by the twiddle factors of
+        // wr and wi every out_stride elements.
+
+        struct fft_radix2
+        {
+            template <class V, class T>
+            void run(const T* xr, const T* xi, T* yr, T* yi, std::size_t in_stride, std::size_t out_stride,
+                     const T* wr, const T* wi) const
+            {
+                fft_complex<V> a0 = fft_load<V>(xr, xi);
+                fft_complex<V> a1 = fft_load<V>(xr + in_stride, xi + in_stride);
+                fft_store(yr, yi, a0 + a1);
+                fft_store(yr + out_stride, yi + out_stride, fft_mul(a0 - a1, wr[0], wi[0]));
+            }
+        };
+
+        struct fft_radix3
+        {
+            template <class V, class T>
+            void run(const T* xr, const T* xi, T* yr, T* yi, std::size_t in_stride, std::size_t out_stride,
+                     const T* wr, const T* wi) const
+            {
+                // sin(2 * pi / 3)
+                const V c(T(0.866025403784438646763723170752936183L));
+                const V half(T(0.5));
+                fft_complex<V> a0 = fft_load<V>(xr, xi);
+                fft_complex<V> a1 = fft_load<V>(xr + in_stride, xi + in_stride);
+                fft_complex<V> a2 = fft_load<V>(xr + 2 * in_stride, xi + 2 * in_stride);
+                fft_complex<V> t1 = a1 + a2;
+                fft_complex<V> t2 = { fft_fma(-half, t1.re, a0.re), fft_fma(-half, t1.im, a0.im) };
+                fft_complex<V> d = a1 - a2;
+                // -i * c * d
+                fft_complex<V> t3 = { c * d.im, -(c * d.re) };
+                fft_store(yr, yi, a0 + t1);
+                fft_store(yr + out_stride, yi + out_stride, fft_mul(t2 + t3, wr[0], wi[0]));
+                fft_store(yr + 2 * out_stride, yi + 2 * out_stride, fft_mul(t2 - t3, wr[1], wi[1]));
+            }
+        };
+
+        struct fft_radix4
+        {
+            template <class V, class T>
+            void run(const T* xr, const T* xi, T* yr, T* yi, std::size_t in_stride, std::size_t out_stride,
+                     const T* wr, const T* wi) const
+            {
+                fft_complex<V> a0 = fft_load<V>(xr, xi);
+                fft_complex<V> a1 = fft_load<V>(xr + in_stride, xi + in_stride);
+                fft_complex<V> a2 = fft_load<V>(xr + 2 * in_stride, xi + 2 * in_stride);
+                fft_complex<V> a3 = fft_load<V>(xr + 3 * in_stride, xi + 3 * in_stride);
+                fft_complex<V> t0 = a0 + a2, t1 = a0 - a2, t2 = a1 + a3, t3 = a1 - a3;
+                // t1 -+ i * t3
+                fft_complex<V> b1 = { t1.re + t3.im, t1.im - t3.re };
+                fft_complex<V> b3 = { t1.re - t3.im, t1.im + t3.re };
+                fft_store(yr, yi, t0 + t2);
+                fft_store(yr + out_stride, yi + out_stride, fft_mul(b1, wr[0], wi[0]));
+                fft_store(yr + 2 * out_stride, yi + 2 * out_stride, fft_mul(t0 - t2, wr[1], wi[1]));
+                fft_store(yr + 3 * out_stride, yi + 3 * out_stride, fft_mul(b3, wr[2], wi[2]));
+            }
+        };
+
+        // Direct transform of a prime radix, with the radix roots of unity
+        template <class T>
+        struct fft_radix_generic
+        {
+            std::size_t radix;
+            const T* root_real;
+            const T* root_imag;
+
+            template <class V>
+            void run(const T* xr, const T* xi, T* yr, T* yi, std::size_t in_stride, std::size_t out_stride,
+                     const T* wr, const T* wi) const
+            {
+                fft_complex<V> sum = fft_load<V>(xr, xi);
+                for (std::size_t r = 1; r < radix; ++r)
+                {
+                    sum = sum + fft_load<V>(xr + r * in_stride, xi + r * in_stride);
+                }
+                fft_store(yr, yi, sum);
+                for (std::size_t k = 1; k < radix; ++k)
+                {
+                    fft_complex<V> acc = fft_load<V>(xr, xi);
+                    std::size_t j = 0;
+                    for (std::size_t r = 1; r < radix; ++r)
+                    {
+                        j += k;
+                        j = j >= radix ? j - radix : j;
+                        acc = fft_mul_add(fft_load<V>(xr + r * in_stride, xi + r * in_stride), root_real[j], root_imag[j], acc);
+                    }
+                    fft_store(yr + k * out_stride, yi + k * out_stride, fft_mul(acc, wr[k - 1], wi[k - 1]));
+                }
+            }
+        };
+
+        // Stockham stage: the butterfly i of the element q reads
+        // x[q + s * (i + r * m)] for r in [0, radix) and writes
+        // y[q + s * (radix * i + k)] for k in [0, radix), where s is the
+        // stride and m the count of the stage. The elements q share the
+        // twiddle factors of i, and are the lanes of the batches when s
+        // is large enough.
+        template <class Arch, class T, class F>
+        inline void fft_run_stage(const F& butterfly, const fft_stage& stage, const T* twr, const T* twi,
+                                  const T* xr, const T* xi, T* yr, T* yi, std::false_type)
+        {
+            const std::size_t p = stage.radix, s = stage.stride, m = stage.count;
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                const T* wr = twr + i * (p - 1);
+                const T* wi = twi + i * (p - 1);
+                for (std::size_t q = 0; q < s; ++q)
+                {
+                    butterfly.template run<T>(xr + s * i + q, xi + s * i + q, yr + s * p * i + q, yi + s * p * i + q,
+                                              s * m, s, wr, wi);
+                }
+            }
+        }
+
+        template <class Arch, class T, class F>
+        inline void fft_run_stage(const F& butterfly, const fft_stage& stage, const T* twr, const T* twi,
+                                  const T* xr, const T* xi, T* yr, T* yi, std::true_type)
+        {
+            using batch_type = typename Arch::template batch<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            const std::size_t p = stage.radix, s = stage.stride, m = stage.count;
+            if (s < simd_size)
+            {
+                fft_run_stage<Arch>(butterfly, stage, twr, twi, xr, xi, yr, yi, std::false_type());
+                return;
+            }
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                const T* wr = twr + i * (p - 1);
+                const T* wi = twi + i * (p - 1);
+                std::size_t q = 0;
+                for (; q + simd_size <= s; q += simd_size)
+                {
+                    butterfly.template run<batch_type>(xr + s * i + q, xi + s * i + q, yr + s * p * i + q, yi + s * p * i + q,
+                                                       s * m, s, wr, wi);
+                }
+                for (; q < s; ++q)
+                {
+                    butterfly.template run<T>(xr + s * i + q, xi + s * i + q, yr + s * p * i + q, yi + s * p * i + q,
+                                              s * m, s, wr, wi);
+                }
+            }
+        }
+
+        template <class Arch, class T>
+        inline void fft_stage_dispatch(const fft_stage& stage, const T* twr, const T* twi, const T* rootr, const T* rooti,
+                                       const T* xr, const T* xi, T* yr, T* yi)
+        {
+            using vectorized = blas_vectorized<T, Arch>;
+            twr += stage.twiddle_offset;
+            twi += stage.twiddle_offset;
+            switch (stage.radix)
+            {
+            case 2:
+                fft_run_stage<Arch>(fft_radix2{}, stage, twr, twi, xr, xi, yr, yi, vectorized());
+                break;
+            case 3:
+                fft_run_stage<Arch>(fft_radix3{}, stage, twr, twi, xr, xi, yr, yi, vectorized());
+                break;
+            case 4:
+                fft_run_stage<Arch>(fft_radix4{}, stage, twr, twi, xr, xi, yr, yi, vectorized());
+                break;
+            default:
+                fft_radix_generic<T> generic = { stage.radix, rootr + stage.root_offset, rooti + stage.root_offset };
+                fft_run_stage<Arch>(generic, stage, twr, twi, xr, xi, yr, yi, vectorized());
+                break;
+            }
+        }
+
+        // Conversions between interleaved and split complex values, with
+        // an optional scaling
+        template <class Arch, class T>
+        inline void fft_split(const std::complex<T>* in, T* re, T* im, std::size_t n, std::false_type)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                re[i] = in[i].real();
+                im[i] = in[i].imag();
+            }
+        }
+
+        template <class Arch, class T>
+        inline void fft_split(const std::complex<T>* in, T* re, T* im, std::size_t n, std::true_type)
+        {
+            using batch_type = blas_batch_t<std::complex<T>, Arch>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t i = 0;
+            batch_type b;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                b.load_unaligned(in + i);
+                b.store_unaligned(re + i, im + i);
+            }
+            fft_split<Arch>(in + i, re + i, im + i, n - i, std::false_type());
+        }
+
+        template <class Arch, class T>
+        inline void fft_merge(const T* re, const T* im, std::complex<T>* out, std::size_t n, T scale, std::false_type)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = std::complex<T>(re[i] * scale, im[i] * scale);
+            }
+        }
+
+        template <class Arch, class T>
+        inline void fft_merge(const T* re, const T* im, std::complex<T>* out, std::size_t n, T scale, std::true_type)
+        {
+            using batch_type = blas_batch_t<std::complex<T>, Arch>;
+            using real_batch = typename Arch::template batch<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t i = 0;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                batch_type b(blas_load<real_batch>(re + i) * real_batch(scale), blas_load<real_batch>(im + i) * real_batch(scale));
+                b.store_unaligned(out + i);
+            }
+            fft_merge<Arch>(re + i, im + i, out + i, n - i, scale, std::false_type());
+        }
+
+        template <class Arch, class T>
+        inline void fft_scale(T* x, std::size_t n, T scale, std::false_type)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                x[i] *= scale;
+            }
+        }
+
+        template <class Arch, class T>
+        inline void fft_scale(T* x, std::size_t n, T scale, std::true_type)
+        {
+            using batch_type = typename Arch::template batch<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            std::size_t i = 0;
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                (blas_load<batch_type>(x + i) * batch_type(scale)).store_unaligned(x + i);
+            }
+            fft_scale<Arch>(x + i, n - i, scale, std::false_type());
+        }
+
+        struct fft_kernel
+        {
+            template <class Arch, class T>
+            void operator()(Arch, const fft_plan<T>* plan, const std::complex<T>* in, std::complex<T>* out, bool inverse) const
+            {
+                plan->template transform<Arch>(in, out, inverse);
+            }
+
+            template <class Arch, class T>
+            void operator()(Arch, const fft_plan<T>* plan, const T* in_real, const T* in_imag, T* out_real, T* out_imag,
+                            bool inverse) const
+            {
+                plan->template transform<Arch>(in_real, in_imag, out_real, out_imag, inverse);
+            }
+        };
+
+        // Cache of the plans of each size, which live until the end of
+        // the program
+        template <class P>
+        inline const P& fft_cached_plan(std::size_t n)
+        {
+            static std::mutex mutex;
+            static std::map<std::size_t, std::unique_ptr<P>> plans;
+            std::lock_guard<std::mutex> lock(mutex);
+            std::unique_ptr<P>& plan = plans[n];
+            if (!plan)
+            {
+                plan.reset(new P(n));
+            }
+            return *plan;
+        }
+
+        // exp(-2i * pi * k / n)
+        template <class T>
+        inline void fft_root(std::size_t k, std::size_t n, T& re, T& im)
+        {
+            const long double two_pi = 6.283185307179586476925286766559005768L;
+            long double angle = two_pi * static_cast<long double>(k % n) / static_cast<long double>(n);
+            re = static_cast<T>(std::cos(angle));
+            im = static_cast<T>(-std::sin(angle));
+        }
+    }
+
+    /***************************
+     * fft_plan implementation *
+     ***************************/
+
+    /**
+     * Builds the plan of the transforms of size n, whose factors are
+     * taken by decreasing size of their stride: 4, 2, 3 and then the
+     * other primes.
+     */
+    template <class T>
+    inline fft_plan<T>::fft_plan(size_type n)
+        : m_size(n)
+    {
+        static_assert(std::is_floating_point<T>::value, "fft_plan requires floating point values");
+        if (n == 0)
+        {
+            return;
+        }
+        std::vector<size_type> factors;
+        size_type rest = n;
+        while (rest % 4 == 0)
+        {
+            factors.push_back(4);
+            rest /= 4;
+        }
+        if (rest % 2 == 0)
+        {
+            factors.push_back(2);
+            rest /= 2;
+        }
+        for (size_type p = 3; p * p <= rest; p += 2)
+        {
+            while (rest % p == 0)
+            {
+                factors.push_back(p);
+                rest /= p;
+            }
+        }
+        if (rest > 1)
+        {
+            factors.push_back(rest);
+        }
+
+        size_type stride = 1, length = n;
+        for (size_type p : factors)
+        {
+            size_type count = length / p;
+            detail::fft_stage stage = { p, stride, count, m_twiddle_real.size(), m_root_real.size() };
+            m_stages.push_back(stage);
+            for (size_type i = 0; i < count; ++i)
+            {
+                for (size_type k = 1; k < p; ++k)
+                {
+                    T re, im;
+                    detail::fft_root(i * k, length, re, im);
+                    m_twiddle_real.push_back(re);
+                    m_twiddle_imag.push_back(im);
+                }
+            }
+            if (p > 4)
+            {
+                for (size_type j = 0; j < p; ++j)
+                {
+                    T re, im;
+                    detail::fft_root(j, p, re, im);
+                    m_root_real.push_back(re);
+                    m_root_imag.push_back(im);
+                }
+            }
+            stride *= p;
+            length = count;
+        }
+    }
+
+    /**
+     * Returns the plan of size n shared by the whole program, built by the
+     * first call for this size.
+     */
+    template <class T>
+    inline auto fft_plan<T>::cached(size_type n) -> const fft_plan&
+    {
+        return detail::fft_cached_plan<fft_plan>(n);
+    }
+
+    template <class T>
+    inline auto fft_plan<T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Computes the forward transform of the interleaved complex values
+     * of in into out, which may be the same array.
+     */
+    template <class T>
+    inline void fft_plan<T>::forward(const value_type* in, value_type* out) const
+    {
+        detail::blas_dispatch(detail::fft_kernel{}, this, in, static_cast<value_type*>(out), false);
+    }
+
+    /**
+     * Computes the inverse transform of the interleaved complex values
+     * of in into out, which may be the same array.
+     */
+    template <class T>
+    inline void fft_plan<T>::inverse(const value_type* in, value_type* out) const
+    {
+        detail::blas_dispatch(detail::fft_kernel{}, this, in, static_cast<value_type*>(out), true);
+    }
+
+    /**
+     * Computes the forward transform of the values whose real and
+     * imaginary parts are in separate arrays. The output arrays may be
+     * the input ones.
+     */
+    template <class T>
+    inline void fft_plan<T>::forward(const real_type* in_real, const real_type* in_imag, real_type* out_real,
+                                     real_type* out_imag) const
+    {
+        detail::blas_dispatch(detail::fft_kernel{}, this, in_real, in_imag, out_real, out_imag, false);
+    }
+
+    /**
+     * Computes the inverse transform of the values whose real and
+     * imaginary parts are in separate arrays. The output arrays may be
+     * the input ones.
+     */
+    template <class T>
+    inline void fft_plan<T>::inverse(const real_type* in_real, const real_type* in_imag, real_type* out_real,
+                                     real_type* out_imag) const
+    {
+        detail::blas_dispatch(detail::fft_kernel{}, this, in_real, in_imag, out_real, out_imag, true);
+    }
+
+    // Runs the stages from the input to the output arrays, going back
+    // and forth between the two pairs of arrays of work.
+    template <class T>
+    template <class Arch>
+    inline void fft_plan<T>::run(const real_type* in_real, const real_type* in_imag, real_type* out_real,
+                                 real_type* out_imag, real_type* work) const
+    {
+        const size_type n = m_size;
+        const size_type nstages = m_stages.size();
+        if (nstages == 0)
+        {
+            std::copy(in_real, in_real + n, out_real);
+            std::copy(in_imag, in_imag + n, out_imag);
+            return;
+        }
+        const real_type* src_real = in_real;
+        const real_type* src_imag = in_imag;
+        for (size_type j = 0; j < nstages; ++j)
+        {
+            bool last = j + 1 == nstages && out_real != in_real;
+            real_type* dst_real = last ? out_real : work + (j % 2) * 2 * n;
+            real_type* dst_imag = last ? out_imag : work + (j % 2) * 2 * n + n;
+            detail::fft_stage_dispatch<Arch>(m_stages[j], m_twiddle_real.data(), m_twiddle_imag.data(), m_root_real.data(),
+                                             m_root_imag.data(), src_real, src_imag, dst_real, dst_imag);
+            src_real = dst_real;
+            src_imag = dst_imag;
+        }
+        if (src_real != out_real)
+        {
+            std::copy(src_real, src_real + n, out_real);
+            std::copy(src_imag, src_imag + n, out_imag);
+        }
+    }
+
+    // The inverse transform is the forward transform of the values whose
+    // real and imaginary parts are swapped, swapped back and scaled.
+    template <class T>
+    template <class Arch>
+    inline void fft_plan<T>::transform(const value_type* in, value_type* out, bool inverse) const
+    {
+        using vectorized = detail::blas_vectorized<T, Arch>;
+        const size_type n = m_size;
+        buffer_type& buffer = workspace(8 * n);
+        real_type* split = buffer.data();
+        real_type* res = split + 2 * n;
+        detail::fft_split<Arch>(in, split, split + n, n, vectorized());
+        const real_type* in_real = inverse ? split + n : split;
+        const real_type* in_imag = inverse ? split : split + n;
+        real_type* out_real = inverse ? res + n : res;
+        real_type* out_imag = inverse ? res : res + n;
+        run<Arch>(in_real, in_imag, out_real, out_imag, res + 2 * n);
+        detail::fft_merge<Arch>(res, res + n, out, n, inverse ? real_type(1) / real_type(n) : real_type(1), vectorized());
+    }
+
+    template <class T>
+    template <class Arch>
+    inline void fft_plan<T>::transform(const real_type* in_real, const real_type* in_imag, real_type* out_real,
+                                       real_type* out_imag, bool inverse) const
+    {
+        const size_type n = m_size;
+        buffer_type& buffer = workspace(4 * n);
+        if (inverse)
+        {
+            run<Arch>(in_imag, in_real, out_imag, out_real, buffer.data());
+            detail::fft_scale<Arch>(out_real, n, real_type(1) / real_type(n), detail::blas_vectorized<T, Arch>());
+            detail::fft_scale<Arch>(out_imag, n, real_type(1) / real_type(n), detail::blas_vectorized<T, Arch>());
+        }
+        else
+        {
+            run<Arch>(in_real, in_imag, out_real, out_imag, buffer.data());
+        }
+    }
+
+    // Work arrays of the calling thread, grown to the largest size used
+    template <class T>
+    inline auto fft_plan<T>::workspace(size_type size) -> buffer_type&
+    {
+        static thread_local buffer_type buffer;
+        if (buffer.size() < size)
+        {
+            buffer.resize(size);
+        }
+        return buffer;
+    }
+
+    /****************************
+     * rfft_plan implementation *
+     ****************************/
+
+    template <class T>
+    inline rfft_plan<T>::rfft_plan(size_type n)
+        : m_size(n), m_plan(fft_plan<T>::cached(n % 2 == 0 ? n / 2 : n))
+    {
+        if (n % 2 == 0)
+        {
+            m_twiddle_real.resize(n / 2);
+            m_twiddle_imag.resize(n / 2);
+            for (size_type k = 0; k < n / 2; ++k)
+            {
+                detail::fft_root(k, n, m_twiddle_real[k], m_twiddle_imag[k]);
+            }
+        }
+    }
+
+    /**
+     * Returns the plan of size n shared by the whole program, built by the
+     * first call for this size.
+     */
+    template <class T>
+    inline auto rfft_plan<T>::cached(size_type n) -> const rfft_plan&
+    {
+        return detail::fft_cached_plan<rfft_plan>(n);
+    }
+
+    template <class T>
+    inline auto rfft_plan<T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Computes the n / 2 + 1 first values of the forward transform of the
+     * n real values of in; the other ones are their conjugates.
+     */
+    template <class T>
+    inline void rfft_plan<T>::forward(const real_type* in, value_type* out) const
+    {
+        const size_type n = m_size;
+        if (n == 0)
+        {
+            return;
+        }
+        static thread_local buffer_type buffer;
+        if (n % 2 != 0)
+        {
+            buffer.assign(2 * n, real_type(0));
+            std::copy(in, in + n, buffer.data());
+            m_plan.forward(buffer.data(), buffer.data() + n, buffer.data(), buffer.data() + n);
+            for (size_type k = 0; k <= n / 2; ++k)
+            {
+                out[k] = value_type(buffer[k], buffer[n + k]);
+            }
+            return;
+        }
+        // Z = E + i * O, E and O being the transforms of the even and odd
+        // values, and X[k] = E[k] + w^k * O[k]
+        const size_type h = n / 2;
+        buffer.resize(2 * h);
+        real_type* zr = buffer.data();
+        real_type* zi = zr + h;
+        for (size_type j = 0; j < h; ++j)
+        {
+            zr[j] = in[2 * j];
+            zi[j] = in[2 * j + 1];
+        }
+        m_plan.forward(zr, zi, zr, zi);
+        const real_type half(0.5);
+        for (size_type k = 0; k <= h; ++k)
+        {
+            size_type a = k == h ? 0 : k, b = k == 0 ? 0 : h - k;
+            // E = (Z[k] + conj(Z[h - k])) / 2, O = (Z[k] - conj(Z[h - k])) / 2i
+            real_type er = half * (zr[a] + zr[b]), ei = half * (zi[a] - zi[b]);
+            real_type or_ = half * (zi[a] + zi[b]), oi = half * (zr[b] - zr[a]);
+            real_type wr = k == h ? real_type(-1) : m_twiddle_real[k], wi = k == h ? real_type(0) : m_twiddle_imag[k];
+            out[k] = value_type(er + wr * or_ - wi * oi, ei + wr * oi + wi * or_);
+        }
+    }
+
+    /**
+     * Computes the n real values whose forward transform starts with the
+     * n / 2 + 1 values of in, scaled by 1 / n.
+     */
+    template <class T>
+    inline void rfft_plan<T>::inverse(const value_type* in, real_type* out) const
+    {
+        const size_type n = m_size;
+        if (n == 0)
+        {
+            return;
+        }
+        static thread_local buffer_type buffer;
+        if (n % 2 != 0)
+        {
+            buffer.resize(2 * n);
+            real_type* xr = buffer.data();
+            real_type* xi = xr + n;
+            for (size_type k = 0; k <= n / 2; ++k)
+            {
+                xr[k] = in[k].real();
+                xi[k] = in[k].imag();
+            }
+            for (size_type k = n / 2 + 1; k < n; ++k)
+            {
+                xr[k] = in[n - k].real();
+                xi[k] = -in[n - k].imag();
+            }
+            m_plan.inverse(xr, xi, xr, xi);
+            std::copy(xr, xr + n, out);
+            return;
+        }
+        const size_type h = n / 2;
+        buffer.resize(2 * h);
+        real_type* zr = buffer.data();
+        real_type* zi = zr + h;
+        const real_type half(0.5);
+        for (size_type k = 0; k < h; ++k)
+        {
+            value_type x = in[k], y = std::conj(in[h - k]);
+            // E = (X[k] + conj(X[h - k])) / 2, O = (X[k] - conj(X[h - k])) * conj(w^k) / 2
+            real_type er = half * (x.real() + y.real()), ei = half * (x.imag() + y.imag());
+            real_type dr = half * (x.real() - y.real()), di = half * (x.imag() - y.imag());
+            real_type wr = m_twiddle_real[k], wi = -m_twiddle_imag[k];
+            real_type or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+            // Z = E + i * O
+            zr[k] = er - oi;
+            zi[k] = ei + or_;
+        }
+        m_plan.inverse(zr, zi, zr, zi);
+        for (size_type j = 0; j < h; ++j)
+        {
+            out[2 * j] = zr[j];
+            out[2 * j + 1] = zi[j];
+        }
+    }
+
+    /**********************
+     * fft free functions *
+     **********************/
+
+    /**
+     * Computes the forward transform of the n interleaved complex values
+     * of in into out, with the cached plan of size n.
+     */
+    template <class T>
+    void fft(const std::complex<T>* in, std::complex<T>* out, std::size_t n)
+    {
+        fft_plan<T>::cached(n).forward(in, out);
+    }
+
+    /**
+     * Computes the inverse transform, scaled by 1 / n, of the n
+     * interleaved complex values of in into out.
+     */
+    template <class T>
+    void ifft(const std::complex<T>* in, std::complex<T>* out, std::size_t n)
+    {
+        fft_plan<T>::cached(n).inverse(in, out);
+    }
+
+    /**
+     * Computes the forward transform of n values whose real and imaginary
+     * parts are in separate arrays.
+     */
+    template <class T>
+    void fft(const T* in_real, const T* in_imag, T* out_real, T* out_imag, std::size_t n)
+    {
+        fft_plan<T>::cached(n).forward(in_real, in_imag, out_real, out_imag);
+    }
+
+    /**
+     * Computes the inverse transform, scaled by 1 / n, of n values whose
+     * real and imaginary parts are in separate arrays.
+     */
+    template <class T>
+    void ifft(const T* in_real, const T* in_imag, T* out_real, T* out_imag, std::size_t n)
+    {
+        fft_plan<T>::cached(n).inverse(in_real, in_imag, out_real, out_imag);
+    }
+
+    /**
+     * Resizes out to the size of in and computes the forward transform of
+     * in into out, which may be in.
+     */
+    template <class T, class A>
+    void fft(const split_complex_vector<T, A>& in, split_complex_vector<T, A>& out)
+    {
+        out.resize(in.size());
+        fft(in.real_data(), in.imag_data(), out.real_data(), out.imag_data(), in.size());
+    }
+
+    /**
+     * Resizes out to the size of in and computes the inverse transform,
+     * scaled by 1 / n, of in into out, which may be in.
+     */
+    template <class T, class A>
+    void ifft(const split_complex_vector<T, A>& in, split_complex_vector<T, A>& out)
+    {
+        out.resize(in.size());
+        ifft(in.real_data(), in.imag_data(), out.real_data(), out.imag_data(), in.size());
+    }
+
+    /**
+     * Computes the n / 2 + 1 first values of the forward transform of the
+     * n real values of in.
+     */
+    template <class T>
+    void rfft(const T* in, std::complex<T>* out, std::size_t n)
+    {
+        rfft_plan<T>::cached(n).forward(in, out);
+    }
+
+    /**
+     * Computes the n real values whose forward transform starts with the
+     * n / 2 + 1 values of in, scaled by 1 / n.
+     */
+    template <class T>
+    void irfft(const std::complex<T>* in, T* out, std::size_t n)
+    {
+        rfft_plan<T>::cached(n).inverse(in, out);
+    }
+}
+
+#endif
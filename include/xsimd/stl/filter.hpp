@@ -0,0 +1,505 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_FILTER_HPP
+#define XSIMD_FILTER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "blas.hpp"
+
+namespace xsimd
+{
+    /**************
+     * fir_filter *
+     **************/
+
+    /**
+     * Finite impulse response filter, which computes
+     * y[n] = sum of h[k] * x[n - k] for k in [0, ntaps) over a stream of
+     * samples given block by block. The last ntaps - 1 samples of a block
+     * are kept as the history of the next one, the samples before the
+     * first block are zeros.
+     */
+    template <class T>
+    class fir_filter
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+
+        fir_filter(const value_type* taps, size_type ntaps);
+
+        size_type size() const noexcept;
+
+        void reset();
+        void process(const value_type* in, value_type* out, size_type n);
+
+    private:
+
+        // Number of samples filtered at once after the history
+        static constexpr size_type chunk_size = 4096;
+
+        using buffer_type = std::vector<value_type, aligned_allocator<value_type>>;
+
+        buffer_type m_taps;
+        buffer_type m_buffer;
+    };
+
+    /**************
+     * convolve2d *
+     **************/
+
+    template <class T>
+    void convolve2d(const T* in, std::size_t rows, std::size_t cols,
+                    const T* kernel, std::size_t krows, std::size_t kcols, T* out);
+
+    /***************
+     * biquad_bank *
+     ***************/
+
+    /**
+     * Bank of independent cascades of biquad sections, one channel per
+     * lane of the batch type B. Each section computes
+     * y[n] = b0 * x[n] + b1 * x[n - 1] + b2 * x[n - 2] - a1 * y[n - 1] - a2 * y[n - 2]
+     * in the transposed direct form II, and the sections of a channel are
+     * applied one after the other. The number of channels does not need
+     * to be a multiple of the batch size; the state of every section is
+     * kept across calls.
+     */
+    template <class B>
+    class biquad_bank
+    {
+    public:
+
+        using batch_type = B;
+        using value_type = typename B::value_type;
+        using size_type = std::size_t;
+
+        static constexpr size_type lanes = B::size;
+
+        biquad_bank(size_type channels, size_type stages);
+
+        size_type channels() const noexcept;
+        size_type stages() const noexcept;
+
+        void set_coefficients(size_type channel, size_type stage, value_type b0, value_type b1, value_type b2,
+                              value_type a1, value_type a2);
+        void reset();
+
+        void process_interleaved(const value_type* in, value_type* out, size_type frames);
+        void process_planar(const value_type* const* in, value_type* const* out, size_type frames);
+
+    private:
+
+        // Number of frames gathered in the lanes of the block at once
+        static constexpr size_type block_size = 256;
+
+        using buffer_type = std::vector<value_type, aligned_allocator<value_type, sizeof(value_type) * lanes>>;
+
+        void filter_block(size_type group, size_type frames);
+
+        size_type m_channels;
+        size_type m_stages;
+        size_type m_groups;
+        // b0, b1, b2, a1, a2 batches of each section of each group of lanes
+        buffer_type m_coefficients;
+        // z1, z2 batches of each section of each group of lanes
+        buffer_type m_state;
+        buffer_type m_block;
+    };
+
+    /********************************
+     * filter kernel implementation *
+     ********************************/
+
+    namespace detail
+    {
+        // Independent accumulators of the output batches
+        constexpr std::size_t filter_unroll = 4;
+
+        // Computes out[i] = sum of g[p * kcols + q] * in[p * stride + i + q]
+        // for p in [0, krows) and q in [0, kcols), for i in [0, n): a
+        // correlation of in with g whose windows are read with unaligned
+        // loads, shifted by one element for each coefficient.
+        template <class Arch, class T>
+        inline void correlate_impl(const T* g, std::size_t krows, std::size_t kcols, const T* in, std::size_t stride,
+                                   T* out, std::size_t n, std::false_type)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                T res(0);
+                for (std::size_t p = 0; p < krows; ++p)
+                {
+                    for (std::size_t q = 0; q < kcols; ++q)
+                    {
+                        res += g[p * kcols + q] * in[p * stride + i + q];
+                    }
+                }
+                out[i] = res;
+            }
+        }
+
+        template <class Arch, class T>
+        inline void correlate_impl(const T* g, std::size_t krows, std::size_t kcols, const T* in, std::size_t stride,
+                                   T* out, std::size_t n, std::true_type)
+        {
+            using batch_type = typename Arch::template batch<T>;
+            constexpr std::size_t simd_size = batch_type::size;
+            constexpr std::size_t block = filter_unroll * simd_size;
+
+            std::size_t i = 0;
+            for (; i + block <= n; i += block)
+            {
+                batch_type acc[filter_unroll];
+                unroller<filter_unroll>([&](std::size_t u) {
+                    acc[u] = batch_type(T(0));
+                });
+                for (std::size_t p = 0; p < krows; ++p)
+                {
+                    const T* row = in + p * stride + i;
+                    const T* taps = g + p * kcols;
+                    for (std::size_t q = 0; q < kcols; ++q)
+                    {
+                        batch_type tap(taps[q]);
+                        unroller<filter_unroll>([&](std::size_t u) {
+                            acc[u] = fma(tap, blas_load<batch_type>(row + q + u * simd_size), acc[u]);
+                        });
+                    }
+                }
+                unroller<filter_unroll>([&](std::size_t u) {
+                    acc[u].store_unaligned(out + i + u * simd_size);
+                });
+            }
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                batch_type acc(T(0));
+                for (std::size_t p = 0; p < krows; ++p)
+                {
+                    const T* row = in + p * stride + i;
+                    const T* taps = g + p * kcols;
+                    for (std::size_t q = 0; q < kcols; ++q)
+                    {
+                        acc = fma(batch_type(taps[q]), blas_load<batch_type>(row + q), acc);
+                    }
+                }
+                acc.store_unaligned(out + i);
+            }
+            correlate_impl<Arch>(g, krows, kcols, in + i, stride, out + i, n - i, std::false_type());
+        }
+
+        struct correlate_kernel
+        {
+            template <class Arch, class T>
+            void operator()(Arch, const T* g, std::size_t krows, std::size_t kcols, const T* in, std::size_t stride,
+                            T* out, std::size_t n) const
+            {
+                correlate_impl<Arch>(g, krows, kcols, in, stride, out, n, blas_vectorized<T, Arch>());
+            }
+        };
+
+        struct convolve2d_kernel
+        {
+            template <class Arch, class T>
+            void operator()(Arch, const T* in, std::size_t cols, const T* g, std::size_t krows, std::size_t kcols,
+                            T* out, std::size_t out_rows, std::size_t out_cols) const
+            {
+                for (std::size_t r = 0; r < out_rows; ++r)
+                {
+                    correlate_impl<Arch>(g, krows, kcols, in + r * cols, cols, out + r * out_cols, out_cols,
+                                         blas_vectorized<T, Arch>());
+                }
+            }
+        };
+    }
+
+    /*****************************
+     * fir_filter implementation *
+     *****************************/
+
+    /**
+     * Builds a filter with the ntaps coefficients h[0], ..., h[ntaps - 1]
+     * pointed to by taps, and an empty history.
+     */
+    template <class T>
+    inline fir_filter<T>::fir_filter(const value_type* taps, size_type ntaps)
+        : m_taps(taps, taps + ntaps), m_buffer(ntaps == 0 ? 0 : ntaps - 1 + chunk_size, value_type(0))
+    {
+        static_assert(std::is_floating_point<T>::value, "fir_filter requires floating point values");
+        // Output i is the dot product of the reversed taps with the
+        // window of samples starting at i
+        std::reverse(m_taps.begin(), m_taps.end());
+    }
+
+    /**
+     * Returns the number of taps of the filter.
+     */
+    template <class T>
+    inline auto fir_filter<T>::size() const noexcept -> size_type
+    {
+        return m_taps.size();
+    }
+
+    /**
+     * Clears the history, as if no sample had been processed.
+     */
+    template <class T>
+    inline void fir_filter<T>::reset()
+    {
+        std::fill(m_buffer.begin(), m_buffer.end(), value_type(0));
+    }
+
+    /**
+     * Filters the n samples of in into out, which may be the same array,
+     * after the samples given to the previous calls.
+     */
+    template <class T>
+    inline void fir_filter<T>::process(const value_type* in, value_type* out, size_type n)
+    {
+        const size_type ntaps = m_taps.size();
+        if (ntaps == 0)
+        {
+            std::fill(out, out + n, value_type(0));
+            return;
+        }
+        const size_type history = ntaps - 1;
+        value_type* buffer = m_buffer.data();
+        while (n != 0)
+        {
+            size_type count = (std::min)(n, size_type(chunk_size));
+            std::copy(in, in + count, buffer + history);
+            detail::blas_dispatch(detail::correlate_kernel{}, static_cast<const value_type*>(m_taps.data()), size_type(1), ntaps,
+                                  static_cast<const value_type*>(buffer), size_type(0), out, count);
+            std::copy(buffer + count, buffer + count + history, buffer);
+            in += count;
+            out += count;
+            n -= count;
+        }
+    }
+
+    /*****************************
+     * convolve2d implementation *
+     *****************************/
+
+    /**
+     * Computes the valid part of the convolution of the row-major rows x
+     * cols image in with the krows x kcols kernel, that is the
+     * (rows - krows + 1) x (cols - kcols + 1) outputs whose window lies
+     * inside the image:
+     * out[r][c] = sum of kernel[p][q] * in[r + krows - 1 - p][c + kcols - 1 - q].
+     * Nothing is written if the kernel is larger than the image.
+     */
+    template <class T>
+    void convolve2d(const T* in, std::size_t rows, std::size_t cols,
+                    const T* kernel, std::size_t krows, std::size_t kcols, T* out)
+    {
+        static_assert(std::is_floating_point<T>::value, "convolve2d requires floating point values");
+        if (krows == 0 || kcols == 0 || rows < krows || cols < kcols)
+        {
+            return;
+        }
+        // The flipped kernel turns the convolution into a correlation
+        std::vector<T> flipped(kernel, kernel + krows * kcols);
+        std::reverse(flipped.begin(), flipped.end());
+        detail::blas_dispatch(detail::convolve2d_kernel{}, in, cols, static_cast<const T*>(flipped.data()), krows, kcols,
+                              out, rows - krows + 1, cols - kcols + 1);
+    }
+
+    /******************************
+     * biquad_bank implementation *
+     ******************************/
+
+    /**
+     * Builds a bank of channels cascades of stages sections, which leave
+     * their input unchanged until their coefficients are set.
+     */
+    template <class B>
+    inline biquad_bank<B>::biquad_bank(size_type channels, size_type stages)
+        : m_channels(channels), m_stages(stages), m_groups((channels + lanes - 1) / lanes),
+          m_coefficients(m_groups * stages * 5 * lanes, value_type(0)),
+          m_state(m_groups * stages * 2 * lanes, value_type(0)),
+          m_block(block_size * lanes, value_type(0))
+    {
+        static_assert(std::is_floating_point<value_type>::value, "biquad_bank requires floating point batches");
+        for (size_type i = 0; i < m_groups * stages; ++i)
+        {
+            std::fill(m_coefficients.begin() + i * 5 * lanes, m_coefficients.begin() + (i * 5 + 1) * lanes, value_type(1));
+        }
+    }
+
+    /**
+     * Returns the number of channels of the bank.
+     */
+    template <class B>
+    inline auto biquad_bank<B>::channels() const noexcept -> size_type
+    {
+        return m_channels;
+    }
+
+    /**
+     * Returns the number of sections of each channel.
+     */
+    template <class B>
+    inline auto biquad_bank<B>::stages() const noexcept -> size_type
+    {
+        return m_stages;
+    }
+
+    /**
+     * Sets the coefficients of a section of a channel, normalized so that
+     * a0 is 1.
+     */
+    template <class B>
+    inline void biquad_bank<B>::set_coefficients(size_type channel, size_type stage, value_type b0, value_type b1,
+                                                 value_type b2, value_type a1, value_type a2)
+    {
+        value_type* coefs = m_coefficients.data() + ((channel / lanes) * m_stages + stage) * 5 * lanes + channel % lanes;
+        coefs[0] = b0;
+        coefs[lanes] = b1;
+        coefs[2 * lanes] = b2;
+        coefs[3 * lanes] = a1;
+        coefs[4 * lanes] = a2;
+    }
+
+    /**
+     * Clears the state of every section, as if no frame had been
+     * processed.
+     */
+    template <class B>
+    inline void biquad_bank<B>::reset()
+    {
+        std::fill(m_state.begin(), m_state.end(), value_type(0));
+    }
+
+    /**
+     * Filters frames frames of interleaved samples, in[f * channels() + c]
+     * being the sample f of the channel c. in and out may be the same
+     * array.
+     */
+    template <class B>
+    inline void biquad_bank<B>::process_interleaved(const value_type* in, value_type* out, size_type frames)
+    {
+        value_type* block = m_block.data();
+        for (size_type start = 0; start < frames; start += block_size)
+        {
+            size_type count = (std::min)(frames - start, size_type(block_size));
+            for (size_type g = 0; g < m_groups; ++g)
+            {
+                size_type first = g * lanes;
+                size_type width = (std::min)(m_channels - first, size_type(lanes));
+                const value_type* src = in + start * m_channels + first;
+                value_type* dst = out + start * m_channels + first;
+                if (width == lanes)
+                {
+                    for (size_type f = 0; f < count; ++f)
+                    {
+                        batch_type(src + f * m_channels, unaligned_mode()).store_aligned(block + f * lanes);
+                    }
+                    filter_block(g, count);
+                    for (size_type f = 0; f < count; ++f)
+                    {
+                        batch_type(block + f * lanes, aligned_mode()).store_unaligned(dst + f * m_channels);
+                    }
+                }
+                else
+                {
+                    for (size_type f = 0; f < count; ++f)
+                    {
+                        std::copy(src + f * m_channels, src + f * m_channels + width, block + f * lanes);
+                        std::fill(block + f * lanes + width, block + (f + 1) * lanes, value_type(0));
+                    }
+                    filter_block(g, count);
+                    for (size_type f = 0; f < count; ++f)
+                    {
+                        std::copy(block + f * lanes, block + f * lanes + width, dst + f * m_channels);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Filters frames frames of planar samples, in[c][f] being the sample f
+     * of the channel c. in[c] and out[c] may be the same array.
+     */
+    template <class B>
+    inline void biquad_bank<B>::process_planar(const value_type* const* in, value_type* const* out, size_type frames)
+    {
+        value_type* block = m_block.data();
+        for (size_type start = 0; start < frames; start += block_size)
+        {
+            size_type count = (std::min)(frames - start, size_type(block_size));
+            for (size_type g = 0; g < m_groups; ++g)
+            {
+                size_type first = g * lanes;
+                size_type width = (std::min)(m_channels - first, size_type(lanes));
+                for (size_type c = 0; c < width; ++c)
+                {
+                    const value_type* src = in[first + c] + start;
+                    for (size_type f = 0; f < count; ++f)
+                    {
+                        block[f * lanes + c] = src[f];
+                    }
+                }
+                for (size_type c = width; c < lanes; ++c)
+                {
+                    for (size_type f = 0; f < count; ++f)
+                    {
+                        block[f * lanes + c] = value_type(0);
+                    }
+                }
+                filter_block(g, count);
+                for (size_type c = 0; c < width; ++c)
+                {
+                    value_type* dst = out[first + c] + start;
+                    for (size_type f = 0; f < count; ++f)
+                    {
+                        dst[f] = block[f * lanes + c];
+                    }
+                }
+            }
+        }
+    }
+
+    // Runs the sections of a group one after the other over the frames
+    // of the block, so that the coefficients and the state of a section
+    // stay in registers. The callers zero the unused lanes of the last
+    // group, which filter these zeros with the identity section and
+    // remain zero.
+    template <class B>
+    inline void biquad_bank<B>::filter_block(size_type group, size_type frames)
+    {
+        value_type* block = m_block.data();
+        for (size_type s = 0; s < m_stages; ++s)
+        {
+            const value_type* coefs = m_coefficients.data() + (group * m_stages + s) * 5 * lanes;
+            value_type* state = m_state.data() + (group * m_stages + s) * 2 * lanes;
+            batch_type b0(coefs, aligned_mode()), b1(coefs + lanes, aligned_mode()), b2(coefs + 2 * lanes, aligned_mode());
+            batch_type a1(coefs + 3 * lanes, aligned_mode()), a2(coefs + 4 * lanes, aligned_mode());
+            batch_type z1(state, aligned_mode()), z2(state + lanes, aligned_mode());
+            for (size_type f = 0; f < frames; ++f)
+            {
+                batch_type x(block + f * lanes, aligned_mode());
+                batch_type y = fma(b0, x, z1);
+                z1 = fma(b1, x, fnma(a1, y, z2));
+                z2 = fnma(a2, y, b2 * x);
+                y.store_aligned(block + f * lanes);
+            }
+            z1.store_aligned(state);
+            z2.store_aligned(state + lanes);
+        }
+    }
+}
+
+#endif
@@ -11,6 +11,13 @@
 #ifndef XSIMD_ITERATOR_HPP
 #define XSIMD_ITERATOR_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "../memory/xsimd_aligned_stack_buffer.hpp"
+
 namespace xsimd
 {
     template <class B>
@@ -106,6 +113,160 @@ namespace xsimd
         pointer m_cur_pointer;
     };
 
+    template <class B, class T>
+    class masked_batch_proxy;
+
+    template <class B, class T>
+    struct simd_batch_traits<masked_batch_proxy<B, T>>
+        : simd_batch_traits<B>
+    {
+    };
+
+    template <class B, class T>
+    struct simd_batch_inner_types<masked_batch_proxy<B, T>>
+    {
+        using batch_reference = B;
+        using const_batch_reference = B;
+    };
+
+    /**
+     * Proxy that batch iterators dereference to, loading the batch B from
+     * unaligned memory and storing it back. The last batch of a range may
+     * hold less than B::size elements: the lanes past the end are loaded
+     * as zeros and are not stored, so that the tail of an array is
+     * handled like the other batches. T is const for read-only arrays.
+     */
+    template <class B, class T>
+    class masked_batch_proxy : public simd_base<masked_batch_proxy<B, T>>
+    {
+    public:
+
+        using self_type = masked_batch_proxy<B, T>;
+        using batch_type = B;
+        using batch_bool_type = typename simd_batch_traits<B>::batch_bool_type;
+        using value_type = typename B::value_type;
+        using pointer = T*;
+        using size_type = std::size_t;
+
+        masked_batch_proxy(pointer ptr, size_type count);
+
+        size_type size() const noexcept;
+        bool is_partial() const noexcept;
+        batch_bool_type mask() const;
+
+        batch_type get() const;
+        operator batch_type() const;
+
+        masked_batch_proxy& operator=(const batch_type& rhs);
+        masked_batch_proxy& operator=(const masked_batch_proxy& rhs);
+
+    private:
+
+        pointer m_ptr;
+        size_type m_count;
+    };
+
+    template <class B, class T>
+    void swap(masked_batch_proxy<B, T> lhs, masked_batch_proxy<B, T> rhs);
+
+    /**
+     * Random access iterator over the batches of an array whose size
+     * does not need to be a multiple of the batch size, nor its data to
+     * be aligned. Iterators compare and subtract in number of batches,
+     * the last batch being a partial one when the size is not a multiple
+     * of the batch size.
+     */
+    template <class B, class T = typename B::value_type>
+    class batch_iterator
+    {
+    public:
+
+        using self_type = batch_iterator<B, T>;
+        using batch_type = B;
+        static constexpr std::size_t batch_size = B::size;
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = batch_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = masked_batch_proxy<B, T>;
+        using size_type = std::size_t;
+
+        batch_iterator() = default;
+        batch_iterator(pointer data, size_type size, difference_type index = 0);
+
+        template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        batch_iterator(const batch_iterator<B, U>& rhs);
+
+        reference operator*() const;
+        reference operator[](difference_type n) const;
+
+        self_type& operator++();
+        self_type operator++(int);
+        self_type& operator--();
+        self_type operator--(int);
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        pointer data() const noexcept;
+        size_type size() const noexcept;
+        difference_type index() const noexcept;
+
+    private:
+
+        pointer m_data = nullptr;
+        size_type m_size = 0;
+        difference_type m_index = 0;
+    };
+
+    template <class B, class T>
+    batch_iterator<B, T> operator+(batch_iterator<B, T> it, std::ptrdiff_t n);
+
+    template <class B, class T>
+    batch_iterator<B, T> operator+(std::ptrdiff_t n, batch_iterator<B, T> it);
+
+    template <class B, class T>
+    batch_iterator<B, T> operator-(batch_iterator<B, T> it, std::ptrdiff_t n);
+
+    template <class B, class T>
+    std::ptrdiff_t operator-(const batch_iterator<B, T>& lhs, const batch_iterator<B, T>& rhs);
+
+    /**
+     * Range of the batches of an array, iterated with batch_iterator.
+     */
+    template <class B, class T>
+    class batch_view
+    {
+    public:
+
+        using iterator = batch_iterator<B, T>;
+        using const_iterator = iterator;
+        using size_type = std::size_t;
+        using pointer = T*;
+
+        batch_view(pointer data, size_type size);
+
+        iterator begin() const;
+        iterator end() const;
+
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+
+    private:
+
+        pointer m_data;
+        size_type m_size;
+    };
+
+    template <class C>
+    batch_view<typename simd_traits<typename C::value_type>::type, typename std::remove_pointer<decltype(std::declval<C&>().data())>::type>
+    batch_range(C& c);
+
+    template <class T>
+    batch_view<typename simd_traits<typename std::remove_const<T>::type>::type, T>
+    batch_range(T* data, std::size_t size);
+
     /******************************
      * batch proxy implementation *
      *****************************/
@@ -204,6 +365,322 @@ namespace xsimd
         return !lhs.equal(rhs);
     }
 
+    /*************************************
+     * masked_batch_proxy implementation *
+     *************************************/
+
+    template <class B, class T>
+    inline masked_batch_proxy<B, T>::masked_batch_proxy(pointer ptr, size_type count)
+        : m_ptr(ptr), m_count(count)
+    {
+    }
+
+    /**
+     * Returns the number of elements of the array in the batch.
+     */
+    template <class B, class T>
+    inline auto masked_batch_proxy<B, T>::size() const noexcept -> size_type
+    {
+        return m_count;
+    }
+
+    template <class B, class T>
+    inline bool masked_batch_proxy<B, T>::is_partial() const noexcept
+    {
+        return m_count < B::size;
+    }
+
+    /**
+     * Returns the mask of the lanes holding elements of the array.
+     */
+    template <class B, class T>
+    inline auto masked_batch_proxy<B, T>::mask() const -> batch_bool_type
+    {
+        aligned_stack_buffer<value_type, B::size, alignof(B)> index;
+        for (size_type i = 0; i < B::size; ++i)
+        {
+            index[i] = static_cast<value_type>(i);
+        }
+        batch_type lanes;
+        lanes.load_aligned(index.data());
+        return lanes < batch_type(static_cast<value_type>(m_count));
+    }
+
+    template <class B, class T>
+    inline auto masked_batch_proxy<B, T>::get() const -> batch_type
+    {
+        batch_type res;
+        if (m_count == B::size)
+        {
+            res.load_unaligned(m_ptr);
+        }
+        else
+        {
+            aligned_stack_buffer<value_type, B::size, alignof(B)> buffer;
+            std::fill(buffer.begin(), buffer.end(), value_type());
+            std::copy(m_ptr, m_ptr + m_count, buffer.begin());
+            res.load_aligned(buffer.data());
+        }
+        return res;
+    }
+
+    template <class B, class T>
+    inline masked_batch_proxy<B, T>::operator batch_type() const
+    {
+        return get();
+    }
+
+    template <class B, class T>
+    inline auto masked_batch_proxy<B, T>::operator=(const batch_type& rhs) -> masked_batch_proxy&
+    {
+        if (m_count == B::size)
+        {
+            rhs.store_unaligned(m_ptr);
+        }
+        else
+        {
+            aligned_stack_buffer<value_type, B::size, alignof(B)> buffer;
+            rhs.store_aligned(buffer.data());
+            std::copy(buffer.begin(), buffer.begin() + m_count, m_ptr);
+        }
+        return *this;
+    }
+
+    template <class B, class T>
+    inline auto masked_batch_proxy<B, T>::operator=(const masked_batch_proxy& rhs) -> masked_batch_proxy&
+    {
+        return *this = rhs.get();
+    }
+
+    /**
+     * Swaps the elements referred to by two proxies of the same size.
+     */
+    template <class B, class T>
+    inline void swap(masked_batch_proxy<B, T> lhs, masked_batch_proxy<B, T> rhs)
+    {
+        B tmp = lhs.get();
+        lhs = rhs.get();
+        rhs = tmp;
+    }
+
+    /*********************************
+     * batch_iterator implementation *
+     *********************************/
+
+    /**
+     * Builds an iterator on the batch index of the array of size elements
+     * starting at data.
+     */
+    template <class B, class T>
+    inline batch_iterator<B, T>::batch_iterator(pointer data, size_type size, difference_type index)
+        : m_data(data), m_size(size), m_index(index)
+    {
+    }
+
+    template <class B, class T>
+    template <class U, class>
+    inline batch_iterator<B, T>::batch_iterator(const batch_iterator<B, U>& rhs)
+        : m_data(rhs.data()), m_size(rhs.size()), m_index(rhs.index())
+    {
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::operator*() const -> reference
+    {
+        return (*this)[0];
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::operator[](difference_type n) const -> reference
+    {
+        size_type first = static_cast<size_type>(m_index + n) * batch_size;
+        size_type count = m_size - first < batch_size ? m_size - first : batch_size;
+        return reference(m_data + first, count);
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::operator++() -> self_type&
+    {
+        ++m_index;
+        return *this;
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::operator++(int) -> self_type
+    {
+        self_type tmp(*this);
+        ++m_index;
+        return tmp;
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::operator--() -> self_type&
+    {
+        --m_index;
+        return *this;
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::operator--(int) -> self_type
+    {
+        self_type tmp(*this);
+        --m_index;
+        return tmp;
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::operator+=(difference_type n) -> self_type&
+    {
+        m_index += n;
+        return *this;
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::operator-=(difference_type n) -> self_type&
+    {
+        m_index -= n;
+        return *this;
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::data() const noexcept -> pointer
+    {
+        return m_data;
+    }
+
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the position of the iterator, in number of batches.
+     */
+    template <class B, class T>
+    inline auto batch_iterator<B, T>::index() const noexcept -> difference_type
+    {
+        return m_index;
+    }
+
+    template <class B, class T>
+    inline batch_iterator<B, T> operator+(batch_iterator<B, T> it, std::ptrdiff_t n)
+    {
+        return it += n;
+    }
+
+    template <class B, class T>
+    inline batch_iterator<B, T> operator+(std::ptrdiff_t n, batch_iterator<B, T> it)
+    {
+        return it += n;
+    }
+
+    template <class B, class T>
+    inline batch_iterator<B, T> operator-(batch_iterator<B, T> it, std::ptrdiff_t n)
+    {
+        return it -= n;
+    }
+
+    template <class B, class T>
+    inline std::ptrdiff_t operator-(const batch_iterator<B, T>& lhs, const batch_iterator<B, T>& rhs)
+    {
+        return lhs.index() - rhs.index();
+    }
+
+    template <class B, class T>
+    inline bool operator==(const batch_iterator<B, T>& lhs, const batch_iterator<B, T>& rhs)
+    {
+        return lhs.index() == rhs.index();
+    }
+
+    template <class B, class T>
+    inline bool operator!=(const batch_iterator<B, T>& lhs, const batch_iterator<B, T>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class B, class T>
+    inline bool operator<(const batch_iterator<B, T>& lhs, const batch_iterator<B, T>& rhs)
+    {
+        return lhs.index() < rhs.index();
+    }
+
+    template <class B, class T>
+    inline bool operator>(const batch_iterator<B, T>& lhs, const batch_iterator<B, T>& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class B, class T>
+    inline bool operator<=(const batch_iterator<B, T>& lhs, const batch_iterator<B, T>& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class B, class T>
+    inline bool operator>=(const batch_iterator<B, T>& lhs, const batch_iterator<B, T>& rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    /*****************************
+     * batch_view implementation *
+     *****************************/
+
+    template <class B, class T>
+    inline batch_view<B, T>::batch_view(pointer data, size_type size)
+        : m_data(data), m_size(size)
+    {
+    }
+
+    template <class B, class T>
+    inline auto batch_view<B, T>::begin() const -> iterator
+    {
+        return iterator(m_data, m_size, 0);
+    }
+
+    template <class B, class T>
+    inline auto batch_view<B, T>::end() const -> iterator
+    {
+        return iterator(m_data, m_size, static_cast<std::ptrdiff_t>(size()));
+    }
+
+    /**
+     * Returns the number of batches, including the partial last one.
+     */
+    template <class B, class T>
+    inline auto batch_view<B, T>::size() const noexcept -> size_type
+    {
+        return (m_size + B::size - 1) / B::size;
+    }
+
+    template <class B, class T>
+    inline bool batch_view<B, T>::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /**
+     * Returns the range of the batches of the contiguous container c.
+     */
+    template <class C>
+    inline batch_view<typename simd_traits<typename C::value_type>::type, typename std::remove_pointer<decltype(std::declval<C&>().data())>::type>
+    batch_range(C& c)
+    {
+        using view_type = batch_view<typename simd_traits<typename C::value_type>::type, typename std::remove_pointer<decltype(std::declval<C&>().data())>::type>;
+        return view_type(c.data(), c.size());
+    }
+
+    /**
+     * Returns the range of the batches of the size elements starting at data.
+     */
+    template <class T>
+    inline batch_view<typename simd_traits<typename std::remove_const<T>::type>::type, T>
+    batch_range(T* data, std::size_t size)
+    {
+        return batch_view<typename simd_traits<typename std::remove_const<T>::type>::type, T>(data, size);
+    }
+
 #if defined(_WIN32) && defined(__clang__)
     // See comment at the end of simd_base.hpp
     template <class B>
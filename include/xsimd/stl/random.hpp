@@ -0,0 +1,451 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_RANDOM_HPP
+#define XSIMD_RANDOM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../math/xsimd_math.hpp"
+
+namespace xsimd
+{
+    /***********
+     * engines *
+     ***********/
+
+    // The engines below return a batch of random bits per call, each lane
+    // being an independent stream. The distributions turn the bits of an
+    // engine into floating point batches of the same width.
+
+    /**
+     * xoshiro256++ generator of Blackman and Vigna, running one generator
+     * per lane of the batch of uint64_t B. The lanes are seeded with
+     * consecutive outputs of splitmix64.
+     */
+    template <class B>
+    class xoshiro256pp
+    {
+    public:
+
+        using result_type = B;
+        using value_type = typename B::value_type;
+
+        explicit xoshiro256pp(uint64_t seed = 0);
+
+        void seed(uint64_t seed);
+        result_type operator()();
+
+    private:
+
+        result_type m_state[4];
+    };
+
+    /**
+     * Philox4x32-10 counter-based generator of Salmon et al. The lane i of
+     * the block b encrypts the counter (i, b) with a key made of the seed,
+     * and the four words of the result are returned by four consecutive
+     * calls.
+     */
+    template <class B>
+    class philox4x32
+    {
+    public:
+
+        using result_type = B;
+        using value_type = typename B::value_type;
+
+        explicit philox4x32(uint64_t seed = 0, uint64_t block = 0);
+
+        void seed(uint64_t seed, uint64_t block = 0);
+        result_type operator()();
+
+    private:
+
+        void generate();
+
+        uint32_t m_key[2];
+        uint64_t m_block;
+        result_type m_output[4];
+        std::size_t m_index;
+    };
+
+    /*****************
+     * distributions *
+     *****************/
+
+    /**
+     * Uniform distribution over [a, b) of the floating point batch B.
+     */
+    template <class B>
+    class uniform_distribution
+    {
+    public:
+
+        using batch_type = B;
+        using value_type = typename B::value_type;
+
+        explicit uniform_distribution(value_type a = value_type(0), value_type b = value_type(1));
+
+        template <class E>
+        batch_type operator()(E& engine);
+
+    private:
+
+        value_type m_a;
+        value_type m_range;
+    };
+
+    /**
+     * Normal distribution of the floating point batch B, computed with
+     * the Box-Muller transform. Each transform gives two batches, the
+     * second one being returned by the next call.
+     */
+    template <class B>
+    class normal_distribution
+    {
+    public:
+
+        using batch_type = B;
+        using value_type = typename B::value_type;
+
+        explicit normal_distribution(value_type mean = value_type(0), value_type stddev = value_type(1));
+
+        void reset();
+
+        template <class E>
+        batch_type operator()(E& engine);
+
+    private:
+
+        value_type m_mean;
+        value_type m_stddev;
+        batch_type m_cache;
+        bool m_cached;
+    };
+
+    /**
+     * Exponential distribution of rate lambda of the floating point batch
+     * B.
+     */
+    template <class B>
+    class exponential_distribution
+    {
+    public:
+
+        using batch_type = B;
+        using value_type = typename B::value_type;
+
+        explicit exponential_distribution(value_type lambda = value_type(1));
+
+        template <class E>
+        batch_type operator()(E& engine);
+
+    private:
+
+        value_type m_inv_lambda;
+    };
+
+    template <class E, class D, class T>
+    void fill(E& engine, D& distribution, T* first, std::size_t n);
+
+    /**************************
+     * engines implementation *
+     **************************/
+
+    namespace detail
+    {
+        inline uint64_t splitmix64(uint64_t& x)
+        {
+            uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        template <class B>
+        inline B random_rotl(const B& x, int32_t k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        // High and low halves of the 64-bit products of the lanes of b by
+        // m, from the products of their 16-bit halves which cannot
+        // overflow 32-bit lanes.
+        template <class B>
+        inline void random_mulhilo(uint32_t m, const B& b, B& hi, B& lo)
+        {
+            const B low_mask(uint32_t(0xffff));
+            B b_lo = b & low_mask, b_hi = b >> 16;
+            B m_lo(m & 0xffff), m_hi(m >> 16);
+            B ll = b_lo * m_lo, lh = b_lo * m_hi, hl = b_hi * m_lo;
+            B mid = (ll >> 16) + (lh & low_mask) + (hl & low_mask);
+            hi = b_hi * m_hi + (lh >> 16) + (hl >> 16) + (mid >> 16);
+            lo = b * B(m);
+        }
+    }
+
+    template <class B>
+    inline xoshiro256pp<B>::xoshiro256pp(uint64_t seed)
+    {
+        this->seed(seed);
+    }
+
+    /**
+     * Restarts the generator from the given seed.
+     */
+    template <class B>
+    inline void xoshiro256pp<B>::seed(uint64_t seed)
+    {
+        static_assert(std::is_same<value_type, uint64_t>::value, "xoshiro256pp requires batches of uint64_t");
+        uint64_t words[B::size];
+        for (std::size_t w = 0; w < 4; ++w)
+        {
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                words[i] = detail::splitmix64(seed);
+            }
+            m_state[w].load_unaligned(words);
+        }
+    }
+
+    /**
+     * Returns the next batch of 64 random bits per lane.
+     */
+    template <class B>
+    inline auto xoshiro256pp<B>::operator()() -> result_type
+    {
+        result_type res = detail::random_rotl(m_state[0] + m_state[3], 23) + m_state[0];
+        result_type t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = detail::random_rotl(m_state[3], 45);
+        return res;
+    }
+
+    template <class B>
+    inline philox4x32<B>::philox4x32(uint64_t seed, uint64_t block)
+    {
+        this->seed(seed, block);
+    }
+
+    /**
+     * Restarts the generator from the given seed, at the given block of
+     * four batches.
+     */
+    template <class B>
+    inline void philox4x32<B>::seed(uint64_t seed, uint64_t block)
+    {
+        static_assert(std::is_same<value_type, uint32_t>::value, "philox4x32 requires batches of uint32_t");
+        m_key[0] = static_cast<uint32_t>(seed);
+        m_key[1] = static_cast<uint32_t>(seed >> 32);
+        m_block = block;
+        m_index = 4;
+    }
+
+    /**
+     * Returns the next batch of 32 random bits per lane.
+     */
+    template <class B>
+    inline auto philox4x32<B>::operator()() -> result_type
+    {
+        if (m_index == 4)
+        {
+            generate();
+            m_index = 0;
+        }
+        return m_output[m_index++];
+    }
+
+    template <class B>
+    inline void philox4x32<B>::generate()
+    {
+        uint32_t lanes[B::size];
+        for (std::size_t i = 0; i < B::size; ++i)
+        {
+            lanes[i] = static_cast<uint32_t>(i);
+        }
+        result_type c0, c1(static_cast<uint32_t>(m_block)), c2(static_cast<uint32_t>(m_block >> 32)), c3(uint32_t(0));
+        c0.load_unaligned(lanes);
+        uint32_t k0 = m_key[0], k1 = m_key[1];
+        for (std::size_t r = 0; r < 10; ++r)
+        {
+            result_type hi0, lo0, hi1, lo1;
+            detail::random_mulhilo(0xd2511f53u, c0, hi0, lo0);
+            detail::random_mulhilo(0xcd9e8d57u, c2, hi1, lo1);
+            c0 = hi1 ^ c1 ^ result_type(k0);
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ result_type(k1);
+            c3 = lo0;
+            k0 += 0x9e3779b9u;
+            k1 += 0xbb67ae85u;
+        }
+        m_output[0] = c0;
+        m_output[1] = c1;
+        m_output[2] = c2;
+        m_output[3] = c3;
+        ++m_block;
+    }
+
+    /********************************
+     * distributions implementation *
+     ********************************/
+
+    namespace detail
+    {
+        template <class T>
+        struct random_bits;
+
+        template <>
+        struct random_bits<float>
+        {
+            using integer_type = int32_t;
+            static constexpr uint32_t mantissa = 0x007fffff;
+            static constexpr uint32_t one = 0x3f800000;
+        };
+
+        template <>
+        struct random_bits<double>
+        {
+            using integer_type = int64_t;
+            static constexpr uint64_t mantissa = 0x000fffffffffffffull;
+            static constexpr uint64_t one = 0x3ff0000000000000ull;
+        };
+
+        template <class B, class R>
+        inline B random_bits_as(const R& bits)
+        {
+            using engine_type = typename R::value_type;
+            using integer_type = typename std::make_signed<engine_type>::type;
+            static_assert(sizeof(engine_type) * R::size == sizeof(typename B::value_type) * B::size,
+                          "the engine and the distribution require batches of the same width");
+            return bitwise_cast<B>(batch_cast<integer_type>(bits));
+        }
+
+        // Uniform values in [0, 1) made of the low bits of the engine
+        // output, used as the mantissa of a value in [1, 2).
+        template <class B, class E>
+        inline B random_unit(E& engine)
+        {
+            using value_type = typename B::value_type;
+            using bits_type = random_bits<value_type>;
+            using integer_batch = batch<typename bits_type::integer_type, B::size>;
+            const B mantissa = bitwise_cast<B>(integer_batch(static_cast<typename bits_type::integer_type>(bits_type::mantissa)));
+            const B one = bitwise_cast<B>(integer_batch(static_cast<typename bits_type::integer_type>(bits_type::one)));
+            return ((random_bits_as<B>(engine()) & mantissa) | one) - B(value_type(1));
+        }
+    }
+
+    template <class B>
+    inline uniform_distribution<B>::uniform_distribution(value_type a, value_type b)
+        : m_a(a), m_range(b - a)
+    {
+        static_assert(std::is_floating_point<value_type>::value, "uniform_distribution requires floating point batches");
+    }
+
+    /**
+     * Returns a batch of values uniformly distributed in [a, b).
+     */
+    template <class B>
+    template <class E>
+    inline auto uniform_distribution<B>::operator()(E& engine) -> batch_type
+    {
+        return fma(detail::random_unit<batch_type>(engine), batch_type(m_range), batch_type(m_a));
+    }
+
+    template <class B>
+    inline normal_distribution<B>::normal_distribution(value_type mean, value_type stddev)
+        : m_mean(mean), m_stddev(stddev), m_cached(false)
+    {
+        static_assert(std::is_floating_point<value_type>::value, "normal_distribution requires floating point batches");
+    }
+
+    /**
+     * Drops the batch computed by the previous transform, so that the next
+     * call only depends on the engine.
+     */
+    template <class B>
+    inline void normal_distribution<B>::reset()
+    {
+        m_cached = false;
+    }
+
+    /**
+     * Returns a batch of normally distributed values.
+     */
+    template <class B>
+    template <class E>
+    inline auto normal_distribution<B>::operator()(E& engine) -> batch_type
+    {
+        if (m_cached)
+        {
+            m_cached = false;
+            return m_cache;
+        }
+        const batch_type one(value_type(1)), half(value_type(0.5));
+        // 1 - u is in (0, 1], where the logarithm is finite
+        batch_type radius = sqrt(batch_type(value_type(-2)) * log(one - detail::random_unit<batch_type>(engine)));
+        batch_type angle = (detail::random_unit<batch_type>(engine) - half) * (batch_type(value_type(2)) * pi<batch_type>());
+        batch_type s, c;
+        sincos(angle, s, c);
+        m_cache = fma(radius * s, batch_type(m_stddev), batch_type(m_mean));
+        m_cached = true;
+        return fma(radius * c, batch_type(m_stddev), batch_type(m_mean));
+    }
+
+    template <class B>
+    inline exponential_distribution<B>::exponential_distribution(value_type lambda)
+        : m_inv_lambda(value_type(1) / lambda)
+    {
+        static_assert(std::is_floating_point<value_type>::value, "exponential_distribution requires floating point batches");
+    }
+
+    /**
+     * Returns a batch of exponentially distributed values.
+     */
+    template <class B>
+    template <class E>
+    inline auto exponential_distribution<B>::operator()(E& engine) -> batch_type
+    {
+        batch_type u = detail::random_unit<batch_type>(engine);
+        return -log(batch_type(value_type(1)) - u) * batch_type(m_inv_lambda);
+    }
+
+    /**
+     * Fills [first, first + n) with values of the distribution drawn from
+     * the engine, a batch at a time. The last values of a batch which
+     * does not fit are dropped.
+     */
+    template <class E, class D, class T>
+    void fill(E& engine, D& distribution, T* first, std::size_t n)
+    {
+        using batch_type = typename D::batch_type;
+        constexpr std::size_t size = batch_type::size;
+        std::size_t i = 0;
+        for (; i + size <= n; i += size)
+        {
+            distribution(engine).store_unaligned(first + i);
+        }
+        if (i != n)
+        {
+            T tail[size];
+            distribution(engine).store_unaligned(tail);
+            std::copy(tail, tail + (n - i), first + i);
+        }
+    }
+}
+
+#endif
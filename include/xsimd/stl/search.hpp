@@ -0,0 +1,362 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_SEARCH_HPP
+#define XSIMD_SEARCH_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "algorithms.hpp"
+
+namespace xsimd
+{
+    /*********************
+     * batched searching *
+     *********************/
+
+    // The functions below look up count keys at once: every lane of a batch
+    // runs its own branchless binary search, with its probes gathered from
+    // the array, and several batches are searched together so that their
+    // loads overlap. out receives the positions of the lower bounds in the
+    // sorted array, n when every element is less than the key.
+
+    template <class T>
+    void lower_bound_batch(const T* sorted, std::size_t n, const T* keys, std::size_t count, std::size_t* out);
+
+    template <class T>
+    void eytzinger_layout(const T* sorted, std::size_t n, T* layout);
+
+    template <class T>
+    void lower_bound_eytzinger(const T* layout, std::size_t n, const T* keys, std::size_t count, std::size_t* out);
+
+    /************************************
+     * batched searching implementation *
+     ************************************/
+
+    namespace detail
+    {
+        inline std::size_t floor_log2(uint64_t x)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<std::size_t>(63 - __builtin_clzll(x));
+#else
+            std::size_t res = 0;
+            while (x >>= 1)
+            {
+                ++res;
+            }
+            return res;
+#endif
+        }
+
+        inline std::size_t count_trailing_ones(uint64_t x)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return ~x == 0 ? 64 : static_cast<std::size_t>(__builtin_ctzll(~x));
+#else
+            std::size_t res = 0;
+            for (; x & 1; x >>= 1)
+            {
+                ++res;
+            }
+            return res;
+#endif
+        }
+
+        // Searches are vectorized for the types that gather with indices of
+        // their own width.
+        template <class T>
+        using search_vectorized = std::integral_constant<bool, (simd_traits<T>::size > 1) && (sizeof(T) >= 4)>;
+
+        // Batches searched together, enough to cover the latency of a gather
+        constexpr std::size_t search_interleave = 4;
+
+        // Eytzinger layouts larger than this are expected to be out of the L2
+        // cache, where the probes of the levels below are prefetched.
+        constexpr std::size_t search_prefetch_bytes = std::size_t(1) << 20;
+
+        template <class T, std::size_t N, class I>
+        inline void store_positions(const batch<I, N>& positions, std::size_t* out)
+        {
+            alignas(batch<I, N>) I buffer[N];
+            positions.store_aligned(buffer);
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                out[i] = static_cast<std::size_t>(buffer[i]);
+            }
+        }
+
+        template <class T, std::size_t N, class I>
+        inline void prefetch_lanes(const T* src, const batch<I, N>& index)
+        {
+            alignas(batch<I, N>) I buffer[N];
+            index.store_aligned(buffer);
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                prefetch(src + buffer[i]);
+            }
+        }
+
+        /*****************
+         * sorted arrays *
+         *****************/
+
+        // All the lanes share the length of the remaining range, so that
+        // only the base of the range differs from one lane to the other.
+        // The next probes are spread over the array, prefetching them costs
+        // more than the interleaved gathers already hide.
+        template <std::size_t U, class T>
+        inline void lower_bound_block(const T* sorted, std::size_t n, const T* keys, std::size_t* out)
+        {
+            using batch_type = typename simd_traits<T>::type;
+            using index_traits = lane_integer_traits<T>;
+            using index_type = typename index_traits::integer_type;
+            constexpr std::size_t simd_size = simd_traits<T>::size;
+            using index_batch = batch<index_type, simd_size>;
+
+            batch_type key[U];
+            index_batch base[U];
+            for (std::size_t u = 0; u < U; ++u)
+            {
+                key[u] = batch_type(keys + u * simd_size, unaligned_mode());
+                base[u] = index_batch(index_type(0));
+            }
+            for (std::size_t len = n; len > 1;)
+            {
+                const std::size_t half = len / 2;
+                len -= half;
+                const index_batch step(static_cast<index_type>(half));
+                for (std::size_t u = 0; u < U; ++u)
+                {
+                    auto less = gather(sorted, base[u] + step) < key[u];
+                    base[u] = select(index_traits::mask(less), base[u] + step, base[u]);
+                }
+            }
+            for (std::size_t u = 0; u < U; ++u)
+            {
+                auto less = gather(sorted, base[u]) < key[u];
+                index_batch res = select(index_traits::mask(less), base[u] + index_batch(index_type(1)), base[u]);
+                store_positions<T>(res, out + u * simd_size);
+            }
+        }
+
+        template <class T>
+        inline void lower_bound_batch_impl(const T* sorted, std::size_t n, const T* keys, std::size_t count, std::size_t* out, std::true_type)
+        {
+            // gather instructions take signed indices
+            using index_type = as_integer_t<T>;
+            constexpr std::size_t simd_size = simd_traits<T>::size;
+            std::size_t i = 0;
+            if (n > 0 && n <= static_cast<std::size_t>((std::numeric_limits<index_type>::max)()))
+            {
+                constexpr std::size_t block = search_interleave * simd_size;
+                for (; i + block <= count; i += block)
+                {
+                    lower_bound_block<search_interleave>(sorted, n, keys + i, out + i);
+                }
+                for (; i + simd_size <= count; i += simd_size)
+                {
+                    lower_bound_block<1>(sorted, n, keys + i, out + i);
+                }
+            }
+            for (; i < count; ++i)
+            {
+                out[i] = static_cast<std::size_t>(std::lower_bound(sorted, sorted + n, keys[i]) - sorted);
+            }
+        }
+
+        template <class T>
+        inline void lower_bound_batch_impl(const T* sorted, std::size_t n, const T* keys, std::size_t count, std::size_t* out, std::false_type)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out[i] = static_cast<std::size_t>(std::lower_bound(sorted, sorted + n, keys[i]) - sorted);
+            }
+        }
+
+        /********************
+         * Eytzinger layout *
+         ********************/
+
+        // Position in the sorted array of the node k of the Eytzinger layout
+        // of n elements: its in-order position in the perfect tree of the
+        // same height, minus the missing leaves of the last level before it.
+        inline std::size_t eytzinger_rank(std::size_t k, std::size_t n)
+        {
+            const std::size_t height = floor_log2(n);
+            const std::size_t depth = floor_log2(k);
+            const std::size_t rank = ((2 * (k - (std::size_t(1) << depth)) + 1) << (height - depth)) - 1;
+            const std::size_t leaves = n - ((std::size_t(1) << height) - 1);
+            const std::size_t leaves_before = (rank + 1) / 2;
+            return leaves_before > leaves ? rank - (leaves_before - leaves) : rank;
+        }
+
+        // The search ends below the node where it last went left, which
+        // holds the lower bound: it is found by removing the right turns
+        // and that left turn from the path.
+        inline std::size_t eytzinger_position(std::size_t k, std::size_t n)
+        {
+            std::size_t shift = count_trailing_ones(k) + 1;
+            k = shift < 64 ? k >> shift : 0;
+            return k == 0 ? n : eytzinger_rank(k, n);
+        }
+
+        // The levels above the last one are complete, so that every lane
+        // descends them; the last level is only probed by the lanes whose
+        // node exists. The descendants of a node some levels below are
+        // contiguous, one cache line of them is prefetched.
+        template <std::size_t U, class T>
+        inline void lower_bound_eytzinger_block(const T* layout, std::size_t n, const T* keys, std::size_t* out, bool prefetch_probes)
+        {
+            using batch_type = typename simd_traits<T>::type;
+            using index_traits = lane_integer_traits<T>;
+            using index_type = typename index_traits::integer_type;
+            constexpr std::size_t simd_size = simd_traits<T>::size;
+            using index_batch = batch<index_type, simd_size>;
+            constexpr std::size_t line = 64 / sizeof(T);
+
+            const std::size_t height = floor_log2(n);
+            const std::size_t prefetch_levels = floor_log2(line);
+            const index_batch one(index_type(1));
+            batch_type key[U];
+            index_batch k[U];
+            for (std::size_t u = 0; u < U; ++u)
+            {
+                key[u] = batch_type(keys + u * simd_size, unaligned_mode());
+                k[u] = one;
+            }
+            for (std::size_t level = 0; level < height; ++level)
+            {
+                for (std::size_t u = 0; u < U; ++u)
+                {
+                    if (prefetch_probes && level + prefetch_levels < height)
+                    {
+                        prefetch_lanes(layout, k[u] << static_cast<int32_t>(prefetch_levels));
+                    }
+                    auto less = gather(layout, k[u]) < key[u];
+                    k[u] = (k[u] + k[u]) + select(index_traits::mask(less), one, index_batch(index_type(0)));
+                }
+            }
+            const index_batch last(static_cast<index_type>(n));
+            for (std::size_t u = 0; u < U; ++u)
+            {
+                auto exists = k[u] <= last;
+                auto less = gather(layout, min(k[u], last)) < key[u];
+                index_batch child = (k[u] + k[u]) + select(index_traits::mask(less), one, index_batch(index_type(0)));
+                k[u] = select(exists, child, k[u]);
+
+                alignas(index_batch) index_type buffer[simd_size];
+                k[u].store_aligned(buffer);
+                for (std::size_t i = 0; i < simd_size; ++i)
+                {
+                    out[u * simd_size + i] = eytzinger_position(static_cast<std::size_t>(buffer[i]), n);
+                }
+            }
+        }
+
+        template <class T>
+        inline std::size_t lower_bound_eytzinger_scalar(const T* layout, std::size_t n, const T& key)
+        {
+            std::size_t k = 1;
+            while (k <= n)
+            {
+                k = 2 * k + (layout[k] < key ? 1 : 0);
+            }
+            return eytzinger_position(k, n);
+        }
+
+        template <class T>
+        inline void lower_bound_eytzinger_impl(const T* layout, std::size_t n, const T* keys, std::size_t count, std::size_t* out, std::true_type)
+        {
+            using index_type = as_integer_t<T>;
+            constexpr std::size_t simd_size = simd_traits<T>::size;
+            std::size_t i = 0;
+            // the children of the last node must fit the signed indices
+            if (n > 0 && n < static_cast<std::size_t>((std::numeric_limits<index_type>::max)()) / 2)
+            {
+                const bool prefetch_probes = n * sizeof(T) > search_prefetch_bytes;
+                constexpr std::size_t block = search_interleave * simd_size;
+                for (; i + block <= count; i += block)
+                {
+                    lower_bound_eytzinger_block<search_interleave>(layout, n, keys + i, out + i, prefetch_probes);
+                }
+                for (; i + simd_size <= count; i += simd_size)
+                {
+                    lower_bound_eytzinger_block<1>(layout, n, keys + i, out + i, prefetch_probes);
+                }
+            }
+            for (; i < count; ++i)
+            {
+                out[i] = lower_bound_eytzinger_scalar(layout, n, keys[i]);
+            }
+        }
+
+        template <class T>
+        inline void lower_bound_eytzinger_impl(const T* layout, std::size_t n, const T* keys, std::size_t count, std::size_t* out, std::false_type)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out[i] = lower_bound_eytzinger_scalar(layout, n, keys[i]);
+            }
+        }
+    }
+
+    /**
+     * For each of the count keys, writes to out the position of the first
+     * element of the sorted array [sorted, sorted + n) which is not less
+     * than the key, as std::lower_bound does.
+     */
+    template <class T>
+    void lower_bound_batch(const T* sorted, std::size_t n, const T* keys, std::size_t count, std::size_t* out)
+    {
+        static_assert(std::is_arithmetic<T>::value, "lower_bound_batch requires arithmetic values");
+        detail::lower_bound_batch_impl(sorted, n, keys, count, out, detail::search_vectorized<T>());
+    }
+
+    /**
+     * Copies the sorted array [sorted, sorted + n) to layout in Eytzinger
+     * order: the children of the element at position k are at 2k and
+     * 2k + 1, starting from the root at position 1, so that the first
+     * levels of every search share the same cache lines. layout must hold
+     * n + 1 elements; layout[0] is not used by the search and receives the
+     * first element.
+     */
+    template <class T>
+    void eytzinger_layout(const T* sorted, std::size_t n, T* layout)
+    {
+        if (n == 0)
+        {
+            return;
+        }
+        layout[0] = sorted[0];
+        for (std::size_t k = 1; k <= n; ++k)
+        {
+            layout[k] = sorted[detail::eytzinger_rank(k, n)];
+        }
+    }
+
+    /**
+     * Same as lower_bound_batch, for the array of n elements laid out by
+     * eytzinger_layout. The positions written to out are the positions in
+     * the sorted array.
+     */
+    template <class T>
+    void lower_bound_eytzinger(const T* layout, std::size_t n, const T* keys, std::size_t count, std::size_t* out)
+    {
+        static_assert(std::is_arithmetic<T>::value, "lower_bound_eytzinger requires arithmetic values");
+        detail::lower_bound_eytzinger_impl(layout, n, keys, count, out, detail::search_vectorized<T>());
+    }
+}
+
+#endif
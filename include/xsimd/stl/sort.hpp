@@ -0,0 +1,766 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_SORT_HPP
+#define XSIMD_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithms.hpp"
+
+namespace xsimd
+{
+    /***********
+     * sorting *
+     ***********/
+
+    // Ranges are sorted in ascending order with a quicksort whose partition
+    // step compresses every batch to both ends of the range; partitions
+    // fitting in a few batches are sorted in registers by bitonic networks.
+    // NaN keys are not supported.
+
+    template <class Iterator1, class Iterator2>
+    void sort(Iterator1 first, Iterator2 last);
+
+    template <class Iterator1, class Iterator2, class Iterator3>
+    void sort_by_key(Iterator1 keys_first, Iterator2 keys_last, Iterator3 values_first);
+
+    /***************************
+     * sorting implementation  *
+     ***************************/
+
+    namespace detail
+    {
+        // Partitions of at most this number of batches are sorted by the
+        // networks.
+        constexpr std::size_t sort_network_batches = 8;
+
+        template <class T>
+        inline T sort_sentinel()
+        {
+            return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                        : (std::numeric_limits<T>::max)();
+        }
+
+        /*******************
+         * bitonic network *
+         *******************/
+
+        template <class I, std::size_t J>
+        struct bitonic_partner
+        {
+            static constexpr I get(std::size_t i, std::size_t)
+            {
+                return static_cast<I>(i ^ J);
+            }
+        };
+
+        template <class I>
+        struct bitonic_reverse
+        {
+            static constexpr I get(std::size_t i, std::size_t n)
+            {
+                return static_cast<I>(n - 1 - i);
+            }
+        };
+
+        // Lanes keeping the minimum when comparing elements J apart, in
+        // blocks of K elements sorted in alternate directions
+        template <std::size_t K, std::size_t J>
+        struct bitonic_lower
+        {
+            static constexpr bool get(std::size_t i, std::size_t)
+            {
+                return ((i & J) == 0) == ((i & K) == 0);
+            }
+        };
+
+        template <class S, std::size_t K, std::size_t J>
+        struct bitonic_stage;
+
+        template <class S, std::size_t K, bool = (K < S::size)>
+        struct bitonic_next
+        {
+            static typename S::type run(const typename S::type& x)
+            {
+                return bitonic_stage<S, 2 * K, K>::run(x);
+            }
+        };
+
+        template <class S, std::size_t K>
+        struct bitonic_next<S, K, false>
+        {
+            static typename S::type run(const typename S::type& x)
+            {
+                return x;
+            }
+        };
+
+        template <class S, std::size_t K, std::size_t J>
+        struct bitonic_stage
+        {
+            static typename S::type run(const typename S::type& x)
+            {
+                return bitonic_stage<S, K, J / 2>::run(S::template exchange<K, J>(x));
+            }
+        };
+
+        template <class S, std::size_t K>
+        struct bitonic_stage<S, K, 0>
+        {
+            static typename S::type run(const typename S::type& x)
+            {
+                return bitonic_next<S, K>::run(x);
+            }
+        };
+
+        // Sorts the M batches of v as a single sequence: every batch is
+        // sorted, then runs of batches are merged with a flip followed by
+        // half-cleaners, the last ones within the batches.
+        template <class S, std::size_t M>
+        inline void bitonic_sort(typename S::type (&v)[M])
+        {
+            constexpr std::size_t size = S::size;
+            for (std::size_t b = 0; b < M; ++b)
+            {
+                v[b] = bitonic_stage<S, 2, 1>::run(v[b]);
+            }
+            for (std::size_t s = 1; s < M; s *= 2)
+            {
+                for (std::size_t base = 0; base < M; base += 2 * s)
+                {
+                    for (std::size_t i = 0; i < s; ++i)
+                    {
+                        typename S::type mirror = S::reverse(v[base + 2 * s - 1 - i]);
+                        S::minmax(v[base + i], mirror);
+                        v[base + 2 * s - 1 - i] = S::reverse(mirror);
+                    }
+                    for (std::size_t d = s / 2; d > 0; d /= 2)
+                    {
+                        for (std::size_t j = base; j < base + 2 * s; ++j)
+                        {
+                            if (((j - base) & d) == 0)
+                            {
+                                S::minmax(v[j], v[j + d]);
+                            }
+                        }
+                    }
+                }
+                for (std::size_t b = 0; b < M; ++b)
+                {
+                    v[b] = bitonic_stage<S, 2 * size, size / 2>::run(v[b]);
+                }
+            }
+        }
+
+        /*****************
+         * sorted arrays *
+         *****************/
+
+        // The sorting algorithms below only access the range through these
+        // classes, which hold the keys, and the values of sort_by_key.
+
+        template <class T, std::size_t N>
+        struct sort_keys
+        {
+            using value_type = T;
+            using batch_type = batch<T, N>;
+            using batch_bool_type = batch_bool<T, N>;
+            using index_type = as_unsigned_integer_t<T>;
+            using type = batch_type;
+            static constexpr std::size_t size = N;
+
+            T* keys;
+
+            static type reverse(const type& x)
+            {
+                return shuffle(x, xsimd::make_batch_constant<bitonic_reverse<index_type>, size>());
+            }
+
+            static void minmax(type& a, type& b)
+            {
+                type lower = min(a, b);
+                b = max(a, b);
+                a = lower;
+            }
+
+            template <std::size_t K, std::size_t J>
+            static type exchange(const type& x)
+            {
+                type partner = shuffle(x, xsimd::make_batch_constant<bitonic_partner<index_type, J>, size>());
+                return select(xsimd::make_batch_bool_constant<T, bitonic_lower<K, J>, size>(), min(x, partner), max(x, partner));
+            }
+
+            static const batch_type& key(const type& x)
+            {
+                return x;
+            }
+
+            const T& key(std::size_t i) const
+            {
+                return keys[i];
+            }
+
+            type load(std::size_t i) const
+            {
+                return batch_type(keys + i, unaligned_mode());
+            }
+
+            void store(std::size_t i, const type& x) const
+            {
+                x.store_unaligned(keys + i);
+            }
+
+            type load_padded(std::size_t i, std::size_t count) const
+            {
+                alignas(batch_type) T buffer[size];
+                std::fill(buffer + count, buffer + size, sort_sentinel<T>());
+                std::copy(keys + i, keys + i + count, buffer);
+                return batch_type(buffer, aligned_mode());
+            }
+
+            void store_partial(std::size_t i, const type& x, std::size_t count) const
+            {
+                alignas(batch_type) T buffer[size];
+                x.store_aligned(buffer);
+                std::copy(buffer, buffer + count, keys + i);
+            }
+
+            // Padding is only distinguishable from the keys equal to the
+            // sentinel when there are no values.
+            bool can_pad(std::size_t, std::size_t) const
+            {
+                return true;
+            }
+
+            // Stores the selected elements of x at first and the other ones
+            // before last; up to size elements are written on both sides.
+            std::size_t store_partitioned(const type& x, const batch_bool_type& mask, std::size_t first, std::size_t last) const
+            {
+                std::size_t count;
+                batch_type res = compress_impl<T, size>::run(x, mask, count);
+                res.store_unaligned(keys + first);
+                res.store_unaligned(keys + last - size);
+                return count;
+            }
+
+            std::size_t store_partitioned(const type& x, const batch_bool_type& mask, std::size_t first) const
+            {
+                std::size_t count;
+                compress_impl<T, size>::run(x, mask, count).store_unaligned(keys + first);
+                return count;
+            }
+
+            // Moves the count elements at i, which have been read, to both
+            // ends of [first, last)
+            template <class P>
+            void move_partitioned(std::size_t i, std::size_t count, std::size_t& first, std::size_t& last, P&& pred) const
+            {
+                T buffer[size];
+                std::copy(keys + i, keys + i + count, buffer);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    keys[pred(buffer[j]) ? first++ : --last] = buffer[j];
+                }
+            }
+
+            void fallback_sort(std::size_t first, std::size_t last) const
+            {
+                std::sort(keys + first, keys + last);
+            }
+        };
+
+        template <class T, std::size_t N>
+        constexpr std::size_t sort_keys<T, N>::size;
+
+        template <class T, std::size_t N>
+        struct sort_pairs
+        {
+            using value_type = T;
+            using batch_type = batch<T, N>;
+            using batch_bool_type = batch_bool<T, N>;
+            using index_type = as_unsigned_integer_t<T>;
+            static constexpr std::size_t size = N;
+            // values are permuted through the integers of the lanes of keys
+            using payload_traits = lane_integer_traits<T>;
+            using payload_type = typename payload_traits::integer_type;
+            using payload_batch = batch<payload_type, size>;
+
+            struct type
+            {
+                batch_type key;
+                payload_batch value;
+            };
+
+            T* keys;
+            payload_type* values;
+
+            template <class G>
+            static type shuffle_pair(const type& x)
+            {
+                constexpr auto pattern = xsimd::make_batch_constant<G, size>();
+                return { shuffle(x.key, pattern), shuffle(x.value, pattern) };
+            }
+
+            static type reverse(const type& x)
+            {
+                return shuffle_pair<bitonic_reverse<index_type>>(x);
+            }
+
+            static void minmax(type& a, type& b)
+            {
+                auto keep = a.key <= b.key;
+                auto payload_keep = payload_traits::mask(keep);
+                type lower = { select(keep, a.key, b.key), select(payload_keep, a.value, b.value) };
+                b = { select(keep, b.key, a.key), select(payload_keep, b.value, a.value) };
+                a = lower;
+            }
+
+            // Each lane keeps its own element on ties so that the values are
+            // exchanged with the keys.
+            template <std::size_t K, std::size_t J>
+            static type exchange(const type& x)
+            {
+                type partner = shuffle_pair<bitonic_partner<index_type, J>>(x);
+                constexpr auto lower = xsimd::make_batch_bool_constant<T, bitonic_lower<K, J>, size>();
+                auto keep = select(lower, x.key, partner.key) <= select(lower, partner.key, x.key);
+                return { select(keep, x.key, partner.key), select(payload_traits::mask(keep), x.value, partner.value) };
+            }
+
+            static const batch_type& key(const type& x)
+            {
+                return x.key;
+            }
+
+            const T& key(std::size_t i) const
+            {
+                return keys[i];
+            }
+
+            type load(std::size_t i) const
+            {
+                return { batch_type(keys + i, unaligned_mode()), payload_batch(values + i, unaligned_mode()) };
+            }
+
+            void store(std::size_t i, const type& x) const
+            {
+                x.key.store_unaligned(keys + i);
+                x.value.store_unaligned(values + i);
+            }
+
+            type load_padded(std::size_t i, std::size_t count) const
+            {
+                alignas(batch_type) T key_buffer[size];
+                alignas(payload_batch) payload_type value_buffer[size];
+                std::fill(key_buffer + count, key_buffer + size, sort_sentinel<T>());
+                std::fill(value_buffer + count, value_buffer + size, payload_type(0));
+                std::copy(keys + i, keys + i + count, key_buffer);
+                std::copy(values + i, values + i + count, value_buffer);
+                return { batch_type(key_buffer, aligned_mode()), payload_batch(value_buffer, aligned_mode()) };
+            }
+
+            void store_partial(std::size_t i, const type& x, std::size_t count) const
+            {
+                alignas(batch_type) T key_buffer[size];
+                alignas(payload_batch) payload_type value_buffer[size];
+                x.key.store_aligned(key_buffer);
+                x.value.store_aligned(value_buffer);
+                std::copy(key_buffer, key_buffer + count, keys + i);
+                std::copy(value_buffer, value_buffer + count, values + i);
+            }
+
+            bool can_pad(std::size_t first, std::size_t last) const
+            {
+                return std::find(keys + first, keys + last, sort_sentinel<T>()) == keys + last;
+            }
+
+            std::size_t store_partitioned(const type& x, const batch_bool_type& mask, std::size_t first, std::size_t last) const
+            {
+                std::size_t count;
+                batch_type key = compress_impl<T, size>::run(x.key, mask, count);
+                payload_batch value = compress_impl<payload_type, size>::run(x.value, payload_traits::mask(mask), count);
+                key.store_unaligned(keys + first);
+                key.store_unaligned(keys + last - size);
+                value.store_unaligned(values + first);
+                value.store_unaligned(values + last - size);
+                return count;
+            }
+
+            std::size_t store_partitioned(const type& x, const batch_bool_type& mask, std::size_t first) const
+            {
+                std::size_t count;
+                compress_impl<T, size>::run(x.key, mask, count).store_unaligned(keys + first);
+                compress_impl<payload_type, size>::run(x.value, payload_traits::mask(mask), count).store_unaligned(values + first);
+                return count;
+            }
+
+            template <class P>
+            void move_partitioned(std::size_t i, std::size_t count, std::size_t& first, std::size_t& last, P&& pred) const
+            {
+                T key_buffer[size];
+                payload_type value_buffer[size];
+                std::copy(keys + i, keys + i + count, key_buffer);
+                std::copy(values + i, values + i + count, value_buffer);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    std::size_t dst = pred(key_buffer[j]) ? first++ : --last;
+                    keys[dst] = key_buffer[j];
+                    values[dst] = value_buffer[j];
+                }
+            }
+
+            void fallback_sort(std::size_t first, std::size_t last) const
+            {
+                std::vector<std::pair<T, payload_type>> pairs(last - first);
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    pairs[i - first] = std::make_pair(keys[i], values[i]);
+                }
+                std::sort(pairs.begin(), pairs.end(), [](const std::pair<T, payload_type>& lhs, const std::pair<T, payload_type>& rhs) {
+                    return lhs.first < rhs.first;
+                });
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    keys[i] = pairs[i - first].first;
+                    values[i] = pairs[i - first].second;
+                }
+            }
+        };
+
+        template <class T, std::size_t N>
+        constexpr std::size_t sort_pairs<T, N>::size;
+
+        /*************
+         * quicksort *
+         *************/
+
+        template <std::size_t M, class S>
+        inline void network_sort(const S& s, std::size_t first, std::size_t count)
+        {
+            constexpr std::size_t size = S::size;
+            typename S::type v[M];
+            for (std::size_t b = 0; b < M; ++b)
+            {
+                std::size_t i = b * size;
+                v[b] = i + size <= count ? s.load(first + i) : s.load_padded(first + i, i < count ? count - i : 0);
+            }
+            bitonic_sort<S>(v);
+            for (std::size_t b = 0; b * size < count; ++b)
+            {
+                std::size_t i = b * size;
+                if (i + size <= count)
+                {
+                    s.store(first + i, v[b]);
+                }
+                else
+                {
+                    s.store_partial(first + i, v[b], count - i);
+                }
+            }
+        }
+
+        template <class S>
+        inline void small_sort(const S& s, std::size_t first, std::size_t last)
+        {
+            constexpr std::size_t size = S::size;
+            std::size_t count = last - first;
+            if (count < 2)
+            {
+                return;
+            }
+            if (count % size != 0 && !s.can_pad(first, last))
+            {
+                s.fallback_sort(first, last);
+            }
+            else if (count <= size)
+            {
+                network_sort<1>(s, first, count);
+            }
+            else if (count <= 2 * size)
+            {
+                network_sort<2>(s, first, count);
+            }
+            else if (count <= 4 * size)
+            {
+                network_sort<4>(s, first, count);
+            }
+            else
+            {
+                network_sort<sort_network_batches>(s, first, count);
+            }
+        }
+
+        template <class T>
+        inline const T& median_of_three(const T& a, const T& b, const T& c)
+        {
+            return a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        }
+
+        template <class S>
+        inline typename S::value_type choose_pivot(const S& s, std::size_t first, std::size_t last)
+        {
+            std::size_t count = last - first;
+            std::size_t mid = first + count / 2;
+            if (count < 1024)
+            {
+                return median_of_three(s.key(first), s.key(mid), s.key(last - 1));
+            }
+            std::size_t step = count / 8;
+            return median_of_three(median_of_three(s.key(first), s.key(first + step), s.key(first + 2 * step)),
+                                   median_of_three(s.key(mid - step), s.key(mid), s.key(mid + step)),
+                                   median_of_three(s.key(last - 1 - 2 * step), s.key(last - 1 - step), s.key(last - 1)));
+        }
+
+        // Moves the elements of [first, last) whose key is less than pivot,
+        // or not greater when Inclusive, to the front and returns their end.
+        // The first and last batches are kept in registers, so that the free
+        // space at both ends of the range always holds a batch once the next
+        // one is read from the end with less space; the last two batches
+        // then fill the remaining gap.
+        template <bool Inclusive, class S>
+        inline std::size_t partition(const S& s, std::size_t first, std::size_t last, typename S::value_type pivot)
+        {
+            using batch_type = typename S::batch_type;
+            using value_type = typename S::value_type;
+            constexpr std::size_t size = S::size;
+            const batch_type pivot_batch(pivot);
+            auto in_left = [&pivot_batch](const typename S::type& x) {
+                return Inclusive ? S::key(x) <= pivot_batch : S::key(x) < pivot_batch;
+            };
+
+            typename S::type left = s.load(first);
+            typename S::type right = s.load(last - size);
+            std::size_t read_first = first + size;
+            std::size_t read_last = last - size;
+            std::size_t write_first = first;
+            std::size_t write_last = last;
+            while (read_last - read_first >= size)
+            {
+                typename S::type current;
+                if (read_first - write_first <= write_last - read_last)
+                {
+                    current = s.load(read_first);
+                    read_first += size;
+                }
+                else
+                {
+                    read_last -= size;
+                    current = s.load(read_last);
+                }
+                std::size_t count = s.store_partitioned(current, in_left(current), write_first, write_last);
+                write_first += count;
+                write_last -= size - count;
+            }
+
+            s.move_partitioned(read_first, read_last - read_first, write_first, write_last, [pivot](const value_type& v) {
+                return Inclusive ? !(pivot < v) : v < pivot;
+            });
+            std::size_t count = s.store_partitioned(left, in_left(left), write_first, write_last);
+            write_first += count;
+            return write_first + s.store_partitioned(right, in_left(right), write_first);
+        }
+
+        template <class S>
+        inline void quicksort(const S& s, std::size_t first, std::size_t last, std::size_t depth)
+        {
+            while (last - first > sort_network_batches * S::size)
+            {
+                if (depth == 0)
+                {
+                    s.fallback_sort(first, last);
+                    return;
+                }
+                --depth;
+
+                auto pivot = choose_pivot(s, first, last);
+                std::size_t mid = partition<false>(s, first, last, pivot);
+                if (mid == first)
+                {
+                    // pivot is the minimum: the keys equal to it are in place
+                    first = partition<true>(s, first, last, pivot);
+                    continue;
+                }
+                if (mid - first < last - mid)
+                {
+                    quicksort(s, first, mid, depth);
+                    first = mid;
+                }
+                else
+                {
+                    quicksort(s, mid, last, depth);
+                    last = mid;
+                }
+            }
+            small_sort(s, first, last);
+        }
+
+        // Batches with a native compress are preferred to wider ones, whose
+        // partition would compress element by element.
+        template <class T, std::size_t N = simd_traits<T>::size, bool = (N > 16 / sizeof(T))>
+        struct sort_batch_size
+            : std::integral_constant<std::size_t, (compress_impl<T, N>::native ? N : 16 / sizeof(T))>
+        {
+        };
+
+        template <class T, std::size_t N>
+        struct sort_batch_size<T, N, false> : std::integral_constant<std::size_t, N>
+        {
+        };
+
+        template <class T>
+        using sort_vectorized = std::integral_constant<bool, (sort_batch_size<T>::value > 1) &&
+                                                                 (sort_batch_size<T>::value & (sort_batch_size<T>::value - 1)) == 0>;
+
+        inline std::size_t sort_depth(std::size_t size)
+        {
+            std::size_t depth = 0;
+            for (; size > 1; size >>= 1)
+            {
+                depth += 2;
+            }
+            return depth;
+        }
+
+        // Counting sort of 8-bit keys, which have fewer values than the
+        // elements of most ranges
+        template <class T>
+        inline void counting_sort(T* keys, std::size_t size)
+        {
+            std::array<std::size_t, 256> counts;
+            counts.fill(0);
+            integer_histogram(reinterpret_cast<const uint8_t*>(keys), size, counts.data());
+            T* out = keys;
+            for (int v = (std::numeric_limits<T>::min)(); v <= (std::numeric_limits<T>::max)(); ++v)
+            {
+                std::size_t count = counts[static_cast<uint8_t>(v)];
+                std::fill(out, out + count, static_cast<T>(v));
+                out += count;
+            }
+        }
+
+        template <class T>
+        inline void sort_range(T* keys, std::size_t size, std::true_type)
+        {
+            quicksort(sort_keys<T, sort_batch_size<T>::value>{ keys }, 0, size, sort_depth(size));
+        }
+
+        inline void sort_range(int8_t* keys, std::size_t size, std::true_type)
+        {
+            if (size > 256)
+            {
+                counting_sort(keys, size);
+            }
+            else
+            {
+                quicksort(sort_keys<int8_t, sort_batch_size<int8_t>::value>{ keys }, 0, size, sort_depth(size));
+            }
+        }
+
+        inline void sort_range(uint8_t* keys, std::size_t size, std::true_type)
+        {
+            if (size > 256)
+            {
+                counting_sort(keys, size);
+            }
+            else
+            {
+                quicksort(sort_keys<uint8_t, sort_batch_size<uint8_t>::value>{ keys }, 0, size, sort_depth(size));
+            }
+        }
+
+        template <class T>
+        inline void sort_range(T* keys, std::size_t size, std::false_type)
+        {
+            std::sort(keys, keys + size);
+        }
+
+        template <class T, class V>
+        using sort_by_key_vectorized = std::integral_constant<bool, sort_vectorized<T>::value && std::is_integral<V>::value &&
+                                                                        sizeof(V) == sizeof(T)>;
+
+        template <class T, class V>
+        inline void sort_range_by_key(T* keys, V* values, std::size_t size, std::true_type)
+        {
+            using sorted_type = sort_pairs<T, sort_batch_size<T>::value>;
+            using payload_type = typename sorted_type::payload_type;
+            sorted_type s = { keys, reinterpret_cast<payload_type*>(values) };
+            quicksort(s, 0, size, sort_depth(size));
+        }
+
+        template <class T, class V>
+        inline void sort_range_by_key(T* keys, V* values, std::size_t size, std::false_type)
+        {
+            std::vector<std::pair<T, V>> pairs(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                pairs[i] = std::make_pair(keys[i], values[i]);
+            }
+            std::sort(pairs.begin(), pairs.end(), [](const std::pair<T, V>& lhs, const std::pair<T, V>& rhs) {
+                return lhs.first < rhs.first;
+            });
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                keys[i] = pairs[i].first;
+                values[i] = pairs[i].second;
+            }
+        }
+    }
+
+    /**
+     * Sorts the contiguous range [first, last) of arithmetic values in
+     * ascending order. The sort is not stable; ranges containing NaN are not
+     * supported.
+     */
+    template <class Iterator1, class Iterator2>
+    void sort(Iterator1 first, Iterator2 last)
+    {
+        using value_type = typename std::decay<decltype(*first)>::type;
+        static_assert(std::is_arithmetic<value_type>::value, "sort requires arithmetic values");
+
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        if (size < 2)
+        {
+            return;
+        }
+        detail::sort_range(&(*first), size, detail::sort_vectorized<value_type>());
+    }
+
+    /**
+     * Sorts the contiguous range [keys_first, keys_last) of arithmetic keys
+     * in ascending order, and applies the same permutation to the range of
+     * values starting at values_first. Integral values of the same width as
+     * the keys, such as indices, are permuted in the same registers as the
+     * keys; other values fall back to a scalar sort. The sort is not stable;
+     * keys containing NaN are not supported.
+     */
+    template <class Iterator1, class Iterator2, class Iterator3>
+    void sort_by_key(Iterator1 keys_first, Iterator2 keys_last, Iterator3 values_first)
+    {
+        using key_type = typename std::decay<decltype(*keys_first)>::type;
+        using value_type = typename std::decay<decltype(*values_first)>::type;
+        static_assert(std::is_arithmetic<key_type>::value, "sort_by_key requires arithmetic keys");
+
+        std::size_t size = static_cast<std::size_t>(std::distance(keys_first, keys_last));
+        if (size < 2)
+        {
+            return;
+        }
+        detail::sort_range_by_key(&(*keys_first), &(*values_first), size, detail::sort_by_key_vectorized<key_type, value_type>());
+    }
+}
+
+#endif
@@ -0,0 +1,517 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_SPLIT_COMPLEX_HPP
+#define XSIMD_SPLIT_COMPLEX_HPP
+
+#include <complex>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "../memory/xsimd_alignment.hpp"
+#include "algorithms.hpp"
+
+namespace xsimd
+{
+    /**
+     * Reference to an element of a split_complex_vector, made of
+     * references to its real and imaginary parts.
+     */
+    template <class T>
+    class split_complex_reference
+    {
+    public:
+
+        using value_type = std::complex<T>;
+
+        split_complex_reference(T& real, T& imag);
+
+        operator value_type() const;
+
+        split_complex_reference& operator=(const value_type& rhs);
+        split_complex_reference& operator=(const split_complex_reference& rhs);
+
+    private:
+
+        T& m_real;
+        T& m_imag;
+    };
+
+    /**
+     * Proxy that split complex iterators dereference to, loading the
+     * complex batch B from the real and imaginary arrays and storing it
+     * back, with the aligned or unaligned accesses of the mode M. T is
+     * const for read-only arrays.
+     */
+    template <class B, class T, class M>
+    class split_complex_batch_proxy
+    {
+    public:
+
+        using batch_type = B;
+        using pointer = T*;
+
+        split_complex_batch_proxy(pointer real, pointer imag);
+
+        operator batch_type() const;
+
+        split_complex_batch_proxy& operator=(const batch_type& rhs);
+
+    private:
+
+        pointer m_real;
+        pointer m_imag;
+    };
+
+    /**
+     * Forward iterator over the complex batches of separate real and
+     * imaginary arrays, accessed with the alignment mode M.
+     */
+    template <class B, class T, class M>
+    class split_complex_iterator
+    {
+    public:
+
+        using self_type = split_complex_iterator<B, T, M>;
+        using batch_type = B;
+        static constexpr std::size_t batch_size = B::size;
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = batch_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = split_complex_batch_proxy<B, T, M>;
+
+        split_complex_iterator(pointer real, pointer imag);
+
+        reference operator*() const;
+
+        self_type& operator++();
+        self_type operator++(int);
+
+        bool equal(const self_type& rhs) const;
+
+    private:
+
+        pointer m_real;
+        pointer m_imag;
+    };
+
+    /**
+     * Container of complex values whose real and imaginary parts are
+     * stored in two arrays, so that complex batches are loaded and stored
+     * without deinterleaving. The batches are accessed with aligned
+     * accesses when the allocator A is aligned, and with unaligned ones
+     * otherwise. The batch iterators cover the
+     * complete batches at the beginning of the container, the last
+     * size() % batch_size values are only reachable with operator[].
+     */
+    template <class T, class A = aligned_allocator<T>>
+    class split_complex_vector
+    {
+    public:
+
+        using real_type = T;
+        using value_type = std::complex<T>;
+        using allocator_type = A;
+        using size_type = std::size_t;
+        using reference = split_complex_reference<T>;
+        using const_reference = value_type;
+        using batch_type = typename simd_traits<value_type>::type;
+        static constexpr size_type batch_size = simd_traits<value_type>::size;
+        using alignment_mode = allocator_alignment_t<A>;
+        using batch_iterator = split_complex_iterator<batch_type, T, alignment_mode>;
+        using const_batch_iterator = split_complex_iterator<batch_type, const T, alignment_mode>;
+
+        split_complex_vector() = default;
+        explicit split_complex_vector(size_type n, const value_type& value = value_type());
+        template <class It>
+        split_complex_vector(It first, It last);
+
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+        void resize(size_type n, const value_type& value = value_type());
+
+        reference operator[](size_type i);
+        const_reference operator[](size_type i) const;
+
+        real_type* real_data() noexcept;
+        const real_type* real_data() const noexcept;
+        real_type* imag_data() noexcept;
+        const real_type* imag_data() const noexcept;
+
+        batch_iterator batch_begin() noexcept;
+        batch_iterator batch_end() noexcept;
+        const_batch_iterator batch_begin() const noexcept;
+        const_batch_iterator batch_end() const noexcept;
+        const_batch_iterator batch_cbegin() const noexcept;
+        const_batch_iterator batch_cend() const noexcept;
+
+    private:
+
+        std::vector<T, A> m_real;
+        std::vector<T, A> m_imag;
+    };
+
+    template <class T, class A, class UF>
+    void transform(const split_complex_vector<T, A>& x, split_complex_vector<T, A>& out, UF&& f);
+
+    template <class T, class A, class BF>
+    void transform(const split_complex_vector<T, A>& x, const split_complex_vector<T, A>& y,
+                   split_complex_vector<T, A>& out, BF&& f);
+
+    template <class T, class A, class Init, class BinaryFunction = detail::plus>
+    Init reduce(const split_complex_vector<T, A>& x, Init init, BinaryFunction&& binfun = detail::plus{});
+
+    /******************************************
+     * split_complex_reference implementation *
+     ******************************************/
+
+    template <class T>
+    inline split_complex_reference<T>::split_complex_reference(T& real, T& imag)
+        : m_real(real), m_imag(imag)
+    {
+    }
+
+    template <class T>
+    inline split_complex_reference<T>::operator value_type() const
+    {
+        return value_type(m_real, m_imag);
+    }
+
+    template <class T>
+    inline auto split_complex_reference<T>::operator=(const value_type& rhs) -> split_complex_reference&
+    {
+        m_real = rhs.real();
+        m_imag = rhs.imag();
+        return *this;
+    }
+
+    template <class T>
+    inline auto split_complex_reference<T>::operator=(const split_complex_reference& rhs) -> split_complex_reference&
+    {
+        return *this = value_type(rhs);
+    }
+
+    /********************************************
+     * split_complex_batch_proxy implementation *
+     ********************************************/
+
+    namespace detail
+    {
+        template <class B, class T>
+        inline void load_split_complex(B& dst, const T* real, const T* imag, aligned_mode)
+        {
+            dst.load_aligned(real, imag);
+        }
+
+        template <class B, class T>
+        inline void load_split_complex(B& dst, const T* real, const T* imag, unaligned_mode)
+        {
+            dst.load_unaligned(real, imag);
+        }
+
+        template <class B, class T>
+        inline void store_split_complex(const B& src, T* real, T* imag, aligned_mode)
+        {
+            src.store_aligned(real, imag);
+        }
+
+        template <class B, class T>
+        inline void store_split_complex(const B& src, T* real, T* imag, unaligned_mode)
+        {
+            src.store_unaligned(real, imag);
+        }
+    }
+
+    template <class B, class T, class M>
+    inline split_complex_batch_proxy<B, T, M>::split_complex_batch_proxy(pointer real, pointer imag)
+        : m_real(real), m_imag(imag)
+    {
+    }
+
+    template <class B, class T, class M>
+    inline split_complex_batch_proxy<B, T, M>::operator batch_type() const
+    {
+        batch_type res;
+        detail::load_split_complex(res, m_real, m_imag, M());
+        return res;
+    }
+
+    template <class B, class T, class M>
+    inline auto split_complex_batch_proxy<B, T, M>::operator=(const batch_type& rhs) -> split_complex_batch_proxy&
+    {
+        detail::store_split_complex(rhs, m_real, m_imag, M());
+        return *this;
+    }
+
+    /*****************************************
+     * split_complex_iterator implementation *
+     *****************************************/
+
+    template <class B, class T, class M>
+    inline split_complex_iterator<B, T, M>::split_complex_iterator(pointer real, pointer imag)
+        : m_real(real), m_imag(imag)
+    {
+    }
+
+    template <class B, class T, class M>
+    inline auto split_complex_iterator<B, T, M>::operator*() const -> reference
+    {
+        return reference(m_real, m_imag);
+    }
+
+    template <class B, class T, class M>
+    inline auto split_complex_iterator<B, T, M>::operator++() -> self_type&
+    {
+        m_real += batch_size;
+        m_imag += batch_size;
+        return *this;
+    }
+
+    template <class B, class T, class M>
+    inline auto split_complex_iterator<B, T, M>::operator++(int) -> self_type
+    {
+        self_type tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+
+    template <class B, class T, class M>
+    inline bool split_complex_iterator<B, T, M>::equal(const self_type& rhs) const
+    {
+        return m_real == rhs.m_real;
+    }
+
+    template <class B, class T, class M>
+    inline bool operator==(const split_complex_iterator<B, T, M>& lhs, const split_complex_iterator<B, T, M>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class B, class T, class M>
+    inline bool operator!=(const split_complex_iterator<B, T, M>& lhs, const split_complex_iterator<B, T, M>& rhs)
+    {
+        return !lhs.equal(rhs);
+    }
+
+    /***************************************
+     * split_complex_vector implementation *
+     ***************************************/
+
+    template <class T, class A>
+    inline split_complex_vector<T, A>::split_complex_vector(size_type n, const value_type& value)
+        : m_real(n, value.real()), m_imag(n, value.imag())
+    {
+    }
+
+    /**
+     * Builds a container from the range of complex values [first, last).
+     */
+    template <class T, class A>
+    template <class It>
+    inline split_complex_vector<T, A>::split_complex_vector(It first, It last)
+    {
+        for (; first != last; ++first)
+        {
+            value_type value = *first;
+            m_real.push_back(value.real());
+            m_imag.push_back(value.imag());
+        }
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::size() const noexcept -> size_type
+    {
+        return m_real.size();
+    }
+
+    template <class T, class A>
+    inline bool split_complex_vector<T, A>::empty() const noexcept
+    {
+        return m_real.empty();
+    }
+
+    template <class T, class A>
+    inline void split_complex_vector<T, A>::resize(size_type n, const value_type& value)
+    {
+        m_real.resize(n, value.real());
+        m_imag.resize(n, value.imag());
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::operator[](size_type i) -> reference
+    {
+        return reference(m_real[i], m_imag[i]);
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::operator[](size_type i) const -> const_reference
+    {
+        return value_type(m_real[i], m_imag[i]);
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::real_data() noexcept -> real_type*
+    {
+        return m_real.data();
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::real_data() const noexcept -> const real_type*
+    {
+        return m_real.data();
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::imag_data() noexcept -> real_type*
+    {
+        return m_imag.data();
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::imag_data() const noexcept -> const real_type*
+    {
+        return m_imag.data();
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::batch_begin() noexcept -> batch_iterator
+    {
+        return batch_iterator(m_real.data(), m_imag.data());
+    }
+
+    /**
+     * Returns the iterator following the last complete batch.
+     */
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::batch_end() noexcept -> batch_iterator
+    {
+        size_type end = size() - size() % batch_size;
+        return batch_iterator(m_real.data() + end, m_imag.data() + end);
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::batch_begin() const noexcept -> const_batch_iterator
+    {
+        return batch_cbegin();
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::batch_end() const noexcept -> const_batch_iterator
+    {
+        return batch_cend();
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::batch_cbegin() const noexcept -> const_batch_iterator
+    {
+        return const_batch_iterator(m_real.data(), m_imag.data());
+    }
+
+    template <class T, class A>
+    inline auto split_complex_vector<T, A>::batch_cend() const noexcept -> const_batch_iterator
+    {
+        size_type end = size() - size() % batch_size;
+        return const_batch_iterator(m_real.data() + end, m_imag.data() + end);
+    }
+
+    /****************************
+     * split complex algorithms *
+     ****************************/
+
+    /**
+     * Resizes out to the size of x and computes out[i] = f(x[i]), where f
+     * is called with complex batches and with std::complex values for
+     * the last elements. out may be x.
+     */
+    template <class T, class A, class UF>
+    void transform(const split_complex_vector<T, A>& x, split_complex_vector<T, A>& out, UF&& f)
+    {
+        using vector_type = split_complex_vector<T, A>;
+        using batch_type = typename vector_type::batch_type;
+        out.resize(x.size());
+        auto it = x.batch_begin();
+        auto end = x.batch_end();
+        auto out_it = out.batch_begin();
+        for (; it != end; ++it, ++out_it)
+        {
+            *out_it = f(static_cast<batch_type>(*it));
+        }
+        for (std::size_t i = x.size() - x.size() % vector_type::batch_size; i < x.size(); ++i)
+        {
+            out[i] = f(x[i]);
+        }
+    }
+
+    /**
+     * Resizes out to the size of x and computes out[i] = f(x[i], y[i]),
+     * y holding at least as many values as x. out may be x or y.
+     */
+    template <class T, class A, class BF>
+    void transform(const split_complex_vector<T, A>& x, const split_complex_vector<T, A>& y,
+                   split_complex_vector<T, A>& out, BF&& f)
+    {
+        using vector_type = split_complex_vector<T, A>;
+        using batch_type = typename vector_type::batch_type;
+        out.resize(x.size());
+        auto it = x.batch_begin();
+        auto end = x.batch_end();
+        auto y_it = y.batch_begin();
+        auto out_it = out.batch_begin();
+        for (; it != end; ++it, ++y_it, ++out_it)
+        {
+            *out_it = f(static_cast<batch_type>(*it), static_cast<batch_type>(*y_it));
+        }
+        for (std::size_t i = x.size() - x.size() % vector_type::batch_size; i < x.size(); ++i)
+        {
+            out[i] = f(x[i], y[i]);
+        }
+    }
+
+    /**
+     * Returns the reduction of init and the values of x by binfun, which
+     * is called with complex batches, then with std::complex values for
+     * the lanes of the reduced batch and the last elements.
+     */
+    template <class T, class A, class Init, class BinaryFunction>
+    Init reduce(const split_complex_vector<T, A>& x, Init init, BinaryFunction&& binfun)
+    {
+        using vector_type = split_complex_vector<T, A>;
+        using batch_type = typename vector_type::batch_type;
+        constexpr std::size_t simd_size = vector_type::batch_size;
+
+        auto it = x.batch_begin();
+        auto end = x.batch_end();
+        if (it != end)
+        {
+            batch_type acc = *it;
+            for (++it; it != end; ++it)
+            {
+                acc = binfun(acc, static_cast<batch_type>(*it));
+            }
+            alignas(batch_type) T real[simd_size];
+            alignas(batch_type) T imag[simd_size];
+            acc.store_aligned(real, imag);
+            for (std::size_t i = 0; i < simd_size; ++i)
+            {
+                init = binfun(init, std::complex<T>(real[i], imag[i]));
+            }
+        }
+        for (std::size_t i = x.size() - x.size() % simd_size; i < x.size(); ++i)
+        {
+            init = binfun(init, x[i]);
+        }
+        return init;
+    }
+}
+
+#endif
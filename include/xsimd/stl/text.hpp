@@ -0,0 +1,628 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_TEXT_HPP
+#define XSIMD_TEXT_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "algorithms.hpp"
+
+namespace xsimd
+{
+    /***********************
+     * byte string search  *
+     ***********************/
+
+    // The functions below operate on any byte-sized character type and
+    // return the offset of the match, or size when there is none.
+
+    template <class CharT>
+    std::size_t find_byte(const CharT* data, std::size_t size, CharT value);
+
+    template <class CharT>
+    std::size_t find_any_of(const CharT* data, std::size_t size, const CharT* set, std::size_t set_size);
+
+    template <class CharT>
+    std::size_t find_substring(const CharT* data, std::size_t size, const CharT* needle, std::size_t needle_size);
+
+    /*****************************
+     * UTF-8 validation and ASCII *
+     * fast-path transcoding      *
+     *****************************/
+
+    template <class CharT>
+    bool is_ascii(const CharT* data, std::size_t size);
+
+    template <class CharT>
+    bool utf8_validate(const CharT* data, std::size_t size);
+
+    template <class CharT, class OutCharT>
+    std::size_t utf8_to_utf16(const CharT* data, std::size_t size, OutCharT* out);
+
+    template <class CharT, class OutCharT>
+    std::size_t latin1_to_utf8(const CharT* data, std::size_t size, OutCharT* out);
+
+    /**************************************
+     * byte string search implementation  *
+     **************************************/
+
+    namespace detail
+    {
+        template <class CharT>
+        inline const uint8_t* as_bytes(const CharT* data)
+        {
+            static_assert(sizeof(CharT) == 1, "byte string algorithms require a byte-sized character type");
+            return reinterpret_cast<const uint8_t*>(data);
+        }
+
+        using byte_vectorized = std::integral_constant<bool, (simd_traits<uint8_t>::size > 1)>;
+
+        // Sets larger than this are matched with a lookup table instead of
+        // one comparison per member and per batch.
+        constexpr std::size_t byte_set_batch_capacity = 16;
+
+        inline std::size_t find_any_of_table(const uint8_t* data, std::size_t size,
+                                             const uint8_t* set, std::size_t set_size)
+        {
+            std::array<bool, 256> table;
+            table.fill(false);
+            for (std::size_t i = 0; i < set_size; ++i)
+            {
+                table[set[i]] = true;
+            }
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (table[data[i]])
+                {
+                    return i;
+                }
+            }
+            return size;
+        }
+
+        template <class V>
+        inline std::size_t find_any_of_bytes(const uint8_t* data, std::size_t size,
+                                             const uint8_t* set, std::size_t set_size, V vectorized)
+        {
+            using batch_type = typename simd_traits<uint8_t>::type;
+
+            if (set_size > byte_set_batch_capacity)
+            {
+                return find_any_of_table(data, size, set, set_size);
+            }
+
+            std::array<batch_type, byte_set_batch_capacity> members;
+            for (std::size_t i = 0; i < set_size; ++i)
+            {
+                members[i] = batch_type(set[i]);
+            }
+            auto batch_test = [data, &members, set_size](std::size_t i)
+            {
+                batch_type current;
+                xsimd::load_aligned(data + i, current);
+                auto res = current == members[0];
+                for (std::size_t j = 1; j < set_size; ++j)
+                {
+                    res = res | (current == members[j]);
+                }
+                return res;
+            };
+            auto scalar_test = [data, set, set_size](std::size_t i) -> bool
+            {
+                return std::memchr(set, data[i], set_size) != nullptr;
+            };
+            return find_index<1>(data, size, batch_test, scalar_test, vectorized);
+        }
+
+        // First / last byte filtering: a candidate position must match both
+        // the first and the last byte of the needle, which rejects most
+        // positions with two comparisons per batch before any memcmp.
+        inline std::size_t find_substring_bytes(const uint8_t* data, std::size_t size,
+                                                const uint8_t* needle, std::size_t needle_size, std::true_type)
+        {
+            using batch_type = typename simd_traits<uint8_t>::type;
+            constexpr std::size_t simd_size = simd_traits<uint8_t>::size;
+
+            const std::size_t last_offset = needle_size - 1;
+            const std::size_t end = size - last_offset;
+            const batch_type first_byte(needle[0]);
+            const batch_type last_byte(needle[last_offset]);
+
+            auto matches = [data, needle, needle_size, last_offset](std::size_t i) -> bool
+            {
+                return data[i] == needle[0] && data[i + last_offset] == needle[last_offset] &&
+                    std::memcmp(data + i + 1, needle + 1, needle_size - 2) == 0;
+            };
+
+            std::size_t i = 0;
+            batch_type head, tail;
+            for (; i + simd_size <= end; i += simd_size)
+            {
+                xsimd::load_unaligned(data + i, head);
+                xsimd::load_unaligned(data + i + last_offset, tail);
+                if (any((head == first_byte) & (tail == last_byte)))
+                {
+                    for (std::size_t j = i; j < i + simd_size; ++j)
+                    {
+                        if (matches(j))
+                        {
+                            return j;
+                        }
+                    }
+                }
+            }
+            for (; i < end; ++i)
+            {
+                if (matches(i))
+                {
+                    return i;
+                }
+            }
+            return size;
+        }
+
+        inline std::size_t find_substring_bytes(const uint8_t* data, std::size_t size,
+                                                const uint8_t* needle, std::size_t needle_size, std::false_type)
+        {
+            const std::size_t end = size - needle_size + 1;
+            for (std::size_t i = 0; i < end; ++i)
+            {
+                if (std::memcmp(data + i, needle, needle_size) == 0)
+                {
+                    return i;
+                }
+            }
+            return size;
+        }
+    }
+
+    /**
+     * Returns the offset of the first occurrence of \c value in the
+     * \c size bytes pointed to by \c data, \c size if there is none.
+     */
+    template <class CharT>
+    inline std::size_t find_byte(const CharT* data, std::size_t size, CharT value)
+    {
+        const uint8_t* bytes = detail::as_bytes(data);
+        uint8_t byte = static_cast<uint8_t>(value);
+        return detail::find_index_if<4>(bytes, size, detail::equal_to_value<uint8_t>{byte});
+    }
+
+    /**
+     * Returns the offset of the first byte of \c data that is one of the
+     * \c set_size bytes pointed to by \c set, \c size if there is none.
+     */
+    template <class CharT>
+    inline std::size_t find_any_of(const CharT* data, std::size_t size, const CharT* set, std::size_t set_size)
+    {
+        if (set_size == 0)
+        {
+            return size;
+        }
+        return detail::find_any_of_bytes(detail::as_bytes(data), size, detail::as_bytes(set), set_size,
+                                         detail::byte_vectorized());
+    }
+
+    /**
+     * Returns the offset of the first occurrence of the \c needle_size bytes
+     * pointed to by \c needle in \c data, \c size if there is none. An empty
+     * needle is found at offset 0.
+     */
+    template <class CharT>
+    inline std::size_t find_substring(const CharT* data, std::size_t size, const CharT* needle, std::size_t needle_size)
+    {
+        if (needle_size == 0)
+        {
+            return 0;
+        }
+        if (needle_size > size)
+        {
+            return size;
+        }
+        if (needle_size == 1)
+        {
+            return find_byte(data, size, needle[0]);
+        }
+        return detail::find_substring_bytes(detail::as_bytes(data), size, detail::as_bytes(needle), needle_size,
+                                            detail::byte_vectorized());
+    }
+
+    /*********************************
+     * UTF-8 and ASCII implementation *
+     *********************************/
+
+    namespace detail
+    {
+        struct non_ascii_byte
+        {
+            template <class U>
+            auto operator()(const U& x) const -> decltype(x >= U(uint8_t(0x80)))
+            {
+                return x >= U(uint8_t(0x80));
+            }
+        };
+
+        // Decodes the code point starting at data, returns its length in
+        // bytes, or 0 if the sequence is not valid UTF-8.
+        inline std::size_t utf8_decode(const uint8_t* data, std::size_t size, uint32_t& code_point)
+        {
+            uint8_t lead = data[0];
+            if (lead < 0x80)
+            {
+                code_point = lead;
+                return 1;
+            }
+            std::size_t length = lead < 0xC2 ? 0 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : lead < 0xF5 ? 4 : 0;
+            if (length == 0 || length > size)
+            {
+                return 0;
+            }
+            code_point = lead & (0x7F >> length);
+            for (std::size_t i = 1; i < length; ++i)
+            {
+                if ((data[i] & 0xC0) != 0x80)
+                {
+                    return 0;
+                }
+                code_point = (code_point << 6) | (data[i] & 0x3F);
+            }
+            // overlong encodings, surrogates and code points above U+10FFFF
+            bool overlong = (length == 3 && code_point < 0x800) || (length == 4 && code_point < 0x10000);
+            bool surrogate = code_point >= 0xD800 && code_point <= 0xDFFF;
+            if (overlong || surrogate || code_point > 0x10FFFF)
+            {
+                return 0;
+            }
+            return length;
+        }
+
+        inline bool utf8_validate_scalar(const uint8_t* data, std::size_t size)
+        {
+            uint32_t code_point;
+            std::size_t i = 0;
+            while (i < size)
+            {
+                std::size_t length = utf8_decode(data + i, size - i, code_point);
+                if (length == 0)
+                {
+                    return false;
+                }
+                i += length;
+            }
+            return true;
+        }
+
+        template <class OutCharT>
+        inline std::size_t utf16_encode(uint32_t code_point, OutCharT* out)
+        {
+            if (code_point < 0x10000)
+            {
+                out[0] = static_cast<OutCharT>(code_point);
+                return 1;
+            }
+            code_point -= 0x10000;
+            out[0] = static_cast<OutCharT>(0xD800 + (code_point >> 10));
+            out[1] = static_cast<OutCharT>(0xDC00 + (code_point & 0x3FF));
+            return 2;
+        }
+
+        // Error classes of the lookup algorithm of Keiser and Lemire,
+        // "Validating UTF-8 in less than one instruction per byte". A byte
+        // pair is invalid when the classes looked up from the high and low
+        // nibbles of the first byte and the high nibble of the second byte
+        // have a bit in common.
+        namespace utf8_error
+        {
+            constexpr uint8_t too_short = 1 << 0;
+            constexpr uint8_t too_long = 1 << 1;
+            constexpr uint8_t overlong_3 = 1 << 2;
+            constexpr uint8_t too_large = 1 << 3;
+            constexpr uint8_t surrogate = 1 << 4;
+            constexpr uint8_t overlong_2 = 1 << 5;
+            constexpr uint8_t too_large_1000 = 1 << 6;
+            constexpr uint8_t overlong_4 = 1 << 6;
+            constexpr uint8_t two_conts = 1 << 7;
+            constexpr uint8_t carry = too_short | too_long | two_conts;
+        }
+
+        template <class B>
+        inline B make_lookup16_table(const std::array<uint8_t, 16>& values)
+        {
+            alignas(B) std::array<uint8_t, B::size> table;
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                table[i] = values[i % 16];
+            }
+            B res;
+            xsimd::load_aligned(table.data(), res);
+            return res;
+        }
+
+        template <class B>
+        struct utf8_checker
+        {
+            B byte_1_high;
+            B byte_1_low;
+            B byte_2_high;
+
+            utf8_checker()
+            {
+                using namespace utf8_error;
+                byte_1_high = make_lookup16_table<B>({{
+                    too_long, too_long, too_long, too_long,
+                    too_long, too_long, too_long, too_long,
+                    two_conts, two_conts, two_conts, two_conts,
+                    too_short | overlong_2,
+                    too_short,
+                    too_short | overlong_3 | surrogate,
+                    too_short | too_large | too_large_1000 | overlong_4
+                }});
+                byte_1_low = make_lookup16_table<B>({{
+                    carry | overlong_3 | overlong_2 | overlong_4,
+                    carry | overlong_2,
+                    carry,
+                    carry,
+                    carry | too_large,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000 | surrogate,
+                    carry | too_large | too_large_1000,
+                    carry | too_large | too_large_1000
+                }});
+                byte_2_high = make_lookup16_table<B>({{
+                    too_short, too_short, too_short, too_short,
+                    too_short, too_short, too_short, too_short,
+                    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+                    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+                    too_long | overlong_2 | two_conts | surrogate | too_large,
+                    too_long | overlong_2 | two_conts | surrogate | too_large,
+                    too_short, too_short, too_short, too_short
+                }});
+            }
+
+            // prev1, prev2 and prev3 hold the bytes preceding those of input
+            // by one, two and three positions; the result is non-zero where
+            // input is not a valid continuation of them.
+            B errors(const B& input, const B& prev1, const B& prev2, const B& prev3) const
+            {
+                const B low_nibble(uint8_t(0x0F));
+                B special = lookup16(byte_1_high, prev1 >> 4) &
+                    lookup16(byte_1_low, prev1 & low_nibble) &
+                    lookup16(byte_2_high, input >> 4);
+                // third and fourth bytes of a sequence must be continuations
+                B must_be_2_3_continuation = ssub(prev2, B(uint8_t(0xE0 - 0x80))) | ssub(prev3, B(uint8_t(0xF0 - 0x80)));
+                return (must_be_2_3_continuation & B(uint8_t(0x80))) ^ special;
+            }
+        };
+
+        inline bool utf8_validate_bytes(const uint8_t* data, std::size_t size, std::true_type)
+        {
+            using batch_type = typename simd_traits<uint8_t>::type;
+            constexpr std::size_t simd_size = simd_traits<uint8_t>::size;
+
+            if (size < simd_size)
+            {
+                return utf8_validate_scalar(data, size);
+            }
+
+            const utf8_checker<batch_type> checker;
+            batch_type input, prev1, prev2, prev3;
+
+            // the first block is preceded by three virtual ASCII bytes
+            std::array<uint8_t, simd_size + 3> head;
+            head.fill(0);
+            std::memcpy(head.data() + 3, data, simd_size);
+            xsimd::load_unaligned(head.data() + 3, input);
+            xsimd::load_unaligned(head.data() + 2, prev1);
+            xsimd::load_unaligned(head.data() + 1, prev2);
+            xsimd::load_unaligned(head.data(), prev3);
+            batch_type error = checker.errors(input, prev1, prev2, prev3);
+
+            std::size_t i = simd_size;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                xsimd::load_unaligned(data + i, input);
+                xsimd::load_unaligned(data + i - 1, prev1);
+                xsimd::load_unaligned(data + i - 2, prev2);
+                xsimd::load_unaligned(data + i - 3, prev3);
+                error |= checker.errors(input, prev1, prev2, prev3);
+            }
+            if (any(error != batch_type(uint8_t(0))))
+            {
+                return false;
+            }
+
+            // the sequence ending the checked bytes may be incomplete, so
+            // the scalar tail restarts from its leading byte
+            std::size_t start = i - 1;
+            for (int k = 0; k < 3 && (data[start] & 0xC0) == 0x80; ++k)
+            {
+                --start;
+            }
+            return utf8_validate_scalar(data + start, size - start);
+        }
+
+        inline bool utf8_validate_bytes(const uint8_t* data, std::size_t size, std::false_type)
+        {
+            return utf8_validate_scalar(data, size);
+        }
+
+        template <class OutCharT>
+        inline std::size_t utf8_to_utf16_bytes(const uint8_t* data, std::size_t size, OutCharT* out, std::true_type)
+        {
+            using batch_type = typename simd_traits<uint8_t>::type;
+            constexpr std::size_t simd_size = simd_traits<uint8_t>::size;
+
+            const batch_type ascii_limit(uint8_t(0x80));
+            std::size_t i = 0, written = 0;
+            uint32_t code_point;
+            batch_type input;
+            while (i + simd_size <= size)
+            {
+                xsimd::load_unaligned(data + i, input);
+                if (!any(input >= ascii_limit))
+                {
+                    for (std::size_t j = 0; j < simd_size; ++j)
+                    {
+                        out[written + j] = static_cast<OutCharT>(data[i + j]);
+                    }
+                    i += simd_size;
+                    written += simd_size;
+                    continue;
+                }
+                for (std::size_t block_end = i + simd_size; i < block_end;)
+                {
+                    std::size_t length = utf8_decode(data + i, size - i, code_point);
+                    if (length == 0)
+                    {
+                        return 0;
+                    }
+                    i += length;
+                    written += utf16_encode(code_point, out + written);
+                }
+            }
+            while (i < size)
+            {
+                std::size_t length = utf8_decode(data + i, size - i, code_point);
+                if (length == 0)
+                {
+                    return 0;
+                }
+                i += length;
+                written += utf16_encode(code_point, out + written);
+            }
+            return written;
+        }
+
+        template <class OutCharT>
+        inline std::size_t utf8_to_utf16_bytes(const uint8_t* data, std::size_t size, OutCharT* out, std::false_type)
+        {
+            std::size_t i = 0, written = 0;
+            uint32_t code_point;
+            while (i < size)
+            {
+                std::size_t length = utf8_decode(data + i, size - i, code_point);
+                if (length == 0)
+                {
+                    return 0;
+                }
+                i += length;
+                written += utf16_encode(code_point, out + written);
+            }
+            return written;
+        }
+
+        inline std::size_t latin1_to_utf8_scalar(const uint8_t* data, std::size_t size, uint8_t* out)
+        {
+            std::size_t written = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                uint8_t c = data[i];
+                if (c < 0x80)
+                {
+                    out[written++] = c;
+                }
+                else
+                {
+                    out[written++] = static_cast<uint8_t>(0xC0 | (c >> 6));
+                    out[written++] = static_cast<uint8_t>(0x80 | (c & 0x3F));
+                }
+            }
+            return written;
+        }
+
+        inline std::size_t latin1_to_utf8_bytes(const uint8_t* data, std::size_t size, uint8_t* out, std::true_type)
+        {
+            using batch_type = typename simd_traits<uint8_t>::type;
+            constexpr std::size_t simd_size = simd_traits<uint8_t>::size;
+
+            const batch_type ascii_limit(uint8_t(0x80));
+            std::size_t i = 0, written = 0;
+            batch_type input;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                xsimd::load_unaligned(data + i, input);
+                if (!any(input >= ascii_limit))
+                {
+                    xsimd::store_unaligned(out + written, input);
+                    written += simd_size;
+                }
+                else
+                {
+                    written += latin1_to_utf8_scalar(data + i, simd_size, out + written);
+                }
+            }
+            return written + latin1_to_utf8_scalar(data + i, size - i, out + written);
+        }
+
+        inline std::size_t latin1_to_utf8_bytes(const uint8_t* data, std::size_t size, uint8_t* out, std::false_type)
+        {
+            return latin1_to_utf8_scalar(data, size, out);
+        }
+    }
+
+    /**
+     * Returns true if the \c size bytes pointed to by \c data are all
+     * ASCII characters.
+     */
+    template <class CharT>
+    inline bool is_ascii(const CharT* data, std::size_t size)
+    {
+        return detail::find_index_if<4>(detail::as_bytes(data), size, detail::non_ascii_byte()) == size;
+    }
+
+    /**
+     * Returns true if the \c size bytes pointed to by \c data are valid
+     * UTF-8: no overlong encoding, surrogate, code point above U+10FFFF or
+     * truncated sequence.
+     */
+    template <class CharT>
+    inline bool utf8_validate(const CharT* data, std::size_t size)
+    {
+        return detail::utf8_validate_bytes(detail::as_bytes(data), size, detail::byte_vectorized());
+    }
+
+    /**
+     * Converts the UTF-8 string \c data of \c size bytes to UTF-16 in
+     * \c out, which must have room for \c size code units. Returns the
+     * number of code units written, or 0 if \c data is not valid UTF-8.
+     */
+    template <class CharT, class OutCharT>
+    inline std::size_t utf8_to_utf16(const CharT* data, std::size_t size, OutCharT* out)
+    {
+        static_assert(sizeof(OutCharT) == 2, "utf8_to_utf16 requires a 16-bit output character type");
+        return detail::utf8_to_utf16_bytes(detail::as_bytes(data), size, out, detail::byte_vectorized());
+    }
+
+    /**
+     * Converts the Latin-1 string \c data of \c size bytes to UTF-8 in
+     * \c out, which must have room for 2 * \c size bytes. Returns the
+     * number of bytes written.
+     */
+    template <class CharT, class OutCharT>
+    inline std::size_t latin1_to_utf8(const CharT* data, std::size_t size, OutCharT* out)
+    {
+        static_assert(sizeof(OutCharT) == 1, "latin1_to_utf8 requires a byte-sized output character type");
+        return detail::latin1_to_utf8_bytes(detail::as_bytes(data), size, reinterpret_cast<uint8_t*>(out),
+                                            detail::byte_vectorized());
+    }
+}
+
+#endif
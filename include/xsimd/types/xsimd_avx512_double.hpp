@@ -504,6 +504,20 @@ namespace xsimd
                 return xsimd::hadd(batch<double, 4>(res1));
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                __m256d tmp1 = _mm512_extractf64x4_pd(rhs, 1);
+                __m256d tmp2 = _mm512_extractf64x4_pd(rhs, 0);
+                return xsimd::hmin(batch<double, 4>(_mm256_min_pd(tmp1, tmp2)));
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                __m256d tmp1 = _mm512_extractf64x4_pd(rhs, 1);
+                __m256d tmp2 = _mm512_extractf64x4_pd(rhs, 0);
+                return xsimd::hmax(batch<double, 4>(_mm256_max_pd(tmp1, tmp2)));
+            }
+
             static batch_type haddp(const batch_type* row)
             {
 #define step1(I, a, b)                                                   \
@@ -563,10 +577,10 @@ namespace xsimd
                 for (int i = 0 ; i < (8 - n); ++i)
                 {
                     b_concatenate[i] = lhs[i + n];
-                    if(i < n)
-                    {
-                        b_concatenate[8 - 1 - i] = rhs[n - 1 - i];
-                    }
+                }
+                for (int i = 0 ; i < n; ++i)
+                {
+                    b_concatenate[8 - n + i] = rhs[i];
                 }
                 return b_concatenate;
             }
@@ -527,6 +527,20 @@ namespace xsimd
                 return xsimd::hadd(batch<float, 8>(res1));
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                __m256 tmp1 = _mm512_extractf32x8_ps(rhs, 1);
+                __m256 tmp2 = _mm512_extractf32x8_ps(rhs, 0);
+                return xsimd::hmin(batch<float, 8>(_mm256_min_ps(tmp1, tmp2)));
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                __m256 tmp1 = _mm512_extractf32x8_ps(rhs, 1);
+                __m256 tmp2 = _mm512_extractf32x8_ps(rhs, 0);
+                return xsimd::hmax(batch<float, 8>(_mm256_max_ps(tmp1, tmp2)));
+            }
+
             static batch_type haddp(const batch_type* row)
             {
                 // The following folds over the vector once:
@@ -621,10 +635,10 @@ namespace xsimd
                 for (int i = 0 ; i < (16 - n); ++i)
                 {
                     b_concatenate[i] = lhs[i + n];
-                    if(i < n)
-                    {
-                        b_concatenate[16 - 1 - i] = rhs[n - 1 - i];
-                    }
+                }
+                for (int i = 0 ; i < n; ++i)
+                {
+                    b_concatenate[16 - n + i] = rhs[i];
                 }
                 return b_concatenate;
             }
@@ -472,6 +472,38 @@ namespace xsimd
     {
         return _mm512_srlv_epi32(lhs, rhs);
     }
+
+#if defined(XSIMD_AVX512CD_AVAILABLE)
+    /**********************
+     * histogram function *
+     **********************/
+
+    // vpconflictd finds the earlier elements holding the same index; the
+    // count of these conflicts is added to every element, so that the last
+    // occurrence of an index carries the total and, scattered last, wins.
+    template <class T>
+    struct histogram_impl<T, 16, typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 4>::type>
+    {
+        static constexpr std::size_t sub_histograms = 1;
+
+        static inline void run(uint32_t* counts, std::size_t, const batch<T, 16>& index)
+        {
+            __m512i conflicts = _mm512_conflict_epi32(index);
+            // popcount of the 16-bit conflict masks
+            __m512i c = _mm512_sub_epi32(conflicts, _mm512_and_si512(_mm512_srli_epi32(conflicts, 1), _mm512_set1_epi32(0x5555)));
+            c = _mm512_add_epi32(_mm512_and_si512(c, _mm512_set1_epi32(0x3333)),
+                                 _mm512_and_si512(_mm512_srli_epi32(c, 2), _mm512_set1_epi32(0x3333)));
+            c = _mm512_and_si512(_mm512_add_epi32(c, _mm512_srli_epi32(c, 4)), _mm512_set1_epi32(0x0f0f));
+            c = _mm512_and_si512(_mm512_add_epi32(c, _mm512_srli_epi32(c, 8)), _mm512_set1_epi32(0x1f));
+            __m512i old = _mm512_i32gather_epi32(index, counts, 4);
+            __m512i res = _mm512_add_epi32(old, _mm512_add_epi32(c, _mm512_set1_epi32(1)));
+            _mm512_i32scatter_epi32(counts, index, res, 4);
+        }
+    };
+
+    template <class T>
+    constexpr std::size_t histogram_impl<T, 16, typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 4>::type>::sub_histograms;
+#endif
 }
 
 #endif
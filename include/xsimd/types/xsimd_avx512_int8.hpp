@@ -364,6 +364,20 @@ namespace xsimd
                 return _mm512_unpackhi_epi8(lhs, rhs);
             }
 
+            static batch_type lookup16(const batch_type& table, const batch_type& index)
+            {
+                __m256i table_low = _mm512_castsi512_si256(table);
+#if defined(XSIMD_AVX512BW_AVAILABLE)
+                return _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm256_castsi256_si128(table_low)), index);
+#else
+                __m256i table_broadcast = _mm256_broadcastsi128_si256(_mm256_castsi256_si128(table_low));
+                XSIMD_SPLIT_AVX512(index);
+                __m256i res_low = _mm256_shuffle_epi8(table_broadcast, index_low);
+                __m256i res_high = _mm256_shuffle_epi8(table_broadcast, index_high);
+                XSIMD_RETURN_MERGED_AVX(res_low, res_high);
+#endif
+            }
+
             static batch_type extract_pair(const batch_type& v_lhs, const batch_type& v_rhs, const int n)
             {
 #if defined(XSIMD_AVX512BW_AVAILABLE)
@@ -0,0 +1,385 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_AVX512_INT_ARITH_HPP
+#define XSIMD_AVX512_INT_ARITH_HPP
+
+#include "xsimd_avx512_int8.hpp"
+#include "xsimd_avx512_int16.hpp"
+#include "xsimd_avx512_int32.hpp"
+#include "xsimd_avx512_int64.hpp"
+
+namespace xsimd
+{
+    namespace detail
+    {
+        inline __m512i avx512_cvt_epi32(__m256i x, std::true_type)
+        {
+            return _mm512_cvtepi32_epi64(x);
+        }
+
+        inline __m512i avx512_cvt_epi32(__m256i x, std::false_type)
+        {
+            return _mm512_cvtepu32_epi64(x);
+        }
+
+        // Full products of the even 32-bit elements
+        inline __m512i avx512_mul_even_epi32(__m512i x, __m512i y, std::true_type)
+        {
+            return _mm512_mul_epi32(x, y);
+        }
+
+        inline __m512i avx512_mul_even_epi32(__m512i x, __m512i y, std::false_type)
+        {
+            return _mm512_mul_epu32(x, y);
+        }
+
+        template <class T, std::size_t S>
+        using enable_avx512_int_t = typename std::enable_if<std::is_integral<T>::value && sizeof(T) == S>::type;
+    }
+
+    /*********
+     * mulhi *
+     *********/
+
+    template <class T>
+    struct mulhi_impl<T, 16, detail::enable_avx512_int_t<T, 4>>
+    {
+        static inline batch<T, 16> run(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m512i even = detail::avx512_mul_even_epi32(x, y, is_signed());
+            __m512i odd = detail::avx512_mul_even_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32), is_signed());
+            return _mm512_mask_blend_epi32(__mmask16(0xAAAA), _mm512_srli_epi64(even, 32), odd);
+        }
+    };
+
+    /*************
+     * mul_widen *
+     *************/
+
+    template <class T>
+    struct mul_widen_impl<T, 16, detail::enable_avx512_int_t<T, 4>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 8> run_lo(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return detail::avx512_mul_even_epi32(detail::avx512_cvt_epi32(_mm512_castsi512_si256(x), is_signed()),
+                                                 detail::avx512_cvt_epi32(_mm512_castsi512_si256(y), is_signed()), is_signed());
+        }
+
+        static inline batch<wide_type, 8> run_hi(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return detail::avx512_mul_even_epi32(detail::avx512_cvt_epi32(_mm512_extracti64x4_epi64(x, 1), is_signed()),
+                                                 detail::avx512_cvt_epi32(_mm512_extracti64x4_epi64(y, 1), is_signed()), is_signed());
+        }
+    };
+
+    /********
+     * madd *
+     ********/
+
+    template <class T>
+    struct madd_impl<T, 16, detail::enable_avx512_int_t<T, 4>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 8> run(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m512i even = detail::avx512_mul_even_epi32(x, y, is_signed());
+            __m512i odd = detail::avx512_mul_even_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32), is_signed());
+            return _mm512_add_epi64(even, odd);
+        }
+    };
+
+#if defined(XSIMD_AVX512BW_AVAILABLE)
+
+    namespace detail
+    {
+        // Sign or zero extension of the low and high halves of the 8-bit
+        // elements of each 128-bit lane
+        inline __m512i avx512_widen_lo_epi8(__m512i x, std::true_type)
+        {
+            return _mm512_srai_epi16(_mm512_unpacklo_epi8(x, x), 8);
+        }
+
+        inline __m512i avx512_widen_hi_epi8(__m512i x, std::true_type)
+        {
+            return _mm512_srai_epi16(_mm512_unpackhi_epi8(x, x), 8);
+        }
+
+        inline __m512i avx512_widen_lo_epi8(__m512i x, std::false_type)
+        {
+            return _mm512_unpacklo_epi8(x, _mm512_setzero_si512());
+        }
+
+        inline __m512i avx512_widen_hi_epi8(__m512i x, std::false_type)
+        {
+            return _mm512_unpackhi_epi8(x, _mm512_setzero_si512());
+        }
+
+        // Sign or zero extension of 256-bit halves
+        inline __m512i avx512_cvt_epi8(__m256i x, std::true_type)
+        {
+            return _mm512_cvtepi8_epi16(x);
+        }
+
+        inline __m512i avx512_cvt_epi8(__m256i x, std::false_type)
+        {
+            return _mm512_cvtepu8_epi16(x);
+        }
+
+        inline __m512i avx512_cvt_epi16(__m256i x, std::true_type)
+        {
+            return _mm512_cvtepi16_epi32(x);
+        }
+
+        inline __m512i avx512_cvt_epi16(__m256i x, std::false_type)
+        {
+            return _mm512_cvtepu16_epi32(x);
+        }
+
+        // Even and odd 8-bit elements, extended in the 16-bit elements
+        inline __m512i avx512_even_epi8(__m512i x, std::true_type)
+        {
+            return _mm512_srai_epi16(_mm512_slli_epi16(x, 8), 8);
+        }
+
+        inline __m512i avx512_odd_epi8(__m512i x, std::true_type)
+        {
+            return _mm512_srai_epi16(x, 8);
+        }
+
+        inline __m512i avx512_even_epi8(__m512i x, std::false_type)
+        {
+            return _mm512_and_si512(x, _mm512_set1_epi16(0x00FF));
+        }
+
+        inline __m512i avx512_odd_epi8(__m512i x, std::false_type)
+        {
+            return _mm512_srli_epi16(x, 8);
+        }
+    }
+
+    /*********
+     * mulhi *
+     *********/
+
+    template <>
+    struct mulhi_impl<int16_t, 32>
+    {
+        static inline batch<int16_t, 32> run(const batch<int16_t, 32>& x, const batch<int16_t, 32>& y)
+        {
+            return _mm512_mulhi_epi16(x, y);
+        }
+    };
+
+    template <>
+    struct mulhi_impl<uint16_t, 32>
+    {
+        static inline batch<uint16_t, 32> run(const batch<uint16_t, 32>& x, const batch<uint16_t, 32>& y)
+        {
+            return _mm512_mulhi_epu16(x, y);
+        }
+    };
+
+    // Unpacks and packs work in 128-bit lanes alike, so that the elements
+    // keep their order.
+    template <class T>
+    struct mulhi_impl<T, 64, detail::enable_avx512_int_t<T, 1>>
+    {
+        static inline __m512i run_half(__m512i x, __m512i y, std::true_type)
+        {
+            return _mm512_srai_epi16(_mm512_mullo_epi16(x, y), 8);
+        }
+
+        static inline __m512i run_half(__m512i x, __m512i y, std::false_type)
+        {
+            return _mm512_srli_epi16(_mm512_mullo_epi16(x, y), 8);
+        }
+
+        static inline __m512i pack(__m512i lo, __m512i hi, std::true_type)
+        {
+            return _mm512_packs_epi16(lo, hi);
+        }
+
+        static inline __m512i pack(__m512i lo, __m512i hi, std::false_type)
+        {
+            return _mm512_packus_epi16(lo, hi);
+        }
+
+        static inline batch<T, 64> run(const batch<T, 64>& x, const batch<T, 64>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m512i lo = run_half(detail::avx512_widen_lo_epi8(x, is_signed()), detail::avx512_widen_lo_epi8(y, is_signed()), is_signed());
+            __m512i hi = run_half(detail::avx512_widen_hi_epi8(x, is_signed()), detail::avx512_widen_hi_epi8(y, is_signed()), is_signed());
+            return pack(lo, hi, is_signed());
+        }
+    };
+
+    /*******
+     * avg *
+     *******/
+
+    template <>
+    struct avg_impl<uint8_t, 64>
+    {
+        static inline batch<uint8_t, 64> run(const batch<uint8_t, 64>& x, const batch<uint8_t, 64>& y)
+        {
+            return _mm512_avg_epu8(x, y);
+        }
+    };
+
+    template <>
+    struct avg_impl<uint16_t, 32>
+    {
+        static inline batch<uint16_t, 32> run(const batch<uint16_t, 32>& x, const batch<uint16_t, 32>& y)
+        {
+            return _mm512_avg_epu16(x, y);
+        }
+    };
+
+    template <>
+    struct avg_impl<int8_t, 64>
+    {
+        static inline batch<int8_t, 64> run(const batch<int8_t, 64>& x, const batch<int8_t, 64>& y)
+        {
+            __m512i bias = _mm512_set1_epi8(-128);
+            return _mm512_xor_si512(_mm512_avg_epu8(_mm512_xor_si512(x, bias), _mm512_xor_si512(y, bias)), bias);
+        }
+    };
+
+    template <>
+    struct avg_impl<int16_t, 32>
+    {
+        static inline batch<int16_t, 32> run(const batch<int16_t, 32>& x, const batch<int16_t, 32>& y)
+        {
+            __m512i bias = _mm512_set1_epi16(-32768);
+            return _mm512_xor_si512(_mm512_avg_epu16(_mm512_xor_si512(x, bias), _mm512_xor_si512(y, bias)), bias);
+        }
+    };
+
+    /*******
+     * sad *
+     *******/
+
+    template <>
+    struct sad_impl<64>
+    {
+        static inline batch<uint64_t, 8> run(const batch<uint8_t, 64>& x, const batch<uint8_t, 64>& y)
+        {
+            return _mm512_sad_epu8(x, y);
+        }
+    };
+
+    /*************
+     * mul_widen *
+     *************/
+
+    template <class T>
+    struct mul_widen_impl<T, 64, detail::enable_avx512_int_t<T, 1>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 32> run_lo(const batch<T, 64>& x, const batch<T, 64>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return _mm512_mullo_epi16(detail::avx512_cvt_epi8(_mm512_castsi512_si256(x), is_signed()),
+                                      detail::avx512_cvt_epi8(_mm512_castsi512_si256(y), is_signed()));
+        }
+
+        static inline batch<wide_type, 32> run_hi(const batch<T, 64>& x, const batch<T, 64>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return _mm512_mullo_epi16(detail::avx512_cvt_epi8(_mm512_extracti64x4_epi64(x, 1), is_signed()),
+                                      detail::avx512_cvt_epi8(_mm512_extracti64x4_epi64(y, 1), is_signed()));
+        }
+    };
+
+    template <class T>
+    struct mul_widen_impl<T, 32, detail::enable_avx512_int_t<T, 2>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 16> run_lo(const batch<T, 32>& x, const batch<T, 32>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return _mm512_mullo_epi32(detail::avx512_cvt_epi16(_mm512_castsi512_si256(x), is_signed()),
+                                      detail::avx512_cvt_epi16(_mm512_castsi512_si256(y), is_signed()));
+        }
+
+        static inline batch<wide_type, 16> run_hi(const batch<T, 32>& x, const batch<T, 32>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return _mm512_mullo_epi32(detail::avx512_cvt_epi16(_mm512_extracti64x4_epi64(x, 1), is_signed()),
+                                      detail::avx512_cvt_epi16(_mm512_extracti64x4_epi64(y, 1), is_signed()));
+        }
+    };
+
+    /********
+     * madd *
+     ********/
+
+    template <>
+    struct madd_impl<int16_t, 32>
+    {
+        static inline batch<int32_t, 16> run(const batch<int16_t, 32>& x, const batch<int16_t, 32>& y)
+        {
+            return _mm512_madd_epi16(x, y);
+        }
+    };
+
+    template <>
+    struct madd_impl<uint16_t, 32>
+    {
+        static inline batch<uint32_t, 16> run(const batch<uint16_t, 32>& x, const batch<uint16_t, 32>& y)
+        {
+            __m512i mask = _mm512_set1_epi32(0xFFFF);
+            __m512i even = _mm512_mullo_epi32(_mm512_and_si512(x, mask), _mm512_and_si512(y, mask));
+            __m512i odd = _mm512_mullo_epi32(_mm512_srli_epi32(x, 16), _mm512_srli_epi32(y, 16));
+            return _mm512_add_epi32(even, odd);
+        }
+    };
+
+    template <class T>
+    struct madd_impl<T, 64, detail::enable_avx512_int_t<T, 1>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 32> run(const batch<T, 64>& x, const batch<T, 64>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m512i even = _mm512_mullo_epi16(detail::avx512_even_epi8(x, is_signed()), detail::avx512_even_epi8(y, is_signed()));
+            __m512i odd = _mm512_mullo_epi16(detail::avx512_odd_epi8(x, is_signed()), detail::avx512_odd_epi8(y, is_signed()));
+            return _mm512_add_epi16(even, odd);
+        }
+    };
+
+    /*********
+     * smadd *
+     *********/
+
+    template <>
+    struct smadd_impl<64>
+    {
+        static inline batch<int16_t, 32> run(const batch<uint8_t, 64>& x, const batch<int8_t, 64>& y)
+        {
+            return _mm512_maddubs_epi16(x, y);
+        }
+    };
+
+#endif
+}
+
+#endif
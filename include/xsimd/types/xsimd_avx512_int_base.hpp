@@ -357,6 +357,7 @@ namespace xsimd
         struct avx512_int_kernel_base
         {
             using batch_type = B;
+            using value_type = typename simd_batch_traits<B>::value_type;
 
             static batch_type fmin(const batch_type& lhs, const batch_type& rhs)
             {
@@ -372,6 +373,22 @@ namespace xsimd
             {
                 return abs(rhs);
             }
+
+            static value_type hmin(const batch_type& rhs)
+            {
+                using half_batch_type = batch<value_type, simd_batch_traits<B>::size / 2>;
+                half_batch_type lo(_mm512_castsi512_si256(rhs));
+                half_batch_type hi(_mm512_extracti64x4_epi64(rhs, 1));
+                return xsimd::hmin(min(lo, hi));
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                using half_batch_type = batch<value_type, simd_batch_traits<B>::size / 2>;
+                half_batch_type lo(_mm512_castsi512_si256(rhs));
+                half_batch_type hi(_mm512_extracti64x4_epi64(rhs, 1));
+                return xsimd::hmax(max(lo, hi));
+            }
         };
     }
 
@@ -0,0 +1,413 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_AVX512_SHUFFLE_HPP
+#define XSIMD_AVX512_SHUFFLE_HPP
+
+#include "xsimd_avx512_double.hpp"
+#include "xsimd_avx512_float.hpp"
+#include "xsimd_avx512_int8.hpp"
+#include "xsimd_avx512_int16.hpp"
+#include "xsimd_avx512_int32.hpp"
+#include "xsimd_avx512_int64.hpp"
+
+namespace xsimd
+{
+    namespace detail
+    {
+        template <class T, std::size_t N>
+        using enable_avx512_shuffle_t = typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 64>::type;
+
+        // Bitwise reinterpretation of 512-bit batches as __m512i
+        template <class T>
+        struct avx512_shuffle_register
+        {
+            using batch_type = batch<T, 64 / sizeof(T)>;
+
+            static __m512i to_int(const batch_type& x)
+            {
+                return x;
+            }
+
+            static batch_type from_int(__m512i x)
+            {
+                return x;
+            }
+        };
+
+        template <>
+        struct avx512_shuffle_register<float>
+        {
+            using batch_type = batch<float, 16>;
+
+            static __m512i to_int(const batch_type& x)
+            {
+                return _mm512_castps_si512(x);
+            }
+
+            static batch_type from_int(__m512i x)
+            {
+                return _mm512_castsi512_ps(x);
+            }
+        };
+
+        template <>
+        struct avx512_shuffle_register<double>
+        {
+            using batch_type = batch<double, 8>;
+
+            static __m512i to_int(const batch_type& x)
+            {
+                return _mm512_castpd_si512(x);
+            }
+
+            static batch_type from_int(__m512i x)
+            {
+                return _mm512_castsi512_pd(x);
+            }
+        };
+
+        // vpermw requires AVX512BW, vpermb requires AVX512VBMI
+        template <std::size_t S>
+        struct avx512_has_permutexvar : std::integral_constant<bool, (S >= 4)>
+        {
+        };
+
+#if defined(XSIMD_AVX512BW_AVAILABLE)
+        template <>
+        struct avx512_has_permutexvar<2> : std::true_type
+        {
+        };
+#endif
+
+#if defined(XSIMD_AVX512VBMI_AVAILABLE)
+        template <>
+        struct avx512_has_permutexvar<1> : std::true_type
+        {
+        };
+#endif
+
+        template <class T, std::size_t S = sizeof(T)>
+        struct avx512_swizzle_kernel;
+
+        template <class T>
+        struct avx512_swizzle_kernel<T, 8>
+        {
+            template <class I>
+            static inline batch<T, 8> run(const batch<T, 8>& x, const batch<I, 8>& index)
+            {
+                return _mm512_permutexvar_epi64(index, x);
+            }
+        };
+
+        template <>
+        struct avx512_swizzle_kernel<double, 8>
+        {
+            template <class I>
+            static inline batch<double, 8> run(const batch<double, 8>& x, const batch<I, 8>& index)
+            {
+                return _mm512_permutexvar_pd(index, x);
+            }
+        };
+
+        template <class T>
+        struct avx512_swizzle_kernel<T, 4>
+        {
+            template <class I>
+            static inline batch<T, 16> run(const batch<T, 16>& x, const batch<I, 16>& index)
+            {
+                return _mm512_permutexvar_epi32(index, x);
+            }
+        };
+
+        template <>
+        struct avx512_swizzle_kernel<float, 4>
+        {
+            template <class I>
+            static inline batch<float, 16> run(const batch<float, 16>& x, const batch<I, 16>& index)
+            {
+                return _mm512_permutexvar_ps(index, x);
+            }
+        };
+
+#if defined(XSIMD_AVX512BW_AVAILABLE)
+        template <class T>
+        struct avx512_swizzle_kernel<T, 2>
+        {
+            template <class I>
+            static inline batch<T, 32> run(const batch<T, 32>& x, const batch<I, 32>& index)
+            {
+                return _mm512_permutexvar_epi16(index, x);
+            }
+        };
+#endif
+
+#if defined(XSIMD_AVX512VBMI_AVAILABLE)
+        template <class T>
+        struct avx512_swizzle_kernel<T, 1>
+        {
+            template <class I>
+            static inline batch<T, 64> run(const batch<T, 64>& x, const batch<I, 64>& index)
+            {
+                return _mm512_permutexvar_epi8(index, x);
+            }
+        };
+#endif
+    }
+
+    /***********
+     * swizzle *
+     ***********/
+
+    template <class T, std::size_t N>
+    struct swizzle_impl<T, N, typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 64 &&
+                                                      detail::avx512_has_permutexvar<sizeof(T)>::value>::type>
+        : detail::avx512_swizzle_kernel<T>
+    {
+    };
+
+    /***********
+     * shuffle *
+     ***********/
+
+    namespace detail
+    {
+        // Patterns where every element stays in its 128-bit lane
+        template <class T, std::size_t S = sizeof(T)>
+        struct avx512_in_lane_shuffle
+        {
+            template <class traits>
+            static constexpr bool accepts()
+            {
+                return false;
+            }
+        };
+
+#if defined(XSIMD_AVX512BW_AVAILABLE)
+        template <class T>
+        struct avx512_in_lane_shuffle<T, 1>
+        {
+            template <class traits>
+            static constexpr bool accepts()
+            {
+                return traits::is_in_lanes(16);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 64> run(const batch<T, 64>& x, const batch_constant<I, Is...>& mask)
+            {
+                // vpshufb only reads the low 4 bits of the byte indices
+                return _mm512_shuffle_epi8(x, mask());
+            }
+        };
+#endif
+
+        template <class T>
+        struct avx512_in_lane_shuffle<T, 4>
+        {
+            template <class traits>
+            static constexpr bool accepts()
+            {
+                return traits::is_in_lanes(4) && traits::is_same_in_lanes(4);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 16> run(const batch<T, 16>& x, const batch_constant<I, Is...>&)
+            {
+                using reg = avx512_shuffle_register<T>;
+                constexpr int imm = shuffle_traits<I, Is...>::immediate(4, 2);
+                return reg::from_int(_mm512_castps_si512(_mm512_permute_ps(_mm512_castsi512_ps(reg::to_int(x)), imm)));
+            }
+        };
+
+        // vpermilpd within 128-bit lanes, vpermpd within 256-bit lanes
+        template <class T>
+        struct avx512_in_lane_shuffle<T, 8>
+        {
+            template <class traits>
+            static constexpr bool accepts()
+            {
+                return traits::is_in_lanes(2) || (traits::is_in_lanes(4) && traits::is_same_in_lanes(4));
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 8> run_impl(const batch<T, 8>& x, const batch_constant<I, Is...>&, std::true_type)
+            {
+                using reg = avx512_shuffle_register<T>;
+                constexpr int imm = shuffle_traits<I, Is...>::odd_mask();
+                return reg::from_int(_mm512_castpd_si512(_mm512_permute_pd(_mm512_castsi512_pd(reg::to_int(x)), imm)));
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 8> run_impl(const batch<T, 8>& x, const batch_constant<I, Is...>&, std::false_type)
+            {
+                using reg = avx512_shuffle_register<T>;
+                constexpr int imm = shuffle_traits<I, Is...>::immediate(4, 2);
+                return reg::from_int(_mm512_permutex_epi64(reg::to_int(x), imm));
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 8> run(const batch<T, 8>& x, const batch_constant<I, Is...>& mask)
+            {
+                using in_pairs = std::integral_constant<bool, shuffle_traits<I, Is...>::is_in_lanes(2)>;
+                return run_impl(x, mask, in_pairs());
+            }
+        };
+
+        // vshufi32x4 when whole lanes are moved, then the in-lane
+        // permutations, then the cross-lane ones
+        template <class T, std::size_t N>
+        struct avx512_shuffle_kernel
+        {
+            template <class I, I... Is>
+            static inline batch<T, N> run_impl(const batch<T, N>& x, const batch_constant<I, Is...>&, std::integral_constant<int, 0>)
+            {
+                using traits = shuffle_traits<I, Is...>;
+                using reg = avx512_shuffle_register<T>;
+                constexpr std::size_t L = N / 4;
+                constexpr int imm = static_cast<int>((traits::get(0) / L) | ((traits::get(L) / L) << 2) |
+                                                     ((traits::get(2 * L) / L) << 4) | ((traits::get(3 * L) / L) << 6));
+                return reg::from_int(_mm512_shuffle_i32x4(reg::to_int(x), reg::to_int(x), imm));
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, N> run_impl(const batch<T, N>& x, const batch_constant<I, Is...>& mask, std::integral_constant<int, 1>)
+            {
+                return avx512_in_lane_shuffle<T>::run(x, mask);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, N> run_impl(const batch<T, N>& x, const batch_constant<I, Is...>& mask, std::integral_constant<int, 2>)
+            {
+                return swizzle_impl<T, N>::run(x, mask());
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, N> run(const batch<T, N>& x, const batch_constant<I, Is...>& mask)
+            {
+                using traits = shuffle_traits<I, Is...>;
+                using strategy = std::integral_constant<int, traits::is_lane_permutation(N / 4) ? 0 :
+                                                             (avx512_in_lane_shuffle<T>::template accepts<traits>() ? 1 : 2)>;
+                return run_impl(x, mask, strategy());
+            }
+        };
+    }
+
+    template <class T, std::size_t N>
+    struct shuffle_impl<T, N, detail::enable_avx512_shuffle_t<T, N>>
+        : detail::avx512_shuffle_kernel<T, N>
+    {
+    };
+
+    /************
+     * compress *
+     ************/
+
+    namespace detail
+    {
+        // The selected elements are compressed to the front, the other ones
+        // are compressed then expanded to the back.
+        template <std::size_t S>
+        struct avx512_compress_kernel;
+
+        template <>
+        struct avx512_compress_kernel<4>
+        {
+            static inline __m512i run(__m512i x, __mmask16 mask, std::size_t count)
+            {
+                __m512i selected = _mm512_maskz_compress_epi32(mask, x);
+                __m512i others = _mm512_maskz_compress_epi32(static_cast<__mmask16>(~mask), x);
+                return _mm512_mask_expand_epi32(selected, static_cast<__mmask16>(0xFFFF << count), others);
+            }
+        };
+
+        template <>
+        struct avx512_compress_kernel<8>
+        {
+            static inline __m512i run(__m512i x, __mmask8 mask, std::size_t count)
+            {
+                __m512i selected = _mm512_maskz_compress_epi64(mask, x);
+                __m512i others = _mm512_maskz_compress_epi64(static_cast<__mmask8>(~mask), x);
+                return _mm512_mask_expand_epi64(selected, static_cast<__mmask8>(0xFF << count), others);
+            }
+        };
+    }
+
+    template <class T, std::size_t N>
+    struct compress_impl<T, N, typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 64 && (sizeof(T) >= 4)>::type>
+    {
+        static constexpr bool native = true;
+
+        static inline batch<T, N> run(const batch<T, N>& x, const batch_bool<T, N>& mask, std::size_t& count)
+        {
+            using reg = detail::avx512_shuffle_register<T>;
+            count = detail::bit_count(static_cast<uint64_t>(mask));
+            return reg::from_int(detail::avx512_compress_kernel<sizeof(T)>::run(reg::to_int(x), mask, count));
+        }
+    };
+
+    /**********
+     * gather *
+     **********/
+
+    namespace detail
+    {
+        template <class T, std::size_t S = sizeof(T)>
+        struct avx512_gather_kernel;
+
+        template <class T>
+        struct avx512_gather_kernel<T, 4>
+        {
+            template <class I>
+            static inline batch<T, 16> run(const T* src, const batch<I, 16>& index)
+            {
+                return _mm512_i32gather_epi32(index, src, 4);
+            }
+        };
+
+        template <>
+        struct avx512_gather_kernel<float, 4>
+        {
+            template <class I>
+            static inline batch<float, 16> run(const float* src, const batch<I, 16>& index)
+            {
+                return _mm512_i32gather_ps(index, src, 4);
+            }
+        };
+
+        template <class T>
+        struct avx512_gather_kernel<T, 8>
+        {
+            template <class I>
+            static inline batch<T, 8> run(const T* src, const batch<I, 8>& index)
+            {
+                return _mm512_i64gather_epi64(index, src, 8);
+            }
+        };
+
+        template <>
+        struct avx512_gather_kernel<double, 8>
+        {
+            template <class I>
+            static inline batch<double, 8> run(const double* src, const batch<I, 8>& index)
+            {
+                return _mm512_i64gather_pd(index, src, 8);
+            }
+        };
+    }
+
+    template <class T, std::size_t N>
+    struct gather_impl<T, N, typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 64 && (sizeof(T) >= 4)>::type>
+        : detail::avx512_gather_kernel<T>
+    {
+    };
+}
+
+#endif
@@ -649,6 +649,18 @@ namespace xsimd
                 return _mm_cvtsd_f64(_mm256_extractf128_pd(tmp, 0));
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                __m128d tmp = _mm_min_pd(_mm256_castpd256_pd128(rhs), _mm256_extractf128_pd(rhs, 1));
+                return xsimd::hmin(batch<double, 2>(tmp));
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                __m128d tmp = _mm_max_pd(_mm256_castpd256_pd128(rhs), _mm256_extractf128_pd(rhs, 1));
+                return xsimd::hmax(batch<double, 2>(tmp));
+            }
+
             static batch_type haddp(const batch_type* row)
             {
                 // row = (a,b,c,d)
@@ -691,10 +703,10 @@ namespace xsimd
                 for (int i = 0 ; i < (4 - n); ++i)
                 {
                     b_concatenate[i] = lhs[i + n];
-                    if(i < n)
-                    {
-                        b_concatenate[4 - 1 - i] = rhs[n - 1 - i];
-                    }
+                }
+                for (int i = 0 ; i < n; ++i)
+                {
+                    b_concatenate[4 - n + i] = rhs[i];
                 }
                 return b_concatenate;
             }
@@ -685,6 +685,18 @@ namespace xsimd
                 return _mm_cvtss_f32(_mm256_extractf128_ps(tmp, 0));
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                __m128 tmp = _mm_min_ps(_mm256_castps256_ps128(rhs), _mm256_extractf128_ps(rhs, 1));
+                return xsimd::hmin(batch<float, 4>(tmp));
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                __m128 tmp = _mm_max_ps(_mm256_castps256_ps128(rhs), _mm256_extractf128_ps(rhs, 1));
+                return xsimd::hmax(batch<float, 4>(tmp));
+            }
+
             static batch_type haddp(const batch_type* row)
             {
                 // row = (a,b,c,d,e,f,g,h)
@@ -739,10 +751,10 @@ namespace xsimd
                 for (int i = 0 ; i < (8 - n); ++i)
                 {
                     b_concatenate[i] = lhs[i + n];
-                    if(i < n)
-                    {
-                        b_concatenate[8 - 1 - i] = rhs[n - 1 - i];
-                    }
+                }
+                for (int i = 0 ; i < n; ++i)
+                {
+                    b_concatenate[8 - n + i] = rhs[i];
                 }
                 return b_concatenate;
             }
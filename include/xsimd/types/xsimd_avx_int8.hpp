@@ -341,6 +341,19 @@ namespace xsimd
                 return _mm256_unpackhi_epi8(lhs, rhs);
             }
 
+            static batch_type lookup16(const batch_type& table, const batch_type& index)
+            {
+                __m128i table_low = _mm256_castsi256_si128(table);
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+                return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(table_low), index);
+#else
+                XSIMD_SPLIT_AVX(index);
+                __m128i res_low = _mm_shuffle_epi8(table_low, index_low);
+                __m128i res_high = _mm_shuffle_epi8(table_low, index_high);
+                XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+#endif
+            }
+
             static batch_type extract_pair(const batch_type& v_lhs, const batch_type& v_rhs, const int n)
             {
 #if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
@@ -0,0 +1,489 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_AVX_INT_ARITH_HPP
+#define XSIMD_AVX_INT_ARITH_HPP
+
+#include "xsimd_avx_int8.hpp"
+#include "xsimd_avx_int16.hpp"
+#include "xsimd_avx_int32.hpp"
+#include "xsimd_avx_int64.hpp"
+#include "xsimd_sse_int_arith.hpp"
+
+namespace xsimd
+{
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+
+    namespace detail
+    {
+        // Sign or zero extension of the low and high halves of the 8-bit
+        // elements of each 128-bit lane
+        inline __m256i avx_widen_lo_epi8(__m256i x, std::true_type)
+        {
+            return _mm256_srai_epi16(_mm256_unpacklo_epi8(x, x), 8);
+        }
+
+        inline __m256i avx_widen_hi_epi8(__m256i x, std::true_type)
+        {
+            return _mm256_srai_epi16(_mm256_unpackhi_epi8(x, x), 8);
+        }
+
+        inline __m256i avx_widen_lo_epi8(__m256i x, std::false_type)
+        {
+            return _mm256_unpacklo_epi8(x, _mm256_setzero_si256());
+        }
+
+        inline __m256i avx_widen_hi_epi8(__m256i x, std::false_type)
+        {
+            return _mm256_unpackhi_epi8(x, _mm256_setzero_si256());
+        }
+
+        // Sign or zero extension of 128-bit halves
+        inline __m256i avx_cvt_epi8(__m128i x, std::true_type)
+        {
+            return _mm256_cvtepi8_epi16(x);
+        }
+
+        inline __m256i avx_cvt_epi8(__m128i x, std::false_type)
+        {
+            return _mm256_cvtepu8_epi16(x);
+        }
+
+        inline __m256i avx_cvt_epi32(__m128i x, std::true_type)
+        {
+            return _mm256_cvtepi32_epi64(x);
+        }
+
+        inline __m256i avx_cvt_epi32(__m128i x, std::false_type)
+        {
+            return _mm256_cvtepu32_epi64(x);
+        }
+
+        // Even and odd 8-bit elements, extended in the 16-bit elements
+        inline __m256i avx_even_epi8(__m256i x, std::true_type)
+        {
+            return _mm256_srai_epi16(_mm256_slli_epi16(x, 8), 8);
+        }
+
+        inline __m256i avx_odd_epi8(__m256i x, std::true_type)
+        {
+            return _mm256_srai_epi16(x, 8);
+        }
+
+        inline __m256i avx_even_epi8(__m256i x, std::false_type)
+        {
+            return _mm256_and_si256(x, _mm256_set1_epi16(0x00FF));
+        }
+
+        inline __m256i avx_odd_epi8(__m256i x, std::false_type)
+        {
+            return _mm256_srli_epi16(x, 8);
+        }
+
+        // Full products of the even 32-bit elements
+        inline __m256i avx_mul_even_epi32(__m256i x, __m256i y, std::true_type)
+        {
+            return _mm256_mul_epi32(x, y);
+        }
+
+        inline __m256i avx_mul_even_epi32(__m256i x, __m256i y, std::false_type)
+        {
+            return _mm256_mul_epu32(x, y);
+        }
+
+        template <class T, std::size_t S>
+        using enable_avx_int_t = typename std::enable_if<std::is_integral<T>::value && sizeof(T) == S>::type;
+    }
+
+    /*********
+     * mulhi *
+     *********/
+
+    template <>
+    struct mulhi_impl<int16_t, 16>
+    {
+        static inline batch<int16_t, 16> run(const batch<int16_t, 16>& x, const batch<int16_t, 16>& y)
+        {
+            return _mm256_mulhi_epi16(x, y);
+        }
+    };
+
+    template <>
+    struct mulhi_impl<uint16_t, 16>
+    {
+        static inline batch<uint16_t, 16> run(const batch<uint16_t, 16>& x, const batch<uint16_t, 16>& y)
+        {
+            return _mm256_mulhi_epu16(x, y);
+        }
+    };
+
+    // Unpacks and packs work in 128-bit lanes alike, so that the elements
+    // keep their order.
+    template <class T>
+    struct mulhi_impl<T, 32, detail::enable_avx_int_t<T, 1>>
+    {
+        static inline __m256i run_half(__m256i x, __m256i y, std::true_type)
+        {
+            return _mm256_srai_epi16(_mm256_mullo_epi16(x, y), 8);
+        }
+
+        static inline __m256i run_half(__m256i x, __m256i y, std::false_type)
+        {
+            return _mm256_srli_epi16(_mm256_mullo_epi16(x, y), 8);
+        }
+
+        static inline __m256i pack(__m256i lo, __m256i hi, std::true_type)
+        {
+            return _mm256_packs_epi16(lo, hi);
+        }
+
+        static inline __m256i pack(__m256i lo, __m256i hi, std::false_type)
+        {
+            return _mm256_packus_epi16(lo, hi);
+        }
+
+        static inline batch<T, 32> run(const batch<T, 32>& x, const batch<T, 32>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m256i lo = run_half(detail::avx_widen_lo_epi8(x, is_signed()), detail::avx_widen_lo_epi8(y, is_signed()), is_signed());
+            __m256i hi = run_half(detail::avx_widen_hi_epi8(x, is_signed()), detail::avx_widen_hi_epi8(y, is_signed()), is_signed());
+            return pack(lo, hi, is_signed());
+        }
+    };
+
+    template <class T>
+    struct mulhi_impl<T, 8, detail::enable_avx_int_t<T, 4>>
+    {
+        static inline batch<T, 8> run(const batch<T, 8>& x, const batch<T, 8>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m256i even = detail::avx_mul_even_epi32(x, y, is_signed());
+            __m256i odd = detail::avx_mul_even_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32), is_signed());
+            return _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+        }
+    };
+
+    /*******
+     * avg *
+     *******/
+
+    template <>
+    struct avg_impl<uint8_t, 32>
+    {
+        static inline batch<uint8_t, 32> run(const batch<uint8_t, 32>& x, const batch<uint8_t, 32>& y)
+        {
+            return _mm256_avg_epu8(x, y);
+        }
+    };
+
+    template <>
+    struct avg_impl<uint16_t, 16>
+    {
+        static inline batch<uint16_t, 16> run(const batch<uint16_t, 16>& x, const batch<uint16_t, 16>& y)
+        {
+            return _mm256_avg_epu16(x, y);
+        }
+    };
+
+    template <>
+    struct avg_impl<int8_t, 32>
+    {
+        static inline batch<int8_t, 32> run(const batch<int8_t, 32>& x, const batch<int8_t, 32>& y)
+        {
+            __m256i bias = _mm256_set1_epi8(-128);
+            return _mm256_xor_si256(_mm256_avg_epu8(_mm256_xor_si256(x, bias), _mm256_xor_si256(y, bias)), bias);
+        }
+    };
+
+    template <>
+    struct avg_impl<int16_t, 16>
+    {
+        static inline batch<int16_t, 16> run(const batch<int16_t, 16>& x, const batch<int16_t, 16>& y)
+        {
+            __m256i bias = _mm256_set1_epi16(-32768);
+            return _mm256_xor_si256(_mm256_avg_epu16(_mm256_xor_si256(x, bias), _mm256_xor_si256(y, bias)), bias);
+        }
+    };
+
+    /*******
+     * sad *
+     *******/
+
+    template <>
+    struct sad_impl<32>
+    {
+        static inline batch<uint64_t, 4> run(const batch<uint8_t, 32>& x, const batch<uint8_t, 32>& y)
+        {
+            return _mm256_sad_epu8(x, y);
+        }
+    };
+
+    /*************
+     * mul_widen *
+     *************/
+
+    template <class T>
+    struct mul_widen_impl<T, 32, detail::enable_avx_int_t<T, 1>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 16> run_lo(const batch<T, 32>& x, const batch<T, 32>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return _mm256_mullo_epi16(detail::avx_cvt_epi8(_mm256_castsi256_si128(x), is_signed()),
+                                      detail::avx_cvt_epi8(_mm256_castsi256_si128(y), is_signed()));
+        }
+
+        static inline batch<wide_type, 16> run_hi(const batch<T, 32>& x, const batch<T, 32>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return _mm256_mullo_epi16(detail::avx_cvt_epi8(_mm256_extracti128_si256(x, 1), is_signed()),
+                                      detail::avx_cvt_epi8(_mm256_extracti128_si256(y, 1), is_signed()));
+        }
+    };
+
+    // The halves of the products are interleaved in each 128-bit lane,
+    // then the lanes are reordered.
+    template <class T>
+    struct mul_widen_impl<T, 16, detail::enable_avx_int_t<T, 2>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline __m256i mulhi(__m256i x, __m256i y, std::true_type)
+        {
+            return _mm256_mulhi_epi16(x, y);
+        }
+
+        static inline __m256i mulhi(__m256i x, __m256i y, std::false_type)
+        {
+            return _mm256_mulhi_epu16(x, y);
+        }
+
+        static inline batch<wide_type, 8> run_lo(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            __m256i lo = _mm256_mullo_epi16(x, y);
+            __m256i hi = mulhi(x, y, std::is_signed<T>());
+            return _mm256_permute2x128_si256(_mm256_unpacklo_epi16(lo, hi), _mm256_unpackhi_epi16(lo, hi), 0x20);
+        }
+
+        static inline batch<wide_type, 8> run_hi(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            __m256i lo = _mm256_mullo_epi16(x, y);
+            __m256i hi = mulhi(x, y, std::is_signed<T>());
+            return _mm256_permute2x128_si256(_mm256_unpacklo_epi16(lo, hi), _mm256_unpackhi_epi16(lo, hi), 0x31);
+        }
+    };
+
+    template <class T>
+    struct mul_widen_impl<T, 8, detail::enable_avx_int_t<T, 4>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 4> run_lo(const batch<T, 8>& x, const batch<T, 8>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return detail::avx_mul_even_epi32(detail::avx_cvt_epi32(_mm256_castsi256_si128(x), is_signed()),
+                                              detail::avx_cvt_epi32(_mm256_castsi256_si128(y), is_signed()), is_signed());
+        }
+
+        static inline batch<wide_type, 4> run_hi(const batch<T, 8>& x, const batch<T, 8>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return detail::avx_mul_even_epi32(detail::avx_cvt_epi32(_mm256_extracti128_si256(x, 1), is_signed()),
+                                              detail::avx_cvt_epi32(_mm256_extracti128_si256(y, 1), is_signed()), is_signed());
+        }
+    };
+
+    /********
+     * madd *
+     ********/
+
+    template <>
+    struct madd_impl<int16_t, 16>
+    {
+        static inline batch<int32_t, 8> run(const batch<int16_t, 16>& x, const batch<int16_t, 16>& y)
+        {
+            return _mm256_madd_epi16(x, y);
+        }
+    };
+
+    template <>
+    struct madd_impl<uint16_t, 16>
+    {
+        static inline batch<uint32_t, 8> run(const batch<uint16_t, 16>& x, const batch<uint16_t, 16>& y)
+        {
+            __m256i mask = _mm256_set1_epi32(0xFFFF);
+            __m256i even = _mm256_mullo_epi32(_mm256_and_si256(x, mask), _mm256_and_si256(y, mask));
+            __m256i odd = _mm256_mullo_epi32(_mm256_srli_epi32(x, 16), _mm256_srli_epi32(y, 16));
+            return _mm256_add_epi32(even, odd);
+        }
+    };
+
+    template <class T>
+    struct madd_impl<T, 32, detail::enable_avx_int_t<T, 1>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 16> run(const batch<T, 32>& x, const batch<T, 32>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m256i even = _mm256_mullo_epi16(detail::avx_even_epi8(x, is_signed()), detail::avx_even_epi8(y, is_signed()));
+            __m256i odd = _mm256_mullo_epi16(detail::avx_odd_epi8(x, is_signed()), detail::avx_odd_epi8(y, is_signed()));
+            return _mm256_add_epi16(even, odd);
+        }
+    };
+
+    template <class T>
+    struct madd_impl<T, 8, detail::enable_avx_int_t<T, 4>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 4> run(const batch<T, 8>& x, const batch<T, 8>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m256i even = detail::avx_mul_even_epi32(x, y, is_signed());
+            __m256i odd = detail::avx_mul_even_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32), is_signed());
+            return _mm256_add_epi64(even, odd);
+        }
+    };
+
+    /*********
+     * smadd *
+     *********/
+
+    template <>
+    struct smadd_impl<32>
+    {
+        static inline batch<int16_t, 16> run(const batch<uint8_t, 32>& x, const batch<int8_t, 32>& y)
+        {
+            return _mm256_maddubs_epi16(x, y);
+        }
+    };
+
+#else
+
+    // AVX has no integer instructions: the 128-bit halves are processed
+    // by the SSE implementations.
+
+    namespace detail
+    {
+        template <class T, std::size_t N>
+        using enable_avx_split_t = typename std::enable_if<std::is_integral<T>::value && sizeof(T) * N == 32>::type;
+    }
+
+    template <class T, std::size_t N>
+    struct mulhi_impl<T, N, detail::enable_avx_split_t<T, N>>
+    {
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            XSIMD_SPLIT_AVX(x);
+            XSIMD_SPLIT_AVX(y);
+            __m128i res_low = mulhi_impl<T, N / 2>::run(x_low, y_low);
+            __m128i res_high = mulhi_impl<T, N / 2>::run(x_high, y_high);
+            XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+        }
+    };
+
+    template <class T, std::size_t N>
+    struct avg_impl<T, N, detail::enable_avx_split_t<T, N>>
+    {
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            XSIMD_SPLIT_AVX(x);
+            XSIMD_SPLIT_AVX(y);
+            __m128i res_low = avg_impl<T, N / 2>::run(x_low, y_low);
+            __m128i res_high = avg_impl<T, N / 2>::run(x_high, y_high);
+            XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+        }
+    };
+
+    template <class T, std::size_t N>
+    struct absdiff_impl<T, N, detail::enable_avx_split_t<T, N>>
+    {
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            XSIMD_SPLIT_AVX(x);
+            XSIMD_SPLIT_AVX(y);
+            __m128i res_low = absdiff_impl<T, N / 2>::run(x_low, y_low);
+            __m128i res_high = absdiff_impl<T, N / 2>::run(x_high, y_high);
+            XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+        }
+    };
+
+    template <>
+    struct sad_impl<32>
+    {
+        static inline batch<uint64_t, 4> run(const batch<uint8_t, 32>& x, const batch<uint8_t, 32>& y)
+        {
+            XSIMD_SPLIT_AVX(x);
+            XSIMD_SPLIT_AVX(y);
+            __m128i res_low = sad_impl<16>::run(x_low, y_low);
+            __m128i res_high = sad_impl<16>::run(x_high, y_high);
+            XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+        }
+    };
+
+    template <class T, std::size_t N>
+    struct mul_widen_impl<T, N, typename std::enable_if<std::is_integral<T>::value && sizeof(T) < 8 && sizeof(T) * N == 32>::type>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+        using half_impl = mul_widen_impl<T, N / 2>;
+
+        static inline batch<wide_type, N / 2> run_lo(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            __m128i x_low = _mm256_castsi256_si128(x);
+            __m128i y_low = _mm256_castsi256_si128(y);
+            __m128i res_low = half_impl::run_lo(x_low, y_low);
+            __m128i res_high = half_impl::run_hi(x_low, y_low);
+            XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+        }
+
+        static inline batch<wide_type, N / 2> run_hi(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            __m128i x_high = _mm256_extractf128_si256(x, 1);
+            __m128i y_high = _mm256_extractf128_si256(y, 1);
+            __m128i res_low = half_impl::run_lo(x_high, y_high);
+            __m128i res_high = half_impl::run_hi(x_high, y_high);
+            XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+        }
+    };
+
+    template <class T, std::size_t N>
+    struct madd_impl<T, N, typename std::enable_if<std::is_integral<T>::value && sizeof(T) < 8 && sizeof(T) * N == 32>::type>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, N / 2> run(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            XSIMD_SPLIT_AVX(x);
+            XSIMD_SPLIT_AVX(y);
+            __m128i res_low = madd_impl<T, N / 2>::run(x_low, y_low);
+            __m128i res_high = madd_impl<T, N / 2>::run(x_high, y_high);
+            XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+        }
+    };
+
+    template <>
+    struct smadd_impl<32>
+    {
+        static inline batch<int16_t, 16> run(const batch<uint8_t, 32>& x, const batch<int8_t, 32>& y)
+        {
+            XSIMD_SPLIT_AVX(x);
+            XSIMD_SPLIT_AVX(y);
+            __m128i res_low = smadd_impl<16>::run(x_low, y_low);
+            __m128i res_high = smadd_impl<16>::run(x_high, y_high);
+            XSIMD_RETURN_MERGED_SSE(res_low, res_high);
+        }
+    };
+
+#endif
+}
+
+#endif
@@ -483,6 +483,7 @@ namespace xsimd
         struct avx_int_kernel_base
         {
             using batch_type = B;
+            using value_type = typename simd_batch_traits<B>::value_type;
             using batch_bool_type = typename simd_batch_traits<B>::batch_bool_type;
             // static constexpr std::size_t size = simd_batch_traits<B>::size;
             // static constexpr std::size_t align = simd_batch_traits<B>::align;
@@ -575,6 +576,22 @@ namespace xsimd
             {
                 return -x * y - z;
             }
+
+            static value_type hmin(const batch_type& rhs)
+            {
+                using half_batch_type = batch<value_type, simd_batch_traits<B>::size / 2>;
+                half_batch_type lo(_mm256_castsi256_si128(rhs));
+                half_batch_type hi(_mm256_extractf128_si256(rhs, 1));
+                return xsimd::hmin(min(lo, hi));
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                using half_batch_type = batch<value_type, simd_batch_traits<B>::size / 2>;
+                half_batch_type lo(_mm256_castsi256_si128(rhs));
+                half_batch_type hi(_mm256_extractf128_si256(rhs, 1));
+                return xsimd::hmax(max(lo, hi));
+            }
         };
     }
 
@@ -0,0 +1,459 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_AVX_SHUFFLE_HPP
+#define XSIMD_AVX_SHUFFLE_HPP
+
+#include "xsimd_avx_double.hpp"
+#include "xsimd_avx_float.hpp"
+#include "xsimd_avx_int8.hpp"
+#include "xsimd_avx_int16.hpp"
+#include "xsimd_avx_int32.hpp"
+#include "xsimd_avx_int64.hpp"
+
+namespace xsimd
+{
+    namespace detail
+    {
+        template <class T, std::size_t N>
+        using enable_avx_shuffle_t = typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 32>::type;
+
+        // Bitwise reinterpretation of 256-bit batches as __m256i
+        template <class T>
+        struct avx_shuffle_register
+        {
+            using batch_type = batch<T, 32 / sizeof(T)>;
+
+            static __m256i to_int(const batch_type& x)
+            {
+                return x;
+            }
+
+            static batch_type from_int(__m256i x)
+            {
+                return x;
+            }
+        };
+
+        template <>
+        struct avx_shuffle_register<float>
+        {
+            using batch_type = batch<float, 8>;
+
+            static __m256i to_int(const batch_type& x)
+            {
+                return _mm256_castps_si256(x);
+            }
+
+            static batch_type from_int(__m256i x)
+            {
+                return _mm256_castsi256_ps(x);
+            }
+        };
+
+        template <>
+        struct avx_shuffle_register<double>
+        {
+            using batch_type = batch<double, 4>;
+
+            static __m256i to_int(const batch_type& x)
+            {
+                return _mm256_castpd_si256(x);
+            }
+
+            static batch_type from_int(__m256i x)
+            {
+                return _mm256_castsi256_pd(x);
+            }
+        };
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+        // Indices of the bytes of the selected elements, for vpshufb
+        // (see sse_byte_indices)
+        template <std::size_t S>
+        __m256i avx_byte_indices(__m256i index);
+
+        template <>
+        inline __m256i avx_byte_indices<1>(__m256i index)
+        {
+            return index;
+        }
+
+        template <>
+        inline __m256i avx_byte_indices<2>(__m256i index)
+        {
+            __m256i rep = _mm256_shuffle_epi8(index, _mm256_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14,
+                                                                      0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14));
+            return _mm256_add_epi8(_mm256_slli_epi16(rep, 1), _mm256_set1_epi16(0x0100));
+        }
+
+        template <class traits, std::size_t... Js>
+        inline __m256i avx_constant_byte_indices(std::size_t S, detail::index_sequence<Js...>)
+        {
+            return _mm256_setr_epi8(static_cast<char>(traits::byte_index(S, Js))...);
+        }
+
+        // Indices of the dwords of the selected elements, for vpermd
+        inline __m256i avx_dword_indices(__m256i index)
+        {
+            __m256i low = _mm256_slli_epi64(index, 1);
+            __m256i high = _mm256_or_si256(low, _mm256_set1_epi64x(1));
+            return _mm256_or_si256(low, _mm256_slli_epi64(high, 32));
+        }
+
+        // vpshufb does not cross 128-bit lanes: both lanes of x are
+        // broadcast and the result is picked according to bit 4 of the
+        // byte index.
+        inline __m256i avx_byte_swizzle(__m256i x, __m256i byte_index)
+        {
+            __m256i low = _mm256_permute2x128_si256(x, x, 0x00);
+            __m256i high = _mm256_permute2x128_si256(x, x, 0x11);
+            __m256i res_low = _mm256_shuffle_epi8(low, byte_index);
+            __m256i res_high = _mm256_shuffle_epi8(high, byte_index);
+            return _mm256_blendv_epi8(res_low, res_high, _mm256_slli_epi16(byte_index, 3));
+        }
+
+        template <class T, std::size_t S = sizeof(T)>
+        struct avx_swizzle_kernel
+        {
+            template <class I>
+            static inline batch<T, 32 / S> run(const batch<T, 32 / S>& x, const batch<I, 32 / S>& index)
+            {
+                return avx_byte_swizzle(x, avx_byte_indices<S>(index));
+            }
+        };
+
+        template <class T>
+        struct avx_swizzle_kernel<T, 4>
+        {
+            template <class I>
+            static inline batch<T, 8> run(const batch<T, 8>& x, const batch<I, 8>& index)
+            {
+                return _mm256_permutevar8x32_epi32(x, index);
+            }
+        };
+
+        template <>
+        struct avx_swizzle_kernel<float, 4>
+        {
+            template <class I>
+            static inline batch<float, 8> run(const batch<float, 8>& x, const batch<I, 8>& index)
+            {
+                return _mm256_permutevar8x32_ps(x, index);
+            }
+        };
+
+        template <class T>
+        struct avx_swizzle_kernel<T, 8>
+        {
+            template <class I>
+            static inline batch<T, 4> run(const batch<T, 4>& x, const batch<I, 4>& index)
+            {
+                using reg = avx_shuffle_register<T>;
+                return reg::from_int(_mm256_permutevar8x32_epi32(reg::to_int(x), avx_dword_indices(index)));
+            }
+        };
+#endif
+    }
+
+    /***********
+     * swizzle *
+     ***********/
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+    template <class T, std::size_t N>
+    struct swizzle_impl<T, N, detail::enable_avx_shuffle_t<T, N>>
+        : detail::avx_swizzle_kernel<T>
+    {
+    };
+#endif
+
+    /***********
+     * shuffle *
+     ***********/
+
+    namespace detail
+    {
+        // Patterns where every element stays in its 128-bit lane
+        template <class T, std::size_t S = sizeof(T)>
+        struct avx_in_lane_shuffle
+        {
+            template <class traits>
+            static constexpr bool accepts()
+            {
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+                return traits::is_in_lanes(16 / S);
+#else
+                return false;
+#endif
+            }
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+            template <class I, I... Is>
+            static inline batch<T, 32 / S> run(const batch<T, 32 / S>& x, const batch_constant<I, Is...>&)
+            {
+                // vpshufb only reads the low 4 bits of the byte indices
+                using traits = shuffle_traits<I, Is...>;
+                return _mm256_shuffle_epi8(x, avx_constant_byte_indices<traits>(S, detail::make_index_sequence<32>()));
+            }
+#endif
+        };
+
+        template <class T>
+        struct avx_in_lane_shuffle<T, 4>
+        {
+            template <class traits>
+            static constexpr bool accepts()
+            {
+                return traits::is_in_lanes(4) && traits::is_same_in_lanes(4);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 8> run(const batch<T, 8>& x, const batch_constant<I, Is...>&)
+            {
+                using reg = avx_shuffle_register<T>;
+                constexpr int imm = shuffle_traits<I, Is...>::immediate(4, 2);
+                return reg::from_int(_mm256_castps_si256(_mm256_permute_ps(_mm256_castsi256_ps(reg::to_int(x)), imm)));
+            }
+        };
+
+        template <class T>
+        struct avx_in_lane_shuffle<T, 8>
+        {
+            template <class traits>
+            static constexpr bool accepts()
+            {
+                return traits::is_in_lanes(2);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 4> run(const batch<T, 4>& x, const batch_constant<I, Is...>&)
+            {
+                using reg = avx_shuffle_register<T>;
+                constexpr int imm = shuffle_traits<I, Is...>::odd_mask();
+                return reg::from_int(_mm256_castpd_si256(_mm256_permute_pd(_mm256_castsi256_pd(reg::to_int(x)), imm)));
+            }
+        };
+
+        // Patterns crossing 128-bit lanes
+        template <class T, std::size_t S = sizeof(T)>
+        struct avx_cross_lane_shuffle
+        {
+            template <class I, I... Is>
+            static inline batch<T, 32 / S> run(const batch<T, 32 / S>& x, const batch_constant<I, Is...>& mask)
+            {
+                return swizzle_impl<T, 32 / S>::run(x, mask());
+            }
+        };
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+        template <class T>
+        struct avx_byte_cross_lane_shuffle
+        {
+            template <class I, I... Is>
+            static inline batch<T, 32 / sizeof(T)> run(const batch<T, 32 / sizeof(T)>& x, const batch_constant<I, Is...>&)
+            {
+                using traits = shuffle_traits<I, Is...>;
+                return avx_byte_swizzle(x, avx_constant_byte_indices<traits>(sizeof(T), detail::make_index_sequence<32>()));
+            }
+        };
+
+        template <class T>
+        struct avx_cross_lane_shuffle<T, 1> : avx_byte_cross_lane_shuffle<T>
+        {
+        };
+
+        template <class T>
+        struct avx_cross_lane_shuffle<T, 2> : avx_byte_cross_lane_shuffle<T>
+        {
+        };
+
+        template <class T>
+        struct avx_cross_lane_shuffle<T, 8>
+        {
+            template <class I, I... Is>
+            static inline batch<T, 4> run(const batch<T, 4>& x, const batch_constant<I, Is...>&)
+            {
+                using reg = avx_shuffle_register<T>;
+                constexpr int imm = shuffle_traits<I, Is...>::immediate(4, 2);
+                return reg::from_int(_mm256_permute4x64_epi64(reg::to_int(x), imm));
+            }
+        };
+#endif
+
+        // vperm2f128 when whole lanes are moved, then the in-lane
+        // permutations, then the cross-lane ones
+        template <class T, std::size_t N>
+        struct avx_shuffle_kernel
+        {
+            template <class I, I... Is>
+            static inline batch<T, N> run_impl(const batch<T, N>& x, const batch_constant<I, Is...>&, std::integral_constant<int, 0>)
+            {
+                using traits = shuffle_traits<I, Is...>;
+                using reg = avx_shuffle_register<T>;
+                constexpr int imm = static_cast<int>((traits::get(0) / (N / 2)) | ((traits::get(N / 2) / (N / 2)) << 4));
+                return reg::from_int(_mm256_permute2f128_si256(reg::to_int(x), reg::to_int(x), imm));
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, N> run_impl(const batch<T, N>& x, const batch_constant<I, Is...>& mask, std::integral_constant<int, 1>)
+            {
+                return avx_in_lane_shuffle<T>::run(x, mask);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, N> run_impl(const batch<T, N>& x, const batch_constant<I, Is...>& mask, std::integral_constant<int, 2>)
+            {
+                return avx_cross_lane_shuffle<T>::run(x, mask);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, N> run(const batch<T, N>& x, const batch_constant<I, Is...>& mask)
+            {
+                using traits = shuffle_traits<I, Is...>;
+                using strategy = std::integral_constant<int, traits::is_lane_permutation(N / 2) ? 0 :
+                                                             (avx_in_lane_shuffle<T>::template accepts<traits>() ? 1 : 2)>;
+                return run_impl(x, mask, strategy());
+            }
+        };
+    }
+
+    template <class T, std::size_t N>
+    struct shuffle_impl<T, N, detail::enable_avx_shuffle_t<T, N>>
+        : detail::avx_shuffle_kernel<T, N>
+    {
+    };
+
+    /************
+     * compress *
+     ************/
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+    namespace detail
+    {
+        // Bitmask of the selection, one bit per element
+        inline int avx_compress_bits(const batch_bool<float, 8>& mask)
+        {
+            return _mm256_movemask_ps(mask);
+        }
+
+        inline int avx_compress_bits(const batch_bool<double, 4>& mask)
+        {
+            return _mm256_movemask_pd(mask);
+        }
+
+        template <class T>
+        inline int avx_compress_bits(const batch_bool<T, 8>& mask)
+        {
+            return _mm256_movemask_ps(_mm256_castsi256_ps(mask));
+        }
+
+        template <class T>
+        inline int avx_compress_bits(const batch_bool<T, 4>& mask)
+        {
+            return _mm256_movemask_pd(_mm256_castsi256_pd(mask));
+        }
+
+        // vpermd indices of compress packed in nibbles, for every bitmask of
+        // N elements
+        constexpr uint32_t avx_compress_nibbles(std::size_t bits, std::size_t N, std::size_t q = 0)
+        {
+            return q == 8 ? 0u
+                          : static_cast<uint32_t>((compress_source(bits, q / (8 / N)) * (8 / N) + q % (8 / N)) << (4 * q)) |
+                                avx_compress_nibbles(bits, N, q + 1);
+        }
+
+        template <std::size_t N, std::size_t... Ms>
+        inline const uint32_t* avx_compress_table(detail::index_sequence<Ms...>)
+        {
+            static const uint32_t table[] = { avx_compress_nibbles(Ms, N)... };
+            return table;
+        }
+    }
+
+    template <class T, std::size_t N>
+    struct compress_impl<T, N, typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 32 && (sizeof(T) >= 4)>::type>
+    {
+        static constexpr bool native = true;
+
+        static inline batch<T, N> run(const batch<T, N>& x, const batch_bool<T, N>& mask, std::size_t& count)
+        {
+            using reg = detail::avx_shuffle_register<T>;
+            const uint32_t* table = detail::avx_compress_table<N>(detail::make_index_sequence<(1 << N)>());
+            int bits = detail::avx_compress_bits(mask);
+            count = detail::bit_count(static_cast<uint64_t>(bits));
+            __m256i nibbles = _mm256_set1_epi32(static_cast<int>(table[bits]));
+            __m256i index = _mm256_and_si256(_mm256_srlv_epi32(nibbles, _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28)),
+                                             _mm256_set1_epi32(0xF));
+            return reg::from_int(_mm256_permutevar8x32_epi32(reg::to_int(x), index));
+        }
+    };
+#endif
+
+    /**********
+     * gather *
+     **********/
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX2_VERSION
+    namespace detail
+    {
+        template <class T, std::size_t S = sizeof(T)>
+        struct avx_gather_kernel;
+
+        template <class T>
+        struct avx_gather_kernel<T, 4>
+        {
+            template <class I>
+            static inline batch<T, 8> run(const T* src, const batch<I, 8>& index)
+            {
+                return _mm256_i32gather_epi32(reinterpret_cast<const int*>(src), index, 4);
+            }
+        };
+
+        template <>
+        struct avx_gather_kernel<float, 4>
+        {
+            template <class I>
+            static inline batch<float, 8> run(const float* src, const batch<I, 8>& index)
+            {
+                return _mm256_i32gather_ps(src, index, 4);
+            }
+        };
+
+        template <class T>
+        struct avx_gather_kernel<T, 8>
+        {
+            template <class I>
+            static inline batch<T, 4> run(const T* src, const batch<I, 4>& index)
+            {
+                return _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), index, 8);
+            }
+        };
+
+        template <>
+        struct avx_gather_kernel<double, 8>
+        {
+            template <class I>
+            static inline batch<double, 4> run(const double* src, const batch<I, 4>& index)
+            {
+                return _mm256_i64gather_pd(src, index, 8);
+            }
+        };
+    }
+
+    template <class T, std::size_t N>
+    struct gather_impl<T, N, typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 32 && (sizeof(T) >= 4)>::type>
+        : detail::avx_gather_kernel<T>
+    {
+    };
+#endif
+}
+
+#endif
@@ -17,6 +17,7 @@
 #include <iterator>
 #include <ostream>
 #include <type_traits>
+#include <utility>
 
 #ifdef XSIMD_ENABLE_XTL_COMPLEX
 #include "xtl/xcomplex.hpp"
@@ -279,6 +280,18 @@ namespace xsimd
     template <class X>
     enable_if_simd_t<X> haddp(const X* row);
 
+    template <class X>
+    typename simd_batch_traits<X>::value_type
+    hmin(const simd_base<X>& rhs);
+
+    template <class X>
+    typename simd_batch_traits<X>::value_type
+    hmax(const simd_base<X>& rhs);
+
+    template <class X>
+    std::pair<typename simd_batch_traits<X>::value_type, typename simd_batch_traits<X>::value_type>
+    hminmax(const simd_base<X>& rhs);
+
     template <class X>
     batch_type_t<X> select(const typename simd_batch_traits<X>::batch_bool_type& cond, const simd_base<X>& a, const simd_base<X>& b);
 
@@ -288,6 +301,9 @@ namespace xsimd
     template <class X>
     batch_type_t<X> zip_hi(const simd_base<X>& lhs, const simd_base<X>& rhs);
 
+    template <class X>
+    batch_type_t<X> lookup16(const simd_base<X>& table, const simd_base<X>& index);
+
     template <class X>
     batch_type_t<X> extract_pair(const simd_base<X>& lhs, const simd_base<X>& rhs, const int n);
 
@@ -377,6 +393,448 @@ namespace xsimd
             }                                                                   \
         };
 
+    /*********************
+     * shuffle functions *
+     *********************/
+
+    // Provides swizzle: res[i] = x[index[i]]. Architectures specialize it
+    // for the batches they can permute with a variable shuffle instruction.
+    template <class T, std::size_t N, class = void>
+    struct swizzle_impl
+    {
+        template <class I, std::size_t... Is>
+        static inline batch<T, N> run_impl(const batch<T, N>& x, const batch<I, N>& index, detail::index_sequence<Is...>)
+        {
+            return batch<T, N>(x[static_cast<std::size_t>(index[Is])]...);
+        }
+
+        template <class I>
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<I, N>& index)
+        {
+            return run_impl(x, index, detail::make_index_sequence<N>{});
+        }
+    };
+
+    // Provides shuffle with a compile-time pattern. Architectures specialize
+    // it to select an instruction with an immediate operand when the pattern
+    // allows it; the default uses swizzle with constant indices.
+    template <class T, std::size_t N, class = void>
+    struct shuffle_impl
+    {
+        template <class I, I... Is>
+        static inline batch<T, N> run(const batch<T, N>& x, const batch_constant<I, Is...>& mask)
+        {
+            return swizzle_impl<T, N>::run(x, mask());
+        }
+    };
+
+    template <class T, class I, std::size_t N>
+    batch<T, N> swizzle(const batch<T, N>& x, const batch<I, N>& index);
+
+    template <class T, std::size_t N, class I, I... Is>
+    batch<T, N> shuffle(const batch<T, N>& x, const batch_constant<I, Is...>& mask);
+
+    /***********************
+     * histogram functions *
+     ***********************/
+
+    // Increments counts[index[i]] for every element of index. Repeated
+    // indices must not serialize on the same counter: the i-th element goes
+    // to the sub-histogram counts + (i % sub_histograms) * stride.
+    // Architectures with conflict detection specialize it to update a
+    // single histogram.
+    template <class T, std::size_t N, class = void>
+    struct histogram_impl
+    {
+        static constexpr std::size_t sub_histograms = 4;
+
+        static inline void run(uint32_t* counts, std::size_t stride, const batch<T, N>& index)
+        {
+            alignas(batch<T, N>) T buffer[N];
+            index.store_aligned(buffer);
+            unroller<N>([&](std::size_t i) {
+                ++counts[(i % sub_histograms) * stride + static_cast<std::size_t>(buffer[i])];
+            });
+        }
+    };
+
+    template <class T, std::size_t N, class V>
+    constexpr std::size_t histogram_impl<T, N, V>::sub_histograms;
+
+    /**********************
+     * compress functions *
+     **********************/
+
+    namespace detail
+    {
+        inline std::size_t bit_count(uint64_t bits)
+        {
+            bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+            bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+            bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            return static_cast<std::size_t>((bits * 0x0101010101010101ull) >> 56);
+        }
+
+        // Compile-time helpers for the permutation tables of compress
+        constexpr std::size_t static_bit_count(std::size_t bits)
+        {
+            return bits == 0 ? 0 : (bits & 1) + static_bit_count(bits >> 1);
+        }
+
+        // Position of the k-th bit of bits equal to value
+        constexpr std::size_t static_nth_bit(std::size_t bits, std::size_t k, std::size_t value, std::size_t i = 0)
+        {
+            return ((bits >> i) & 1) == value ? (k == 0 ? i : static_nth_bit(bits, k - 1, value, i + 1))
+                                              : static_nth_bit(bits, k, value, i + 1);
+        }
+
+        // Source of the element moved to position p by compress, for the
+        // selection whose bitmask is bits
+        constexpr std::size_t compress_source(std::size_t bits, std::size_t p)
+        {
+            return p < static_bit_count(bits) ? static_nth_bit(bits, p, 1)
+                                              : static_nth_bit(bits, p - static_bit_count(bits), 0);
+        }
+
+        // Byte indices of compress for every bitmask of 16 / S elements, for
+        // the table lookup instructions on 128-bit registers
+        template <std::size_t S, std::size_t... Js>
+        inline const uint8_t* compress_byte_table(detail::index_sequence<Js...>)
+        {
+            alignas(16) static const uint8_t table[] = {
+                static_cast<uint8_t>(compress_source(Js / 16, Js % 16 / S) * S + Js % S)...
+            };
+            return table;
+        }
+    }
+
+    // Provides compress: the elements of x selected by mask are moved to the
+    // front and followed by the other ones, both groups keeping their order;
+    // count receives the number of selected elements. Architectures
+    // specialize it with a table of permutations indexed by the bitmask of
+    // the selection, or with a native compress instruction, and set native.
+    template <class T, std::size_t N, class = void>
+    struct compress_impl
+    {
+        static constexpr bool native = false;
+
+        static inline batch<T, N> run(const batch<T, N>& x, const batch_bool<T, N>& mask, std::size_t& count)
+        {
+            alignas(batch<T, N>) T buffer[N];
+            alignas(batch<T, N>) T res[N];
+            bool selected[N];
+            x.store_aligned(buffer);
+            mask.store_unaligned(selected);
+            std::size_t pos = 0;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (selected[i])
+                {
+                    res[pos++] = buffer[i];
+                }
+            }
+            count = pos;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (!selected[i])
+                {
+                    res[pos++] = buffer[i];
+                }
+            }
+            return batch<T, N>(res, aligned_mode());
+        }
+    };
+
+    template <class T, std::size_t N>
+    batch<T, N> compress(const batch<T, N>& x, const batch_bool<T, N>& mask);
+
+    /********************
+     * gather functions *
+     ********************/
+
+    // Provides gather: res[i] = src[index[i]]. Architectures with gather
+    // instructions specialize it.
+    template <class T, std::size_t N, class = void>
+    struct gather_impl
+    {
+        template <class I>
+        static inline batch<T, N> run(const T* src, const batch<I, N>& index)
+        {
+            alignas(batch<I, N>) I buffer[N];
+            alignas(batch<T, N>) T res[N];
+            index.store_aligned(buffer);
+            unroller<N>([&](std::size_t i) {
+                res[i] = src[static_cast<std::size_t>(buffer[i])];
+            });
+            return batch<T, N>(res, aligned_mode());
+        }
+    };
+
+    template <class T, class I, std::size_t N>
+    batch<T, N> gather(const T* src, const batch<I, N>& index);
+
+    /********************************
+     * integer arithmetic functions *
+     ********************************/
+
+    namespace detail
+    {
+        // Integer type of twice the width of T, with the same signedness
+        template <class T>
+        struct widen_integer;
+
+        template <>
+        struct widen_integer<int8_t>
+        {
+            using type = int16_t;
+        };
+
+        template <>
+        struct widen_integer<uint8_t>
+        {
+            using type = uint16_t;
+        };
+
+        template <>
+        struct widen_integer<int16_t>
+        {
+            using type = int32_t;
+        };
+
+        template <>
+        struct widen_integer<uint16_t>
+        {
+            using type = uint32_t;
+        };
+
+        template <>
+        struct widen_integer<int32_t>
+        {
+            using type = int64_t;
+        };
+
+        template <>
+        struct widen_integer<uint32_t>
+        {
+            using type = uint64_t;
+        };
+
+        template <class T>
+        using widen_integer_t = typename widen_integer<T>::type;
+
+        template <class T>
+        inline T scalar_mulhi(T lhs, T rhs, std::false_type)
+        {
+            using wide_type = widen_integer_t<T>;
+            return static_cast<T>((static_cast<wide_type>(lhs) * static_cast<wide_type>(rhs)) >> (8 * sizeof(T)));
+        }
+
+        // 64-bit high multiply from the four 32-bit partial products; the
+        // signed result is corrected for the negative operands.
+        inline uint64_t scalar_mulhi(uint64_t lhs, uint64_t rhs, std::true_type)
+        {
+            uint64_t lhs_lo = lhs & 0xFFFFFFFFull, lhs_hi = lhs >> 32;
+            uint64_t rhs_lo = rhs & 0xFFFFFFFFull, rhs_hi = rhs >> 32;
+            uint64_t lo_lo = lhs_lo * rhs_lo;
+            uint64_t hi_lo = lhs_hi * rhs_lo;
+            uint64_t lo_hi = lhs_lo * rhs_hi;
+            uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFull) + lo_hi;
+            return lhs_hi * rhs_hi + (hi_lo >> 32) + (cross >> 32);
+        }
+
+        inline int64_t scalar_mulhi(int64_t lhs, int64_t rhs, std::true_type)
+        {
+            uint64_t res = scalar_mulhi(static_cast<uint64_t>(lhs), static_cast<uint64_t>(rhs), std::true_type());
+            res -= lhs < 0 ? static_cast<uint64_t>(rhs) : 0;
+            res -= rhs < 0 ? static_cast<uint64_t>(lhs) : 0;
+            return static_cast<int64_t>(res);
+        }
+
+        template <class T>
+        inline T scalar_mulhi(T lhs, T rhs)
+        {
+            return scalar_mulhi(lhs, rhs, std::integral_constant<bool, sizeof(T) == 8>());
+        }
+
+        template <class T>
+        inline widen_integer_t<T> scalar_mul_widen(T lhs, T rhs)
+        {
+            using wide_type = widen_integer_t<T>;
+            return static_cast<wide_type>(static_cast<wide_type>(lhs) * static_cast<wide_type>(rhs));
+        }
+    }
+
+    // Provides mulhi: the high half of the products of the elements,
+    // computed in twice their width. Architectures specialize it for the
+    // widths of their high multiply instructions.
+    template <class T, std::size_t N, class = void>
+    struct mulhi_impl
+    {
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            alignas(batch<T, N>) T lhs[N];
+            alignas(batch<T, N>) T rhs[N];
+            x.store_aligned(lhs);
+            y.store_aligned(rhs);
+            unroller<N>([&](std::size_t i) {
+                lhs[i] = detail::scalar_mulhi(lhs[i], rhs[i]);
+            });
+            return batch<T, N>(lhs, aligned_mode());
+        }
+    };
+
+    // Provides avg: the average of the elements rounded up, without
+    // overflow. Architectures specialize it with their rounding average
+    // instructions.
+    template <class T, std::size_t N, class = void>
+    struct avg_impl
+    {
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            return (x | y) - ((x ^ y) >> 1);
+        }
+    };
+
+    // Provides absdiff: the absolute difference of the elements, which
+    // may not fit in a signed type and is then wrapped.
+    template <class T, std::size_t N, class = void>
+    struct absdiff_impl
+    {
+        static inline batch<T, N> run_impl(const batch<T, N>& x, const batch<T, N>& y, std::true_type)
+        {
+            return max(x, y) - min(x, y);
+        }
+
+        static inline batch<T, N> run_impl(const batch<T, N>& x, const batch<T, N>& y, std::false_type)
+        {
+            return ssub(x, y) | ssub(y, x);
+        }
+
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            return run_impl(x, y, std::is_signed<T>());
+        }
+    };
+
+    // Provides sad: the sums of the absolute differences of each group of
+    // eight bytes. Architectures specialize it with psadbw or with
+    // pairwise additions.
+    template <std::size_t N, class = void>
+    struct sad_impl
+    {
+        static inline batch<uint64_t, N / 8> run(const batch<uint8_t, N>& x, const batch<uint8_t, N>& y)
+        {
+            alignas(batch<uint8_t, N>) uint8_t lhs[N];
+            alignas(batch<uint8_t, N>) uint8_t rhs[N];
+            alignas(batch<uint64_t, N / 8>) uint64_t res[N / 8] = {};
+            x.store_aligned(lhs);
+            y.store_aligned(rhs);
+            unroller<N>([&](std::size_t i) {
+                res[i / 8] += static_cast<uint64_t>(lhs[i] > rhs[i] ? lhs[i] - rhs[i] : rhs[i] - lhs[i]);
+            });
+            return batch<uint64_t, N / 8>(res, aligned_mode());
+        }
+    };
+
+    // Provides mul_widen_lo and mul_widen_hi: the full products of the
+    // elements of the low and high halves, in twice their width.
+    template <class T, std::size_t N, class = void>
+    struct mul_widen_impl
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, N / 2> run(const batch<T, N>& x, const batch<T, N>& y, std::size_t offset)
+        {
+            alignas(batch<T, N>) T lhs[N];
+            alignas(batch<T, N>) T rhs[N];
+            alignas(batch<wide_type, N / 2>) wide_type res[N / 2];
+            x.store_aligned(lhs);
+            y.store_aligned(rhs);
+            unroller<N / 2>([&](std::size_t i) {
+                res[i] = detail::scalar_mul_widen(lhs[offset + i], rhs[offset + i]);
+            });
+            return batch<wide_type, N / 2>(res, aligned_mode());
+        }
+
+        static inline batch<wide_type, N / 2> run_lo(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            return run(x, y, 0);
+        }
+
+        static inline batch<wide_type, N / 2> run_hi(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            return run(x, y, N / 2);
+        }
+    };
+
+    // Provides madd: the sums of the full products of adjacent elements,
+    // in twice their width, wrapped on overflow (pmaddwd).
+    template <class T, std::size_t N, class = void>
+    struct madd_impl
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, N / 2> run(const batch<T, N>& x, const batch<T, N>& y)
+        {
+            using unsigned_type = typename std::make_unsigned<wide_type>::type;
+            alignas(batch<T, N>) T lhs[N];
+            alignas(batch<T, N>) T rhs[N];
+            alignas(batch<wide_type, N / 2>) wide_type res[N / 2];
+            x.store_aligned(lhs);
+            y.store_aligned(rhs);
+            unroller<N / 2>([&](std::size_t i) {
+                unsigned_type even = static_cast<unsigned_type>(detail::scalar_mul_widen(lhs[2 * i], rhs[2 * i]));
+                unsigned_type odd = static_cast<unsigned_type>(detail::scalar_mul_widen(lhs[2 * i + 1], rhs[2 * i + 1]));
+                res[i] = static_cast<wide_type>(static_cast<unsigned_type>(even + odd));
+            });
+            return batch<wide_type, N / 2>(res, aligned_mode());
+        }
+    };
+
+    // Provides smadd: the saturated sums of the products of adjacent
+    // unsigned and signed bytes (pmaddubsw).
+    template <std::size_t N, class = void>
+    struct smadd_impl
+    {
+        static inline batch<int16_t, N / 2> run(const batch<uint8_t, N>& x, const batch<int8_t, N>& y)
+        {
+            alignas(batch<uint8_t, N>) uint8_t lhs[N];
+            alignas(batch<int8_t, N>) int8_t rhs[N];
+            alignas(batch<int16_t, N / 2>) int16_t res[N / 2];
+            x.store_aligned(lhs);
+            y.store_aligned(rhs);
+            unroller<N / 2>([&](std::size_t i) {
+                int sum = int(lhs[2 * i]) * int(rhs[2 * i]) + int(lhs[2 * i + 1]) * int(rhs[2 * i + 1]);
+                res[i] = static_cast<int16_t>(sum < -32768 ? -32768 : (sum > 32767 ? 32767 : sum));
+            });
+            return batch<int16_t, N / 2>(res, aligned_mode());
+        }
+    };
+
+    template <class T, std::size_t N>
+    batch<T, N> mulhi(const batch<T, N>& x, const batch<T, N>& y);
+
+    template <class T, std::size_t N>
+    batch<T, N> avg(const batch<T, N>& x, const batch<T, N>& y);
+
+    template <class T, std::size_t N>
+    batch<T, N> absdiff(const batch<T, N>& x, const batch<T, N>& y);
+
+    template <std::size_t N>
+    batch<uint64_t, N / 8> sad(const batch<uint8_t, N>& x, const batch<uint8_t, N>& y);
+
+    template <class T, std::size_t N>
+    batch<detail::widen_integer_t<T>, N / 2> mul_widen_lo(const batch<T, N>& x, const batch<T, N>& y);
+
+    template <class T, std::size_t N>
+    batch<detail::widen_integer_t<T>, N / 2> mul_widen_hi(const batch<T, N>& x, const batch<T, N>& y);
+
+    template <class T, std::size_t N>
+    batch<detail::widen_integer_t<T>, N / 2> madd(const batch<T, N>& x, const batch<T, N>& y);
+
+    template <std::size_t N>
+    batch<int16_t, N / 2> smadd(const batch<uint8_t, N>& x, const batch<int8_t, N>& y);
+
     /**************************
      * bitwise cast functions *
      **************************/
@@ -1847,6 +2305,54 @@ namespace xsimd
         return kernel::haddp(row);
     }
 
+    /**
+     * @ingroup simd_batch_reducers
+     *
+     * Returns the smallest scalar of the batch \c rhs.
+     * @param rhs batch involved in the reduction
+     * @return the result of the reduction.
+     */
+    template <class X>
+    inline typename simd_batch_traits<X>::value_type
+    hmin(const simd_base<X>& rhs)
+    {
+        using value_type = typename simd_batch_traits<X>::value_type;
+        using kernel = detail::batch_kernel<value_type, simd_batch_traits<X>::size>;
+        return kernel::hmin(rhs());
+    }
+
+    /**
+     * @ingroup simd_batch_reducers
+     *
+     * Returns the largest scalar of the batch \c rhs.
+     * @param rhs batch involved in the reduction
+     * @return the result of the reduction.
+     */
+    template <class X>
+    inline typename simd_batch_traits<X>::value_type
+    hmax(const simd_base<X>& rhs)
+    {
+        using value_type = typename simd_batch_traits<X>::value_type;
+        using kernel = detail::batch_kernel<value_type, simd_batch_traits<X>::size>;
+        return kernel::hmax(rhs());
+    }
+
+    /**
+     * @ingroup simd_batch_reducers
+     *
+     * Returns both the smallest and the largest scalars of the batch \c rhs.
+     * @param rhs batch involved in the reduction
+     * @return a pair made of the minimum and the maximum of \c rhs.
+     */
+    template <class X>
+    inline std::pair<typename simd_batch_traits<X>::value_type, typename simd_batch_traits<X>::value_type>
+    hminmax(const simd_base<X>& rhs)
+    {
+        using value_type = typename simd_batch_traits<X>::value_type;
+        using kernel = detail::batch_kernel<value_type, simd_batch_traits<X>::size>;
+        return std::make_pair(kernel::hmin(rhs()), kernel::hmax(rhs()));
+    }
+
     /**
      * @defgroup simd_batch_miscellaneous Miscellaneous
      */
@@ -1925,6 +2431,24 @@ namespace xsimd
         return kernel::zip_hi(lhs(), rhs());
     }
 
+    /**
+     * Byte table lookup: each element of the returned batch is the element
+     * of \c table whose position is given by the corresponding element of
+     * \c index. Only the first 16 elements of \c table are used, so that
+     * the lookup maps to a single byte shuffle (pshufb, vqtbl1q).
+     * @param table a batch of 8-bit integers holding the table in its first 16 elements.
+     * @param index a batch of 8-bit integers in the range [0, 16).
+     * @return a batch of the looked up values.
+     */
+    template <class X>
+    inline batch_type_t<X> lookup16(const simd_base<X>& table, const simd_base<X>& index)
+    {
+        using value_type = typename simd_batch_traits<X>::value_type;
+        static_assert(sizeof(value_type) == 1, "lookup16 requires a batch of 8-bit integers");
+        using kernel = detail::batch_kernel<value_type, simd_batch_traits<X>::size>;
+        return kernel::lookup16(table(), index());
+    }
+
     /**
      * Extract vector from pair of vectors
      * extracts the lowest vector elements from the second source \c rhs
@@ -2029,6 +2553,251 @@ namespace xsimd
         return batch_cast_impl<T_in, T_out, N>::run(x);
     }
 
+    /************************************
+     * shuffle functions implementation *
+     ************************************/
+
+    /**
+     * @ingroup simd_batch_miscellaneous
+     *
+     * Permutes the elements of \c x with runtime indices. Equivalent to
+     * \code{.cpp}
+     * for(std::size_t i = 0; i < N; ++i)
+     *     res[i] = x[index[i]];
+     * \endcode
+     * @param x batch to permute.
+     * @param index batch of integers of the same width as the elements of
+     * \c x, in the range [0, N).
+     * @return the permuted batch.
+     */
+    template <class T, class I, std::size_t N>
+    inline batch<T, N> swizzle(const batch<T, N>& x, const batch<I, N>& index)
+    {
+        static_assert(std::is_integral<I>::value && sizeof(I) == sizeof(T),
+                      "swizzle indices must be integers of the same width as the elements");
+        return swizzle_impl<T, N>::run(x, index);
+    }
+
+    namespace detail
+    {
+        template <class T, std::size_t N, class I, I... Is>
+        inline batch<T, N> shuffle_dispatch(const batch<T, N>& x, const batch_constant<I, Is...>&, std::true_type)
+        {
+            return x;
+        }
+
+        template <class T, std::size_t N, class I, I... Is>
+        inline batch<T, N> shuffle_dispatch(const batch<T, N>& x, const batch_constant<I, Is...>& mask, std::false_type)
+        {
+            return shuffle_impl<T, N>::run(x, mask);
+        }
+    }
+
+    /**
+     * @ingroup simd_batch_miscellaneous
+     *
+     * Permutes the elements of \c x with compile-time indices. Equivalent to
+     * \code{.cpp}
+     * for(std::size_t i = 0; i < N; ++i)
+     *     res[i] = x[mask[i]];
+     * \endcode
+     * Since the pattern is known at compile time, the cheapest instruction
+     * implementing it is selected.
+     * @param x batch to permute.
+     * @param mask constant batch of integers of the same width as the
+     * elements of \c x, in the range [0, N).
+     * @return the permuted batch.
+     */
+    template <class T, std::size_t N, class I, I... Is>
+    inline batch<T, N> shuffle(const batch<T, N>& x, const batch_constant<I, Is...>& mask)
+    {
+        static_assert(std::is_integral<I>::value && sizeof(I) == sizeof(T),
+                      "shuffle indices must be integers of the same width as the elements");
+        static_assert(sizeof...(Is) == N, "shuffle mask and batch must have the same size");
+        using is_identity = std::integral_constant<bool, detail::shuffle_traits<I, Is...>::is_identity()>;
+        return detail::shuffle_dispatch(x, mask, is_identity());
+    }
+
+    /*************************************
+     * compress functions implementation *
+     *************************************/
+
+    /**
+     * @ingroup simd_batch_miscellaneous
+     *
+     * Moves the elements of \c x selected by \c mask to the front of the
+     * result, in order, and the other elements after them, in order.
+     * Storing the result at two positions of a buffer partitions a batch
+     * in place, which is how the quicksort partition of xsimd::sort works.
+     * @param x batch to compress.
+     * @param mask selection of the elements to move to the front.
+     * @return the compressed batch.
+     */
+    template <class T, std::size_t N>
+    inline batch<T, N> compress(const batch<T, N>& x, const batch_bool<T, N>& mask)
+    {
+        std::size_t count;
+        return compress_impl<T, N>::run(x, mask, count);
+    }
+
+    /***********************************
+     * gather functions implementation *
+     ***********************************/
+
+    /**
+     * @ingroup simd_batch_miscellaneous
+     *
+     * Loads the elements of \c src at runtime indices. Equivalent to
+     * \code{.cpp}
+     * for(std::size_t i = 0; i < N; ++i)
+     *     res[i] = src[index[i]];
+     * \endcode
+     * @param src pointer to the array to load from.
+     * @param index batch of non-negative integers of the same width as the
+     * elements of the result.
+     * @return the gathered batch.
+     */
+    template <class T, class I, std::size_t N>
+    inline batch<T, N> gather(const T* src, const batch<I, N>& index)
+    {
+        static_assert(std::is_integral<I>::value && sizeof(I) == sizeof(T),
+                      "gather indices must be integers of the same width as the elements");
+        return gather_impl<T, N>::run(src, index);
+    }
+
+    /***********************************************
+     * integer arithmetic functions implementation *
+     ***********************************************/
+
+    /**
+     * @ingroup simd_batch_arithmetic
+     *
+     * Computes the high half of the products of the batches \c x and \c y,
+     * the products being computed in twice the width of their elements.
+     * @param x batch of integers.
+     * @param y batch of integers.
+     * @return the high half of the products.
+     */
+    template <class T, std::size_t N>
+    inline batch<T, N> mulhi(const batch<T, N>& x, const batch<T, N>& y)
+    {
+        static_assert(std::is_integral<T>::value, "mulhi requires a batch of integers");
+        return mulhi_impl<T, N>::run(x, y);
+    }
+
+    /**
+     * @ingroup simd_batch_arithmetic
+     *
+     * Computes the average of the batches \c x and \c y, rounded up,
+     * without intermediate overflow.
+     * @param x batch of integers.
+     * @param y batch of integers.
+     * @return the rounded average.
+     */
+    template <class T, std::size_t N>
+    inline batch<T, N> avg(const batch<T, N>& x, const batch<T, N>& y)
+    {
+        static_assert(std::is_integral<T>::value, "avg requires a batch of integers");
+        return avg_impl<T, N>::run(x, y);
+    }
+
+    /**
+     * @ingroup simd_batch_arithmetic
+     *
+     * Computes the absolute difference of the batches \c x and \c y. For
+     * signed integers, differences larger than the maximum of the type
+     * are wrapped, and are the difference when read as unsigned integers.
+     * @param x batch of integers.
+     * @param y batch of integers.
+     * @return the absolute difference.
+     */
+    template <class T, std::size_t N>
+    inline batch<T, N> absdiff(const batch<T, N>& x, const batch<T, N>& y)
+    {
+        static_assert(std::is_integral<T>::value, "absdiff requires a batch of integers");
+        return absdiff_impl<T, N>::run(x, y);
+    }
+
+    /**
+     * @ingroup simd_batch_arithmetic
+     *
+     * Computes the sums of the absolute differences of each group of eight
+     * bytes of the batches \c x and \c y.
+     * @param x batch of unsigned bytes.
+     * @param y batch of unsigned bytes.
+     * @return a batch of one sum per group of eight bytes.
+     */
+    template <std::size_t N>
+    inline batch<uint64_t, N / 8> sad(const batch<uint8_t, N>& x, const batch<uint8_t, N>& y)
+    {
+        return sad_impl<N>::run(x, y);
+    }
+
+    /**
+     * @ingroup simd_batch_arithmetic
+     *
+     * Computes the full products of the low halves of the batches \c x
+     * and \c y, in twice the width of their elements.
+     * @param x batch of 8, 16 or 32-bit integers.
+     * @param y batch of 8, 16 or 32-bit integers.
+     * @return the products of the first N / 2 elements.
+     */
+    template <class T, std::size_t N>
+    inline batch<detail::widen_integer_t<T>, N / 2> mul_widen_lo(const batch<T, N>& x, const batch<T, N>& y)
+    {
+        return mul_widen_impl<T, N>::run_lo(x, y);
+    }
+
+    /**
+     * @ingroup simd_batch_arithmetic
+     *
+     * Computes the full products of the high halves of the batches \c x
+     * and \c y, in twice the width of their elements.
+     * @param x batch of 8, 16 or 32-bit integers.
+     * @param y batch of 8, 16 or 32-bit integers.
+     * @return the products of the last N / 2 elements.
+     */
+    template <class T, std::size_t N>
+    inline batch<detail::widen_integer_t<T>, N / 2> mul_widen_hi(const batch<T, N>& x, const batch<T, N>& y)
+    {
+        return mul_widen_impl<T, N>::run_hi(x, y);
+    }
+
+    /**
+     * @ingroup simd_batch_arithmetic
+     *
+     * Multiplies the batches \c x and \c y in twice the width of their
+     * elements and adds the products of adjacent elements. Equivalent to
+     * \code{.cpp}
+     * for(std::size_t i = 0; i < N / 2; ++i)
+     *     res[i] = W(x[2 * i]) * y[2 * i] + W(x[2 * i + 1]) * y[2 * i + 1];
+     * \endcode
+     * with wrapping on overflow.
+     * @param x batch of 8, 16 or 32-bit integers.
+     * @param y batch of 8, 16 or 32-bit integers.
+     * @return the sums of the products of adjacent elements.
+     */
+    template <class T, std::size_t N>
+    inline batch<detail::widen_integer_t<T>, N / 2> madd(const batch<T, N>& x, const batch<T, N>& y)
+    {
+        return madd_impl<T, N>::run(x, y);
+    }
+
+    /**
+     * @ingroup simd_batch_arithmetic
+     *
+     * Multiplies the unsigned bytes of \c x by the signed bytes of \c y
+     * and adds the products of adjacent elements with saturation.
+     * @param x batch of unsigned bytes.
+     * @param y batch of signed bytes.
+     * @return the saturated sums of the products of adjacent elements.
+     */
+    template <std::size_t N>
+    inline batch<int16_t, N / 2> smadd(const batch<uint8_t, N>& x, const batch<int8_t, N>& y)
+    {
+        return smadd_impl<N>::run(x, y);
+    }
+
     /*****************************************
      * bitwise cast functions implementation *
      *****************************************/
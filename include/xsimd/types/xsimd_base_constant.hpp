@@ -89,6 +89,73 @@ namespace xsimd
         {
             return {};
         }
+
+        template <class I>
+        constexpr I pack_get(std::size_t, I value)
+        {
+            return value;
+        }
+
+        template <class I, class... Is>
+        constexpr I pack_get(std::size_t i, I value, Is... values)
+        {
+            return i == 0 ? value : pack_get(i - 1, values...);
+        }
+
+        // Compile-time properties of the indices of a batch_constant used as
+        // a shuffle pattern, lanes being groups of L consecutive elements
+        template <class I, I... Is>
+        struct shuffle_traits
+        {
+            static constexpr std::size_t size = sizeof...(Is);
+
+            static constexpr std::size_t get(std::size_t i)
+            {
+                return static_cast<std::size_t>(pack_get(i, Is...));
+            }
+
+            static constexpr bool is_identity(std::size_t i = 0)
+            {
+                return i == size || (get(i) == i && is_identity(i + 1));
+            }
+
+            // every index selects an element of its own lane
+            static constexpr bool is_in_lanes(std::size_t L, std::size_t i = 0)
+            {
+                return i == size || (get(i) / L == i / L && is_in_lanes(L, i + 1));
+            }
+
+            // every lane applies the pattern of the first one
+            static constexpr bool is_same_in_lanes(std::size_t L, std::size_t i = 0)
+            {
+                return i == size || (get(i) % L == get(i % L) % L && is_same_in_lanes(L, i + 1));
+            }
+
+            // every lane is a copy of a whole lane of the input
+            static constexpr bool is_lane_permutation(std::size_t L, std::size_t i = 0)
+            {
+                return i == size || (get(i) % L == i % L && get(i) / L == get(i - i % L) / L && is_lane_permutation(L, i + 1));
+            }
+
+            // one bit per element, set when it selects the odd element of its pair
+            static constexpr int odd_mask(std::size_t i = 0)
+            {
+                return i == size ? 0 : static_cast<int>(((get(i) & 1) << i) | odd_mask(i + 1));
+            }
+
+            // index of byte j of the result for elements of S bytes
+            static constexpr int byte_index(std::size_t S, std::size_t j)
+            {
+                return static_cast<int>(get(j / S) * S + j % S);
+            }
+
+            // immediate operand made of the B-bit indices, modulo L, of the
+            // elements first to first + L - 1
+            static constexpr int immediate(std::size_t L, std::size_t B, std::size_t first = 0, std::size_t i = 0)
+            {
+                return i == L ? 0 : static_cast<int>(((get(first + i) % L) << (B * i)) | immediate(L, B, first, i + 1));
+            }
+        };
     } // namespace detail
 
     template <class G, std::size_t N>
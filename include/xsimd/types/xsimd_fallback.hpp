@@ -920,6 +920,26 @@ namespace xsimd
                 return result;
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                value_type result = rhs[0];
+                for (std::size_t i = 1; i < N; ++i)
+                {
+                    result = std::min(result, rhs[i]);
+                }
+                return result;
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                value_type result = rhs[0];
+                for (std::size_t i = 1; i < N; ++i)
+                {
+                    result = std::max(result, rhs[i]);
+                }
+                return result;
+            }
+
             static batch_type haddp(const batch_type* row)
             {
                 XSIMD_FALLBACK_MAPPING_LOOP(batch, hadd(row[i]))
@@ -963,6 +983,11 @@ namespace xsimd
                 return b_hi;
             }
 
+            static batch_type lookup16(const batch_type& table, const batch_type& index)
+            {
+                XSIMD_FALLBACK_MAPPING_LOOP(batch, table[static_cast<std::size_t>(index[i])])
+            }
+
             /* 0 <= n <= N/2 */
             static batch_type extract_pair(const batch_type& lhs, const batch_type& rhs, const int n)
             {
@@ -970,10 +995,10 @@ namespace xsimd
                 for (int i = 0 ; i < static_cast<int>(N - n); ++i)
                 {
                     b_concatenate[i] = lhs[i + n];
-                    if(i < n)
-                    {
-                        b_concatenate[N - 1 - i] = rhs[n - 1 - i];
-                    }
+                }
+                for (int i = 0 ; i < n; ++i)
+                {
+                    b_concatenate[static_cast<int>(N) - n + i] = rhs[i];
                 }
                 return b_concatenate;
             }
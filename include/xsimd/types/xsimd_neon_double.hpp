@@ -580,6 +580,16 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                return vminvq_f64(rhs);
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                return vmaxvq_f64(rhs);
+            }
+
             static batch_type haddp(const simd_batch<batch_type>* row)
             {
                 return vpaddq_f64(row[0](), row[1]());
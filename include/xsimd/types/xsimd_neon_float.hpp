@@ -618,6 +618,28 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vminvq_f32(rhs);
+#else
+                float32x2_t tmp = vpmin_f32(vget_low_f32(rhs), vget_high_f32(rhs));
+                tmp = vpmin_f32(tmp, tmp);
+                return vget_lane_f32(tmp, 0);
+#endif
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vmaxvq_f32(rhs);
+#else
+                float32x2_t tmp = vpmax_f32(vget_low_f32(rhs), vget_high_f32(rhs));
+                tmp = vpmax_f32(tmp, tmp);
+                return vget_lane_f32(tmp, 0);
+#endif
+            }
+
             static batch_type haddp(const simd_batch<batch_type>* row)
             {
 #if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
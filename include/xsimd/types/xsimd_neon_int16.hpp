@@ -350,6 +350,30 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vminvq_s16(rhs);
+#else
+                int16x4_t tmp = vpmin_s16(vget_low_s16(rhs), vget_high_s16(rhs));
+                tmp = vpmin_s16(tmp, tmp);
+                tmp = vpmin_s16(tmp, tmp);
+                return vget_lane_s16(tmp, 0);
+#endif
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vmaxvq_s16(rhs);
+#else
+                int16x4_t tmp = vpmax_s16(vget_low_s16(rhs), vget_high_s16(rhs));
+                tmp = vpmax_s16(tmp, tmp);
+                tmp = vpmax_s16(tmp, tmp);
+                return vget_lane_s16(tmp, 0);
+#endif
+            }
+
             static batch_type select(const batch_bool_type& cond, const batch_type& a, const batch_type& b)
             {
                 return vbslq_s16(cond, a, b);
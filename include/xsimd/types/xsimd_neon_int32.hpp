@@ -430,6 +430,28 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vminvq_s32(rhs);
+#else
+                int32x2_t tmp = vpmin_s32(vget_low_s32(rhs), vget_high_s32(rhs));
+                tmp = vpmin_s32(tmp, tmp);
+                return vget_lane_s32(tmp, 0);
+#endif
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vmaxvq_s32(rhs);
+#else
+                int32x2_t tmp = vpmax_s32(vget_low_s32(rhs), vget_high_s32(rhs));
+                tmp = vpmax_s32(tmp, tmp);
+                return vget_lane_s32(tmp, 0);
+#endif
+            }
+
             static batch_type select(const batch_bool_type& cond, const batch_type& a, const batch_type& b)
             {
                 return vbslq_s32(cond, a, b);
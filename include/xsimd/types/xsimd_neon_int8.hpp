@@ -351,6 +351,32 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vminvq_s8(rhs);
+#else
+                int8x8_t tmp = vpmin_s8(vget_low_s8(rhs), vget_high_s8(rhs));
+                tmp = vpmin_s8(tmp, tmp);
+                tmp = vpmin_s8(tmp, tmp);
+                tmp = vpmin_s8(tmp, tmp);
+                return vget_lane_s8(tmp, 0);
+#endif
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vmaxvq_s8(rhs);
+#else
+                int8x8_t tmp = vpmax_s8(vget_low_s8(rhs), vget_high_s8(rhs));
+                tmp = vpmax_s8(tmp, tmp);
+                tmp = vpmax_s8(tmp, tmp);
+                tmp = vpmax_s8(tmp, tmp);
+                return vget_lane_s8(tmp, 0);
+#endif
+            }
+
             static batch_type select(const batch_bool_type& cond, const batch_type& a, const batch_type& b)
             {
                 return vbslq_s8(cond, a, b);
@@ -376,6 +402,16 @@ namespace xsimd
 #endif
             }
 
+            static batch_type lookup16(const batch_type& table, const batch_type& index)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vqtbl1q_s8(table, vreinterpretq_u8_s8(index));
+#else
+                int8x8x2_t tmp = { { vget_low_s8(table), vget_high_s8(table) } };
+                return vcombine_s8(vtbl2_s8(tmp, vget_low_s8(index)), vtbl2_s8(tmp, vget_high_s8(index)));
+#endif
+            }
+
             static batch_type extract_pair(const batch_type& lhs, const batch_type& rhs, const int n)
             {
                 switch(n)
@@ -0,0 +1,135 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_NEON_INT_ARITH_HPP
+#define XSIMD_NEON_INT_ARITH_HPP
+
+#include "xsimd_neon_int8.hpp"
+#include "xsimd_neon_uint8.hpp"
+#include "xsimd_neon_int16.hpp"
+#include "xsimd_neon_uint16.hpp"
+#include "xsimd_neon_int32.hpp"
+#include "xsimd_neon_uint32.hpp"
+#include "xsimd_neon_int64.hpp"
+#include "xsimd_neon_uint64.hpp"
+
+namespace xsimd
+{
+    // The 8, 16 and 32-bit elements have widening multiplies (vmull), and
+    // rounding halving adds and absolute differences of the same width;
+    // the 64-bit elements use the generic implementations.
+
+#define XSIMD_NEON_INT_ARITH_IMPL(T, N, SUFFIX, WIDE_SUFFIX)                                    \
+    template <>                                                                                 \
+    struct mulhi_impl<T, N>                                                                     \
+    {                                                                                           \
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)               \
+        {                                                                                       \
+            return vcombine_##SUFFIX(                                                           \
+                vshrn_n_##WIDE_SUFFIX(vmull_##SUFFIX(vget_low_##SUFFIX(x), vget_low_##SUFFIX(y)), \
+                                      8 * sizeof(T)),                                           \
+                vshrn_n_##WIDE_SUFFIX(vmull_##SUFFIX(vget_high_##SUFFIX(x), vget_high_##SUFFIX(y)), \
+                                      8 * sizeof(T)));                                          \
+        }                                                                                       \
+    };                                                                                          \
+                                                                                                \
+    template <>                                                                                 \
+    struct avg_impl<T, N>                                                                       \
+    {                                                                                           \
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)               \
+        {                                                                                       \
+            return vrhaddq_##SUFFIX(x, y);                                                      \
+        }                                                                                       \
+    };                                                                                          \
+                                                                                                \
+    template <>                                                                                 \
+    struct absdiff_impl<T, N>                                                                   \
+    {                                                                                           \
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<T, N>& y)               \
+        {                                                                                       \
+            return vabdq_##SUFFIX(x, y);                                                        \
+        }                                                                                       \
+    };                                                                                          \
+                                                                                                \
+    template <>                                                                                 \
+    struct mul_widen_impl<T, N>                                                                 \
+    {                                                                                           \
+        using wide_type = detail::widen_integer_t<T>;                                           \
+                                                                                                \
+        static inline batch<wide_type, N / 2> run_lo(const batch<T, N>& x, const batch<T, N>& y) \
+        {                                                                                       \
+            return vmull_##SUFFIX(vget_low_##SUFFIX(x), vget_low_##SUFFIX(y));                  \
+        }                                                                                       \
+                                                                                                \
+        static inline batch<wide_type, N / 2> run_hi(const batch<T, N>& x, const batch<T, N>& y) \
+        {                                                                                       \
+            return vmull_##SUFFIX(vget_high_##SUFFIX(x), vget_high_##SUFFIX(y));                \
+        }                                                                                       \
+    };                                                                                          \
+                                                                                                \
+    /* the even and odd elements are unzipped in the low halves */                             \
+    template <>                                                                                 \
+    struct madd_impl<T, N>                                                                      \
+    {                                                                                           \
+        using wide_type = detail::widen_integer_t<T>;                                           \
+                                                                                                \
+        static inline batch<wide_type, N / 2> run(const batch<T, N>& x, const batch<T, N>& y)   \
+        {                                                                                       \
+            auto x_unzipped = vuzpq_##SUFFIX(x, x);                                             \
+            auto y_unzipped = vuzpq_##SUFFIX(y, y);                                             \
+            return vmlal_##SUFFIX(vmull_##SUFFIX(vget_low_##SUFFIX(x_unzipped.val[0]),          \
+                                                 vget_low_##SUFFIX(y_unzipped.val[0])),         \
+                                  vget_low_##SUFFIX(x_unzipped.val[1]),                         \
+                                  vget_low_##SUFFIX(y_unzipped.val[1]));                        \
+        }                                                                                       \
+    }
+
+    XSIMD_NEON_INT_ARITH_IMPL(int8_t, 16, s8, s16);
+    XSIMD_NEON_INT_ARITH_IMPL(uint8_t, 16, u8, u16);
+    XSIMD_NEON_INT_ARITH_IMPL(int16_t, 8, s16, s32);
+    XSIMD_NEON_INT_ARITH_IMPL(uint16_t, 8, u16, u32);
+    XSIMD_NEON_INT_ARITH_IMPL(int32_t, 4, s32, s64);
+    XSIMD_NEON_INT_ARITH_IMPL(uint32_t, 4, u32, u64);
+
+#undef XSIMD_NEON_INT_ARITH_IMPL
+
+    /*******
+     * sad *
+     *******/
+
+    template <>
+    struct sad_impl<16>
+    {
+        static inline batch<uint64_t, 2> run(const batch<uint8_t, 16>& x, const batch<uint8_t, 16>& y)
+        {
+            return vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vabdq_u8(x, y))));
+        }
+    };
+
+    /*********
+     * smadd *
+     *********/
+
+    // The products of unsigned and signed bytes fit in 16 bits; the even
+    // and odd products are unzipped and added with saturation.
+    template <>
+    struct smadd_impl<16>
+    {
+        static inline batch<int16_t, 8> run(const batch<uint8_t, 16>& x, const batch<int8_t, 16>& y)
+        {
+            int16x8_t products_lo = vmulq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(x))), vmovl_s8(vget_low_s8(y)));
+            int16x8_t products_hi = vmulq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(x))), vmovl_s8(vget_high_s8(y)));
+            int16x8x2_t products = vuzpq_s16(products_lo, products_hi);
+            return vqaddq_s16(products.val[0], products.val[1]);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,186 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_NEON_SHUFFLE_HPP
+#define XSIMD_NEON_SHUFFLE_HPP
+
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+#include "xsimd_neon_double.hpp"
+#endif
+#include "xsimd_neon_float.hpp"
+#include "xsimd_neon_int8.hpp"
+#include "xsimd_neon_uint8.hpp"
+#include "xsimd_neon_int16.hpp"
+#include "xsimd_neon_uint16.hpp"
+#include "xsimd_neon_int32.hpp"
+#include "xsimd_neon_uint32.hpp"
+#include "xsimd_neon_int64.hpp"
+#include "xsimd_neon_uint64.hpp"
+
+namespace xsimd
+{
+    namespace detail
+    {
+        // Bitwise reinterpretation of 128-bit batches as uint8x16_t
+        template <class T>
+        struct neon_shuffle_register;
+
+#define XSIMD_NEON_SHUFFLE_REGISTER(T, N, SUFFIX)           \
+    template <>                                             \
+    struct neon_shuffle_register<T>                         \
+    {                                                       \
+        static uint8x16_t to_bytes(const batch<T, N>& x)    \
+        {                                                   \
+            return vreinterpretq_u8_##SUFFIX(x);            \
+        }                                                   \
+                                                            \
+        static batch<T, N> from_bytes(uint8x16_t x)         \
+        {                                                   \
+            return vreinterpretq_##SUFFIX##_u8(x);          \
+        }                                                   \
+    }
+
+        template <>
+        struct neon_shuffle_register<uint8_t>
+        {
+            static uint8x16_t to_bytes(const batch<uint8_t, 16>& x)
+            {
+                return x;
+            }
+
+            static batch<uint8_t, 16> from_bytes(uint8x16_t x)
+            {
+                return x;
+            }
+        };
+
+        XSIMD_NEON_SHUFFLE_REGISTER(int8_t, 16, s8);
+        XSIMD_NEON_SHUFFLE_REGISTER(int16_t, 8, s16);
+        XSIMD_NEON_SHUFFLE_REGISTER(uint16_t, 8, u16);
+        XSIMD_NEON_SHUFFLE_REGISTER(int32_t, 4, s32);
+        XSIMD_NEON_SHUFFLE_REGISTER(uint32_t, 4, u32);
+        XSIMD_NEON_SHUFFLE_REGISTER(int64_t, 2, s64);
+        XSIMD_NEON_SHUFFLE_REGISTER(uint64_t, 2, u64);
+        XSIMD_NEON_SHUFFLE_REGISTER(float, 4, f32);
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+        XSIMD_NEON_SHUFFLE_REGISTER(double, 2, f64);
+#endif
+
+#undef XSIMD_NEON_SHUFFLE_REGISTER
+
+        inline uint8x16_t neon_byte_lookup(uint8x16_t table, uint8x16_t index)
+        {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+            return vqtbl1q_u8(table, index);
+#else
+            uint8x8x2_t tmp = { { vget_low_u8(table), vget_high_u8(table) } };
+            return vcombine_u8(vtbl2_u8(tmp, vget_low_u8(index)), vtbl2_u8(tmp, vget_high_u8(index)));
+#endif
+        }
+
+        // Converts indices of S-byte elements to the indices of their bytes:
+        // the low byte of each index is replicated over its element, scaled
+        // by S and offset by the position of the byte.
+        template <std::size_t S>
+        uint8x16_t neon_byte_indices(uint8x16_t index);
+
+        template <>
+        inline uint8x16_t neon_byte_indices<1>(uint8x16_t index)
+        {
+            return index;
+        }
+
+        template <>
+        inline uint8x16_t neon_byte_indices<2>(uint8x16_t index)
+        {
+            static const uint8_t rep[16] = { 0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14 };
+            static const uint8_t offset[16] = { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1 };
+            return vaddq_u8(vshlq_n_u8(neon_byte_lookup(index, vld1q_u8(rep)), 1), vld1q_u8(offset));
+        }
+
+        template <>
+        inline uint8x16_t neon_byte_indices<4>(uint8x16_t index)
+        {
+            static const uint8_t rep[16] = { 0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12 };
+            static const uint8_t offset[16] = { 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3 };
+            return vaddq_u8(vshlq_n_u8(neon_byte_lookup(index, vld1q_u8(rep)), 2), vld1q_u8(offset));
+        }
+
+        template <>
+        inline uint8x16_t neon_byte_indices<8>(uint8x16_t index)
+        {
+            static const uint8_t rep[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 8, 8, 8, 8 };
+            static const uint8_t offset[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+            return vaddq_u8(vshlq_n_u8(neon_byte_lookup(index, vld1q_u8(rep)), 3), vld1q_u8(offset));
+        }
+    }
+
+    /***********
+     * swizzle *
+     ***********/
+
+    // shuffle relies on the default implementation, which calls swizzle
+    // with constant indices: the byte indices are then folded by the
+    // compiler and a single table lookup remains.
+    template <class T, std::size_t N>
+    struct swizzle_impl<T, N, typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 16>::type>
+    {
+        template <class I>
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<I, N>& index)
+        {
+            using reg = detail::neon_shuffle_register<T>;
+            uint8x16_t byte_index = detail::neon_byte_indices<sizeof(T)>(detail::neon_shuffle_register<I>::to_bytes(index));
+            return reg::from_bytes(detail::neon_byte_lookup(reg::to_bytes(x), byte_index));
+        }
+    };
+
+    /************
+     * compress *
+     ************/
+
+    namespace detail
+    {
+        // Bitmask of the selection, one bit per element
+        inline int neon_compress_bits(uint32x4_t mask)
+        {
+            static const uint32_t weights[4] = { 1, 2, 4, 8 };
+            uint32x4_t bits = vandq_u32(mask, vld1q_u32(weights));
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+            return static_cast<int>(vaddvq_u32(bits));
+#else
+            uint32x2_t sum = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+            return static_cast<int>(vget_lane_u32(vpadd_u32(sum, sum), 0));
+#endif
+        }
+
+        inline int neon_compress_bits(uint64x2_t mask)
+        {
+            return static_cast<int>((vgetq_lane_u64(mask, 0) & 1) | (vgetq_lane_u64(mask, 1) & 2));
+        }
+    }
+
+    template <class T, std::size_t N>
+    struct compress_impl<T, N, typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 16 && (sizeof(T) >= 4)>::type>
+    {
+        static constexpr bool native = true;
+
+        static inline batch<T, N> run(const batch<T, N>& x, const batch_bool<T, N>& mask, std::size_t& count)
+        {
+            using reg = detail::neon_shuffle_register<T>;
+            using mask_type = typename std::conditional<sizeof(T) == 4, uint32x4_t, uint64x2_t>::type;
+            const uint8_t* table = detail::compress_byte_table<sizeof(T)>(detail::make_index_sequence<16 << N>());
+            int bits = detail::neon_compress_bits(static_cast<mask_type>(mask));
+            count = detail::bit_count(static_cast<uint64_t>(bits));
+            return reg::from_bytes(detail::neon_byte_lookup(reg::to_bytes(x), vld1q_u8(table + 16 * bits)));
+        }
+    };
+}
+
+#endif
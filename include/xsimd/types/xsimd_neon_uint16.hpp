@@ -324,6 +324,30 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vminvq_u16(rhs);
+#else
+                uint16x4_t tmp = vpmin_u16(vget_low_u16(rhs), vget_high_u16(rhs));
+                tmp = vpmin_u16(tmp, tmp);
+                tmp = vpmin_u16(tmp, tmp);
+                return vget_lane_u16(tmp, 0);
+#endif
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vmaxvq_u16(rhs);
+#else
+                uint16x4_t tmp = vpmax_u16(vget_low_u16(rhs), vget_high_u16(rhs));
+                tmp = vpmax_u16(tmp, tmp);
+                tmp = vpmax_u16(tmp, tmp);
+                return vget_lane_u16(tmp, 0);
+#endif
+            }
+
             static batch_type select(const batch_bool_type& cond, const batch_type& a, const batch_type& b)
             {
                 return vbslq_u16(cond, a, b);
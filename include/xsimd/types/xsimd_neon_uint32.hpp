@@ -420,6 +420,28 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vminvq_u32(rhs);
+#else
+                uint32x2_t tmp = vpmin_u32(vget_low_u32(rhs), vget_high_u32(rhs));
+                tmp = vpmin_u32(tmp, tmp);
+                return vget_lane_u32(tmp, 0);
+#endif
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vmaxvq_u32(rhs);
+#else
+                uint32x2_t tmp = vpmax_u32(vget_low_u32(rhs), vget_high_u32(rhs));
+                tmp = vpmax_u32(tmp, tmp);
+                return vget_lane_u32(tmp, 0);
+#endif
+            }
+
             static batch_type select(const batch_bool_type& cond, const batch_type& a, const batch_type& b)
             {
                 return vbslq_u32(cond, a, b);
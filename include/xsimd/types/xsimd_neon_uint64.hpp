@@ -473,6 +473,16 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                return rhs[0] < rhs[1] ? rhs[0] : rhs[1];
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                return rhs[0] < rhs[1] ? rhs[1] : rhs[0];
+            }
+
             static batch_type select(const batch_bool_type& cond, const batch_type& a, const batch_type& b)
             {
                 return vbslq_u64(cond, a, b);
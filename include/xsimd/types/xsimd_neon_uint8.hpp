@@ -325,6 +325,32 @@ namespace xsimd
 #endif
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vminvq_u8(rhs);
+#else
+                uint8x8_t tmp = vpmin_u8(vget_low_u8(rhs), vget_high_u8(rhs));
+                tmp = vpmin_u8(tmp, tmp);
+                tmp = vpmin_u8(tmp, tmp);
+                tmp = vpmin_u8(tmp, tmp);
+                return vget_lane_u8(tmp, 0);
+#endif
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vmaxvq_u8(rhs);
+#else
+                uint8x8_t tmp = vpmax_u8(vget_low_u8(rhs), vget_high_u8(rhs));
+                tmp = vpmax_u8(tmp, tmp);
+                tmp = vpmax_u8(tmp, tmp);
+                tmp = vpmax_u8(tmp, tmp);
+                return vget_lane_u8(tmp, 0);
+#endif
+            }
+
             static batch_type select(const batch_bool_type& cond, const batch_type& a, const batch_type& b)
             {
                 return vbslq_u8(cond, a, b);
@@ -350,6 +376,16 @@ namespace xsimd
 #endif
             }
 
+            static batch_type lookup16(const batch_type& table, const batch_type& index)
+            {
+#if XSIMD_ARM_INSTR_SET >= XSIMD_ARM8_64_NEON_VERSION
+                return vqtbl1q_u8(table, index);
+#else
+                uint8x8x2_t tmp = { { vget_low_u8(table), vget_high_u8(table) } };
+                return vcombine_u8(vtbl2_u8(tmp, vget_low_u8(index)), vtbl2_u8(tmp, vget_high_u8(index)));
+#endif
+            }
+
             static batch_type extract_pair(const batch_type& lhs, const batch_type& rhs, const int n)
             {
                 switch(n)
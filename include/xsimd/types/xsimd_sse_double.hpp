@@ -620,6 +620,16 @@ namespace xsimd
                 return _mm_cvtsd_f64(tmp0);
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                return _mm_cvtsd_f64(_mm_min_sd(rhs, _mm_unpackhi_pd(rhs, rhs)));
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                return _mm_cvtsd_f64(_mm_max_sd(rhs, _mm_unpackhi_pd(rhs, rhs)));
+            }
+
             static batch_type haddp(const batch_type* row)
             {
 #if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE3_VERSION
@@ -675,6 +675,20 @@ namespace xsimd
                 return _mm_cvtss_f32(tmp1);
             }
 
+            static value_type hmin(const batch_type& rhs)
+            {
+                __m128 tmp0 = _mm_min_ps(rhs, _mm_movehl_ps(rhs, rhs));
+                __m128 tmp1 = _mm_min_ss(tmp0, _mm_shuffle_ps(tmp0, tmp0, 1));
+                return _mm_cvtss_f32(tmp1);
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                __m128 tmp0 = _mm_max_ps(rhs, _mm_movehl_ps(rhs, rhs));
+                __m128 tmp1 = _mm_max_ss(tmp0, _mm_shuffle_ps(tmp0, tmp0, 1));
+                return _mm_cvtss_f32(tmp1);
+            }
+
             static batch_type haddp(const batch_type* row)
             {
 #if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE3_VERSION
@@ -735,10 +749,10 @@ namespace xsimd
                 for (int i = 0 ; i < (4 - n); ++i)
                 {
                     b_concatenate[i] = lhs[i + n];
-                    if(i < n)
-                    {
-                        b_concatenate[4 - 1 - i] = rhs[n - 1 - i];
-                    }
+                }
+                for (int i = 0 ; i < n; ++i)
+                {
+                    b_concatenate[4 - n + i] = rhs[i];
                 }
                 return b_concatenate;
             }
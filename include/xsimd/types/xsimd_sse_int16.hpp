@@ -274,6 +274,21 @@ namespace xsimd
                 return res;
 #endif
             }
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION
+            static value_type hmin(const batch_type& rhs)
+            {
+                // flipping the sign bit maps signed order onto unsigned order
+                uint16_t res = sse_detail::hmin_epu16(_mm_xor_si128(rhs, _mm_set1_epi16(std::numeric_limits<int16_t>::min())));
+                return static_cast<value_type>(res ^ 0x8000);
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                uint16_t res = sse_detail::hmin_epu16(_mm_xor_si128(rhs, _mm_set1_epi16(0x7FFF)));
+                return static_cast<value_type>(res ^ 0x7FFF);
+            }
+#endif
         };
 
         template <>
@@ -318,6 +333,19 @@ namespace xsimd
             {
                 return _mm_subs_epu16(lhs, rhs);
             }
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION
+            static value_type hmin(const batch_type& rhs)
+            {
+                return sse_detail::hmin_epu16(rhs);
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                uint16_t res = sse_detail::hmin_epu16(_mm_xor_si128(rhs, _mm_set1_epi16(-1)));
+                return static_cast<value_type>(res ^ 0xFFFF);
+            }
+#endif
         };
     }
 
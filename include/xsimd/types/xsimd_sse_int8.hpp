@@ -235,6 +235,23 @@ namespace xsimd
                 return _mm_unpackhi_epi8(lhs, rhs);
             }
 
+            static batch_type lookup16(const batch_type& table, const batch_type& index)
+            {
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSSE3_VERSION
+                return _mm_shuffle_epi8(table, index);
+#else
+                alignas(16) T ttable[16];
+                alignas(16) T tindex[16];
+                table.store_aligned(ttable);
+                index.store_aligned(tindex);
+                for (int i = 0; i < 16; ++i)
+                {
+                    tindex[i] = ttable[tindex[i] & 0x0F];
+                }
+                return _mm_load_si128(reinterpret_cast<const __m128i*>(tindex));
+#endif
+            }
+
             static batch_type extract_pair(const batch_type& v_lhs, const batch_type& v_rhs, const int n)
             {
 #if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSSE3_VERSION
@@ -302,6 +319,21 @@ namespace xsimd
                 return _mm_min_epu8(rhs, neg);
 #endif
             }
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION
+            static value_type hmin(const batch_type& rhs)
+            {
+                // flipping the sign bit maps signed order onto unsigned order
+                uint16_t res = sse_detail::hmin_epu8(_mm_xor_si128(rhs, _mm_set1_epi8(-128)));
+                return static_cast<value_type>(res ^ 0x80);
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                uint16_t res = sse_detail::hmin_epu8(_mm_xor_si128(rhs, _mm_set1_epi8(0x7F)));
+                return static_cast<value_type>(res ^ 0x7F);
+            }
+#endif
         };
 
         template <>
@@ -347,6 +379,18 @@ namespace xsimd
                 return _mm_subs_epu8(lhs,rhs);
             }
 
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION
+            static value_type hmin(const batch_type& rhs)
+            {
+                return static_cast<value_type>(sse_detail::hmin_epu8(rhs));
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                uint16_t res = sse_detail::hmin_epu8(_mm_xor_si128(rhs, _mm_set1_epi8(-1)));
+                return static_cast<value_type>(res ^ 0xFF);
+            }
+#endif
 
         };
     }
@@ -0,0 +1,352 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_SSE_INT_ARITH_HPP
+#define XSIMD_SSE_INT_ARITH_HPP
+
+#include "xsimd_sse_int8.hpp"
+#include "xsimd_sse_int16.hpp"
+#include "xsimd_sse_int32.hpp"
+#include "xsimd_sse_int64.hpp"
+
+namespace xsimd
+{
+    namespace detail
+    {
+        // Sign or zero extension of the low and high halves of 8-bit elements
+        inline __m128i sse_widen_lo_epi8(__m128i x, std::true_type)
+        {
+            return _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+        }
+
+        inline __m128i sse_widen_hi_epi8(__m128i x, std::true_type)
+        {
+            return _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+        }
+
+        inline __m128i sse_widen_lo_epi8(__m128i x, std::false_type)
+        {
+            return _mm_unpacklo_epi8(x, _mm_setzero_si128());
+        }
+
+        inline __m128i sse_widen_hi_epi8(__m128i x, std::false_type)
+        {
+            return _mm_unpackhi_epi8(x, _mm_setzero_si128());
+        }
+
+        // Even and odd 8-bit elements, extended in the 16-bit elements
+        inline __m128i sse_even_epi8(__m128i x, std::true_type)
+        {
+            return _mm_srai_epi16(_mm_slli_epi16(x, 8), 8);
+        }
+
+        inline __m128i sse_odd_epi8(__m128i x, std::true_type)
+        {
+            return _mm_srai_epi16(x, 8);
+        }
+
+        inline __m128i sse_even_epi8(__m128i x, std::false_type)
+        {
+            return _mm_and_si128(x, _mm_set1_epi16(0x00FF));
+        }
+
+        inline __m128i sse_odd_epi8(__m128i x, std::false_type)
+        {
+            return _mm_srli_epi16(x, 8);
+        }
+
+        // Full products of the even 32-bit elements (pmuludq, pmuldq)
+        inline __m128i sse_mul_even_epi32(__m128i x, __m128i y, std::false_type)
+        {
+            return _mm_mul_epu32(x, y);
+        }
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION
+        inline __m128i sse_mul_even_epi32(__m128i x, __m128i y, std::true_type)
+        {
+            return _mm_mul_epi32(x, y);
+        }
+#endif
+
+        template <class T>
+        using enable_sse_int8_t = typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 1>::type;
+
+        // 32-bit integers whose even elements have a full multiply
+        template <class T>
+        using enable_sse_mul_even_t = typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 4 &&
+                                                              (std::is_unsigned<T>::value || XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION)>::type;
+    }
+
+    /*********
+     * mulhi *
+     *********/
+
+    template <>
+    struct mulhi_impl<int16_t, 8>
+    {
+        static inline batch<int16_t, 8> run(const batch<int16_t, 8>& x, const batch<int16_t, 8>& y)
+        {
+            return _mm_mulhi_epi16(x, y);
+        }
+    };
+
+    template <>
+    struct mulhi_impl<uint16_t, 8>
+    {
+        static inline batch<uint16_t, 8> run(const batch<uint16_t, 8>& x, const batch<uint16_t, 8>& y)
+        {
+            return _mm_mulhi_epu16(x, y);
+        }
+    };
+
+    // The bytes are multiplied in 16-bit elements; the high halves of the
+    // products fit in a byte, so that the packs do not saturate.
+    template <class T>
+    struct mulhi_impl<T, 16, detail::enable_sse_int8_t<T>>
+    {
+        static inline __m128i run_half(__m128i x, __m128i y, std::true_type)
+        {
+            return _mm_srai_epi16(_mm_mullo_epi16(x, y), 8);
+        }
+
+        static inline __m128i run_half(__m128i x, __m128i y, std::false_type)
+        {
+            return _mm_srli_epi16(_mm_mullo_epi16(x, y), 8);
+        }
+
+        static inline __m128i pack(__m128i lo, __m128i hi, std::true_type)
+        {
+            return _mm_packs_epi16(lo, hi);
+        }
+
+        static inline __m128i pack(__m128i lo, __m128i hi, std::false_type)
+        {
+            return _mm_packus_epi16(lo, hi);
+        }
+
+        static inline batch<T, 16> run(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m128i lo = run_half(detail::sse_widen_lo_epi8(x, is_signed()), detail::sse_widen_lo_epi8(y, is_signed()), is_signed());
+            __m128i hi = run_half(detail::sse_widen_hi_epi8(x, is_signed()), detail::sse_widen_hi_epi8(y, is_signed()), is_signed());
+            return pack(lo, hi, is_signed());
+        }
+    };
+
+    template <class T>
+    struct mulhi_impl<T, 4, detail::enable_sse_mul_even_t<T>>
+    {
+        static inline batch<T, 4> run(const batch<T, 4>& x, const batch<T, 4>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m128i even = detail::sse_mul_even_epi32(x, y, is_signed());
+            __m128i odd = detail::sse_mul_even_epi32(_mm_srli_epi64(x, 32), _mm_srli_epi64(y, 32), is_signed());
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION
+            return _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+#else
+            return _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, _mm_set_epi32(-1, 0, -1, 0)));
+#endif
+        }
+    };
+
+    /*******
+     * avg *
+     *******/
+
+    template <>
+    struct avg_impl<uint8_t, 16>
+    {
+        static inline batch<uint8_t, 16> run(const batch<uint8_t, 16>& x, const batch<uint8_t, 16>& y)
+        {
+            return _mm_avg_epu8(x, y);
+        }
+    };
+
+    template <>
+    struct avg_impl<uint16_t, 8>
+    {
+        static inline batch<uint16_t, 8> run(const batch<uint16_t, 8>& x, const batch<uint16_t, 8>& y)
+        {
+            return _mm_avg_epu16(x, y);
+        }
+    };
+
+    // Flipping the sign bits maps the signed elements to unsigned ones in
+    // the same order
+    template <>
+    struct avg_impl<int8_t, 16>
+    {
+        static inline batch<int8_t, 16> run(const batch<int8_t, 16>& x, const batch<int8_t, 16>& y)
+        {
+            __m128i bias = _mm_set1_epi8(-128);
+            return _mm_xor_si128(_mm_avg_epu8(_mm_xor_si128(x, bias), _mm_xor_si128(y, bias)), bias);
+        }
+    };
+
+    template <>
+    struct avg_impl<int16_t, 8>
+    {
+        static inline batch<int16_t, 8> run(const batch<int16_t, 8>& x, const batch<int16_t, 8>& y)
+        {
+            __m128i bias = _mm_set1_epi16(-32768);
+            return _mm_xor_si128(_mm_avg_epu16(_mm_xor_si128(x, bias), _mm_xor_si128(y, bias)), bias);
+        }
+    };
+
+    /*******
+     * sad *
+     *******/
+
+    template <>
+    struct sad_impl<16>
+    {
+        static inline batch<uint64_t, 2> run(const batch<uint8_t, 16>& x, const batch<uint8_t, 16>& y)
+        {
+            return _mm_sad_epu8(x, y);
+        }
+    };
+
+    /*************
+     * mul_widen *
+     *************/
+
+    template <class T>
+    struct mul_widen_impl<T, 16, detail::enable_sse_int8_t<T>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 8> run_lo(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return _mm_mullo_epi16(detail::sse_widen_lo_epi8(x, is_signed()), detail::sse_widen_lo_epi8(y, is_signed()));
+        }
+
+        static inline batch<wide_type, 8> run_hi(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            return _mm_mullo_epi16(detail::sse_widen_hi_epi8(x, is_signed()), detail::sse_widen_hi_epi8(y, is_signed()));
+        }
+    };
+
+    template <class T>
+    struct mul_widen_impl<T, 8, typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 2>::type>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline __m128i mulhi(__m128i x, __m128i y, std::true_type)
+        {
+            return _mm_mulhi_epi16(x, y);
+        }
+
+        static inline __m128i mulhi(__m128i x, __m128i y, std::false_type)
+        {
+            return _mm_mulhi_epu16(x, y);
+        }
+
+        static inline batch<wide_type, 4> run_lo(const batch<T, 8>& x, const batch<T, 8>& y)
+        {
+            return _mm_unpacklo_epi16(_mm_mullo_epi16(x, y), mulhi(x, y, std::is_signed<T>()));
+        }
+
+        static inline batch<wide_type, 4> run_hi(const batch<T, 8>& x, const batch<T, 8>& y)
+        {
+            return _mm_unpackhi_epi16(_mm_mullo_epi16(x, y), mulhi(x, y, std::is_signed<T>()));
+        }
+    };
+
+    template <class T>
+    struct mul_widen_impl<T, 4, detail::enable_sse_mul_even_t<T>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 2> run_lo(const batch<T, 4>& x, const batch<T, 4>& y)
+        {
+            return detail::sse_mul_even_epi32(_mm_unpacklo_epi32(x, x), _mm_unpacklo_epi32(y, y), std::is_signed<T>());
+        }
+
+        static inline batch<wide_type, 2> run_hi(const batch<T, 4>& x, const batch<T, 4>& y)
+        {
+            return detail::sse_mul_even_epi32(_mm_unpackhi_epi32(x, x), _mm_unpackhi_epi32(y, y), std::is_signed<T>());
+        }
+    };
+
+    /********
+     * madd *
+     ********/
+
+    template <>
+    struct madd_impl<int16_t, 8>
+    {
+        static inline batch<int32_t, 4> run(const batch<int16_t, 8>& x, const batch<int16_t, 8>& y)
+        {
+            return _mm_madd_epi16(x, y);
+        }
+    };
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION
+    // pmaddwd is signed; the unsigned words are multiplied as 32-bit elements
+    template <>
+    struct madd_impl<uint16_t, 8>
+    {
+        static inline batch<uint32_t, 4> run(const batch<uint16_t, 8>& x, const batch<uint16_t, 8>& y)
+        {
+            __m128i mask = _mm_set1_epi32(0xFFFF);
+            __m128i even = _mm_mullo_epi32(_mm_and_si128(x, mask), _mm_and_si128(y, mask));
+            __m128i odd = _mm_mullo_epi32(_mm_srli_epi32(x, 16), _mm_srli_epi32(y, 16));
+            return _mm_add_epi32(even, odd);
+        }
+    };
+#endif
+
+    template <class T>
+    struct madd_impl<T, 16, detail::enable_sse_int8_t<T>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 8> run(const batch<T, 16>& x, const batch<T, 16>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m128i even = _mm_mullo_epi16(detail::sse_even_epi8(x, is_signed()), detail::sse_even_epi8(y, is_signed()));
+            __m128i odd = _mm_mullo_epi16(detail::sse_odd_epi8(x, is_signed()), detail::sse_odd_epi8(y, is_signed()));
+            return _mm_add_epi16(even, odd);
+        }
+    };
+
+    template <class T>
+    struct madd_impl<T, 4, detail::enable_sse_mul_even_t<T>>
+    {
+        using wide_type = detail::widen_integer_t<T>;
+
+        static inline batch<wide_type, 2> run(const batch<T, 4>& x, const batch<T, 4>& y)
+        {
+            using is_signed = std::is_signed<T>;
+            __m128i even = detail::sse_mul_even_epi32(x, y, is_signed());
+            __m128i odd = detail::sse_mul_even_epi32(_mm_srli_epi64(x, 32), _mm_srli_epi64(y, 32), is_signed());
+            return _mm_add_epi64(even, odd);
+        }
+    };
+
+    /*********
+     * smadd *
+     *********/
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSSE3_VERSION
+    template <>
+    struct smadd_impl<16>
+    {
+        static inline batch<int16_t, 8> run(const batch<uint8_t, 16>& x, const batch<int8_t, 16>& y)
+        {
+            return _mm_maddubs_epi16(x, y);
+        }
+    };
+#endif
+}
+
+#endif
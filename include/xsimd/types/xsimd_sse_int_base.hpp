@@ -162,6 +162,43 @@ namespace xsimd
             __m128i tmp4 = _mm_srai_epi32(tmp3, 31);
             return _mm_shuffle_epi32(tmp4, 0xF5);
         }
+
+        // Reduces the scalars of rhs with f by folding the register
+        // onto itself, halving the number of meaningful bytes at each step.
+        template <class B, class F>
+        inline typename simd_batch_traits<B>::value_type int_hreduce(const B& rhs, F&& f)
+        {
+            using value_type = typename simd_batch_traits<B>::value_type;
+            B tmp = f(rhs, B(_mm_srli_si128(rhs, 8)));
+            if (sizeof(value_type) <= 4)
+            {
+                tmp = f(tmp, B(_mm_srli_si128(tmp, 4)));
+            }
+            if (sizeof(value_type) <= 2)
+            {
+                tmp = f(tmp, B(_mm_srli_si128(tmp, 2)));
+            }
+            if (sizeof(value_type) <= 1)
+            {
+                tmp = f(tmp, B(_mm_srli_si128(tmp, 1)));
+            }
+            return tmp[0];
+        }
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSE4_1_VERSION
+        // phminposuw based reductions, the result is the unsigned minimum
+        inline uint16_t hmin_epu16(__m128i rhs)
+        {
+            return static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(rhs)));
+        }
+
+        inline uint16_t hmin_epu8(__m128i rhs)
+        {
+            // folds pairs of bytes into zero-extended 16 bit words
+            __m128i tmp = _mm_min_epu8(rhs, _mm_srli_epi16(rhs, 8));
+            return static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(tmp)));
+        }
+#endif
     }
 
     /***********************************
@@ -437,6 +474,7 @@ namespace xsimd
         struct sse_int_kernel_base
         {
             using batch_type = B;
+            using value_type = typename simd_batch_traits<B>::value_type;
             using batch_bool_type = typename simd_batch_traits<B>::batch_bool_type;
             static constexpr std::size_t size = simd_batch_traits<B>::size;
             static constexpr std::size_t align = simd_batch_traits<B>::align;
@@ -526,6 +564,16 @@ namespace xsimd
             {
                 return -x * y - z;
             }
+
+            static value_type hmin(const batch_type& rhs)
+            {
+                return sse_detail::int_hreduce(rhs, [](const batch_type& a, const batch_type& b) { return min(a, b); });
+            }
+
+            static value_type hmax(const batch_type& rhs)
+            {
+                return sse_detail::int_hreduce(rhs, [](const batch_type& a, const batch_type& b) { return max(a, b); });
+            }
         };
     }
 
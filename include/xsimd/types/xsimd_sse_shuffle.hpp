@@ -0,0 +1,304 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSIMD_SSE_SHUFFLE_HPP
+#define XSIMD_SSE_SHUFFLE_HPP
+
+#include "xsimd_sse_double.hpp"
+#include "xsimd_sse_float.hpp"
+#include "xsimd_sse_int8.hpp"
+#include "xsimd_sse_int16.hpp"
+#include "xsimd_sse_int32.hpp"
+#include "xsimd_sse_int64.hpp"
+
+namespace xsimd
+{
+    namespace detail
+    {
+        template <class T, std::size_t N>
+        using enable_sse_shuffle_t = typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 16>::type;
+
+        // Bitwise reinterpretation of 128-bit batches as __m128i
+        template <class T>
+        struct sse_shuffle_register
+        {
+            using batch_type = batch<T, 16 / sizeof(T)>;
+
+            static __m128i to_int(const batch_type& x)
+            {
+                return x;
+            }
+
+            static batch_type from_int(__m128i x)
+            {
+                return x;
+            }
+        };
+
+        template <>
+        struct sse_shuffle_register<float>
+        {
+            using batch_type = batch<float, 4>;
+
+            static __m128i to_int(const batch_type& x)
+            {
+                return _mm_castps_si128(x);
+            }
+
+            static batch_type from_int(__m128i x)
+            {
+                return _mm_castsi128_ps(x);
+            }
+        };
+
+        template <>
+        struct sse_shuffle_register<double>
+        {
+            using batch_type = batch<double, 2>;
+
+            static __m128i to_int(const batch_type& x)
+            {
+                return _mm_castpd_si128(x);
+            }
+
+            static batch_type from_int(__m128i x)
+            {
+                return _mm_castsi128_pd(x);
+            }
+        };
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSSE3_VERSION
+        // Converts indices of S-byte elements to the indices of their bytes,
+        // as expected by pshufb: the low byte of each index is replicated over
+        // its element, scaled by S and offset by the position of the byte.
+        template <std::size_t S>
+        __m128i sse_byte_indices(__m128i index);
+
+        template <>
+        inline __m128i sse_byte_indices<1>(__m128i index)
+        {
+            return index;
+        }
+
+        template <>
+        inline __m128i sse_byte_indices<2>(__m128i index)
+        {
+            __m128i rep = _mm_shuffle_epi8(index, _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14));
+            return _mm_add_epi8(_mm_slli_epi16(rep, 1), _mm_setr_epi8(0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1));
+        }
+
+        template <>
+        inline __m128i sse_byte_indices<4>(__m128i index)
+        {
+            __m128i rep = _mm_shuffle_epi8(index, _mm_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12));
+            return _mm_add_epi8(_mm_slli_epi16(rep, 2), _mm_setr_epi8(0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3));
+        }
+
+        template <>
+        inline __m128i sse_byte_indices<8>(__m128i index)
+        {
+            __m128i rep = _mm_shuffle_epi8(index, _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 8, 8, 8, 8));
+            return _mm_add_epi8(_mm_slli_epi16(rep, 3), _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7));
+        }
+
+        // Same as above, for a pattern known at compile time
+        template <class traits, std::size_t... Js>
+        inline __m128i sse_constant_byte_indices(std::size_t S, detail::index_sequence<Js...>)
+        {
+            return _mm_setr_epi8(static_cast<char>(traits::byte_index(S, Js))...);
+        }
+#endif
+    }
+
+    /***********
+     * swizzle *
+     ***********/
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSSE3_VERSION
+    template <class T, std::size_t N>
+    struct swizzle_impl<T, N, detail::enable_sse_shuffle_t<T, N>>
+    {
+        template <class I>
+        static inline batch<T, N> run(const batch<T, N>& x, const batch<I, N>& index)
+        {
+            using reg = detail::sse_shuffle_register<T>;
+            __m128i byte_index = detail::sse_byte_indices<sizeof(T)>(index);
+            return reg::from_int(_mm_shuffle_epi8(reg::to_int(x), byte_index));
+        }
+    };
+#endif
+
+    /***********
+     * shuffle *
+     ***********/
+
+    namespace detail
+    {
+        // pshufb for 8-bit and 16-bit elements
+        template <class T, std::size_t N, class I, I... Is>
+        inline batch<T, N> sse_byte_shuffle(const batch<T, N>& x, const batch_constant<I, Is...>& mask)
+        {
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSSE3_VERSION
+            (void)mask;
+            using traits = shuffle_traits<I, Is...>;
+            return _mm_shuffle_epi8(x, sse_constant_byte_indices<traits>(sizeof(T), detail::make_index_sequence<16>()));
+#else
+            return swizzle_impl<T, N>::run(x, mask());
+#endif
+        }
+
+        template <class T, std::size_t N, class = void>
+        struct sse_shuffle_kernel
+        {
+            template <class I, I... Is>
+            static inline batch<T, N> run(const batch<T, N>& x, const batch_constant<I, Is...>& mask)
+            {
+                return sse_byte_shuffle(x, mask);
+            }
+        };
+
+        // shufps / pshufd handle any pattern of 4 elements
+        template <>
+        struct sse_shuffle_kernel<float, 4>
+        {
+            template <class I, I... Is>
+            static inline batch<float, 4> run(const batch<float, 4>& x, const batch_constant<I, Is...>&)
+            {
+                constexpr int imm = shuffle_traits<I, Is...>::immediate(4, 2);
+                return _mm_shuffle_ps(x, x, imm);
+            }
+        };
+
+        template <class T>
+        struct sse_shuffle_kernel<T, 4, typename std::enable_if<std::is_integral<T>::value>::type>
+        {
+            template <class I, I... Is>
+            static inline batch<T, 4> run(const batch<T, 4>& x, const batch_constant<I, Is...>&)
+            {
+                constexpr int imm = shuffle_traits<I, Is...>::immediate(4, 2);
+                return _mm_shuffle_epi32(x, imm);
+            }
+        };
+
+        template <>
+        struct sse_shuffle_kernel<double, 2>
+        {
+            template <class I, I... Is>
+            static inline batch<double, 2> run(const batch<double, 2>& x, const batch_constant<I, Is...>&)
+            {
+                constexpr int imm = shuffle_traits<I, Is...>::immediate(2, 1);
+                return _mm_shuffle_pd(x, x, imm);
+            }
+        };
+
+        template <class T>
+        struct sse_shuffle_kernel<T, 2, typename std::enable_if<std::is_integral<T>::value>::type>
+        {
+            template <class I, I... Is>
+            static inline batch<T, 2> run(const batch<T, 2>& x, const batch_constant<I, Is...>&)
+            {
+                // each 64-bit element moves as a pair of 32-bit elements
+                using traits = shuffle_traits<I, Is...>;
+                constexpr int imm = static_cast<int>((2 * traits::get(0)) | ((2 * traits::get(0) + 1) << 2) |
+                                                     ((2 * traits::get(1)) << 4) | ((2 * traits::get(1) + 1) << 6));
+                return _mm_shuffle_epi32(x, imm);
+            }
+        };
+
+        // pshuflw / pshufhw when the words stay in their half
+        template <class T>
+        struct sse_shuffle_kernel<T, 8, typename std::enable_if<std::is_integral<T>::value>::type>
+        {
+            template <class I, I... Is>
+            static inline batch<T, 8> run_impl(const batch<T, 8>& x, const batch_constant<I, Is...>&, std::true_type)
+            {
+                using traits = shuffle_traits<I, Is...>;
+                constexpr int imm_low = traits::immediate(4, 2, 0);
+                constexpr int imm_high = traits::immediate(4, 2, 4);
+                return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, imm_low), imm_high);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 8> run_impl(const batch<T, 8>& x, const batch_constant<I, Is...>& mask, std::false_type)
+            {
+                return sse_byte_shuffle(x, mask);
+            }
+
+            template <class I, I... Is>
+            static inline batch<T, 8> run(const batch<T, 8>& x, const batch_constant<I, Is...>& mask)
+            {
+                using in_halves = std::integral_constant<bool, shuffle_traits<I, Is...>::is_in_lanes(4)>;
+                return run_impl(x, mask, in_halves());
+            }
+        };
+    }
+
+    template <class T, std::size_t N>
+    struct shuffle_impl<T, N, detail::enable_sse_shuffle_t<T, N>>
+        : detail::sse_shuffle_kernel<T, N>
+    {
+    };
+
+    /************
+     * compress *
+     ************/
+
+#if XSIMD_X86_INSTR_SET >= XSIMD_X86_SSSE3_VERSION
+    namespace detail
+    {
+        // Bitmask of the selection, one bit per element
+        inline int sse_compress_bits(const batch_bool<float, 4>& mask)
+        {
+            return _mm_movemask_ps(mask);
+        }
+
+        inline int sse_compress_bits(const batch_bool<double, 2>& mask)
+        {
+            return _mm_movemask_pd(mask);
+        }
+
+        template <class T>
+        inline int sse_compress_bits(const batch_bool<T, 8>& mask)
+        {
+            return _mm_movemask_epi8(_mm_packs_epi16(mask, _mm_setzero_si128()));
+        }
+
+        template <class T>
+        inline int sse_compress_bits(const batch_bool<T, 4>& mask)
+        {
+            return _mm_movemask_ps(_mm_castsi128_ps(mask));
+        }
+
+        template <class T>
+        inline int sse_compress_bits(const batch_bool<T, 2>& mask)
+        {
+            return _mm_movemask_pd(_mm_castsi128_pd(mask));
+        }
+    }
+
+    template <class T, std::size_t N>
+    struct compress_impl<T, N, typename std::enable_if<std::is_arithmetic<T>::value && sizeof(T) * N == 16 && (sizeof(T) > 1)>::type>
+    {
+        static constexpr bool native = true;
+
+        static inline batch<T, N> run(const batch<T, N>& x, const batch_bool<T, N>& mask, std::size_t& count)
+        {
+            using reg = detail::sse_shuffle_register<T>;
+            const uint8_t* table = detail::compress_byte_table<sizeof(T)>(detail::make_index_sequence<16 << N>());
+            int bits = detail::sse_compress_bits(mask);
+            count = detail::bit_count(static_cast<uint64_t>(bits));
+            __m128i index = _mm_load_si128(reinterpret_cast<const __m128i*>(table + 16 * bits));
+            return reg::from_int(_mm_shuffle_epi8(reg::to_int(x), index));
+        }
+    };
+#endif
+}
+
+#endif
@@ -26,6 +26,8 @@
 #include "xsimd_sse_int32.hpp"
 #include "xsimd_sse_int64.hpp"
 #include "xsimd_sse_complex.hpp"
+#include "xsimd_sse_shuffle.hpp"
+#include "xsimd_sse_int_arith.hpp"
 #endif
 
 #if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX_VERSION
@@ -37,6 +39,8 @@
 #include "xsimd_avx_int32.hpp"
 #include "xsimd_avx_int64.hpp"
 #include "xsimd_avx_complex.hpp"
+#include "xsimd_avx_shuffle.hpp"
+#include "xsimd_avx_int_arith.hpp"
 #endif
 
 #if XSIMD_X86_INSTR_SET >= XSIMD_X86_AVX512_VERSION
@@ -49,6 +53,8 @@
 #include "xsimd_avx512_int32.hpp"
 #include "xsimd_avx512_int64.hpp"
 #include "xsimd_avx512_complex.hpp"
+#include "xsimd_avx512_shuffle.hpp"
+#include "xsimd_avx512_int_arith.hpp"
 #endif
 
 #if XSIMD_ARM_INSTR_SET >= XSIMD_ARM7_NEON_VERSION
@@ -67,6 +73,8 @@
 #include "xsimd_neon_int64.hpp"
 #include "xsimd_neon_uint64.hpp"
 #include "xsimd_neon_complex.hpp"
+#include "xsimd_neon_shuffle.hpp"
+#include "xsimd_neon_int_arith.hpp"
 #endif
 
 #if !defined(XSIMD_INSTR_SET_AVAILABLE)
@@ -17,9 +17,20 @@
 #include "math/xsimd_math.hpp"
 #include "math/xsimd_math_complex.hpp"
 #include "memory/xsimd_load_store.hpp"
+#include "memory/xsimd_aligned_arena.hpp"
+#include "memory/xsimd_aligned_stack_buffer.hpp"
 
 #include "stl/algorithms.hpp"
+#include "stl/array_expr.hpp"
+#include "stl/blas.hpp"
+#include "stl/fft.hpp"
+#include "stl/filter.hpp"
 #include "stl/iterator.hpp"
+#include "stl/random.hpp"
+#include "stl/search.hpp"
+#include "stl/sort.hpp"
+#include "stl/split_complex.hpp"
+#include "stl/text.hpp"
 
 #endif
 
@@ -8,7 +8,10 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
 #include <numeric>
+#include <string>
+#include <tuple>
 #include "test_utils.hpp"
 
 struct binary_functor
@@ -29,6 +32,33 @@ struct unary_functor
     }
 };
 
+struct clip_functor
+{
+    template <class T>
+    T operator()(const T& x, const T& lo, const T& hi) const
+    {
+        return xsimd::min(xsimd::max(x, lo), hi);
+    }
+};
+
+struct weighted_fma_functor
+{
+    template <class T>
+    T operator()(const T& a, const T& b, const T& c, const T& w) const
+    {
+        return xsimd::fma(a, b, c) * w;
+    }
+};
+
+struct sincos_functor
+{
+    template <class T>
+    std::tuple<T, T> operator()(const T& x) const
+    {
+        return std::make_tuple(xsimd::sin(x), xsimd::cos(x));
+    }
+};
+
 template <class T>
 using test_allocator_type = xsimd::aligned_allocator<T>;
 
@@ -109,6 +139,172 @@ TEST(algorithms, unary_transform)
     std::fill(ca.begin(), ca.end(), -1); // erase
 }
 
+TEST(algorithms, nary_transform)
+{
+    const std::size_t size = 1003;
+    std::vector<double, test_allocator_type<double>> x(size + 1), lo(size + 2), hi(size + 3), w(size), out(size + 2), out2(size + 1);
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        x[i] = double(i % 41) - 20.;
+    }
+    std::fill(lo.begin(), lo.end(), -5.);
+    std::fill(hi.begin(), hi.end(), 7.);
+    std::iota(w.begin(), w.end(), 0.);
+
+    // every stream has its own alignment
+    xsimd::transform(x.begin() + 1, x.end(), std::make_tuple(lo.begin() + 2, hi.begin() + 3),
+                     std::make_tuple(out.begin() + 1), clip_functor{});
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        EXPECT_EQ(out[i + 1], std::min(std::max(x[i + 1], -5.), 7.)) << "index " << i;
+    }
+
+    xsimd::transform(x.begin(), x.end() - 1, std::make_tuple(lo.cbegin() + 1, hi.cbegin(), w.cbegin()),
+                     std::make_tuple(out.begin()), weighted_fma_functor{});
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        EXPECT_EQ(out[i], (x[i] * lo[i + 1] + hi[i]) * w[i]) << "index " << i;
+    }
+
+    // one output per element of the returned tuple
+    xsimd::transform(x.begin(), x.end() - 1, std::make_tuple(), std::make_tuple(out.begin() + 2, out2.begin() + 1), sincos_functor{});
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        EXPECT_NEAR(out[i + 2], std::sin(x[i]), 1e-15) << "index " << i;
+        EXPECT_NEAR(out2[i + 1], std::cos(x[i]), 1e-15) << "index " << i;
+    }
+}
+
+TEST(algorithms, stream_transform)
+{
+    // a threshold of zero streams every output
+    const xsimd::stream_mode modes[] = { xsimd::stream_mode(0), xsimd::stream_mode() };
+    for (const auto& mode : modes)
+    {
+        std::vector<float> expected(1003);
+        std::vector<float, test_allocator_type<float>> a(1003), b(1003), c(1004);
+        std::iota(a.begin(), a.end(), 1.f);
+        std::iota(b.begin(), b.end(), -500.f);
+
+        std::transform(a.begin(), a.end(), expected.begin(), unary_functor{});
+        xsimd::transform(a.begin(), a.end(), c.begin(), unary_functor{}, mode);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), c.begin()));
+        // unaligned input and output
+        xsimd::transform(a.begin() + 1, a.end(), c.begin() + 2, unary_functor{}, mode);
+        EXPECT_TRUE(std::equal(expected.begin() + 1, expected.end(), c.begin() + 2));
+
+        std::transform(a.begin(), a.end(), b.begin(), expected.begin(), binary_functor{});
+        xsimd::transform(a.begin(), a.end(), b.begin(), c.begin(), binary_functor{}, mode);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), c.begin()));
+        xsimd::transform(a.begin() + 1, a.end(), b.begin() + 1, c.begin() + 3, binary_functor{}, mode);
+        EXPECT_TRUE(std::equal(expected.begin() + 1, expected.end(), c.begin() + 3));
+    }
+}
+
+TEST(algorithms, prefetch_transform)
+{
+    // distances shorter and longer than the arrays
+    const xsimd::prefetch_mode modes[] = { xsimd::prefetch_mode(0), xsimd::prefetch_mode(), xsimd::prefetch_mode(1 << 16) };
+    for (const auto& mode : modes)
+    {
+        std::vector<float> expected(1003);
+        std::vector<float, test_allocator_type<float>> a(1003), b(1003), c(1004);
+        std::iota(a.begin(), a.end(), 1.f);
+        std::iota(b.begin(), b.end(), -500.f);
+
+        std::transform(a.begin(), a.end(), expected.begin(), unary_functor{});
+        xsimd::transform(a.begin(), a.end(), c.begin(), unary_functor{}, mode);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), c.begin()));
+        xsimd::transform(a.begin() + 1, a.end(), c.begin() + 2, unary_functor{}, mode);
+        EXPECT_TRUE(std::equal(expected.begin() + 1, expected.end(), c.begin() + 2));
+
+        std::transform(a.begin(), a.end(), b.begin(), expected.begin(), binary_functor{});
+        xsimd::transform(a.begin(), a.end(), b.begin(), c.begin(), binary_functor{}, mode);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), c.begin()));
+        // second input misaligned with the first one
+        std::transform(a.begin() + 1, a.end() - 1, b.begin() + 2, expected.begin(), binary_functor{});
+        xsimd::transform(a.begin() + 1, a.end() - 1, b.begin() + 2, c.begin() + 1, binary_functor{}, mode);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end() - 2, c.begin() + 1));
+    }
+}
+
+struct square_functor
+{
+    template <class T>
+    T operator()(const T& a) const
+    {
+        return a * a;
+    }
+};
+
+struct squared_distance_functor
+{
+    template <class T>
+    T operator()(const T& a, const T& b) const
+    {
+        return (a - b) * (a - b);
+    }
+};
+
+struct max_functor
+{
+    template <class T>
+    T operator()(const T& a, const T& b) const
+    {
+        return xsimd::max(a, b);
+    }
+};
+
+struct abs_functor
+{
+    template <class T>
+    T operator()(const T& a) const
+    {
+        return xsimd::abs(a);
+    }
+};
+
+TEST(algorithms, transform_reduce)
+{
+    for (std::size_t size : {0, 1, 3, 17, 64, 133, 1000})
+    {
+        // the values are small integers, so that the sums are exact
+        std::vector<double, test_allocator_type<double>> a(size + 1), b(size + 2);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            a[i] = double(i % 13) - 6.;
+        }
+        for (std::size_t i = 0; i < b.size(); ++i)
+        {
+            b[i] = double(i % 7);
+        }
+
+        for (std::size_t offset : {0, 1})
+        {
+            auto first = a.cbegin() + offset;
+            auto last = first + size;
+            double squares = 0., distance = 0., dot = 0., max_abs = -1.;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                squares += first[i] * first[i];
+                distance += (first[i] - b[i + 2]) * (first[i] - b[i + 2]);
+                dot += first[i] * b[i + 2];
+                max_abs = std::max(max_abs, std::abs(first[i]));
+            }
+
+            EXPECT_EQ(xsimd::transform_reduce(first, last, 1., binary_functor{}, square_functor{}), 1. + squares) << "size " << size;
+            EXPECT_EQ(xsimd::transform_reduce(first, last, b.cbegin() + 2, 0., binary_functor{}, squared_distance_functor{}), distance) << "size " << size;
+            EXPECT_EQ(xsimd::transform_reduce(first, last, b.cbegin() + 2, 2.), 2. + dot) << "size " << size;
+            EXPECT_EQ(xsimd::transform_reduce(first, last, -1., max_functor{}, abs_functor{}), max_abs) << "size " << size;
+        }
+    }
+
+    // empty ranges are not dereferenced
+    std::vector<double> empty;
+    EXPECT_EQ(xsimd::transform_reduce(empty.cbegin(), empty.cend(), 3., binary_functor{}, square_functor{}), 3.);
+    EXPECT_EQ(xsimd::transform_reduce(empty.cbegin(), empty.cend(), empty.cbegin(), 3.), 3.);
+}
+
 class xsimd_reduce : public ::testing::Test
 {
 public:
@@ -211,6 +407,246 @@ TEST_F(xsimd_reduce, using_custom_binary_function)
     }
 }
 
+TEST_F(xsimd_reduce, prefetch)
+{
+    std::vector<double, test_allocator_type<double>> large(10000);
+    std::iota(large.begin(), large.end(), 1.);
+    const double expected = std::accumulate(large.begin() + 1, large.end(), init);
+
+    const xsimd::prefetch_mode modes[] = { xsimd::prefetch_mode(0), xsimd::prefetch_mode(), xsimd::prefetch_mode(1 << 20) };
+    for (const auto& mode : modes)
+    {
+        EXPECT_EQ(expected, xsimd::reduce(large.begin() + 1, large.end(), init, binary_functor{}, mode));
+        EXPECT_DOUBLE_EQ(std::accumulate(vec.begin(), vec.end(), init, multiply{}),
+                         xsimd::reduce(vec.begin(), vec.end(), init, multiply{}, mode));
+    }
+
+    // the calibrated distance is one of the measured ones
+    std::size_t distance = xsimd::prefetch_mode::calibrated().distance;
+    EXPECT_LE(distance, std::size_t(4096));
+    EXPECT_EQ(distance, xsimd::prefetch_mode::calibrated().distance);
+}
+
+template <class T>
+class min_max_element_test : public ::testing::Test
+{
+public:
+    using vector_type = std::vector<T, test_allocator_type<T>>;
+
+    // Values repeat so that ties are exercised, extrema are placed in the
+    // prologue, the aligned body and the epilogue in turn.
+    void check() const
+    {
+        for (std::size_t size : {0, 1, 3, 17, 64, 133, 1000})
+        {
+            vector_type vec(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                vec[i] = static_cast<T>((i * 7) % 23);
+            }
+            check_range(vec, size);
+            for (std::size_t pos : {std::size_t(1), size / 2, size - 1})
+            {
+                if (pos < size)
+                {
+                    vector_type tmp(vec);
+                    tmp[pos] = static_cast<T>(-1);
+                    tmp[size - 1 - pos] = static_cast<T>(100);
+                    check_range(tmp, size);
+                }
+            }
+        }
+    }
+
+private:
+    void check_range(const vector_type& vec, std::size_t size) const
+    {
+        for (std::size_t offset = 0; offset < 3 && offset <= size; ++offset)
+        {
+            auto begin = vec.begin() + static_cast<std::ptrdiff_t>(offset);
+            auto end = vec.end();
+            EXPECT_EQ(std::min_element(begin, end), xsimd::min_element(begin, end)) << "size: " << size << ", offset: " << offset;
+            EXPECT_EQ(std::max_element(begin, end), xsimd::max_element(begin, end)) << "size: " << size << ", offset: " << offset;
+            EXPECT_EQ(std::minmax_element(begin, end), xsimd::minmax_element(begin, end)) << "size: " << size << ", offset: " << offset;
+            EXPECT_EQ(static_cast<std::size_t>(std::distance(begin, std::min_element(begin, end))), xsimd::argmin(begin, end));
+            EXPECT_EQ(static_cast<std::size_t>(std::distance(begin, std::max_element(begin, end))), xsimd::argmax(begin, end));
+        }
+    }
+};
+
+using min_max_element_types = testing::Types<int8_t, uint8_t, int16_t, uint16_t, int32_t, int64_t, float, double>;
+TYPED_TEST_SUITE(min_max_element_test, min_max_element_types);
+
+TYPED_TEST(min_max_element_test, min_max_element)
+{
+    this->check();
+}
+
+template <class T>
+struct greater_than
+{
+    T value;
+
+    template <class U>
+    auto operator()(const U& x) const -> decltype(x > U(value))
+    {
+        return x > U(value);
+    }
+};
+
+template <class T>
+class find_count_test : public ::testing::Test
+{
+public:
+    using vector_type = std::vector<T, test_allocator_type<T>>;
+
+    // 70000 elements overflow 8-bit lane counters several times.
+    void check() const
+    {
+        for (std::size_t size : {0, 1, 5, 33, 300, 70000})
+        {
+            vector_type vec(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                vec[i] = static_cast<T>((i * 37) % 53);
+            }
+            vector_type other(vec);
+            if (size > 10)
+            {
+                other[size - 3] = static_cast<T>(1);
+            }
+            for (std::size_t offset = 0; offset < 3 && offset <= size; ++offset)
+            {
+                check_range(vec, other, offset);
+            }
+        }
+    }
+
+private:
+    void check_range(const vector_type& vec, const vector_type& other, std::size_t offset) const
+    {
+        auto begin = vec.begin() + static_cast<std::ptrdiff_t>(offset);
+        auto end = vec.end();
+        auto other_begin = other.begin() + static_cast<std::ptrdiff_t>(offset);
+        std::string info = "size: " + std::to_string(vec.size()) + ", offset: " + std::to_string(offset);
+
+        EXPECT_EQ(std::find(begin, end, T(52)), xsimd::find(begin, end, T(52))) << info;
+        EXPECT_EQ(std::find(begin, end, T(99)), xsimd::find(begin, end, T(99))) << info;
+        EXPECT_EQ(std::find(begin, end, T(52)), xsimd::find<1>(begin, end, T(52))) << info;
+        // values that the element type cannot hold, 308 wrapping to 52 in 8 bits
+        EXPECT_EQ(std::find(begin, end, 308), xsimd::find(begin, end, 308)) << info;
+        EXPECT_EQ(std::find(begin, end, 52.5), xsimd::find(begin, end, 52.5)) << info;
+        EXPECT_EQ(std::count(begin, end, 308), xsimd::count(begin, end, 308)) << info;
+        EXPECT_EQ(std::count(begin, end, 7.5), xsimd::count(begin, end, 7.5)) << info;
+        EXPECT_EQ(std::find_if(begin, end, greater_than<T>{T(50)}), xsimd::find_if(begin, end, greater_than<T>{T(50)})) << info;
+        EXPECT_EQ(std::count(begin, end, T(7)), xsimd::count(begin, end, T(7))) << info;
+        EXPECT_EQ(std::count_if(begin, end, greater_than<T>{T(20)}), xsimd::count_if(begin, end, greater_than<T>{T(20)})) << info;
+        EXPECT_EQ(std::any_of(begin, end, greater_than<T>{T(51)}), xsimd::any_of(begin, end, greater_than<T>{T(51)})) << info;
+        EXPECT_EQ(std::all_of(begin, end, greater_than<T>{T(0)}), xsimd::all_of(begin, end, greater_than<T>{T(0)})) << info;
+        EXPECT_EQ(std::none_of(begin, end, greater_than<T>{T(60)}), xsimd::none_of(begin, end, greater_than<T>{T(60)})) << info;
+        EXPECT_EQ(std::mismatch(begin, end, other_begin), xsimd::mismatch(begin, end, other_begin)) << info;
+        EXPECT_EQ(std::equal(begin, end, other_begin), xsimd::equal(begin, end, other_begin)) << info;
+        EXPECT_EQ(std::equal(begin, end, begin), xsimd::equal(begin, end, begin)) << info;
+        if (begin != end)
+        {
+            // second range with a different alignment
+            auto last = std::prev(end);
+            EXPECT_EQ(std::mismatch(begin, last, std::next(other_begin)), xsimd::mismatch(begin, last, std::next(other_begin))) << info;
+        }
+    }
+};
+
+using find_count_types = testing::Types<int8_t, uint8_t, int16_t, int32_t, int64_t, float, double>;
+TYPED_TEST_SUITE(find_count_test, find_count_types);
+
+TYPED_TEST(find_count_test, find_count)
+{
+    this->check();
+}
+
+template <class T>
+class integer_histogram_test : public ::testing::Test
+{
+public:
+    using vector_type = std::vector<T, test_allocator_type<T>>;
+    static constexpr std::size_t nbins = std::size_t(1) << (8 * sizeof(T));
+
+    // Runs of equal values exercise repeated indices within a batch.
+    void check() const
+    {
+        for (std::size_t size : {0, 1, 5, 33, 300, 70000})
+        {
+            vector_type vec(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                vec[i] = static_cast<T>(i % 7 == 0 ? (i * 2654435761u) >> 7 : i / 16);
+            }
+            std::vector<uint32_t> expected(nbins, 1), res(nbins, 1);
+            for (T v : vec)
+            {
+                ++expected[v];
+            }
+            xsimd::histogram(vec.begin(), vec.end(), res.begin());
+            EXPECT_EQ(expected, res) << "size: " << size;
+        }
+    }
+};
+
+using integer_histogram_types = testing::Types<uint8_t, uint16_t>;
+TYPED_TEST_SUITE(integer_histogram_test, integer_histogram_types);
+
+TYPED_TEST(integer_histogram_test, histogram)
+{
+    this->check();
+}
+
+template <class T>
+class float_histogram_test : public ::testing::Test
+{
+public:
+    using vector_type = std::vector<T, test_allocator_type<T>>;
+
+    void check() const
+    {
+        const std::size_t nbins = 50;
+        const T lo = T(-2), hi = T(3);
+        for (std::size_t size : {0, 1, 5, 33, 300, 10000})
+        {
+            vector_type vec(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                vec[i] = T(-3) + static_cast<T>((i * 37) % 701) / T(100);
+            }
+            if (size > 10)
+            {
+                vec[3] = std::numeric_limits<T>::quiet_NaN();
+                vec[7] = std::numeric_limits<T>::infinity();
+                vec[9] = hi;
+            }
+            std::vector<int64_t> expected(nbins, 0), res(nbins, 0);
+            const T scale = static_cast<T>(nbins) / (hi - lo);
+            for (T v : vec)
+            {
+                T bucket = std::floor((v - lo) * scale);
+                if (bucket >= T(0) && bucket < static_cast<T>(nbins))
+                {
+                    ++expected[static_cast<std::size_t>(bucket)];
+                }
+            }
+            xsimd::histogram(vec.begin(), vec.end(), res.data(), nbins, lo, hi);
+            EXPECT_EQ(expected, res) << "size: " << size;
+        }
+    }
+};
+
+using float_histogram_types = testing::Types<float, double>;
+TYPED_TEST_SUITE(float_histogram_test, float_histogram_types);
+
+TYPED_TEST(float_histogram_test, histogram)
+{
+    this->check();
+}
+
 #if XSIMD_X86_INSTR_SET > XSIMD_VERSION_NUMBER_NOT_AVAILABLE || XSIMD_ARM_INSTR_SET > XSIMD_VERSION_NUMBER_NOT_AVAILABLE
 TEST(algorithms, iterator)
 {
@@ -262,4 +698,64 @@ TEST(algorithms, iterator)
 #endif
 
 }
+
+TEST(algorithms, batch_iterator)
+{
+    using batch_type = typename xsimd::simd_traits<float>::type;
+    constexpr std::size_t batch_size = batch_type::size;
+
+    // unaligned data with a partial last batch
+    std::vector<float> a(5 * batch_size + 3);
+    std::iota(a.begin(), a.end(), 1.f);
+    std::vector<float> expected(a);
+    for (auto& el : expected)
+    {
+        el *= 2.f;
+    }
+
+    for (auto b : xsimd::batch_range(a.data() + 1, a.size() - 1))
+    {
+        b = b * 2.f;
+    }
+    a[0] *= 2.f;
+    EXPECT_TRUE(std::equal(a.begin(), a.end(), expected.begin()));
+
+    // the lanes past the end are zeros
+    const std::vector<float>& ca = a;
+    batch_type sum(0.f);
+    std::size_t partial = 0;
+    for (auto b : xsimd::batch_range(ca))
+    {
+        sum += b;
+        partial += b.is_partial() ? 1 : 0;
+    }
+    EXPECT_EQ(xsimd::hadd(sum), std::accumulate(a.begin(), a.end(), 0.f));
+    EXPECT_EQ(partial, std::size_t(1));
+
+    auto range = xsimd::batch_range(a);
+    auto first = range.begin();
+    auto last = range.end();
+    EXPECT_EQ(last - first, std::ptrdiff_t(6));
+    EXPECT_EQ(std::distance(first, last), std::ptrdiff_t(range.size()));
+    EXPECT_TRUE(first < last && last > first && first <= first && last >= first);
+    EXPECT_TRUE(first + 6 == last && 6 + first == last && last - 6 == first);
+
+    auto it = first;
+    it += 5;
+    EXPECT_EQ((*it).size(), std::size_t(3));
+    EXPECT_EQ(xsimd::hadd(xsimd::select((*it).mask(), batch_type(1.f), batch_type(0.f))), 3.f);
+    EXPECT_EQ(first[5].size(), std::size_t(3));
+    it -= 2;
+    EXPECT_EQ(batch_type(*it)[0], a[3 * batch_size]);
+    EXPECT_EQ(batch_type(*--it)[0], a[2 * batch_size]);
+
+    // read-only iterators are built from mutable ones
+    xsimd::batch_iterator<batch_type, const float> cit = it;
+    EXPECT_EQ(cit.index(), std::ptrdiff_t(2));
+
+    // batches are swapped through their proxies
+    std::vector<float> b(a);
+    std::reverse(xsimd::batch_range(b.data(), 4 * batch_size).begin(), xsimd::batch_range(b.data(), 4 * batch_size).end());
+    EXPECT_TRUE(std::equal(b.begin(), b.begin() + batch_size, a.begin() + 3 * batch_size));
+}
 #endif
@@ -0,0 +1,111 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "test_utils.hpp"
+
+template <class T>
+class array_expr_test : public testing::Test
+{
+protected:
+
+    using value_type = T;
+    using vector_type = std::vector<T, xsimd::aligned_allocator<T>>;
+
+    static constexpr std::size_t size = 1003;
+
+    array_expr_test()
+        : a(size), b(size), d(size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            a[i] = value_type(0.5) + value_type(i % 17) / value_type(4);
+            b[i] = value_type(1) - value_type(i % 5) / value_type(8);
+            d[i] = value_type(i % 31) / value_type(10) - value_type(1);
+        }
+    }
+
+    vector_type a, b, d;
+};
+
+template <class T>
+constexpr std::size_t array_expr_test<T>::size;
+
+using array_expr_types = testing::Types<float, double>;
+TYPED_TEST_SUITE(array_expr_test, array_expr_types);
+
+TYPED_TEST(array_expr_test, arithmetic)
+{
+    using value_type = typename TestFixture::value_type;
+    const auto& a = this->a;
+    const auto& b = this->b;
+    const auto& d = this->d;
+
+    auto res = xsimd::eval(xsimd::expr(a) * xsimd::expr(b) + value_type(2) * xsimd::expr(d) - xsimd::expr(a) / value_type(4));
+    ASSERT_EQ(res.size(), a.size());
+    for (std::size_t i = 0; i < res.size(); ++i)
+    {
+        value_type expected = a[i] * b[i] + value_type(2) * d[i] - a[i] / value_type(4);
+        EXPECT_NEAR(res[i], expected, std::abs(expected) * 1e-6 + 1e-6) << "index " << i;
+    }
+
+    // operands and output misaligned with each other
+    std::vector<value_type> out(a.size() + 3);
+    xsimd::evaluate(-xsimd::expr(a.data() + 1, a.size() - 2) + xsimd::expr(b.data() + 2, b.size() - 2), out.data() + 3);
+    for (std::size_t i = 0; i + 2 < a.size(); ++i)
+    {
+        EXPECT_EQ(out[i + 3], -a[i + 1] + b[i + 2]) << "index " << i;
+    }
+
+    // one operand aligned like the output and the other one misaligned
+    typename TestFixture::vector_type aligned_out(a.size() - 1);
+    xsimd::evaluate(xsimd::expr(a.data(), a.size() - 1) * xsimd::expr(b.data() + 1, b.size() - 1), aligned_out.data());
+    for (std::size_t i = 0; i < aligned_out.size(); ++i)
+    {
+        EXPECT_EQ(aligned_out[i], a[i] * b[i + 1]) << "index " << i;
+    }
+}
+
+TYPED_TEST(array_expr_test, math)
+{
+    using value_type = typename TestFixture::value_type;
+    const auto& a = this->a;
+    const auto& b = this->b;
+    const auto& d = this->d;
+
+    typename TestFixture::vector_type res;
+    xsimd::assign(res, xsimd::expr(a) * xsimd::expr(b) + xsimd::sin(xsimd::expr(d)));
+    ASSERT_EQ(res.size(), a.size());
+    for (std::size_t i = 0; i < res.size(); ++i)
+    {
+        value_type expected = a[i] * b[i] + std::sin(d[i]);
+        EXPECT_NEAR(res[i], expected, std::abs(expected) * 1e-5 + 1e-6) << "index " << i;
+    }
+
+    xsimd::assign(res, xsimd::fma(xsimd::expr(a), xsimd::expr(b), value_type(1)) +
+                       xsimd::max(xsimd::sqrt(xsimd::expr(a)), value_type(1.5)) * xsimd::exp(xsimd::abs(xsimd::expr(d))));
+    for (std::size_t i = 0; i < res.size(); ++i)
+    {
+        value_type expected = (a[i] * b[i] + value_type(1)) + std::max(std::sqrt(a[i]), value_type(1.5)) * std::exp(std::abs(d[i]));
+        EXPECT_NEAR(res[i], expected, std::abs(expected) * 1e-5) << "index " << i;
+    }
+
+    // the output may be an operand
+    auto expected = a;
+    xsimd::assign(expected, xsimd::expr(expected) * xsimd::expr(expected));
+    xsimd::assign(res, xsimd::pow(xsimd::expr(a), value_type(2)));
+    for (std::size_t i = 0; i < res.size(); ++i)
+    {
+        EXPECT_NEAR(res[i], expected[i], expected[i] * 1e-5) << "index " << i;
+    }
+}
@@ -500,6 +500,25 @@ protected:
             value_type res = hadd(batch_lhs());
             EXPECT_SCALAR_EQ(res, expected) << print_function_name("hadd");
         }
+        // hmin
+        {
+            value_type expected = *std::min_element(lhs.cbegin(), lhs.cend());
+            value_type res = hmin(batch_lhs());
+            EXPECT_SCALAR_EQ(res, expected) << print_function_name("hmin");
+        }
+        // hmax
+        {
+            value_type expected = *std::max_element(lhs.cbegin(), lhs.cend());
+            value_type res = hmax(batch_lhs());
+            EXPECT_SCALAR_EQ(res, expected) << print_function_name("hmax");
+        }
+        // hminmax
+        {
+            auto expected = std::minmax_element(lhs.cbegin(), lhs.cend());
+            auto res = hminmax(batch_lhs());
+            EXPECT_SCALAR_EQ(res.first, *expected.first) << print_function_name("hminmax");
+            EXPECT_SCALAR_EQ(res.second, *expected.second) << print_function_name("hminmax");
+        }
     }
 
     void test_boolean_conversions() const
@@ -168,6 +168,179 @@ namespace xsimd
             EXPECT_TRUE(xsimd::all(r4 == e4));
         }
     };
+
+    template <class B, bool = sizeof(typename B::value_type) == 1>
+    struct test_int_lookup16
+    {
+        void run()
+        {
+        }
+    };
+
+    template <class B>
+    struct test_int_lookup16<B, true>
+    {
+        void run()
+        {
+            using T = typename B::value_type;
+            std::array<T, B::size> table, index, expected;
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                table[i] = static_cast<T>(i < 16 ? 3 * i + 1 : 0);
+                index[i] = static_cast<T>((i * 7 + 3) % 16);
+            }
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                expected[i] = table[static_cast<std::size_t>(index[i])];
+            }
+            B res = lookup16(B(table.data()), B(index.data()));
+            EXPECT_BATCH_EQ(res, expected) << print_function_name("lookup16");
+        }
+    };
+
+    template <class T>
+    T int_arith_value(std::size_t i)
+    {
+        // extreme values first, then a pseudo-random sequence
+        switch (i % 8)
+        {
+        case 0:
+            return std::numeric_limits<T>::max();
+        case 3:
+            return std::numeric_limits<T>::min();
+        default:
+            return static_cast<T>(0x9E3779B97F4A7C15ull * (i + 1) >> 17);
+        }
+    }
+
+    template <class T>
+    T int_arith_mulhi(T lhs, T rhs, std::false_type)
+    {
+        using wide_type = typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type;
+        return static_cast<T>((wide_type(lhs) * wide_type(rhs)) >> (8 * sizeof(T)));
+    }
+
+    template <class T>
+    T int_arith_mulhi(T lhs, T rhs, std::true_type)
+    {
+#if defined(__SIZEOF_INT128__)
+        using wide_type = typename std::conditional<std::is_signed<T>::value, __int128, unsigned __int128>::type;
+        return static_cast<T>((wide_type(lhs) * wide_type(rhs)) >> 64);
+#else
+        return detail::scalar_mulhi(lhs, rhs);
+#endif
+    }
+
+    template <class B>
+    struct test_int_arith
+    {
+        void run()
+        {
+            using T = typename B::value_type;
+            using U = typename std::make_unsigned<T>::type;
+            std::array<T, B::size> lhs, rhs, expected;
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                lhs[i] = int_arith_value<T>(i);
+                rhs[i] = int_arith_value<T>(3 * i + 5);
+            }
+            B x(lhs.data()), y(rhs.data());
+
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                expected[i] = int_arith_mulhi(lhs[i], rhs[i], std::integral_constant<bool, sizeof(T) == 8>());
+            }
+            EXPECT_BATCH_EQ(mulhi(x, y), expected) << print_function_name("mulhi");
+
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                expected[i] = static_cast<T>((lhs[i] >> 1) + (rhs[i] >> 1) + ((lhs[i] | rhs[i]) & 1));
+            }
+            EXPECT_BATCH_EQ(avg(x, y), expected) << print_function_name("avg");
+
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                expected[i] = static_cast<T>(lhs[i] > rhs[i] ? U(U(lhs[i]) - U(rhs[i])) : U(U(rhs[i]) - U(lhs[i])));
+            }
+            EXPECT_BATCH_EQ(absdiff(x, y), expected) << print_function_name("absdiff");
+        }
+    };
+
+    template <class B, bool = sizeof(typename B::value_type) < 8>
+    struct test_int_widen
+    {
+        void run()
+        {
+        }
+    };
+
+    template <class B>
+    struct test_int_widen<B, true>
+    {
+        void run()
+        {
+            using T = typename B::value_type;
+            using W = detail::widen_integer_t<T>;
+            using U = typename std::make_unsigned<W>::type;
+            constexpr std::size_t half_size = B::size / 2;
+            std::array<T, B::size> lhs, rhs;
+            std::array<W, half_size> expected_lo, expected_hi, expected_madd;
+            for (std::size_t i = 0; i < B::size; ++i)
+            {
+                lhs[i] = int_arith_value<T>(i);
+                rhs[i] = int_arith_value<T>(5 * i + 2);
+            }
+            for (std::size_t i = 0; i < half_size; ++i)
+            {
+                expected_lo[i] = static_cast<W>(W(lhs[i]) * W(rhs[i]));
+                expected_hi[i] = static_cast<W>(W(lhs[half_size + i]) * W(rhs[half_size + i]));
+                U even = static_cast<U>(W(lhs[2 * i]) * W(rhs[2 * i]));
+                U odd = static_cast<U>(W(lhs[2 * i + 1]) * W(rhs[2 * i + 1]));
+                expected_madd[i] = static_cast<W>(U(even + odd));
+            }
+            B x(lhs.data()), y(rhs.data());
+            EXPECT_BATCH_EQ(mul_widen_lo(x, y), expected_lo) << print_function_name("mul_widen_lo");
+            EXPECT_BATCH_EQ(mul_widen_hi(x, y), expected_hi) << print_function_name("mul_widen_hi");
+            EXPECT_BATCH_EQ(madd(x, y), expected_madd) << print_function_name("madd");
+        }
+    };
+
+    template <class B, bool = std::is_same<typename B::value_type, uint8_t>::value>
+    struct test_int_sad
+    {
+        void run()
+        {
+        }
+    };
+
+    template <class B>
+    struct test_int_sad<B, true>
+    {
+        void run()
+        {
+            constexpr std::size_t size = B::size;
+            std::array<uint8_t, size> lhs, rhs;
+            std::array<int8_t, size> coefs;
+            std::array<uint64_t, size / 8> expected_sad = {};
+            std::array<int16_t, size / 2> expected_smadd;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                lhs[i] = int_arith_value<uint8_t>(i);
+                rhs[i] = int_arith_value<uint8_t>(3 * i + 1);
+                coefs[i] = i % 4 == 0 ? int8_t(-128) : int_arith_value<int8_t>(7 * i + 4);
+                expected_sad[i / 8] += static_cast<uint64_t>(std::abs(int(lhs[i]) - int(rhs[i])));
+            }
+            for (std::size_t i = 0; i < size / 2; ++i)
+            {
+                int sum = int(lhs[2 * i]) * coefs[2 * i] + int(lhs[2 * i + 1]) * coefs[2 * i + 1];
+                expected_smadd[i] = static_cast<int16_t>(std::min(32767, std::max(-32768, sum)));
+            }
+            B x(lhs.data()), y(rhs.data());
+            batch<int8_t, size> c(coefs.data());
+            EXPECT_BATCH_EQ(sad(x, y), expected_sad) << print_function_name("sad");
+            EXPECT_BATCH_EQ(smadd(x, c), expected_smadd) << print_function_name("smadd");
+        }
+    };
 }
 
 template <class B>
@@ -283,6 +456,22 @@ protected:
         t.run();
     }
 
+    void test_lookup16() const
+    {
+        xsimd::test_int_lookup16<batch_type> t;
+        t.run();
+    }
+
+    void test_int_arith() const
+    {
+        xsimd::test_int_arith<batch_type> t;
+        t.run();
+        xsimd::test_int_widen<batch_type> w;
+        w.run();
+        xsimd::test_int_sad<batch_type> s;
+        s.run();
+    }
+
     void test_less_than_underflow() const
     {
         batch_type test_negative_compare = batch_type(5) - 6;
@@ -336,6 +525,16 @@ TYPED_TEST(batch_int_test, min_max)
     this->test_min_max();
 }
 
+TYPED_TEST(batch_int_test, lookup16)
+{
+    this->test_lookup16();
+}
+
+TYPED_TEST(batch_int_test, int_arith)
+{
+    this->test_int_arith();
+}
+
 TYPED_TEST(batch_int_test, less_than_underflow)
 {
     this->test_less_than_underflow();
@@ -0,0 +1,350 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "test_utils.hpp"
+
+namespace
+{
+    template <class T>
+    struct blas_value
+    {
+        using real_type = T;
+
+        template <class G>
+        static T random(G& gen)
+        {
+            std::uniform_real_distribution<T> dist(T(-1), T(1));
+            return dist(gen);
+        }
+
+        static T conj(const T& x)
+        {
+            return x;
+        }
+
+        static long double magnitude(const T& x)
+        {
+            return std::abs(static_cast<long double>(x));
+        }
+    };
+
+    template <class T>
+    struct blas_value<std::complex<T>>
+    {
+        using real_type = T;
+
+        template <class G>
+        static std::complex<T> random(G& gen)
+        {
+            std::uniform_real_distribution<T> dist(T(-1), T(1));
+            T re = dist(gen);
+            return std::complex<T>(re, dist(gen));
+        }
+
+        static std::complex<T> conj(const std::complex<T>& x)
+        {
+            return std::conj(x);
+        }
+
+        static long double magnitude(const std::complex<T>& x)
+        {
+            return std::abs(static_cast<long double>(x.real())) + std::abs(static_cast<long double>(x.imag()));
+        }
+    };
+}
+
+template <class T>
+class blas_test : public testing::Test
+{
+protected:
+
+    using value_type = T;
+    using traits = blas_value<T>;
+    using real_type = typename traits::real_type;
+    using vector_type = std::vector<value_type>;
+
+    // Sizes below, around and above the unrolled blocks
+    std::vector<std::size_t> sizes() const
+    {
+        return { 0, 1, 3, 8, 17, 63, 64, 100, 1001 };
+    }
+
+    vector_type make_vector(std::size_t n, unsigned seed) const
+    {
+        std::mt19937 gen(seed);
+        vector_type res(n);
+        for (auto& x : res)
+        {
+            x = traits::random(gen);
+        }
+        return res;
+    }
+
+    real_type tolerance(std::size_t n) const
+    {
+        return real_type(4) * static_cast<real_type>(n + 1) * std::numeric_limits<real_type>::epsilon();
+    }
+
+    void expect_near(const value_type& res, const value_type& expected, std::size_t n) const
+    {
+        EXPECT_LE(std::abs(res - expected), tolerance(n) * (real_type(1) + std::abs(expected))) << "size: " << n;
+    }
+
+    void test_dot() const
+    {
+        for (std::size_t n : sizes())
+        {
+            vector_type x = make_vector(n, 1), y = make_vector(n, 2);
+            value_type expected(0), expected_c(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                expected += x[i] * y[i];
+                expected_c += traits::conj(x[i]) * y[i];
+            }
+            expect_near(xsimd::dot(x.data(), y.data(), n), expected, n);
+            expect_near(xsimd::dotc(x.data(), y.data(), n), expected_c, n);
+        }
+    }
+
+    void test_axpy_scal() const
+    {
+        const value_type alpha = make_vector(1, 3)[0];
+        for (std::size_t n : sizes())
+        {
+            vector_type x = make_vector(n, 1), y = make_vector(n, 2);
+            vector_type expected_y = y, expected_x = x;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                expected_y[i] += alpha * x[i];
+                expected_x[i] *= alpha;
+            }
+            xsimd::axpy(alpha, x.data(), y.data(), n);
+            xsimd::scal(alpha, x.data(), n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                expect_near(y[i], expected_y[i], 1);
+                expect_near(x[i], expected_x[i], 1);
+            }
+        }
+    }
+
+    void test_nrm2_asum() const
+    {
+        for (std::size_t n : sizes())
+        {
+            vector_type x = make_vector(n, 1);
+            long double ssq = 0, sum = 0;
+            for (const auto& v : x)
+            {
+                ssq += static_cast<long double>(std::norm(v));
+                sum += traits::magnitude(v);
+            }
+            real_type expected_nrm2 = static_cast<real_type>(std::sqrt(ssq));
+            real_type expected_asum = static_cast<real_type>(sum);
+            EXPECT_NEAR(xsimd::nrm2(x.data(), n), expected_nrm2, tolerance(n) * (1 + expected_nrm2)) << "size: " << n;
+            EXPECT_NEAR(xsimd::asum(x.data(), n), expected_asum, tolerance(n) * (1 + expected_asum)) << "size: " << n;
+        }
+    }
+
+    // The squares of these elements overflow or underflow
+    void test_nrm2_scaling() const
+    {
+        const std::size_t n = 100;
+        const real_type scales[] = { (std::numeric_limits<real_type>::max)() / real_type(64),
+                                     (std::numeric_limits<real_type>::min)() * real_type(4),
+                                     std::numeric_limits<real_type>::denorm_min() * real_type(64) };
+        for (real_type scale : scales)
+        {
+            vector_type x = make_vector(n, 4);
+            long double ssq = 0;
+            for (auto& v : x)
+            {
+                v *= scale;
+                ssq += static_cast<long double>(std::norm(v / scale));
+            }
+            real_type expected = static_cast<real_type>(std::sqrt(ssq)) * scale;
+            real_type res = xsimd::nrm2(x.data(), n);
+            // the smallest scale loses the bits of the subnormal elements
+            real_type tol = scale < (std::numeric_limits<real_type>::min)() ? real_type(0.1) : tolerance(n);
+            EXPECT_NEAR(res / scale, expected / scale, tol * (1 + expected / scale)) << "scale: " << scale;
+        }
+        vector_type zeros(n, value_type(0));
+        EXPECT_EQ(xsimd::nrm2(zeros.data(), n), real_type(0));
+    }
+
+    void test_iamax() const
+    {
+        for (std::size_t n : sizes())
+        {
+            vector_type x = make_vector(n, 5);
+            std::size_t expected = 0;
+            for (std::size_t i = 1; i < n; ++i)
+            {
+                if (traits::magnitude(x[expected]) < traits::magnitude(x[i]))
+                {
+                    expected = i;
+                }
+            }
+            EXPECT_EQ(xsimd::iamax(x.data(), n), expected) << "size: " << n;
+
+            // the first of several equal maxima
+            if (n > 2)
+            {
+                x[n / 2] = value_type(4);
+                x[n - 1] = value_type(-4);
+                EXPECT_EQ(xsimd::iamax(x.data(), n), n / 2) << "size: " << n;
+            }
+        }
+    }
+
+    // Reference product of row-major matrices, C = alpha * A * B + beta * C
+    // where C is not read when beta is zero
+    void reference_gemm(std::size_t m, std::size_t n, std::size_t k, const value_type& alpha, const value_type* a, std::size_t lda,
+                        const value_type* b, std::size_t ldb, const value_type& beta, value_type* c, std::size_t ldc) const
+    {
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                value_type res(0);
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    res += a[i * lda + p] * b[p * ldb + j];
+                }
+                c[i * ldc + j] = beta == value_type(0) ? alpha * res : alpha * res + beta * c[i * ldc + j];
+            }
+        }
+    }
+
+    template <std::size_t M, std::size_t N, std::size_t K>
+    void check_gemm_small() const
+    {
+        vector_type a = make_vector(M * K, 6), b = make_vector(K * N, 7);
+        vector_type res(M * N), expected(M * N);
+        xsimd::gemm_small<M, N, K>(a.data(), b.data(), res.data());
+        reference_gemm(M, N, K, value_type(1), a.data(), K, b.data(), N, value_type(0), expected.data(), N);
+        for (std::size_t i = 0; i < M * N; ++i)
+        {
+            expect_near(res[i], expected[i], K);
+        }
+    }
+
+    void test_gemm_small() const
+    {
+        check_gemm_small<1, 1, 1>();
+        check_gemm_small<3, 3, 3>();
+        check_gemm_small<4, 4, 4>();
+        check_gemm_small<3, 5, 7>();
+        check_gemm_small<8, 8, 8>();
+        check_gemm_small<6, 12, 9>();
+        check_gemm_small<16, 16, 16>();
+        check_gemm_small<17, 33, 20>();
+    }
+
+    // Shapes around the register and cache blocks, with padded rows
+    void test_gemm() const
+    {
+        const std::size_t shapes[][3] = { { 1, 1, 1 }, { 4, 16, 8 }, { 5, 7, 3 }, { 33, 65, 17 }, { 130, 40, 300 }, { 130, 70, 300 }, { 9, 4100, 60 } };
+        const value_type alpha = make_vector(1, 8)[0], beta = make_vector(1, 9)[0];
+        for (const auto& shape : shapes)
+        {
+            std::size_t m = shape[0], n = shape[1], k = shape[2];
+            std::size_t lda = k + 1, ldb = n + 2, ldc = n + 3;
+            vector_type a = make_vector(m * lda, 10), b = make_vector(k * ldb, 11);
+            vector_type c = make_vector(m * ldc, 12);
+            vector_type expected = c;
+            xsimd::gemm(m, n, k, alpha, a.data(), lda, b.data(), ldb, beta, c.data(), ldc);
+            reference_gemm(m, n, k, alpha, a.data(), lda, b.data(), ldb, beta, expected.data(), ldc);
+            for (std::size_t i = 0; i < m * ldc; ++i)
+            {
+                expect_near(c[i], expected[i], k);
+            }
+
+            // C is not read when beta is zero
+            vector_type nans(m * ldc, value_type(std::numeric_limits<real_type>::quiet_NaN()));
+            expected = nans;
+            xsimd::gemm(m, n, k, alpha, a.data(), lda, b.data(), ldb, value_type(0), nans.data(), ldc);
+            reference_gemm(m, n, k, alpha, a.data(), lda, b.data(), ldb, value_type(0), expected.data(), ldc);
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    expect_near(nans[i * ldc + j], expected[i * ldc + j], k);
+                }
+            }
+        }
+    }
+};
+
+using blas_types = testing::Types<float, double, std::complex<float>, std::complex<double>>;
+
+TYPED_TEST_SUITE(blas_test, blas_types);
+
+TYPED_TEST(blas_test, dot)
+{
+    this->test_dot();
+}
+
+TYPED_TEST(blas_test, axpy_scal)
+{
+    this->test_axpy_scal();
+}
+
+TYPED_TEST(blas_test, nrm2_asum)
+{
+    this->test_nrm2_asum();
+}
+
+TYPED_TEST(blas_test, nrm2_scaling)
+{
+    this->test_nrm2_scaling();
+}
+
+TYPED_TEST(blas_test, iamax)
+{
+    this->test_iamax();
+}
+
+TYPED_TEST(blas_test, gemm_small)
+{
+    this->test_gemm_small();
+}
+
+TYPED_TEST(blas_test, gemm)
+{
+    this->test_gemm();
+}
+
+TEST(blas, integer)
+{
+    std::vector<int32_t> x(103), y(103);
+    int32_t expected = 0;
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        x[i] = static_cast<int32_t>(i % 7) - 3;
+        y[i] = static_cast<int32_t>(i % 5) - 2;
+        expected += x[i] * y[i];
+    }
+    EXPECT_EQ(xsimd::dot(x.data(), y.data(), x.size()), expected);
+
+    std::vector<int32_t> expected_y = y;
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        expected_y[i] += 3 * x[i];
+    }
+    xsimd::axpy(int32_t(3), x.data(), y.data(), x.size());
+    EXPECT_EQ(y, expected_y);
+}
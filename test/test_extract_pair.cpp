@@ -35,10 +35,10 @@ namespace xsimd
             for (int i = 0 ; i < (num - index); ++i)
             {
                 exped[i] = lhs_in[i + index];
-                if(i < index)
-                {
-                    exped[num - 1 - i] = rhs_in[index - 1 - i];
-                }
+            }
+            for (int i = 0 ; i < index; ++i)
+            {
+                exped[num - index + i] = rhs_in[i];
             }
             vects.push_back(std::move(exped));
 
@@ -88,3 +88,36 @@ TYPED_TEST(extract_pair_test, extract_pair_128)
 {
     this->extract_pair_128();
 }
+
+// Every index, on the floating point kernels
+template <class B>
+class extract_pair_float_test : public extract_pair_test<B>
+{
+  protected:
+    using base_type = extract_pair_test<B>;
+    using value_type = typename base_type::value_type;
+    static constexpr size_t size = base_type::size;
+
+    void extract_pair_all()
+    {
+        xsimd::init_extract_pair_base<value_type, size> extract_pair_base;
+        for (int index = 0; index < static_cast<int>(size); ++index)
+        {
+            auto extract_pair_vecs = extract_pair_base.create_extract_vectors(index);
+            B b_lhs, b_rhs, b_exped, b_res;
+            b_lhs.load_unaligned(extract_pair_vecs[0].data());
+            b_rhs.load_unaligned(extract_pair_vecs[1].data());
+            b_exped.load_unaligned(extract_pair_vecs[2].data());
+
+            b_res = xsimd::extract_pair(b_lhs, b_rhs, index);
+            EXPECT_BATCH_EQ(b_res, b_exped) << print_function_name("extract_pair index " + std::to_string(index));
+        }
+    }
+};
+
+TYPED_TEST_SUITE(extract_pair_float_test, batch_float_types, simd_test_names);
+
+TYPED_TEST(extract_pair_float_test, extract_pair_all)
+{
+    this->extract_pair_all();
+}
@@ -0,0 +1,225 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "test_utils.hpp"
+
+template <class T>
+class fft_test : public testing::Test
+{
+protected:
+
+    using real_type = T;
+    using value_type = std::complex<T>;
+    using vector_type = std::vector<value_type>;
+
+    // Powers of two, products of small primes and primes
+    std::vector<std::size_t> sizes() const
+    {
+        return { 1, 2, 3, 4, 5, 7, 8, 12, 15, 16, 60, 64, 97, 100, 1024, 1536 };
+    }
+
+    vector_type make_vector(std::size_t n, unsigned seed) const
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<T> dist(T(-1), T(1));
+        vector_type res(n);
+        for (auto& x : res)
+        {
+            T re = dist(gen);
+            x = value_type(re, dist(gen));
+        }
+        return res;
+    }
+
+    std::vector<std::complex<long double>> reference(const vector_type& x, bool inverse) const
+    {
+        const long double two_pi = 6.283185307179586476925286766559005768L;
+        const std::size_t n = x.size();
+        std::vector<std::complex<long double>> roots(n), res(n);
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            long double angle = two_pi * static_cast<long double>(j) / static_cast<long double>(n);
+            roots[j] = std::complex<long double>(std::cos(angle), inverse ? std::sin(angle) : -std::sin(angle));
+        }
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            std::complex<long double> acc(0);
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                acc += std::complex<long double>(x[j].real(), x[j].imag()) * roots[(j * k) % n];
+            }
+            res[k] = inverse ? acc / static_cast<long double>(n) : acc;
+        }
+        return res;
+    }
+
+    real_type tolerance(std::size_t n) const
+    {
+        return real_type(8) * static_cast<real_type>(std::log2(static_cast<double>(n)) + 1) *
+            std::numeric_limits<real_type>::epsilon();
+    }
+
+    // Error relative to the norm of the expected values
+    void expect_near(const value_type* res, const std::vector<std::complex<long double>>& expected, std::size_t n) const
+    {
+        long double norm = 0, err = 0;
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            norm += std::norm(expected[k]);
+            err += std::norm(std::complex<long double>(res[k].real(), res[k].imag()) - expected[k]);
+        }
+        EXPECT_LE(std::sqrt(err), tolerance(n) * std::sqrt(norm)) << "size: " << n;
+    }
+
+    void test_interleaved() const
+    {
+        for (std::size_t n : sizes())
+        {
+            vector_type x = make_vector(n, 1), res(n);
+            xsimd::fft(x.data(), res.data(), n);
+            expect_near(res.data(), reference(x, false), n);
+            xsimd::ifft(x.data(), res.data(), n);
+            expect_near(res.data(), reference(x, true), n);
+
+            // in place round trip
+            vector_type y = x;
+            xsimd::fft(y.data(), y.data(), n);
+            xsimd::ifft(y.data(), y.data(), n);
+            expect_near(y.data(), widen(x), n);
+        }
+    }
+
+    void test_split() const
+    {
+        for (std::size_t n : sizes())
+        {
+            vector_type x = make_vector(n, 2);
+            xsimd::split_complex_vector<T> in(x.begin(), x.end()), out;
+            xsimd::fft(in, out);
+            vector_type res(n);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                res[k] = out[k];
+            }
+            expect_near(res.data(), reference(x, false), n);
+
+            xsimd::ifft(out, out);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                res[k] = out[k];
+            }
+            expect_near(res.data(), widen(x), n);
+        }
+    }
+
+    void test_real() const
+    {
+        std::vector<std::size_t> real_sizes = sizes();
+        real_sizes.push_back(30);
+        real_sizes.push_back(2048);
+        for (std::size_t n : real_sizes)
+        {
+            vector_type x = make_vector(n, 3);
+            std::vector<T> in(n);
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                x[j] = value_type(x[j].real(), T(0));
+                in[j] = x[j].real();
+            }
+            std::size_t h = n / 2 + 1;
+            vector_type res(h);
+            xsimd::rfft(in.data(), res.data(), n);
+            expect_near(res.data(), reference(x, false), h);
+
+            std::vector<T> back(n);
+            xsimd::irfft(res.data(), back.data(), n);
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                EXPECT_NEAR(back[j], in[j], tolerance(n) * 4) << "size: " << n;
+            }
+        }
+    }
+
+    // The transforms of size 0 leave the output untouched
+    void test_empty() const
+    {
+        vector_type x = make_vector(1, 4), res = x;
+        xsimd::fft(x.data(), res.data(), 0);
+        xsimd::ifft(x.data(), res.data(), 0);
+        EXPECT_EQ(res[0], x[0]);
+
+        std::vector<T> in(1, T(1)), back(1, T(2));
+        xsimd::rfft(in.data(), res.data(), 0);
+        xsimd::irfft(res.data(), back.data(), 0);
+        EXPECT_EQ(res[0], x[0]);
+        EXPECT_EQ(back[0], T(2));
+
+        xsimd::split_complex_vector<T> empty, out;
+        xsimd::fft(empty, out);
+        EXPECT_EQ(out.size(), std::size_t(0));
+        EXPECT_EQ(xsimd::fft_plan<T>::cached(0).size(), std::size_t(0));
+    }
+
+    void test_plan() const
+    {
+        const xsimd::fft_plan<T>& plan = xsimd::fft_plan<T>::cached(60);
+        EXPECT_EQ(&plan, &xsimd::fft_plan<T>::cached(60));
+        EXPECT_EQ(plan.size(), std::size_t(60));
+        xsimd::fft_plan<T> other(64);
+        EXPECT_EQ(other.size(), std::size_t(64));
+    }
+
+private:
+
+    static std::vector<std::complex<long double>> widen(const vector_type& x)
+    {
+        std::vector<std::complex<long double>> res(x.size());
+        for (std::size_t j = 0; j < x.size(); ++j)
+        {
+            res[j] = std::complex<long double>(x[j].real(), x[j].imag());
+        }
+        return res;
+    }
+};
+
+using fft_types = testing::Types<float, double>;
+
+TYPED_TEST_SUITE(fft_test, fft_types);
+
+TYPED_TEST(fft_test, interleaved)
+{
+    this->test_interleaved();
+}
+
+TYPED_TEST(fft_test, split)
+{
+    this->test_split();
+}
+
+TYPED_TEST(fft_test, real)
+{
+    this->test_real();
+}
+
+TYPED_TEST(fft_test, empty)
+{
+    this->test_empty();
+}
+
+TYPED_TEST(fft_test, plan)
+{
+    this->test_plan();
+}
@@ -0,0 +1,254 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "test_utils.hpp"
+
+template <class T>
+class filter_test : public testing::Test
+{
+protected:
+
+    using value_type = T;
+    using vector_type = std::vector<value_type>;
+
+    vector_type make_vector(std::size_t n, unsigned seed) const
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<value_type> dist(value_type(-1), value_type(1));
+        vector_type res(n);
+        for (auto& x : res)
+        {
+            x = dist(gen);
+        }
+        return res;
+    }
+
+    void expect_near(const value_type& res, const value_type& expected, std::size_t n) const
+    {
+        value_type tol = value_type(4) * static_cast<value_type>(n + 1) * std::numeric_limits<value_type>::epsilon();
+        EXPECT_NEAR(res, expected, tol * (value_type(1) + std::abs(expected))) << "size: " << n;
+    }
+
+    // Reference filter of the whole signal, zeros before the first sample
+    vector_type reference_fir(const vector_type& taps, const vector_type& x) const
+    {
+        vector_type res(x.size(), value_type(0));
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            for (std::size_t k = 0; k < taps.size() && k <= i; ++k)
+            {
+                res[i] += taps[k] * x[i - k];
+            }
+        }
+        return res;
+    }
+
+    void test_fir() const
+    {
+        const std::size_t ntaps[] = { 1, 3, 16, 33, 512 };
+        for (std::size_t nt : ntaps)
+        {
+            vector_type taps = make_vector(nt, 1);
+            vector_type x = make_vector(10000, 2);
+            vector_type expected = reference_fir(taps, x);
+
+            xsimd::fir_filter<value_type> filter(taps.data(), nt);
+            EXPECT_EQ(filter.size(), nt);
+            vector_type res(x.size());
+            filter.process(x.data(), res.data(), x.size());
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                expect_near(res[i], expected[i], nt);
+            }
+
+            // Blocks of any length carry the history across calls,
+            // in place
+            filter.reset();
+            res = x;
+            const std::size_t blocks[] = { 0, 1, 7, 64, 100, 5000 };
+            std::size_t start = 0;
+            for (std::size_t i = 0; start < res.size(); ++i)
+            {
+                std::size_t count = std::min(blocks[i % 6], res.size() - start);
+                filter.process(res.data() + start, res.data() + start, count);
+                start += count;
+            }
+            for (std::size_t i = 0; i < x.size(); ++i)
+            {
+                expect_near(res[i], expected[i], nt);
+            }
+        }
+    }
+
+    void test_convolve2d() const
+    {
+        const std::size_t shapes[][4] = { { 1, 1, 1, 1 }, { 5, 9, 3, 3 }, { 20, 37, 5, 5 }, { 16, 70, 1, 7 }, { 40, 100, 7, 2 }, { 3, 3, 5, 5 } };
+        for (const auto& shape : shapes)
+        {
+            std::size_t rows = shape[0], cols = shape[1], krows = shape[2], kcols = shape[3];
+            vector_type in = make_vector(rows * cols, 3), kernel = make_vector(krows * kcols, 4);
+            std::size_t out_rows = rows < krows ? 0 : rows - krows + 1;
+            std::size_t out_cols = cols < kcols ? 0 : cols - kcols + 1;
+            vector_type res(out_rows * out_cols + 1, value_type(42));
+            xsimd::convolve2d(in.data(), rows, cols, kernel.data(), krows, kcols, res.data());
+            for (std::size_t r = 0; r < out_rows; ++r)
+            {
+                for (std::size_t c = 0; c < out_cols; ++c)
+                {
+                    value_type expected(0);
+                    for (std::size_t p = 0; p < krows; ++p)
+                    {
+                        for (std::size_t q = 0; q < kcols; ++q)
+                        {
+                            expected += kernel[p * kcols + q] * in[(r + krows - 1 - p) * cols + c + kcols - 1 - q];
+                        }
+                    }
+                    expect_near(res[r * out_cols + c], expected, krows * kcols);
+                }
+            }
+            EXPECT_EQ(res.back(), value_type(42));
+        }
+    }
+
+    // Low-pass section of the channel c and stage s, with poles inside
+    // the unit circle
+    void coefficients(std::size_t c, std::size_t s, value_type* coefs) const
+    {
+        value_type r = value_type(0.5) + value_type(0.05) * static_cast<value_type>((c + s) % 8);
+        value_type theta = value_type(0.1) + value_type(0.2) * static_cast<value_type>(c % 5);
+        coefs[0] = value_type(0.2);
+        coefs[1] = value_type(0.3) - value_type(0.01) * static_cast<value_type>(s);
+        coefs[2] = value_type(0.1);
+        coefs[3] = -2 * r * std::cos(theta);
+        coefs[4] = r * r;
+    }
+
+    // Reference cascade of a channel, in the direct form I
+    vector_type reference_biquad(std::size_t c, std::size_t stages, const vector_type& x) const
+    {
+        std::vector<long double> res(x.begin(), x.end());
+        for (std::size_t s = 0; s < stages; ++s)
+        {
+            value_type k[5];
+            coefficients(c, s, k);
+            long double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+            for (auto& v : res)
+            {
+                long double y = k[0] * v + k[1] * x1 + k[2] * x2 - k[3] * y1 - k[4] * y2;
+                x2 = x1;
+                x1 = v;
+                y2 = y1;
+                y1 = y;
+                v = y;
+            }
+        }
+        return vector_type(res.begin(), res.end());
+    }
+
+    template <class B>
+    void check_biquad_bank() const
+    {
+        const std::size_t frames = 1000;
+        // The poles close to the unit circle amplify the rounding errors
+        const std::size_t iir_size = 1024;
+        const std::size_t blocks[] = { 1, 0, 300, 17, 500 };
+        const std::size_t channel_counts[] = { 1, B::size, B::size + 3, 3 * B::size - 1 };
+        for (std::size_t channels : channel_counts)
+        {
+            const std::size_t stages = 3;
+            xsimd::biquad_bank<B> bank(channels, stages);
+            EXPECT_EQ(bank.channels(), channels);
+            EXPECT_EQ(bank.stages(), stages);
+            for (std::size_t c = 0; c < channels; ++c)
+            {
+                for (std::size_t s = 0; s < stages; ++s)
+                {
+                    value_type k[5];
+                    coefficients(c, s, k);
+                    bank.set_coefficients(c, s, k[0], k[1], k[2], k[3], k[4]);
+                }
+            }
+
+            std::vector<vector_type> planar(channels), expected(channels);
+            vector_type interleaved(frames * channels);
+            for (std::size_t c = 0; c < channels; ++c)
+            {
+                planar[c] = make_vector(frames, static_cast<unsigned>(c + 5));
+                expected[c] = reference_biquad(c, stages, planar[c]);
+                for (std::size_t f = 0; f < frames; ++f)
+                {
+                    interleaved[f * channels + c] = planar[c][f];
+                }
+            }
+
+            // Interleaved, in place, in blocks of several lengths
+            std::size_t start = 0;
+            for (std::size_t i = 0; start < frames; ++i)
+            {
+                std::size_t count = std::min(blocks[i % 5], frames - start);
+                bank.process_interleaved(interleaved.data() + start * channels, interleaved.data() + start * channels, count);
+                start += count;
+            }
+            for (std::size_t c = 0; c < channels; ++c)
+            {
+                for (std::size_t f = 0; f < frames; ++f)
+                {
+                    expect_near(interleaved[f * channels + c], expected[c][f], iir_size);
+                }
+            }
+
+            // Planar, after a reset
+            bank.reset();
+            std::vector<value_type*> ptrs(channels);
+            for (std::size_t c = 0; c < channels; ++c)
+            {
+                ptrs[c] = planar[c].data();
+            }
+            bank.process_planar(ptrs.data(), ptrs.data(), frames);
+            for (std::size_t c = 0; c < channels; ++c)
+            {
+                for (std::size_t f = 0; f < frames; ++f)
+                {
+                    expect_near(planar[c][f], expected[c][f], iir_size);
+                }
+            }
+        }
+    }
+
+    void test_biquad_bank() const
+    {
+        check_biquad_bank<xsimd::simd_type<value_type>>();
+    }
+};
+
+using filter_types = testing::Types<float, double>;
+
+TYPED_TEST_SUITE(filter_test, filter_types);
+
+TYPED_TEST(filter_test, fir)
+{
+    this->test_fir();
+}
+
+TYPED_TEST(filter_test, convolve2d)
+{
+    this->test_convolve2d();
+}
+
+TYPED_TEST(filter_test, biquad_bank)
+{
+    this->test_biquad_bank();
+}
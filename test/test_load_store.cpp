@@ -116,6 +116,14 @@ private:
         batch_type b;
         std::copy(v.cbegin(), v.cend(), expected.begin());
 
+        // prefetches are hints which leave the memory unchanged
+        xsimd::prefetch(v.data());
+        xsimd::prefetch<xsimd::prefetch_hint::t1>(v.data());
+        xsimd::prefetch<xsimd::prefetch_hint::t2>(v.data());
+        xsimd::prefetch<xsimd::prefetch_hint::nta>(v.data());
+        xsimd::prefetch<xsimd::prefetch_hint::write_t0>(v.data());
+        xsimd::prefetch<xsimd::prefetch_hint::write_t1>(v.data());
+
         b.load_unaligned(v.data());
         EXPECT_BATCH_EQ(b, expected) << print_function_name(name + " unaligned");
         
@@ -135,6 +143,23 @@ private:
         
         b.store_aligned(res.data());
         EXPECT_VECTOR_EQ(res, v) << print_function_name(name + " aligned");
+
+        test_store_stream_impl(b, v, name, std::is_same<typename V::value_type, value_type>());
+    }
+
+    // Streaming stores do not convert the elements
+    template <class V>
+    void test_store_stream_impl(const batch_type& b, const V& v, const std::string& name, std::true_type)
+    {
+        V res(size);
+        xsimd::store_stream(res.data(), b);
+        xsimd::stream_fence();
+        EXPECT_VECTOR_EQ(res, v) << print_function_name(name + " stream");
+    }
+
+    template <class V>
+    void test_store_stream_impl(const batch_type&, const V&, const std::string&, std::false_type)
+    {
     }
 
     template <class V>
@@ -8,6 +8,8 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <cstdint>
+#include <thread>
 #include <vector>
 #include <type_traits>
 
@@ -18,6 +20,8 @@
 #ifdef XSIMD_INSTR_SET_AVAILABLE
 
 #include "xsimd/memory/xsimd_alignment.hpp"
+#include "xsimd/memory/xsimd_aligned_arena.hpp"
+#include "xsimd/memory/xsimd_aligned_stack_buffer.hpp"
 
 struct mock_container {};
 
@@ -33,5 +37,174 @@ TEST(xsimd, alignment)
     EXPECT_TRUE((std::is_same<u_vector_align, xsimd::unaligned_mode>::value));
     EXPECT_TRUE((std::is_same<a_vector_align, xsimd::aligned_mode>::value));
     EXPECT_TRUE((std::is_same<mock_align, xsimd::unaligned_mode>::value));
+
+    using p_vector_type = std::vector<double, xsimd::aligned_pool_allocator<double>>;
+    using p_vector_align = xsimd::container_alignment_t<p_vector_type>;
+    EXPECT_TRUE((std::is_same<p_vector_align, xsimd::aligned_mode>::value));
+
+    using h_vector_type = std::vector<double, xsimd::huge_page_allocator<double>>;
+    using h_vector_align = xsimd::container_alignment_t<h_vector_type>;
+    EXPECT_TRUE((std::is_same<h_vector_align, xsimd::aligned_mode>::value));
+}
+
+namespace
+{
+    template <class B>
+    bool is_buffer_aligned(const B& buffer)
+    {
+        return reinterpret_cast<std::uintptr_t>(buffer.data()) % B::alignment == 0;
+    }
+
+    struct counted
+    {
+        static int live;
+        counted() { ++live; }
+        ~counted() { --live; }
+    };
+
+    int counted::live = 0;
+}
+
+TEST(xsimd, aligned_stack_buffer)
+{
+    using small_buffer = xsimd::aligned_stack_buffer<float, 16, 64>;
+    {
+        small_buffer inline_buffer;
+        EXPECT_EQ(inline_buffer.size(), std::size_t(16));
+        EXPECT_TRUE(inline_buffer.is_inline());
+        EXPECT_TRUE(is_buffer_aligned(inline_buffer));
+        EXPECT_TRUE(inline_buffer.data() >= reinterpret_cast<float*>(&inline_buffer) &&
+                    inline_buffer.data() < reinterpret_cast<float*>(&inline_buffer + 1));
+
+        // buffers larger than their capacity are nested in the arena
+        small_buffer outer(1000);
+        EXPECT_FALSE(outer.is_inline());
+        EXPECT_TRUE(is_buffer_aligned(outer));
+        for (std::size_t i = 0; i < outer.size(); ++i)
+        {
+            outer[i] = float(i);
+        }
+        const float* first_inner = nullptr;
+        for (int repeat = 0; repeat < 2; ++repeat)
+        {
+            small_buffer inner(100000);
+            EXPECT_TRUE(is_buffer_aligned(inner));
+            EXPECT_TRUE(inner.data() + inner.size() <= outer.data() || outer.data() + outer.size() <= inner.data());
+            for (std::size_t i = 0; i < inner.size(); ++i)
+            {
+                inner[i] = -1.f;
+            }
+            // the memory released by a buffer is reused by the next one
+            if (repeat == 0)
+            {
+                first_inner = inner.data();
+            }
+            else
+            {
+                EXPECT_EQ(inner.data(), first_inner);
+            }
+        }
+        for (std::size_t i = 0; i < outer.size(); ++i)
+        {
+            EXPECT_EQ(outer[i], float(i));
+        }
+    }
+
+    {
+        xsimd::aligned_stack_buffer<counted, 4> inline_buffer;
+        xsimd::aligned_stack_buffer<counted, 4> arena_buffer(10);
+        EXPECT_EQ(counted::live, 14);
+    }
+    EXPECT_EQ(counted::live, 0);
+}
+
+TEST(xsimd, aligned_arena)
+{
+    xsimd::aligned_arena arena(1024);
+    EXPECT_EQ(arena.capacity(), std::size_t(0));
+
+    void* first = arena.allocate(100, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % 64, std::uintptr_t(0));
+    double* values = arena.allocate<double>(10);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(values) % xsimd::arch::default_::alignment, std::uintptr_t(0));
+    EXPECT_GE(reinterpret_cast<char*>(values), static_cast<char*>(first) + 100);
+
+    // allocations larger than the blocks get their own block
+    xsimd::aligned_arena::marker m = arena.mark();
+    void* large = arena.allocate(5000, 128);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % 128, std::uintptr_t(0));
+    std::size_t capacity = arena.capacity();
+    EXPECT_GE(capacity, std::size_t(6024));
+
+    arena.rewind(m);
+    EXPECT_EQ(arena.allocate(5000, 128), large);
+
+    arena.reset();
+    EXPECT_EQ(arena.allocate(100, 64), first);
+    EXPECT_EQ(arena.capacity(), capacity);
+
+    arena.release();
+    EXPECT_EQ(arena.capacity(), std::size_t(0));
+}
+
+TEST(xsimd, aligned_pool_allocator)
+{
+    using allocator_type = xsimd::aligned_pool_allocator<float, 64>;
+    using vector_type = std::vector<float, allocator_type>;
+    const float* first;
+    {
+        vector_type v(1000, 1.f);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.data()) % 64, std::uintptr_t(0));
+        first = v.data();
+    }
+    // the freed block is reused for the same size class
+    {
+        vector_type v(900, 2.f);
+        EXPECT_EQ(v.data(), first);
+        v.resize(5000, 3.f);
+        EXPECT_EQ(v[899], 2.f);
+        EXPECT_EQ(v[4999], 3.f);
+    }
+
+    // blocks may be freed by another thread
+    vector_type shared(100, 4.f);
+    std::thread t([&shared]() { vector_type().swap(shared); });
+    t.join();
+    EXPECT_TRUE(shared.empty());
+
+    EXPECT_TRUE((allocator_type() == xsimd::aligned_pool_allocator<double, 64>()));
+    EXPECT_TRUE((allocator_type() != xsimd::aligned_pool_allocator<float, 128>()));
+}
+
+TEST(xsimd, huge_page_allocator)
+{
+    using allocator_type = xsimd::huge_page_allocator<double>;
+    const std::size_t huge_size = 3 * allocator_type::huge_page_size / sizeof(double) + 5;
+    const int nodes[] = { allocator_type::any_node, 0 };
+    for (int node : nodes)
+    {
+        std::vector<double, allocator_type> large(huge_size, 1., allocator_type(node));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large.data()) % allocator_type::huge_page_size, std::uintptr_t(0));
+        large.back() = 2.;
+        EXPECT_EQ(large.front(), 1.);
+        EXPECT_EQ(large.back(), 2.);
+        EXPECT_EQ(large.get_allocator().numa_node(), node);
+
+        std::vector<double, allocator_type> small(100, 3., allocator_type(node));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(small.data()) % allocator_type::alignment, std::uintptr_t(0));
+        small.resize(huge_size, 4.);
+        EXPECT_EQ(small[99], 3.);
+        EXPECT_EQ(small.back(), 4.);
+    }
+    EXPECT_TRUE((allocator_type(0) == xsimd::huge_page_allocator<float>(0)));
+    EXPECT_TRUE((allocator_type(0) == allocator_type()));
+
+    // storage moves between containers of different nodes
+    std::vector<double, allocator_type> from(huge_size, 5., allocator_type(0));
+    std::vector<double, allocator_type> to = {};
+    const double* data = from.data();
+    to = std::move(from);
+    EXPECT_EQ(to.data(), data);
+    EXPECT_EQ(to.get_allocator().numa_node(), int(allocator_type::any_node));
 }
 #endif // XSIMD_INSTR_SET_AVAILABLE
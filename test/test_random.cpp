@@ -0,0 +1,199 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "test_utils.hpp"
+
+namespace
+{
+    using uint64_batch = xsimd::batch<uint64_t, xsimd::simd_type<double>::size>;
+    using uint32_batch = xsimd::batch<uint32_t, xsimd::simd_type<float>::size>;
+
+    uint64_t splitmix64(uint64_t& x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    // Reference xoshiro256++ step
+    uint64_t xoshiro256pp(uint64_t* s)
+    {
+        uint64_t res = rotl(s[0] + s[3], 23) + s[0];
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return res;
+    }
+
+    // Reference Philox4x32-10
+    void philox4x32(uint32_t* c, uint32_t k0, uint32_t k1)
+    {
+        for (int r = 0; r < 10; ++r)
+        {
+            uint64_t p0 = uint64_t(0xd2511f53u) * c[0];
+            uint64_t p1 = uint64_t(0xcd9e8d57u) * c[2];
+            uint32_t res[4] = { uint32_t(p1 >> 32) ^ c[1] ^ k0, uint32_t(p1), uint32_t(p0 >> 32) ^ c[3] ^ k1, uint32_t(p0) };
+            std::copy(res, res + 4, c);
+            k0 += 0x9e3779b9u;
+            k1 += 0xbb67ae85u;
+        }
+    }
+}
+
+TEST(random, xoshiro256pp)
+{
+    constexpr std::size_t size = uint64_batch::size;
+    uint64_t seed = 42;
+    std::vector<uint64_t> states(4 * size);
+    for (auto& s : states)
+    {
+        s = splitmix64(seed);
+    }
+    xsimd::xoshiro256pp<uint64_batch> engine(42);
+    for (int n = 0; n < 100; ++n)
+    {
+        uint64_batch res = engine();
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            uint64_t s[4] = { states[i], states[size + i], states[2 * size + i], states[3 * size + i] };
+            EXPECT_EQ(res[i], xoshiro256pp(s)) << "lane " << i;
+            for (std::size_t w = 0; w < 4; ++w)
+            {
+                states[w * size + i] = s[w];
+            }
+        }
+    }
+}
+
+TEST(random, philox4x32)
+{
+    constexpr std::size_t size = uint32_batch::size;
+
+    // Known answer of the Random123 test vectors
+    xsimd::philox4x32<uint32_batch> engine;
+    const uint32_t known[4] = { 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u };
+    for (std::size_t w = 0; w < 4; ++w)
+    {
+        EXPECT_EQ(engine()[0], known[w]);
+    }
+
+    const uint64_t seed = 0x0123456789abcdefull, block = 0xfffffffeull;
+    engine.seed(seed, block);
+    for (uint64_t b = block; b < block + 3; ++b)
+    {
+        uint32_batch res[4] = { engine(), engine(), engine(), engine() };
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            uint32_t c[4] = { uint32_t(i), uint32_t(b), uint32_t(b >> 32), 0 };
+            philox4x32(c, uint32_t(seed), uint32_t(seed >> 32));
+            for (std::size_t w = 0; w < 4; ++w)
+            {
+                EXPECT_EQ(res[w][i], c[w]) << "block " << b << " lane " << i;
+            }
+        }
+    }
+}
+
+template <class T>
+class random_test : public testing::Test
+{
+protected:
+
+    using value_type = T;
+    using batch_type = xsimd::simd_type<T>;
+
+    static constexpr std::size_t count = 100000;
+
+    // Mean and variance of count values of the distribution, for both
+    // engines, with a tail that does not fill a batch
+    template <class D, class F>
+    void check_moments(D distribution, value_type mean, value_type variance, F&& check) const
+    {
+        xsimd::xoshiro256pp<uint64_batch> xoshiro(1);
+        xsimd::philox4x32<uint32_batch> philox(2);
+        check_moments_impl(xoshiro, distribution, mean, variance, check);
+        check_moments_impl(philox, distribution, mean, variance, check);
+    }
+
+    template <class E, class D, class F>
+    void check_moments_impl(E& engine, D distribution, value_type mean, value_type variance, F&& check) const
+    {
+        std::size_t n = count - 1;
+        std::vector<value_type> values(count, value_type(42));
+        xsimd::fill(engine, distribution, values.data(), n);
+        EXPECT_EQ(values.back(), value_type(42));
+        double sum = 0, sum2 = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            check(values[i]);
+            sum += values[i];
+            sum2 += double(values[i]) * values[i];
+        }
+        double m = sum / n, v = sum2 / n - m * m;
+        // a few standard deviations of the estimators
+        EXPECT_NEAR(m, mean, 5 * std::sqrt(variance / n));
+        EXPECT_NEAR(v, variance, 0.05 * variance);
+    }
+
+    void test_uniform() const
+    {
+        const value_type a = value_type(-2), b = value_type(3);
+        check_moments(xsimd::uniform_distribution<batch_type>(a, b), (a + b) / 2, (b - a) * (b - a) / 12, [&](value_type x) {
+            EXPECT_TRUE(a <= x && x < b) << x;
+        });
+    }
+
+    void test_normal() const
+    {
+        check_moments(xsimd::normal_distribution<batch_type>(value_type(1), value_type(2)), value_type(1), value_type(4), [](value_type x) {
+            EXPECT_TRUE(std::isfinite(x)) << x;
+        });
+    }
+
+    void test_exponential() const
+    {
+        check_moments(xsimd::exponential_distribution<batch_type>(value_type(4)), value_type(0.25), value_type(0.0625), [](value_type x) {
+            EXPECT_TRUE(x >= 0 && std::isfinite(x)) << x;
+        });
+    }
+};
+
+using random_types = testing::Types<float, double>;
+
+TYPED_TEST_SUITE(random_test, random_types);
+
+TYPED_TEST(random_test, uniform)
+{
+    this->test_uniform();
+}
+
+TYPED_TEST(random_test, normal)
+{
+    this->test_normal();
+}
+
+TYPED_TEST(random_test, exponential)
+{
+    this->test_exponential();
+}
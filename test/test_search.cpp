@@ -0,0 +1,108 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "test_utils.hpp"
+
+template <class T>
+class search_test : public testing::Test
+{
+protected:
+
+    using value_type = T;
+    using vector_type = std::vector<value_type>;
+
+    // Sorted arrays with duplicates, of sizes around the complete trees
+    // of the Eytzinger layout
+    vector_type make_sorted(std::size_t n) const
+    {
+        std::mt19937 gen(static_cast<unsigned>(n));
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * n));
+        vector_type res(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            res[i] = static_cast<value_type>(dist(gen));
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+
+    // Keys below, inside and above the range of the array
+    vector_type make_keys(std::size_t n, std::size_t count) const
+    {
+        std::mt19937 gen(static_cast<unsigned>(count));
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(2 * n + 2));
+        vector_type res(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            res[i] = static_cast<value_type>(dist(gen)) - value_type(1);
+        }
+        return res;
+    }
+
+    std::vector<std::size_t> expected_positions(const vector_type& sorted, const vector_type& keys) const
+    {
+        std::vector<std::size_t> res(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            res[i] = static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), keys[i]) - sorted.begin());
+        }
+        return res;
+    }
+
+    void test_lower_bound_batch() const
+    {
+        for (std::size_t n : { 0, 1, 2, 3, 5, 7, 8, 17, 100, 1023, 1024, 100000 })
+        {
+            vector_type sorted = make_sorted(n);
+            for (std::size_t count : { 0, 1, 13, 200 })
+            {
+                vector_type keys = make_keys(n, count);
+                std::vector<std::size_t> res(count);
+                xsimd::lower_bound_batch(sorted.data(), n, keys.data(), count, res.data());
+                EXPECT_EQ(res, expected_positions(sorted, keys)) << "n: " << n << ", count: " << count;
+            }
+        }
+    }
+
+    void test_lower_bound_eytzinger() const
+    {
+        for (std::size_t n : { 0, 1, 2, 3, 5, 7, 8, 17, 100, 1023, 1024, 100000 })
+        {
+            vector_type sorted = make_sorted(n);
+            vector_type layout(n + 1);
+            xsimd::eytzinger_layout(sorted.data(), n, layout.data());
+            for (std::size_t count : { 0, 1, 13, 200 })
+            {
+                vector_type keys = make_keys(n, count);
+                std::vector<std::size_t> res(count);
+                xsimd::lower_bound_eytzinger(layout.data(), n, keys.data(), count, res.data());
+                EXPECT_EQ(res, expected_positions(sorted, keys)) << "n: " << n << ", count: " << count;
+            }
+        }
+    }
+};
+
+using search_types = testing::Types<int16_t, int32_t, uint32_t, int64_t, uint64_t, float, double>;
+
+TYPED_TEST_SUITE(search_test, search_types);
+
+TYPED_TEST(search_test, lower_bound_batch)
+{
+    this->test_lower_bound_batch();
+}
+
+TYPED_TEST(search_test, lower_bound_eytzinger)
+{
+    this->test_lower_bound_eytzinger();
+}
@@ -0,0 +1,202 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "test_utils.hpp"
+
+namespace xsimd
+{
+    // Shuffle patterns; each of them selects a different instruction on
+    // some architecture. Indices falling out of range for small or odd
+    // sizes are replaced with the identity.
+
+    template <class I>
+    struct reverse_pattern
+    {
+        static constexpr I get(std::size_t i, std::size_t n)
+        {
+            return static_cast<I>(n - 1 - i);
+        }
+    };
+
+    template <class I>
+    struct broadcast_pattern
+    {
+        static constexpr I get(std::size_t, std::size_t)
+        {
+            return 0;
+        }
+    };
+
+    template <class I>
+    struct swap_pairs_pattern
+    {
+        static constexpr I get(std::size_t i, std::size_t n)
+        {
+            return static_cast<I>((i ^ 1) < n ? i ^ 1 : i);
+        }
+    };
+
+    template <class I>
+    struct rotate_pattern
+    {
+        static constexpr I get(std::size_t i, std::size_t n)
+        {
+            return static_cast<I>((i + 1) % n);
+        }
+    };
+
+    template <class I>
+    struct swap_halves_pattern
+    {
+        static constexpr I get(std::size_t i, std::size_t n)
+        {
+            return static_cast<I>(n % 2 == 0 ? (i + n / 2) % n : i);
+        }
+    };
+
+    template <class I>
+    struct reverse_quads_pattern
+    {
+        static constexpr I get(std::size_t i, std::size_t n)
+        {
+            return static_cast<I>(i / 4 * 4 + 3 < n ? i / 4 * 4 + 3 - i % 4 : i);
+        }
+    };
+
+    template <class I>
+    struct duplicate_even_pattern
+    {
+        static constexpr I get(std::size_t i, std::size_t)
+        {
+            return static_cast<I>(i & ~std::size_t(1));
+        }
+    };
+}
+
+template <class B>
+class shuffle_test : public testing::Test
+{
+protected:
+
+    using batch_type = B;
+    using value_type = typename B::value_type;
+    static constexpr size_t size = B::size;
+    using array_type = std::array<value_type, size>;
+    using index_type = xsimd::as_unsigned_integer_t<value_type>;
+    using index_batch_type = xsimd::batch<index_type, size>;
+
+    array_type input;
+
+    shuffle_test()
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            input[i] = static_cast<value_type>(i + 1);
+        }
+    }
+
+    template <template <class> class P>
+    void test_pattern(const std::string& name) const
+    {
+        using pattern = P<index_type>;
+        array_type expected;
+        std::array<index_type, size> indices;
+        for (size_t i = 0; i < size; ++i)
+        {
+            indices[i] = pattern::get(i, size);
+            expected[i] = input[indices[i]];
+        }
+
+        batch_type x;
+        x.load_unaligned(input.data());
+        constexpr auto mask = xsimd::make_batch_constant<pattern, size>();
+        EXPECT_BATCH_EQ(xsimd::shuffle(x, mask), expected) << print_function_name("shuffle " + name);
+
+        index_batch_type index;
+        index.load_unaligned(indices.data());
+        EXPECT_BATCH_EQ(xsimd::swizzle(x, index), expected) << print_function_name("swizzle " + name);
+    }
+
+    void test_shuffle() const
+    {
+        test_pattern<xsimd::reverse_pattern>("reverse");
+        test_pattern<xsimd::broadcast_pattern>("broadcast");
+        test_pattern<xsimd::swap_pairs_pattern>("swap pairs");
+        test_pattern<xsimd::rotate_pattern>("rotate");
+        test_pattern<xsimd::swap_halves_pattern>("swap halves");
+        test_pattern<xsimd::reverse_quads_pattern>("reverse quads");
+        test_pattern<xsimd::duplicate_even_pattern>("duplicate even");
+    }
+
+    void test_identity() const
+    {
+        struct identity
+        {
+            static constexpr index_type get(size_t i, size_t)
+            {
+                return static_cast<index_type>(i);
+            }
+        };
+        batch_type x;
+        x.load_unaligned(input.data());
+        EXPECT_BATCH_EQ(xsimd::shuffle(x, xsimd::make_batch_constant<identity, size>()), input) << print_function_name("shuffle identity");
+    }
+
+    void test_compress() const
+    {
+        using bool_batch_type = xsimd::batch_bool<value_type, size>;
+        // none, all, alternating, first half, and a scattered selection
+        const std::array<uint64_t, 5> selections = { { 0, ~uint64_t(0), 0x5555555555555555ull,
+                                                       (uint64_t(1) << (size / 2)) - 1, 0x9c3a61f0e84b27d5ull } };
+        batch_type x;
+        x.load_unaligned(input.data());
+        for (uint64_t selection : selections)
+        {
+            std::array<bool, size> selected;
+            array_type expected;
+            size_t pos = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                selected[i] = ((selection >> i) & 1) != 0;
+                if (selected[i])
+                {
+                    expected[pos++] = input[i];
+                }
+            }
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (!selected[i])
+                {
+                    expected[pos++] = input[i];
+                }
+            }
+            bool_batch_type mask;
+            mask.load_unaligned(selected.data());
+            EXPECT_BATCH_EQ(xsimd::compress(x, mask), expected) << print_function_name("compress");
+        }
+    }
+};
+
+TYPED_TEST_SUITE(shuffle_test, batch_types, simd_test_names);
+
+TYPED_TEST(shuffle_test, shuffle)
+{
+    this->test_shuffle();
+}
+
+TYPED_TEST(shuffle_test, identity)
+{
+    this->test_identity();
+}
+
+TYPED_TEST(shuffle_test, compress)
+{
+    this->test_compress();
+}
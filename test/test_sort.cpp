@@ -0,0 +1,133 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "test_utils.hpp"
+
+template <class T>
+class sort_test : public testing::Test
+{
+protected:
+
+    using value_type = T;
+    using index_type = xsimd::as_unsigned_integer_t<T>;
+    using vector_type = std::vector<value_type>;
+
+    // Sizes below, around and above the sizes handled by the networks
+    std::vector<std::size_t> sizes() const
+    {
+        return { 0, 1, 2, 3, 7, 16, 31, 64, 100, 255, 256, 1000, 4097, 20000 };
+    }
+
+    // Random values, sorted and reversed ranges, few distinct values and
+    // values equal to the padding of the networks
+    std::vector<vector_type> inputs(std::size_t size) const
+    {
+        std::mt19937 gen(static_cast<unsigned>(size));
+        std::uniform_int_distribution<int> dist(-100000, 100000);
+        std::uniform_int_distribution<int> small_dist(0, 3);
+        const value_type highest = std::numeric_limits<value_type>::has_infinity ? std::numeric_limits<value_type>::infinity()
+                                                                                 : (std::numeric_limits<value_type>::max)();
+
+        vector_type random(size), few(size), extremes(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            random[i] = static_cast<value_type>(dist(gen));
+            few[i] = static_cast<value_type>(small_dist(gen));
+            int e = small_dist(gen);
+            extremes[i] = e == 0 ? highest : (e == 1 ? std::numeric_limits<value_type>::lowest() : static_cast<value_type>(dist(gen)));
+        }
+        vector_type sorted = random;
+        std::sort(sorted.begin(), sorted.end());
+        vector_type reversed(sorted.rbegin(), sorted.rend());
+        vector_type equal(size, value_type(7));
+        return { random, few, extremes, sorted, reversed, equal };
+    }
+
+    void test_sort() const
+    {
+        for (std::size_t size : sizes())
+        {
+            for (const vector_type& input : inputs(size))
+            {
+                vector_type expected = input;
+                std::sort(expected.begin(), expected.end());
+                vector_type res = input;
+                xsimd::sort(res.begin(), res.end());
+                EXPECT_EQ(res, expected) << "size: " << size;
+            }
+        }
+    }
+
+    template <class V>
+    void test_sort_by_key_values() const
+    {
+        for (std::size_t size : sizes())
+        {
+            if (size > static_cast<std::size_t>((std::numeric_limits<V>::max)()))
+            {
+                continue;
+            }
+            for (const vector_type& input : inputs(size))
+            {
+                vector_type expected = input;
+                std::sort(expected.begin(), expected.end());
+
+                vector_type keys = input;
+                std::vector<V> values(size);
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    values[i] = static_cast<V>(i);
+                }
+                xsimd::sort_by_key(keys.begin(), keys.end(), values.begin());
+                EXPECT_EQ(keys, expected) << "size: " << size;
+
+                // every value follows its key
+                std::vector<bool> seen(size, false);
+                bool consistent = true;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    std::size_t index = static_cast<std::size_t>(values[i]);
+                    consistent = consistent && index < size && !seen[index] && input[index] == keys[i];
+                    if (index < size)
+                    {
+                        seen[index] = true;
+                    }
+                }
+                EXPECT_TRUE(consistent) << "size: " << size;
+            }
+        }
+    }
+
+    void test_sort_by_key() const
+    {
+        test_sort_by_key_values<index_type>();
+        // values of another width are sorted by the scalar fallback
+        test_sort_by_key_values<uint16_t>();
+    }
+};
+
+using sort_types = testing::Types<int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t, float, double>;
+
+TYPED_TEST_SUITE(sort_test, sort_types);
+
+TYPED_TEST(sort_test, sort)
+{
+    this->test_sort();
+}
+
+TYPED_TEST(sort_test, sort_by_key)
+{
+    this->test_sort_by_key();
+}
@@ -0,0 +1,261 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "test_utils.hpp"
+
+namespace
+{
+    // Functions of complex batches and of complex values
+    struct square_plus
+    {
+        template <class X>
+        X operator()(const X& a) const
+        {
+            return a * a + a;
+        }
+    };
+
+    struct times_minus
+    {
+        template <class X>
+        X operator()(const X& a, const X& b) const
+        {
+            return a * b - b;
+        }
+    };
+
+    struct plus
+    {
+        template <class X>
+        X operator()(const X& a, const X& b) const
+        {
+            return a + b;
+        }
+    };
+
+    struct times
+    {
+        template <class X>
+        X operator()(const X& a, const X& b) const
+        {
+            return a * b;
+        }
+    };
+
+    // Allocator whose arrays start one element past an aligned address
+    template <class T>
+    struct misaligned_allocator
+    {
+        using value_type = T;
+
+        misaligned_allocator() = default;
+
+        template <class U>
+        misaligned_allocator(const misaligned_allocator<U>&)
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(xsimd::aligned_malloc((n + 1) * sizeof(T), 64)) + 1;
+        }
+
+        void deallocate(T* p, std::size_t)
+        {
+            xsimd::aligned_free(p - 1);
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const misaligned_allocator<T>&, const misaligned_allocator<U>&)
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const misaligned_allocator<T>&, const misaligned_allocator<U>&)
+    {
+        return false;
+    }
+}
+
+template <class T>
+class split_complex_test : public testing::Test
+{
+protected:
+
+    using real_type = T;
+    using value_type = std::complex<T>;
+    using vector_type = xsimd::split_complex_vector<T>;
+    using batch_type = typename vector_type::batch_type;
+
+    // Sizes below, at and above a batch
+    std::vector<std::size_t> sizes() const
+    {
+        return { 0, 1, vector_type::batch_size, 2 * vector_type::batch_size + 1, 100 };
+    }
+
+    std::vector<value_type> make_values(std::size_t n, int seed) const
+    {
+        std::vector<value_type> res(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            res[i] = value_type(real_type(int(i) % 7 - 3 + seed), real_type(int(i) % 5 - 2 - seed)) / real_type(4);
+        }
+        return res;
+    }
+
+    void expect_near(const value_type& res, const value_type& expected) const
+    {
+        real_type tol = real_type(64) * std::numeric_limits<real_type>::epsilon() * (real_type(1) + std::abs(expected));
+        EXPECT_LE(std::abs(res - expected), tol) << res << " " << expected;
+    }
+
+    void test_container() const
+    {
+        std::vector<value_type> values = make_values(37, 1);
+        vector_type v(values.begin(), values.end());
+        EXPECT_EQ(v.size(), values.size());
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.real_data()) % alignof(batch_type), 0u);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.imag_data()) % alignof(batch_type), 0u);
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            EXPECT_EQ(static_cast<value_type>(v[i]), values[i]);
+            EXPECT_EQ(v.real_data()[i], values[i].real());
+            EXPECT_EQ(v.imag_data()[i], values[i].imag());
+        }
+
+        v[3] = value_type(5, -6);
+        EXPECT_EQ(static_cast<value_type>(v[3]), value_type(5, -6));
+        v[4] = v[3];
+        EXPECT_EQ(static_cast<value_type>(v[4]), value_type(5, -6));
+
+        v.resize(40, value_type(1, 2));
+        EXPECT_EQ(static_cast<value_type>(v[39]), value_type(1, 2));
+        EXPECT_FALSE(v.empty());
+
+        // Batches are read and written in place
+        std::size_t i = 0;
+        for (auto it = v.batch_begin(); it != v.batch_end(); ++it, i += vector_type::batch_size)
+        {
+            batch_type b = *it;
+            for (std::size_t j = 0; j < vector_type::batch_size; ++j)
+            {
+                EXPECT_EQ(b[j], static_cast<value_type>(v[i + j]));
+            }
+            *it = b * b;
+        }
+        EXPECT_EQ(i, 40 - 40 % vector_type::batch_size);
+        EXPECT_EQ(static_cast<value_type>(v[3]), value_type(5, -6) * value_type(5, -6));
+    }
+
+    void test_transform() const
+    {
+        for (std::size_t n : sizes())
+        {
+            std::vector<value_type> xs = make_values(n, 1), ys = make_values(n, 2);
+            vector_type x(xs.begin(), xs.end()), y(ys.begin(), ys.end()), res;
+
+            xsimd::transform(x, res, square_plus());
+            ASSERT_EQ(res.size(), n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                expect_near(res[i], xs[i] * xs[i] + xs[i]);
+            }
+
+            xsimd::transform(x, y, res, times_minus());
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                expect_near(res[i], xs[i] * ys[i] - ys[i]);
+            }
+
+            // in place
+            xsimd::transform(x, y, x, plus());
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                expect_near(x[i], xs[i] + ys[i]);
+            }
+        }
+    }
+
+    void test_reduce() const
+    {
+        for (std::size_t n : sizes())
+        {
+            std::vector<value_type> xs = make_values(n, 3);
+            vector_type x(xs.begin(), xs.end());
+            value_type expected(1, 1);
+            for (const auto& v : xs)
+            {
+                expected += v;
+            }
+            expect_near(xsimd::reduce(x, value_type(1, 1)), expected);
+            value_type product = xsimd::reduce(x, value_type(1), times());
+            value_type expected_product(1);
+            for (const auto& v : xs)
+            {
+                expected_product *= v;
+            }
+            expect_near(product, expected_product);
+        }
+    }
+
+    // Containers with an unaligned allocator use unaligned accesses
+    template <class A>
+    void test_unaligned() const
+    {
+        using unaligned_vector = xsimd::split_complex_vector<T, A>;
+        EXPECT_TRUE((std::is_same<typename unaligned_vector::alignment_mode, xsimd::unaligned_mode>::value));
+        std::vector<value_type> xs = make_values(37, 1), ys = make_values(37, 2);
+        unaligned_vector x(xs.begin(), xs.end()), y(ys.begin(), ys.end()), res;
+
+        xsimd::transform(x, y, res, times_minus());
+        ASSERT_EQ(res.size(), xs.size());
+        value_type expected(1, 1);
+        for (std::size_t i = 0; i < xs.size(); ++i)
+        {
+            expect_near(res[i], xs[i] * ys[i] - ys[i]);
+            expected += xs[i];
+        }
+        expect_near(xsimd::reduce(x, value_type(1, 1)), expected);
+    }
+};
+
+using split_complex_types = testing::Types<float, double>;
+
+TYPED_TEST_SUITE(split_complex_test, split_complex_types);
+
+TYPED_TEST(split_complex_test, container)
+{
+    this->test_container();
+}
+
+TYPED_TEST(split_complex_test, transform)
+{
+    this->test_transform();
+}
+
+TYPED_TEST(split_complex_test, reduce)
+{
+    this->test_reduce();
+}
+
+TYPED_TEST(split_complex_test, unaligned)
+{
+    this->template test_unaligned<std::allocator<TypeParam>>();
+    this->template test_unaligned<misaligned_allocator<TypeParam>>();
+}
@@ -0,0 +1,204 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <string>
+
+#include "test_utils.hpp"
+
+namespace
+{
+    // Log-like text long enough to span several batches on every architecture.
+    std::string make_text(std::size_t size)
+    {
+        const std::string line = "2020-06-01 12:00:00 [info] request served in 12ms\n";
+        std::string res;
+        while (res.size() < size)
+        {
+            res += line;
+        }
+        res.resize(size);
+        return res;
+    }
+}
+
+TEST(text, find_byte)
+{
+    for (std::size_t size : {0, 1, 15, 64, 257, 4096})
+    {
+        std::string text = make_text(size);
+        for (std::size_t offset = 0; offset < 3 && offset <= size; ++offset)
+        {
+            const char* data = text.data() + offset;
+            std::size_t n = size - offset;
+            std::string view(data, n);
+            for (char c : {'[', '\n', 'm', '#'})
+            {
+                std::size_t expected = std::min(view.find(c), n);
+                EXPECT_EQ(expected, xsimd::find_byte(data, n, c)) << "size: " << size << ", char: " << c;
+            }
+        }
+    }
+
+    std::string text = make_text(4096);
+    text[4000] = '\xff';
+    EXPECT_EQ(4000u, xsimd::find_byte(text.data(), text.size(), '\xff'));
+    const unsigned char* udata = reinterpret_cast<const unsigned char*>(text.data());
+    EXPECT_EQ(4000u, xsimd::find_byte(udata, text.size(), static_cast<unsigned char>(0xff)));
+}
+
+TEST(text, find_any_of)
+{
+    const std::string large_set = "#!@$%^&*(){}|<>?~`+=_;'\"/\\,";
+    for (std::size_t size : {0, 1, 15, 64, 257, 4096})
+    {
+        std::string text = make_text(size);
+        if (size > 200)
+        {
+            text[200] = '!';
+        }
+        for (std::size_t offset = 0; offset < 3 && offset <= size; ++offset)
+        {
+            const char* data = text.data() + offset;
+            std::size_t n = size - offset;
+            std::string view(data, n);
+            for (const std::string& set : {std::string("]["), std::string("zyx"), std::string("#!"), large_set, std::string()})
+            {
+                std::size_t expected = set.empty() ? n : std::min(view.find_first_of(set), n);
+                EXPECT_EQ(expected, xsimd::find_any_of(data, n, set.data(), set.size())) << "size: " << size << ", set: " << set;
+            }
+        }
+    }
+}
+
+TEST(text, find_substring)
+{
+    for (std::size_t size : {0, 1, 15, 64, 257, 4096})
+    {
+        std::string text = make_text(size);
+        if (size > 4000)
+        {
+            text.replace(4000, 5, "ERROR");
+        }
+        for (std::size_t offset = 0; offset < 3 && offset <= size; ++offset)
+        {
+            const char* data = text.data() + offset;
+            std::size_t n = size - offset;
+            std::string view(data, n);
+            for (const std::string& needle : {std::string("ERROR"), std::string("served in"), std::string("12"),
+                                              std::string("m"), std::string("[warn]"), std::string()})
+            {
+                std::size_t expected = std::min(view.find(needle), n);
+                EXPECT_EQ(expected, xsimd::find_substring(data, n, needle.data(), needle.size())) << "size: " << size << ", needle: " << needle;
+            }
+        }
+    }
+}
+
+namespace
+{
+    // Mixed text with 1 to 4-byte sequences; repeated so that sequences
+    // straddle batch boundaries at every offset.
+    std::string make_utf8_text(std::size_t repeat)
+    {
+        const std::string chunk = "plain ascii text, caf\xc3\xa9, \xe2\x82\xac 42, \xf0\x9f\x98\x80!\n";
+        std::string res;
+        for (std::size_t i = 0; i < repeat; ++i)
+        {
+            res += chunk;
+        }
+        return res;
+    }
+}
+
+TEST(text, is_ascii)
+{
+    std::string text = make_text(1000);
+    EXPECT_TRUE(xsimd::is_ascii(text.data(), text.size()));
+    EXPECT_TRUE(xsimd::is_ascii(text.data(), 0));
+    for (std::size_t pos : {0, 1, 63, 500, 999})
+    {
+        std::string tmp = text;
+        tmp[pos] = '\x80';
+        EXPECT_FALSE(xsimd::is_ascii(tmp.data(), tmp.size())) << "position: " << pos;
+    }
+}
+
+TEST(text, utf8_validate)
+{
+    std::string text = make_utf8_text(20);
+    for (std::size_t size = 0; size <= text.size(); ++size)
+    {
+        // truncating the text may split the last sequence
+        bool expected = size == text.size() || (static_cast<unsigned char>(text[size]) & 0xC0) != 0x80;
+        EXPECT_EQ(expected, xsimd::utf8_validate(text.data(), size)) << "size: " << size;
+    }
+
+    const std::string invalid[] = {
+        "\x80",                 // lone continuation
+        "\xc3",                 // truncated 2-byte sequence
+        "\xc0\xaf",             // overlong 2-byte encoding
+        "\xe0\x80\xaf",         // overlong 3-byte encoding
+        "\xed\xa0\x80",         // surrogate
+        "\xf0\x80\x80\xaf",     // overlong 4-byte encoding
+        "\xf4\x90\x80\x80",     // above U+10FFFF
+        "\xf8\x88\x80\x80\x80", // 5-byte sequence
+        "\xe2\x82\x41",         // ASCII inside a sequence
+        "\xc3\xa9\xa9",         // too many continuations
+    };
+    for (const std::string& seq : invalid)
+    {
+        for (std::size_t pos : {0, 5, 31, 64, 200})
+        {
+            std::string tmp = make_text(300);
+            tmp.replace(pos, seq.size(), seq);
+            EXPECT_FALSE(xsimd::utf8_validate(tmp.data(), tmp.size())) << "position: " << pos;
+            tmp.resize(pos + seq.size());
+            EXPECT_FALSE(xsimd::utf8_validate(tmp.data(), tmp.size())) << "at end, position: " << pos;
+        }
+    }
+}
+
+TEST(text, utf8_to_utf16)
+{
+    const std::u16string chunk = u"plain ascii text, café, € 42, \U0001F600!\n";
+    std::u16string expected;
+    for (std::size_t i = 0; i < 20; ++i)
+    {
+        expected += chunk;
+    }
+    std::string text = make_utf8_text(20);
+    std::u16string res(text.size(), u'\0');
+    std::size_t written = xsimd::utf8_to_utf16(text.data(), text.size(), &res[0]);
+    res.resize(written);
+    EXPECT_EQ(expected, res);
+
+    std::string ascii = make_text(1000);
+    std::u16string ascii_res(ascii.size(), u'\0');
+    EXPECT_EQ(ascii.size(), xsimd::utf8_to_utf16(ascii.data(), ascii.size(), &ascii_res[0]));
+    EXPECT_EQ(std::u16string(ascii.begin(), ascii.end()), ascii_res);
+
+    text[100] = '\xff';
+    EXPECT_EQ(0u, xsimd::utf8_to_utf16(text.data(), text.size(), &res[0]));
+}
+
+TEST(text, latin1_to_utf8)
+{
+    std::string latin1 = make_text(300);
+    latin1[10] = '\xe9';
+    latin1[150] = '\xff';
+    latin1[299] = '\x80';
+    std::string expected = latin1.substr(0, 10) + "\xc3\xa9" + latin1.substr(11, 139) + "\xc3\xbf" +
+        latin1.substr(151, 148) + "\xc2\x80";
+    std::string res(2 * latin1.size(), '\0');
+    std::size_t written = xsimd::latin1_to_utf8(latin1.data(), latin1.size(), &res[0]);
+    res.resize(written);
+    EXPECT_EQ(expected, res);
+    EXPECT_TRUE(xsimd::utf8_validate(res.data(), res.size()));
+}